@@ -244,6 +244,88 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////
+// Re-applies the same AA clip path every loop (as a frame that saves, clips and
+// restores would), or, if unique, a slightly different one each time so that
+// nothing can be reused.
+class AAClipRepeatBench : public Benchmark {
+    SkString fName;
+    SkRect   fClipRect;
+    SkRect   fDrawRect;
+    SkScalar fJitter;
+    bool     fUnique;
+
+public:
+    AAClipRepeatBench(bool unique) : fJitter(0), fUnique(unique) {
+        fName.printf("aaclip_%s_rrect", unique ? "unique" : "repeat");
+        fClipRect.set(10.5f, 10.5f, 210.5f, 160.5f);
+        fDrawRect.set(0, 0, 20, 20);
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+    virtual void onDraw(const int loops, SkCanvas* canvas) {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; ++i) {
+            SkRect r = fClipRect;
+            if (fUnique) {
+                fJitter += 0.37f;
+                if (fJitter > 50) {
+                    fJitter -= 50;
+                }
+                r.offset(fJitter, 0);
+            }
+            SkPath path;
+            path.addRoundRect(r, SkIntToScalar(20), SkIntToScalar(20));
+
+            canvas->save();
+            canvas->clipPath(path, SkRegion::kIntersect_Op, true);
+            canvas->drawRect(fDrawRect, paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Intersects a (shared) AA clip with an integer rect, as clipRect() after an
+// AA clipPath() does.
+class AAClipOpRectBench : public Benchmark {
+    SkAAClip fClip;
+    SkIRect  fRect;
+
+public:
+    AAClipOpRectBench() {
+        SkPath path;
+        path.addRoundRect(SkRect::MakeLTRB(0.5f, 0.5f, 400.5f, 300.5f),
+                          SkIntToScalar(30), SkIntToScalar(30));
+        fClip.setPath(path);
+        fRect.set(10, 10, 300, 200);
+    }
+
+protected:
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+    virtual const char* onGetName() { return "aaclip_op_rect"; }
+    virtual void onDraw(const int loops, SkCanvas*) {
+        for (int i = 0; i < loops; ++i) {
+            SkAAClip clip(fClip);
+            clip.op(fRect, SkRegion::kIntersect_Op);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 DEF_BENCH( return SkNEW_ARGS(AAClipBuilderBench, (false, false)); )
 DEF_BENCH( return SkNEW_ARGS(AAClipBuilderBench, (false, true)); )
 DEF_BENCH( return SkNEW_ARGS(AAClipBuilderBench, (true, false)); )
@@ -255,3 +337,6 @@ DEF_BENCH( return SkNEW_ARGS(AAClipBench, (true, false)); )
 DEF_BENCH( return SkNEW_ARGS(AAClipBench, (true, true)); )
 DEF_BENCH( return SkNEW_ARGS(NestedAAClipBench, (false)); )
 DEF_BENCH( return SkNEW_ARGS(NestedAAClipBench, (true)); )
+DEF_BENCH( return SkNEW_ARGS(AAClipRepeatBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(AAClipRepeatBench, (true)); )
+DEF_BENCH( return SkNEW_ARGS(AAClipOpRectBench, ()); )
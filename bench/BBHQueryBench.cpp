@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBBHFactory.h"
+#include "SkBBoxHierarchy.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+enum BBH { kRTree, kTileGrid, kLinear };
+
+// Time small, unaligned queries against each kind of BBH, holding the bounds of N random ops on a
+// 1024x1024 picture (the same ops as TiledPlaybackBench).
+class BBHQueryBench : public Benchmark {
+public:
+    BBHQueryBench(BBH bbh, int N) : fType(bbh), fN(N) {
+        const char* names[] = { "rtree", "tilegrid", "linear" };
+        fName.printf("bbh_query_%s_%d", names[bbh], N);
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        const SkRect bounds = SkRect::MakeWH(1024, 1024);
+        SkTileGridFactory::TileGridInfo info = { { 256, 256 }, {0,0}, {0,0} };
+        switch (fType) {
+            case kRTree:    fBBH.reset(SkRTreeFactory()(bounds));         break;
+            case kTileGrid: fBBH.reset(SkTileGridFactory(info)(bounds));  break;
+            case kLinear:   fBBH.reset(SkLinearBBHFactory()(bounds));     break;
+        }
+
+        SkRandom rand;
+        SkAutoTMalloc<SkRect> rects(fN);
+        for (int i = 0; i < fN; i++) {
+            rects[i] = SkRect::MakeXYWH(rand.nextRangeScalar(0, 1024),
+                                        rand.nextRangeScalar(0, 1024),
+                                        rand.nextRangeScalar(0, 128),
+                                        rand.nextRangeScalar(0, 128));
+        }
+        fBBH->insert(&rects, fN);
+    }
+
+    virtual void onDraw(const int loops, SkCanvas*) SK_OVERRIDE {
+        SkTDArray<unsigned> hits;
+        for (int i = 0; i < loops; i++) {
+            for (int y = 0; y < 1024; y += 256) {
+                for (int x = 0; x < 1024; x += 256) {
+                    hits.rewind();
+                    fBBH->search(SkRect::MakeXYWH(SkIntToScalar(x + 17), SkIntToScalar(y + 31), 64, 64),
+                                 &hits);
+                }
+            }
+        }
+    }
+
+private:
+    BBH                           fType;
+    int                           fN;
+    SkString                      fName;
+    SkAutoTUnref<SkBBoxHierarchy> fBBH;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kRTree,      256)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kTileGrid,   256)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kLinear,     256)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kRTree,     2048)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kTileGrid,  2048)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kLinear,    2048)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kRTree,    16384)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kTileGrid, 16384)); )
+DEF_BENCH( return SkNEW_ARGS(BBHQueryBench, (kLinear,   16384)); )
@@ -7,8 +7,10 @@
 
 #include "Benchmark.h"
 #include "SkBlurMask.h"
+#include "SkBlurMaskFilter.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
@@ -180,6 +182,84 @@ private:
     typedef BlurRectSeparableBench INHERITED;
 };
 
+// Draws a blurred, rotated rect through the canvas. Rotation rules out the nine-patch, so this
+// blurs the full path mask unless it is found in the mask cache.
+class BlurRectPathBench : public Benchmark {
+    SkScalar    fRadius;
+    SkPath      fPath;
+    SkPaint     fPaint;
+    SkString    fName;
+
+public:
+    BlurRectPathBench(SkScalar rad) : fRadius(rad) {
+        fName.printf("blurrect_path_rotated_%.2f", SkScalarToFloat(rad));
+        fPath.addRect(SkRect::MakeWH(SkIntToScalar(60), SkIntToScalar(40)));
+        fPaint.setAntiAlias(true);
+        fPaint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle,
+                SkBlurMask::ConvertRadiusToSigma(fRadius)))->unref();
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        for (int i = 0; i < loops; i++) {
+            canvas->save();
+            canvas->translate(SkIntToScalar(50 + (i % 5) * 80),
+                              SkIntToScalar(50 + (i / 5 % 4) * 80));
+            canvas->rotate(30);
+            canvas->drawPath(fPath, fPaint);
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+// Draws blurred rects through the canvas, as a drop shadow would.
+class BlurRectCanvasBench : public Benchmark {
+    SkRect      fRect;
+    SkPaint     fPaint;
+    SkString    fName;
+
+public:
+    BlurRectCanvasBench(SkScalar rad) {
+        fName.printf("blurrect_canvas_%.2f", SkScalarToFloat(rad));
+        fRect.setWH(SkIntToScalar(160), SkIntToScalar(100));
+        fPaint.setAntiAlias(true);
+        fPaint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle,
+                SkBlurMask::ConvertRadiusToSigma(rad)))->unref();
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        for (int i = 0; i < loops; i++) {
+            canvas->save();
+            canvas->translate(SkIntToScalar(30 + (i % 5) * 50),
+                              SkIntToScalar(30 + (i / 5 % 4) * 50));
+            canvas->drawRect(fRect, fPaint);
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new BlurRectCanvasBench(kMedium);)
+DEF_BENCH(return new BlurRectCanvasBench(BIG);)
+DEF_BENCH(return new BlurRectCanvasBench(REALBIG);)
+
+DEF_BENCH(return new BlurRectPathBench(kMedium);)
+DEF_BENCH(return new BlurRectPathBench(BIG);)
+
 DEF_BENCH(return new BlurRectBoxFilterBench(SMALL);)
 DEF_BENCH(return new BlurRectBoxFilterBench(BIG);)
 DEF_BENCH(return new BlurRectBoxFilterBench(REALBIG);)
@@ -84,6 +84,46 @@ private:
     typedef     Benchmark INHERITED;
 };
 
+// Shadows under rotated round-rect icons can't use the nine-patch path, so they blur the full
+// path mask. Repeated draws of the same (persistent) path reuse the cached blurred mask.
+class BlurRoundRectPathBench : public Benchmark {
+public:
+    BlurRoundRectPathBench(int size, int cornerRadius) : fName("blurroundrect_path") {
+        fName.appendf("_WH[%ix%i]_cr[%i]", size, size, cornerRadius);
+        SkRect r = SkRect::MakeWH(SkIntToScalar(size), SkIntToScalar(size));
+        fPath.addRoundRect(r, SkIntToScalar(cornerRadius), SkIntToScalar(cornerRadius));
+        fPaint.setAntiAlias(true);
+        fPaint.setColor(0x80000000);
+        fPaint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle,
+                SkBlurMask::ConvertRadiusToSigma(SkIntToScalar(6))))->unref();
+    }
+
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        for (int i = 0; i < loops; i++) {
+            canvas->save();
+            // A grid of icons, all at the same subpixel offset.
+            canvas->translate(SkIntToScalar(20 + (i % 4) * 100),
+                              SkIntToScalar(20 + (i / 4 % 3) * 100));
+            canvas->rotate(15);
+            canvas->drawPath(fPath, fPaint);
+            canvas->restore();
+        }
+    }
+
+private:
+    SkString    fName;
+    SkPath      fPath;
+    SkPaint     fPaint;
+
+    typedef     Benchmark INHERITED;
+};
+
+DEF_BENCH(return new BlurRoundRectPathBench(64, 12);)
+
 // Create one with dimensions/rounded corners based on the skp
 DEF_BENCH(return new BlurRoundRectBench(600, 5514, 6);)
 // Same radii, much smaller rectangle
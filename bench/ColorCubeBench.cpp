@@ -7,6 +7,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkColorCubeFilter.h"
+#include "SkColorFilterImageFilter.h"
 #include "SkGradientShader.h"
 
 class ColorCubeBench : public Benchmark {
@@ -14,11 +15,13 @@ class ColorCubeBench : public Benchmark {
     int fCubeDimension;
     SkData* fCubeData;
     SkBitmap fBitmap;
+    bool fUseImageFilter;
 
 public:
-    ColorCubeBench()
+    ColorCubeBench(bool useImageFilter)
      : fCubeDimension(0)
-     , fCubeData(NULL) {
+     , fCubeData(NULL)
+     , fUseImageFilter(useImageFilter) {
         fSize = SkISize::Make(2880, 1800); // 2014 Macbook Pro resolution
     }
 
@@ -28,7 +31,7 @@ public:
 
 protected:
     virtual const char* onGetName() SK_OVERRIDE {
-        return "colorcube";
+        return fUseImageFilter ? "colorcube_imagefilter" : "colorcube";
     }
 
     virtual void onPreDraw() SK_OVERRIDE {
@@ -98,7 +101,14 @@ private:
         for (int i = 0; i < loops; i++) {
             SkAutoTUnref<SkColorFilter> colorCube(
                 SkColorCubeFilter::Create(fCubeData, fCubeDimension));
-            paint.setColorFilter(colorCube);
+            if (fUseImageFilter) {
+                // Goes through SkColorFilterImageFilter's whole-bitmap path.
+                SkAutoTUnref<SkImageFilter> imageFilter(
+                    SkColorFilterImageFilter::Create(colorCube));
+                paint.setImageFilter(imageFilter);
+            } else {
+                paint.setColorFilter(colorCube);
+            }
             canvas->drawBitmap(fBitmap, 0, 0, &paint);
         }
     }
@@ -108,4 +118,5 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH( return new ColorCubeBench(); )
+DEF_BENCH( return new ColorCubeBench(false); )
+DEF_BENCH( return new ColorCubeBench(true); )
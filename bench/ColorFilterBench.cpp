@@ -9,6 +9,7 @@
 #include "SkColorFilterImageFilter.h"
 #include "SkColorMatrixFilter.h"
 #include "SkLumaColorFilter.h"
+#include "SkRandom.h"
 #include "SkTableColorFilter.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
@@ -54,6 +55,15 @@ protected:
         return SkColorFilterImageFilter::Create(filter, input);
     }
 
+    static SkImageFilter* make_gamma(float gamma, SkImageFilter* input = NULL) {
+        uint8_t table[256];
+        for (int i = 0; i < 256; ++i) {
+            table[i] = SkScalarRoundToInt(SkScalarPow(i / 255.0f, gamma) * 255);
+        }
+        SkAutoTUnref<SkColorFilter> filter(SkTableColorFilter::Create(table));
+        return SkColorFilterImageFilter::Create(filter, input);
+    }
+
     inline bool isSmall() const { return fIsSmall; }
 private:
     bool fIsSmall;
@@ -277,6 +287,65 @@ private:
     typedef ColorFilterBaseBench INHERITED;
 };
 
+class ColorFilterGammaGammaBench : public ColorFilterBaseBench {
+
+public:
+    ColorFilterGammaGammaBench(bool small) : INHERITED(small) {
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return isSmall() ? "colorfilter_gamma_gamma_small" : "colorfilter_gamma_gamma_large";
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkRect r = getFilterRect();
+        SkPaint paint;
+        paint.setColor(SK_ColorRED);
+        for (int i = 0; i < loops; i++) {
+            SkAutoTUnref<SkImageFilter> gamma(make_gamma(2.2f));
+            SkAutoTUnref<SkImageFilter> inverseGamma(make_gamma(1 / 2.2f, gamma));
+            paint.setImageFilter(inverseGamma);
+            canvas->drawRect(r, paint);
+        }
+    }
+
+private:
+    typedef ColorFilterBaseBench INHERITED;
+};
+
+class ComposeColorFilterBench : public ColorFilterBaseBench {
+
+public:
+    ComposeColorFilterBench(bool small) : INHERITED(small) {
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return isSmall() ? "colorfilter_compose_small" : "colorfilter_compose_large";
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkRect r = getFilterRect();
+        SkPaint paint;
+        paint.setColor(SK_ColorRED);
+        for (int i = 0; i < loops; i++) {
+            // A brightness matrix under a luma filter can't be folded, so this measures the
+            // plain (two pass) composition.
+            SkAutoTUnref<SkColorFilter> luma(SkLumaColorFilter::Create());
+            SkAutoTUnref<SkColorFilter> bright(SkColorFilter::CreateLightingFilter(
+                SK_ColorWHITE, SkColorSetRGB(0x20, 0x20, 0x20)));
+            SkAutoTUnref<SkColorFilter> compose(SkColorFilter::CreateComposeFilter(luma, bright));
+            SkAutoTUnref<SkImageFilter> filter(SkColorFilterImageFilter::Create(compose));
+            paint.setImageFilter(filter);
+            canvas->drawRect(r, paint);
+        }
+    }
+
+private:
+    typedef ColorFilterBaseBench INHERITED;
+};
+
 class TableColorFilterBench : public ColorFilterBaseBench {
 
 public:
@@ -342,6 +411,53 @@ private:
     typedef ColorFilterBaseBench INHERITED;
 };
 
+// Measures SkColorMatrixFilter::filterSpan directly, on opaque or translucent pixels.
+class ColorMatrixSpanBench : public Benchmark {
+public:
+    ColorMatrixSpanBench(bool opaque) : fOpaque(opaque) {
+        SkColorMatrix sepia;
+        sepia.setSaturation(0);
+        SkColorMatrix tint;
+        tint.setScale(1.07f, 0.74f, 0.43f);
+        sepia.postConcat(tint);
+        fFilter.reset(SkColorMatrixFilter::Create(sepia));
+
+        SkRandom rand;
+        for (int i = 0; i < kCount; ++i) {
+            SkColor c = rand.nextU();
+            if (fOpaque) {
+                c = SkColorSetA(c, 0xFF);
+            }
+            fSrc[i] = SkPreMultiplyColor(c);
+        }
+    }
+
+protected:
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fOpaque ? "colormatrix_span_opaque" : "colormatrix_span_translucent";
+    }
+
+    virtual void onDraw(const int loops, SkCanvas*) SK_OVERRIDE {
+        for (int i = 0; i < loops; i++) {
+            fFilter->filterSpan(fSrc, kCount, fDst);
+        }
+    }
+
+private:
+    enum { kCount = 1024 };
+
+    SkAutoTUnref<SkColorFilter> fFilter;
+    SkPMColor                   fSrc[kCount];
+    SkPMColor                   fDst[kCount];
+    bool                        fOpaque;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ColorFilterDimBrightBench(true); )
@@ -352,6 +468,8 @@ DEF_BENCH( return new ColorFilterBrightBlueBench(true); )
 DEF_BENCH( return new ColorFilterBrightBench(true); )
 DEF_BENCH( return new ColorFilterBlueBench(true); )
 DEF_BENCH( return new ColorFilterGrayBench(true); )
+DEF_BENCH( return new ColorFilterGammaGammaBench(true); )
+DEF_BENCH( return new ComposeColorFilterBench(true); )
 DEF_BENCH( return new TableColorFilterBench(true); )
 DEF_BENCH( return new LumaColorFilterBench(true); )
 
@@ -363,5 +481,10 @@ DEF_BENCH( return new ColorFilterBrightBlueBench(false); )
 DEF_BENCH( return new ColorFilterBrightBench(false); )
 DEF_BENCH( return new ColorFilterBlueBench(false); )
 DEF_BENCH( return new ColorFilterGrayBench(false); )
+DEF_BENCH( return new ColorFilterGammaGammaBench(false); )
+DEF_BENCH( return new ComposeColorFilterBench(false); )
 DEF_BENCH( return new TableColorFilterBench(false); )
 DEF_BENCH( return new LumaColorFilterBench(false); )
+
+DEF_BENCH( return new ColorMatrixSpanBench(true); )
+DEF_BENCH( return new ColorMatrixSpanBench(false); )
@@ -68,7 +68,42 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Snapshots a surface and then changes a small part of it, the way a compositor would each frame.
+class SurfacePartialCopyBench : public Benchmark {
+    enum {
+        kSurfaceWidth = 1000,
+        kSurfaceHeight = 1000,
+    };
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return "SurfaceCopyOnWrite_partial";
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkImageInfo info = SkImageInfo::MakeN32Premul(kSurfaceWidth, kSurfaceHeight);
+        SkAutoTUnref<SkSurface> surface(canvas->newSurface(info));
+        if (NULL == surface.get()) {
+            SkDebugf("SurfacePartialCopyBench newSurface failed, bench results are meaningless\n");
+            return;
+        }
+
+        SkPaint paint;
+        paint.setAlpha(127);
+        for (int iteration = 0; iteration < loops; iteration++) {
+            SkAutoTUnref<SkImage> image(surface->newImageSnapshot());
+            const SkScalar x = SkIntToScalar((iteration * 97) % (kSurfaceWidth - 50));
+            const SkScalar y = SkIntToScalar((iteration * 61) % (kSurfaceHeight - 50));
+            // Trigger copy on write.
+            surface->getCanvas()->drawRect(SkRect::MakeXYWH(x, y, 50, 50), paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new DeferredSurfaceCopyBench(false); )
 DEF_BENCH( return new DeferredSurfaceCopyBench(true); )
+DEF_BENCH( return new SurfacePartialCopyBench(); )
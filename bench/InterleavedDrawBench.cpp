@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+/**
+ * Draws a grid of cells that each hold a rect, a line of text and a small image, in that order, the
+ * way a list or a page of thumbnails would. No two consecutive draws share state, so on the GPU
+ * this measures how well draws are batched across the ones in between. With overlap the cells are
+ * piled on top of each other, so nothing can be reordered.
+ */
+class InterleavedDrawBench : public Benchmark {
+public:
+    InterleavedDrawBench(bool overlap) : fOverlap(overlap) {
+        fName.printf("interleaved_draws%s", overlap ? "_overlap" : "");
+    }
+
+protected:
+    const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+
+    void onPreDraw() SK_OVERRIDE {
+        fImage.allocN32Pixels(kImageSize, kImageSize);
+        fImage.eraseColor(SK_ColorGREEN);
+        fImage.eraseArea(SkIRect::MakeWH(kImageSize / 2, kImageSize / 2), SK_ColorBLUE);
+
+        SkRandom rand;
+        for (int i = 0; i < kCells; ++i) {
+            fColors[i] = rand.nextU() | 0xFF000000;
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint rectPaint, textPaint;
+        textPaint.setAntiAlias(true);
+        textPaint.setTextSize(SkIntToScalar(12));
+        for (int loop = 0; loop < loops; ++loop) {
+            for (int i = 0; i < kCells; ++i) {
+                SkScalar x = 0, y = 0;
+                if (!fOverlap) {
+                    x = SkIntToScalar(i % kColumns * kCellWidth);
+                    y = SkIntToScalar(i / kColumns * kCellHeight);
+                }
+                rectPaint.setColor(fColors[i]);
+                canvas->drawRect(SkRect::MakeXYWH(x, y, kCellWidth - 4, kCellHeight - 4),
+                                 rectPaint);
+                canvas->drawText("cell", 4, x + 2, y + 14, textPaint);
+                canvas->drawBitmap(fImage, x + kCellWidth - kImageSize - 6, y + 2);
+            }
+        }
+    }
+
+private:
+    enum {
+        kColumns = 10,
+        kCells = 100,
+        kCellWidth = 64,
+        kCellHeight = 32,
+        kImageSize = 16,
+    };
+
+    SkString fName;
+    bool     fOverlap;
+    SkBitmap fImage;
+    SkColor  fColors[kCells];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(InterleavedDrawBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(InterleavedDrawBench, (true)); )
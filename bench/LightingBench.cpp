@@ -7,6 +7,7 @@
 #include "Benchmark.h"
 #include "SkBitmapSource.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkDevice.h"
 #include "SkLightingImageFilter.h"
 
@@ -230,6 +231,53 @@ private:
     typedef LightingBaseBench INHERITED;
 };
 
+// Moves a point light across a fixed source bitmap, as an animation of just the light would.
+// The surface normals only depend on the source, so they can be reused from frame to frame.
+class LightingMovingPointLitDiffuseBench : public LightingBaseBench {
+public:
+    LightingMovingPointLitDiffuseBench(bool small) : INHERITED(small) {
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fIsSmall ? "lightingmovingpointlitdiffuse_small" :
+                          "lightingmovingpointlitdiffuse_large";
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        const int size = SkScalarCeilToInt(fIsSmall ? FILTER_WIDTH_SMALL : FILTER_WIDTH_LARGE);
+        fBitmap.allocN32Pixels(size, size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                *fBitmap.getAddr32(x, y) = SkPackARGB32((x * y) & 0xFF, 0, 0, 0);
+            }
+        }
+        fBitmap.notifyPixelsChanged();
+        // Only the normals of immutable sources are cached.
+        fBitmap.setImmutable();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkAutoTUnref<SkImageFilter> source(SkBitmapSource::Create(fBitmap));
+        SkRect r = SkRect::MakeWH(SkIntToScalar(fBitmap.width()),
+                                  SkIntToScalar(fBitmap.height()));
+        for (int i = 0; i < loops; i++) {
+            SkPoint3 location(SkIntToScalar(i % fBitmap.width()), 0, SkIntToScalar(10));
+            SkPaint paint;
+            paint.setImageFilter(SkLightingImageFilter::CreatePointLitDiffuse(location,
+                                                                              getWhite(),
+                                                                              getSurfaceScale(),
+                                                                              getKd(),
+                                                                              source))->unref();
+            canvas->drawRect(r, paint);
+        }
+    }
+
+private:
+    SkBitmap fBitmap;
+    typedef LightingBaseBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new LightingPointLitDiffuseBench(true); )
@@ -244,3 +292,5 @@ DEF_BENCH( return new LightingDistantLitSpecularBench(true); )
 DEF_BENCH( return new LightingDistantLitSpecularBench(false); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(true); )
 DEF_BENCH( return new LightingSpotLitSpecularBench(false); )
+DEF_BENCH( return new LightingMovingPointLitDiffuseBench(true); )
+DEF_BENCH( return new LightingMovingPointLitDiffuseBench(false); )
@@ -424,6 +424,75 @@ private:
     typedef MatrixBench INHERITED;
 };
 
+// Maps a batch of points or rects through matrices of each type, to exercise the
+// per-type mappers that mapPoints() and mapRects() dispatch to.
+class MapBatchMatrixBench : public MatrixBench {
+public:
+    enum Type {
+        kTranslate_Type,
+        kScale_Type,
+        kScaleTranslate_Type,
+        kRotate_Type,
+        kRotateTranslate_Type,
+        kPerspective_Type,
+    };
+
+    MapBatchMatrixBench(const char* name, Type type, bool rects)
+        : INHERITED(name)
+        , fRects(rects) {
+        switch (type) {
+            case kTranslate_Type:
+                fMatrix.setTranslate(1.5f, 2.5f);
+                break;
+            case kScale_Type:
+                fMatrix.setScale(1.5f, 2.5f);
+                break;
+            case kScaleTranslate_Type:
+                fMatrix.setScale(1.5f, 2.5f);
+                fMatrix.postTranslate(3.5f, 4.5f);
+                break;
+            case kRotate_Type:
+                fMatrix.setRotate(30);
+                break;
+            case kRotateTranslate_Type:
+                fMatrix.setRotate(30, 15, 25);
+                break;
+            case kPerspective_Type:
+                fMatrix.setRotate(30, 15, 25);
+                fMatrix.setPerspX(0.001f);
+                fMatrix.setPerspY(0.002f);
+                break;
+        }
+        fMatrix.getType();
+
+        SkRandom rand;
+        for (int i = 0; i < kCount; ++i) {
+            fSrc[i].setXYWH(rand.nextRangeScalar(0, 200), rand.nextRangeScalar(0, 200),
+                            rand.nextRangeScalar(0, 50), rand.nextRangeScalar(0, 50));
+        }
+    }
+
+protected:
+    virtual void performTest() SK_OVERRIDE {
+        if (fRects) {
+            fMatrix.mapRects(fDst, fSrc, kCount);
+        } else {
+            // Each rect is two points.
+            fMatrix.mapPoints((SkPoint*)fDst, (const SkPoint*)fSrc, 2 * kCount);
+        }
+    }
+
+private:
+    enum { kCount = 512 };
+
+    SkMatrix fMatrix;
+    bool     fRects;
+    SkRect   fSrc[kCount];
+    SkRect   fDst[kCount];
+
+    typedef MatrixBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new EqualsMatrixBench(); )
@@ -470,3 +539,22 @@ DEF_BENCH( return new InvertMapRectMatrixBench(
 
 DEF_BENCH( return new ScaleTransMixedMatrixBench(); )
 DEF_BENCH( return new ScaleTransDoubleMatrixBench(); )
+
+DEF_BENCH( return new MapBatchMatrixBench("mappoints_trans",
+                                          MapBatchMatrixBench::kTranslate_Type, false); )
+DEF_BENCH( return new MapBatchMatrixBench("mappoints_scale",
+                                          MapBatchMatrixBench::kScale_Type, false); )
+DEF_BENCH( return new MapBatchMatrixBench("mappoints_scaletrans",
+                                          MapBatchMatrixBench::kScaleTranslate_Type, false); )
+DEF_BENCH( return new MapBatchMatrixBench("mappoints_rot",
+                                          MapBatchMatrixBench::kRotate_Type, false); )
+DEF_BENCH( return new MapBatchMatrixBench("mappoints_rottrans",
+                                          MapBatchMatrixBench::kRotateTranslate_Type, false); )
+DEF_BENCH( return new MapBatchMatrixBench("mappoints_persp",
+                                          MapBatchMatrixBench::kPerspective_Type, false); )
+DEF_BENCH( return new MapBatchMatrixBench("maprects_scaletrans",
+                                          MapBatchMatrixBench::kScaleTranslate_Type, true); )
+DEF_BENCH( return new MapBatchMatrixBench("maprects_rottrans",
+                                          MapBatchMatrixBench::kRotateTranslate_Type, true); )
+DEF_BENCH( return new MapBatchMatrixBench("maprects_persp",
+                                          MapBatchMatrixBench::kPerspective_Type, true); )
@@ -6,6 +6,7 @@
  */
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkMatrixConvolutionImageFilter.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
@@ -54,7 +55,71 @@ private:
     SkString fName;
 };
 
+// Filters a 256x256 bitmap with an NxN kernel, either a separable (blur-like) one or a
+// general (edge-detect-like) one.
+class MatrixConvolutionKernelBench : public Benchmark {
+public:
+    MatrixConvolutionKernelBench(int kernelSize, bool separable) {
+        fName.printf("matrixconvolution_%dx%d_%s", kernelSize, kernelSize,
+                     separable ? "separable" : "general");
+
+        SkAutoTMalloc<SkScalar> kernel(kernelSize * kernelSize);
+        SkRandom rand;
+        for (int y = 0; y < kernelSize; ++y) {
+            for (int x = 0; x < kernelSize; ++x) {
+                SkScalar weight = SkIntToScalar((x + 1) * (y + 1));
+                kernel[y * kernelSize + x] = separable ? weight : rand.nextSScalar1();
+            }
+        }
+        const SkScalar sum = SkIntToScalar(kernelSize * (kernelSize + 1) / 2);
+        SkScalar gain = separable ? SkScalarInvert(sum * sum) : SK_Scalar1;
+        SkIPoint kernelOffset = SkIPoint::Make(kernelSize / 2, kernelSize / 2);
+        fFilter.reset(SkMatrixConvolutionImageFilter::Create(
+            SkISize::Make(kernelSize, kernelSize), kernel.get(), gain, 0, kernelOffset,
+            SkMatrixConvolutionImageFilter::kClamp_TileMode, true));
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        fBitmap.allocN32Pixels(256, 256);
+        SkRandom rand;
+        for (int y = 0; y < fBitmap.height(); ++y) {
+            for (int x = 0; x < fBitmap.width(); ++x) {
+                *fBitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+            }
+        }
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        paint.setImageFilter(fFilter);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawBitmap(fBitmap, 0, 0, &paint);
+        }
+    }
+
+private:
+    SkAutoTUnref<SkImageFilter> fFilter;
+    SkBitmap fBitmap;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClamp_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kRepeat_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, false); )
+
+DEF_BENCH( return new MatrixConvolutionKernelBench(3, false); )
+DEF_BENCH( return new MatrixConvolutionKernelBench(3, true); )
+DEF_BENCH( return new MatrixConvolutionKernelBench(5, false); )
+DEF_BENCH( return new MatrixConvolutionKernelBench(5, true); )
+DEF_BENCH( return new MatrixConvolutionKernelBench(7, false); )
+DEF_BENCH( return new MatrixConvolutionKernelBench(7, true); )
+DEF_BENCH( return new MatrixConvolutionKernelBench(9, false); )
+DEF_BENCH( return new MatrixConvolutionKernelBench(9, true); )
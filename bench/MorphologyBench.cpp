@@ -16,6 +16,7 @@
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 #define BIG     SkIntToScalar(10)
+#define LARGE   SkIntToScalar(32)
 
 enum MorphologyType {
     kErode_MT,
@@ -90,6 +91,9 @@ DEF_BENCH( return new MorphologyBench(SMALL, kDilate_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(BIG, kDilate_MT); )
 
+DEF_BENCH( return new MorphologyBench(LARGE, kErode_MT); )
+DEF_BENCH( return new MorphologyBench(LARGE, kDilate_MT); )
+
 DEF_BENCH( return new MorphologyBench(REAL, kErode_MT); )
 DEF_BENCH( return new MorphologyBench(REAL, kDilate_MT); )
 
@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkCompactPath.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkShader.h"
@@ -89,7 +90,85 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Walks a path whose points lie on a 1/8th pixel grid (as map tile geometry does), either as an
+// SkPath or as an SkCompactPath decoding its points on the fly.
+class GridPathIterBench : public Benchmark {
+    SkString                    fName;
+    SkPath                      fPath;
+    SkAutoTUnref<SkCompactPath> fCompact;
+    bool                        fDoCompact;
+
+public:
+    GridPathIterBench(bool compact) : fDoCompact(compact) {
+        fName.printf("pathiter_grid_%s", compact ? "compact" : "raw");
+
+        SkRandom rand;
+        for (int i = 0; i < 1000; ++i) {
+            SkPoint pts[4];
+            int n = rand_pts(rand, pts);
+            for (int j = 0; j < n; ++j) {
+                pts[j].set(SkScalarFloorToScalar((pts[j].fX + 1) * 2048) / 8,
+                           SkScalarFloorToScalar((pts[j].fY + 1) * 2048) / 8);
+            }
+            switch (n) {
+                case 1:
+                    fPath.moveTo(pts[0]);
+                    break;
+                case 2:
+                    fPath.lineTo(pts[1]);
+                    break;
+                case 3:
+                    fPath.quadTo(pts[1], pts[2]);
+                    break;
+                case 4:
+                    fPath.cubicTo(pts[1], pts[2], pts[3]);
+                    break;
+            }
+        }
+        fCompact.reset(SkCompactPath::Create(fPath));
+        SkASSERT(fCompact.get());
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onDraw(const int loops, SkCanvas*) SK_OVERRIDE {
+        SkPoint pts[4];
+        SkScalar sum = 0;
+        if (fDoCompact) {
+            for (int i = 0; i < loops; ++i) {
+                SkCompactPath::RawIter iter(*fCompact);
+                while (iter.next(pts) != SkPath::kDone_Verb) {
+                    sum += pts[0].fX;
+                }
+            }
+        } else {
+            for (int i = 0; i < loops; ++i) {
+                SkPath::RawIter iter(fPath);
+                while (iter.next(pts) != SkPath::kDone_Verb) {
+                    sum += pts[0].fX;
+                }
+            }
+        }
+        // keep the loops from being optimized away
+        if (SkScalarIsNaN(sum)) {
+            SkDebugf("%f\n", sum);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new PathIterBench(false); )
 DEF_BENCH( return new PathIterBench(true); )
+DEF_BENCH( return new GridPathIterBench(false); )
+DEF_BENCH( return new GridPathIterBench(true); )
@@ -10,6 +10,7 @@
 #include "SkPaint.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
+#include "SkPictureUtils.h"
 #include "SkPoint.h"
 #include "SkRandom.h"
 #include "SkRect.h"
@@ -134,30 +135,64 @@ private:
     typedef PicturePlaybackBench INHERITED;
 };
 
+// Emulates display lists that wrap every item in a save()/restore(), only some
+// of which actually change the matrix.
+class SaveRestorePlaybackBench : public PicturePlaybackBench {
+public:
+    SaveRestorePlaybackBench() : INHERITED("saveRestore") { }
+protected:
+    virtual void recordCanvas(SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        paint.setColor(SK_ColorBLACK);
+
+        const SkRect r = SkRect::MakeWH(fTextSize, fTextSize);
+        int count = 0;
+        for (SkScalar x = 0; x < fPictureWidth; x += 2 * fTextSize) {
+            for (SkScalar y = 0; y < fPictureHeight; y += 2 * fTextSize) {
+                canvas->save();
+                if (0 == (++count & 7)) {
+                    canvas->translate(x, y);
+                    canvas->drawRect(r, paint);
+                } else {
+                    canvas->drawRect(r.makeOffset(x, y), paint);
+                }
+                canvas->restore();
+            }
+        }
+    }
+private:
+    typedef PicturePlaybackBench INHERITED;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new TextPlaybackBench(); )
 DEF_BENCH( return new PosTextPlaybackBench(true); )
 DEF_BENCH( return new PosTextPlaybackBench(false); )
+DEF_BENCH( return new SaveRestorePlaybackBench(); )
 
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
 // both when querying tiles perfectly and when not.
-enum BBH  { kNone, kRTree, kTileGrid };
+enum BBH  { kNone, kRTree, kTileGrid, kLinear };
 enum Mode { kTiled, kRandom };
 class TiledPlaybackBench : public Benchmark {
 public:
-    TiledPlaybackBench(BBH bbh, Mode mode) : fBBH(bbh), fMode(mode), fName("tiled_playback") {
+    TiledPlaybackBench(BBH bbh, Mode mode, int ops = 10000)
+        : fBBH(bbh), fMode(mode), fOps(ops), fName("tiled_playback") {
         switch (fBBH) {
             case kNone:     fName.append("_none"    ); break;
             case kRTree:    fName.append("_rtree"   ); break;
             case kTileGrid: fName.append("_tilegrid"); break;
+            case kLinear:   fName.append("_linear"  ); break;
         }
         switch (fMode) {
             case kTiled:  fName.append("_tiled" ); break;
             case kRandom: fName.append("_random"); break;
         }
+        if (fOps != 10000) {
+            fName.appendf("_%d", fOps);
+        }
     }
 
     virtual const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
@@ -170,12 +205,13 @@ public:
             case kNone:                                                 break;
             case kRTree:    factory.reset(new SkRTreeFactory);          break;
             case kTileGrid: factory.reset(new SkTileGridFactory(info)); break;
+            case kLinear:   factory.reset(new SkLinearBBHFactory);      break;
         }
 
         SkPictureRecorder recorder;
         SkCanvas* canvas = recorder.beginRecording(1024, 1024, factory);
             SkRandom rand;
-            for (int i = 0; i < 10000; i++) {
+            for (int i = 0; i < fOps; i++) {
                 SkScalar x = rand.nextRangeScalar(0, 1024),
                          y = rand.nextRangeScalar(0, 1024),
                          w = rand.nextRangeScalar(0, 128),
@@ -212,6 +248,7 @@ public:
 private:
     BBH                     fBBH;
     Mode                    fMode;
+    int                     fOps;
     SkString                fName;
     SkAutoTUnref<SkPicture> fPic;
 };
@@ -222,3 +259,70 @@ DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kTileGrid, kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kTileGrid, kTiled ); )
+DEF_BENCH( return new TiledPlaybackBench(kLinear,   kRandom); )
+DEF_BENCH( return new TiledPlaybackBench(kLinear,   kTiled ); )
+
+DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom, 1000); )
+DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom, 1000); )
+DEF_BENCH( return new TiledPlaybackBench(kTileGrid, kRandom, 1000); )
+DEF_BENCH( return new TiledPlaybackBench(kLinear,   kRandom, 1000); )
+
+// Updates a canvas holding one picture to show another that differs from it by a single op, either
+// by redrawing everything or by replaying only the damage.
+class DamagePlaybackBench : public Benchmark {
+public:
+    DamagePlaybackBench(bool partial) : fPartial(partial) {
+        fName.printf("damage_playback_%s", partial ? "partial" : "full");
+    }
+
+    virtual const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+    virtual SkIPoint onGetSize() SK_OVERRIDE { return SkIPoint::Make(1024,1024); }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        SkRTreeFactory factory;
+        fOld.reset(Record(&factory, -1));
+        fNew.reset(Record(&factory, 5000));
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        for (int i = 0; i < loops; i++) {
+            if (fPartial) {
+                SkTDArray<SkRect> damage;
+                SkPictureUtils::ComputeDamage(fOld, fNew, &damage);
+                SkPictureUtils::PlaybackDamage(fNew, damage, canvas);
+            } else {
+                canvas->clear(SK_ColorTRANSPARENT);
+                fNew->playback(canvas);
+            }
+        }
+    }
+
+private:
+    // Records 10000 random rects, moving the one at index moved.
+    static SkPicture* Record(SkBBHFactory* factory, int moved) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024, factory);
+            SkRandom rand;
+            for (int i = 0; i < 10000; i++) {
+                SkScalar x = rand.nextRangeScalar(0, 1024),
+                         y = rand.nextRangeScalar(0, 1024),
+                         w = rand.nextRangeScalar(0, 128),
+                         h = rand.nextRangeScalar(0, 128);
+                if (i == moved) {
+                    x += 16;
+                }
+                SkPaint paint;
+                paint.setColor(rand.nextU());
+                paint.setAlpha(0xFF);
+                canvas->drawRect(SkRect::MakeXYWH(x,y,w,h), paint);
+            }
+        return recorder.endRecording();
+    }
+
+    bool                    fPartial;
+    SkString                fName;
+    SkAutoTUnref<SkPicture> fOld, fNew;
+};
+
+DEF_BENCH( return new DamagePlaybackBench(false); )
+DEF_BENCH( return new DamagePlaybackBench(true ); )
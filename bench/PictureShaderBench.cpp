@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkShader.h"
+#include "SkString.h"
+
+// Fills the canvas with a picture-shader pattern. When zooming, every draw uses a slightly
+// different scale, as during a pinch-zoom.
+class PictureShaderBench : public Benchmark {
+public:
+    PictureShaderBench(bool zoom) : fZoom(zoom), fStep(0) {
+        fName.printf("pictureshader_%s", zoom ? "zoom" : "static");
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fName.c_str();
+    }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        static const SkScalar kTileSize = 128;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kTileSize, kTileSize, NULL, 0);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 32; ++i) {
+            SkScalar t = SkIntToScalar(i) / 32;
+            paint.setColor(SkColorSetARGB(0xC0, 0xFF - 8 * i, 0x40, 8 * i));
+            paint.setStyle(i & 1 ? SkPaint::kStroke_Style : SkPaint::kFill_Style);
+            paint.setStrokeWidth(2);
+            canvas->drawCircle(kTileSize * t, kTileSize * (1 - t) * t * 4, 4 + 12 * t, paint);
+            canvas->drawLine(0, kTileSize * t, kTileSize * t, kTileSize, paint);
+        }
+        SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+        fPaint.setShader(SkShader::CreatePictureShader(picture, SkShader::kRepeat_TileMode,
+                                                       SkShader::kRepeat_TileMode,
+                                                       NULL, NULL))->unref();
+    }
+
+    virtual SkIPoint onGetSize() SK_OVERRIDE {
+        return SkIPoint::Make(256, 256);
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        const SkRect bounds = SkRect::MakeWH(256, 256);
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            if (fZoom) {
+                // Sweep the scale over [0.5, 4) in steps of about 1.6%, without repeating it.
+                SkScalar phase = (fStep++) * 0.0047f;
+                SkScalar scale = 0.5f + 3.5f * (phase - SkScalarFloorToScalar(phase));
+                canvas->scale(scale, scale);
+            }
+            canvas->drawRect(bounds, fPaint);
+            canvas->restore();
+        }
+    }
+
+private:
+    bool     fZoom;
+    int      fStep;
+    SkPaint  fPaint;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PictureShaderBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(PictureShaderBench, (true)); )
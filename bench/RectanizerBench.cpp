@@ -20,6 +20,7 @@
  * rectanizers:
  *      Pow2 Rectanizer
  *      Skyline Rectanizer
+ *      Skyline Rectanizer with a waste map
  * in the following cases:
  *      random rects (e.g., pull-save-layers forward use case)
  *      random power of two rects
@@ -33,6 +34,7 @@ public:
     enum RectanizerType {
         kPow2_RectanizerType,
         kSkyline_RectanizerType,
+        kSkylineWasteMap_RectanizerType,
     };
 
     enum RectType {
@@ -48,9 +50,11 @@ public:
 
         if (kPow2_RectanizerType == fRectanizerType) {
             fName.append("pow2_");
-        } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
+        } else if (kSkyline_RectanizerType == fRectanizerType) {
             fName.append("skyline_");
+        } else {
+            SkASSERT(kSkylineWasteMap_RectanizerType == fRectanizerType);
+            fName.append("skylinewm_");
         }
 
         if (kRand_RectType == fRectType) {
@@ -78,8 +82,10 @@ protected:
         if (kPow2_RectanizerType == fRectanizerType) {
             fRectanizer.reset(SkNEW_ARGS(GrRectanizerPow2, (kWidth, kHeight)));
         } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
-            fRectanizer.reset(SkNEW_ARGS(GrRectanizerSkyline, (kWidth, kHeight)));
+            SkASSERT(kSkyline_RectanizerType == fRectanizerType ||
+                     kSkylineWasteMap_RectanizerType == fRectanizerType);
+            fRectanizer.reset(SkNEW_ARGS(GrRectanizerSkyline,
+                        (kWidth, kHeight, kSkylineWasteMap_RectanizerType == fRectanizerType)));
         }
     }
 
@@ -134,5 +140,11 @@ DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kRandPow2_RectType);)
 DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kSmallPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkylineWasteMap_RectanizerType,
+                                     RectanizerBench::kRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkylineWasteMap_RectanizerType,
+                                     RectanizerBench::kRandPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkylineWasteMap_RectanizerType,
+                                     RectanizerBench::kSmallPow2_RectType);)
 
 #endif
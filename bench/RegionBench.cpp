@@ -9,6 +9,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -117,6 +118,88 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Builds a region from many rects, either by a batched setRects()/opRects() or by calling
+// op() once per rect, which is what a clip stack replaying into a BW raster clip does.
+class RegionBatchBench : public Benchmark {
+public:
+    enum Mode {
+        kLoopUnion_Mode,
+        kSetRects_Mode,
+        kLoopIntersect_Mode,
+        kOpRectsIntersect_Mode,
+    };
+
+    RegionBatchBench(int count, Mode mode) : fMode(mode) {
+        static const char* gNames[] = {
+            "union_loop", "setrects", "intersect_loop", "oprects_intersect"
+        };
+        fName.printf("region_batch_%s_%d", gNames[mode], count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            SkIRect* r = fRects.append();
+            if (kLoopIntersect_Mode == mode || kOpRectsIntersect_Mode == mode) {
+                *r = SkIRect::MakeLTRB(rand.nextU() % 64, rand.nextU() % 64,
+                                       W - rand.nextU() % 64, H - rand.nextU() % 64);
+            } else {
+                int x = rand.nextU() % W;
+                int y = rand.nextU() % H;
+                *r = SkIRect::MakeXYWH(x, y, 1 + rand.nextU() % 64, 1 + rand.nextU() % 64);
+            }
+        }
+        fBase.setRect(0, 0, W, H);
+        fBase.op(SkIRect::MakeXYWH(W/4, H/4, W/2, H/2), SkRegion::kDifference_Op);
+    }
+
+    virtual bool isSuitableFor(Backend backend) SK_OVERRIDE {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    virtual const char* onGetName() { return fName.c_str(); }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) {
+        const SkIRect* rects = fRects.begin();
+        const int count = fRects.count();
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            switch (fMode) {
+                case kLoopUnion_Mode:
+                    for (int j = 0; j < count; ++j) {
+                        rgn.op(rects[j], SkRegion::kUnion_Op);
+                    }
+                    break;
+                case kSetRects_Mode:
+                    rgn.setRects(rects, count);
+                    break;
+                case kLoopIntersect_Mode:
+                    rgn = fBase;
+                    for (int j = 0; j < count; ++j) {
+                        rgn.op(rects[j], SkRegion::kIntersect_Op);
+                    }
+                    break;
+                case kOpRectsIntersect_Mode:
+                    rgn = fBase;
+                    rgn.opRects(rects, count, SkRegion::kIntersect_Op);
+                    break;
+            }
+        }
+    }
+
+private:
+    enum {
+        W = 1024,
+        H = 768,
+    };
+
+    Mode               fMode;
+    SkString           fName;
+    SkTDArray<SkIRect> fRects;
+    SkRegion           fBase;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define SMALL   16
@@ -130,3 +213,10 @@ DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, containsrect_proc, "containsre
 DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, sectsrgn_proc, "intersectsrgn")); )
 DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, sectsrect_proc, "intersectsrect")); )
 DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, containsxy_proc, "containsxy")); )
+
+DEF_BENCH( return SkNEW_ARGS(RegionBatchBench, (64, RegionBatchBench::kLoopUnion_Mode)); )
+DEF_BENCH( return SkNEW_ARGS(RegionBatchBench, (64, RegionBatchBench::kSetRects_Mode)); )
+DEF_BENCH( return SkNEW_ARGS(RegionBatchBench, (512, RegionBatchBench::kLoopUnion_Mode)); )
+DEF_BENCH( return SkNEW_ARGS(RegionBatchBench, (512, RegionBatchBench::kSetRects_Mode)); )
+DEF_BENCH( return SkNEW_ARGS(RegionBatchBench, (64, RegionBatchBench::kLoopIntersect_Mode)); )
+DEF_BENCH( return SkNEW_ARGS(RegionBatchBench, (64, RegionBatchBench::kOpRectsIntersect_Mode)); )
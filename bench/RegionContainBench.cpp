@@ -15,6 +15,11 @@ static bool sect_proc(SkRegion& a, SkRegion& b) {
     return result.op(a, b, SkRegion::kIntersect_Op);
 }
 
+static bool union_proc(SkRegion& a, SkRegion& b) {
+    SkRegion result;
+    return result.op(a, b, SkRegion::kUnion_Op);
+}
+
 class RegionContainBench : public Benchmark {
 public:
     typedef bool (*Proc)(SkRegion& a, SkRegion& b);
@@ -65,3 +70,4 @@ private:
 };
 
 DEF_BENCH( return SkNEW_ARGS(RegionContainBench, (sect_proc, "sect")); )
+DEF_BENCH( return SkNEW_ARGS(RegionContainBench, (union_proc, "union")); )
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkString.h"
+
+static const int kSize = 512;
+
+/** Nested opacity layers around a small draw, as in web content with stacked opacity: each
+    saveLayer() allocates (and clears) a full-canvas layer. With fill, each layer is first filled
+    with an opaque background, so there's no need to clear it.
+  */
+class SaveLayerNestedBench : public Benchmark {
+public:
+    SaveLayerNestedBench(int depth, bool fill = false) : fDepth(depth), fFill(fill) {
+        fName.printf("savelayer_%s_%d", fill ? "filled" : "nested", depth);
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+    virtual SkIPoint onGetSize() SK_OVERRIDE { return SkIPoint::Make(kSize, kSize); }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        const SkRect r = SkRect::MakeXYWH(100, 100, 50, 50);
+        for (int i = 0; i < loops; i++) {
+            for (int d = 0; d < fDepth; d++) {
+                canvas->saveLayerAlpha(NULL, 0xC0);
+                if (fFill) {
+                    canvas->clear(SK_ColorWHITE);
+                }
+            }
+            canvas->drawRect(r, paint);
+            for (int d = 0; d < fDepth; d++) {
+                canvas->restore();
+            }
+        }
+    }
+
+private:
+    int      fDepth;
+    bool     fFill;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+/** Plays back a picture full of small unbounded opacity layers. When the picture is recorded
+    with kComputeSaveLayerInfo_RecordFlag the layers are shrunk to what they contain.
+  */
+class SaveLayerPlaybackBench : public Benchmark {
+public:
+    SaveLayerPlaybackBench(bool computeLayerInfo) : fComputeLayerInfo(computeLayerInfo) {}
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE {
+        return fComputeLayerInfo ? "savelayer_playback_tight" : "savelayer_playback";
+    }
+    virtual SkIPoint onGetSize() SK_OVERRIDE { return SkIPoint::Make(kSize, kSize); }
+
+    virtual void onPreDraw() SK_OVERRIDE {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kSize), SkIntToScalar(kSize),
+                &factory,
+                fComputeLayerInfo ? SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag : 0);
+
+        SkPaint paint;
+        paint.setColor(SK_ColorGREEN);
+        for (int y = 0; y < kSize; y += 64) {
+            for (int x = 0; x < kSize; x += 64) {
+                // Two overlapping draws, so the layer can't be folded into a single draw's alpha.
+                const SkRect r = SkRect::MakeXYWH(SkIntToScalar(x), SkIntToScalar(y), 48, 48);
+                canvas->saveLayerAlpha(NULL, 0x80);
+                canvas->drawRect(r, paint);
+                canvas->drawOval(r, paint);
+                canvas->restore();
+            }
+        }
+        fPicture.reset(recorder.endRecording());
+    }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPicture(fPicture);
+        }
+    }
+
+private:
+    bool                    fComputeLayerInfo;
+    SkAutoTUnref<SkPicture> fPicture;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SaveLayerNestedBench(1); )
+DEF_BENCH( return new SaveLayerNestedBench(4); )
+DEF_BENCH( return new SaveLayerNestedBench(4, true); )
+DEF_BENCH( return new SaveLayerPlaybackBench(false); )
+DEF_BENCH( return new SaveLayerPlaybackBench(true); )
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkString.h"
+
+/** Measures the cost of save()/restore() pairs, alone and around a matrix or
+    clip change. Most saves in real content (e.g. Chrome's display lists) are
+    never followed by a state change, so those should be close to free.
+  */
+class SaveRestoreBench : public Benchmark {
+public:
+    enum Op {
+        kNone_Op,       // save(); restore();
+        kTranslate_Op,  // save(); translate(); restore();
+        kClipRect_Op,   // save(); clipRect(); restore();
+        kDraw_Op,       // save(); drawRect(); restore();
+    };
+
+    SaveRestoreBench(Op op, int depth) : fOp(op), fDepth(depth) {
+        static const char* gOpNames[] = { "none", "translate", "cliprect", "draw" };
+        fName.printf("save_restore_%s_%d", gOpNames[op], depth);
+    }
+
+protected:
+    virtual const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+    virtual SkIPoint onGetSize() SK_OVERRIDE { return SkIPoint::Make(64, 64); }
+
+    virtual void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        const SkRect r = SkRect::MakeWH(16, 16);
+        SkPaint paint;
+        for (int i = 0; i < loops; i++) {
+            for (int j = 0; j < N; j++) {
+                for (int d = 0; d < fDepth; d++) {
+                    canvas->save();
+                }
+                switch (fOp) {
+                    case kNone_Op:
+                        break;
+                    case kTranslate_Op:
+                        canvas->translate(1, 1);
+                        break;
+                    case kClipRect_Op:
+                        canvas->clipRect(r);
+                        break;
+                    case kDraw_Op:
+                        canvas->drawRect(r, paint);
+                        break;
+                }
+                for (int d = 0; d < fDepth; d++) {
+                    canvas->restore();
+                }
+            }
+        }
+    }
+
+private:
+    enum { N = 1000 };
+
+    Op       fOp;
+    int      fDepth;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kNone_Op, 1); )
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kNone_Op, 4); )
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kTranslate_Op, 1); )
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kTranslate_Op, 4); )
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kClipRect_Op, 1); )
+DEF_BENCH( return new SaveRestoreBench(SaveRestoreBench::kDraw_Op, 1); )
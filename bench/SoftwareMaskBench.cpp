@@ -0,0 +1,106 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+
+/**
+ * Draws a grid of cells that each need masks rasterized on the CPU, either by drawing volatile,
+ * concave, antialiased paths, which the GPU backend draws through software path masks, or by
+ * clipping to them, which makes it rasterize the whole clip stack into a mask while it flushes.
+ * In the clip variant each cell draws under its outer clip again after drawing under a nested
+ * one, the way content drawn after a clipped child would.
+ */
+class SoftwareMaskBench : public Benchmark {
+public:
+    SoftwareMaskBench(bool clip) : fClip(clip) {
+        fName.printf("sw_masks_%s", clip ? "clips" : "paths");
+    }
+
+protected:
+    const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+
+    void onPreDraw() SK_OVERRIDE {
+        // A flower with sixteen curved petals of two lengths
+        static const SkScalar kCenter = SkIntToScalar(kCellSize) / 2;
+        fFlower.moveTo(kCenter + 36, kCenter);
+        for (int i = 1; i <= 16; ++i) {
+            SkScalar tip = SkIntToScalar(i & 1 ? 128 : 112);
+            SkScalar tipAngle = SK_ScalarPI * (2 * i - 1) / 16;
+            SkScalar angle = SK_ScalarPI * i / 8;
+            fFlower.quadTo(kCenter + SkScalarMul(tip, SkScalarCos(tipAngle)),
+                           kCenter + SkScalarMul(tip, SkScalarSin(tipAngle)),
+                           kCenter + SkScalarMul(36, SkScalarCos(angle)),
+                           kCenter + SkScalarMul(36, SkScalarSin(angle)));
+        }
+        fFlower.close();
+        fFlower.setIsVolatile(true);
+
+        // A ring
+        fRing.addCircle(kCenter, kCenter, 56);
+        fRing.addCircle(kCenter, kCenter, 28);
+        fRing.setFillType(SkPath::kEvenOdd_FillType);
+        fRing.setIsVolatile(true);
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(true);
+        SkRect cell = SkRect::MakeWH(SkIntToScalar(kCellSize), SkIntToScalar(kCellSize));
+        SkRect inset = cell;
+        inset.inset(SkIntToScalar(kCellSize) / 4, SkIntToScalar(kCellSize) / 4);
+
+        for (int loop = 0; loop < loops; ++loop) {
+            for (int i = 0; i < kColumns * kRows; ++i) {
+                canvas->save();
+                canvas->translate(SkIntToScalar(i % kColumns * kCellSize),
+                                  SkIntToScalar(i / kColumns * kCellSize));
+                if (!fClip) {
+                    paint.setColor(0xFF000000 | (0x3F << (i % 3 * 8)));
+                    canvas->drawPath(fFlower, paint);
+                    canvas->restore();
+                    continue;
+                }
+
+                canvas->clipPath(fFlower, SkRegion::kIntersect_Op, true);
+                paint.setColor(0xFF3F3F3F);
+                canvas->drawRect(cell, paint);
+
+                canvas->save();
+                canvas->clipPath(fRing, SkRegion::kIntersect_Op, true);
+                paint.setColor(0xFF3F3FFF);
+                canvas->drawRect(cell, paint);
+                canvas->restore();
+
+                paint.setColor(0xFFFF3F3F);
+                canvas->drawRect(inset, paint);
+                canvas->restore();
+            }
+        }
+    }
+
+private:
+    enum {
+        kColumns = 4,
+        kRows = 3,
+        kCellSize = 160,
+    };
+
+    SkString fName;
+    bool     fClip;
+    SkPath   fFlower;
+    SkPath   fRing;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(SoftwareMaskBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(SoftwareMaskBench, (true)); )
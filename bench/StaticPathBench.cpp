@@ -0,0 +1,113 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+
+/**
+ * Draws a grid of concave, antialiased paths that stay the same from frame to frame, the way the
+ * icons and shapes of a UI would. They're too big for the distance field path renderer and not
+ * convex, so on the GPU they are either tessellated once and redrawn from the cached mesh, or,
+ * when volatile, drawn through a software mask every time.
+ */
+class StaticPathBench : public Benchmark {
+public:
+    StaticPathBench(bool isVolatile) : fVolatile(isVolatile) {
+        fName.printf("static_paths%s", isVolatile ? "_volatile" : "");
+    }
+
+protected:
+    const char* onGetName() SK_OVERRIDE { return fName.c_str(); }
+
+    void onPreDraw() SK_OVERRIDE {
+        // A twelve pointed star
+        SkPath* path = &fPaths[0];
+        path->moveTo(92, 48);
+        for (int i = 1; i < 24; ++i) {
+            SkScalar radius = SkIntToScalar(i & 1 ? 22 : 44);
+            SkScalar angle = SK_ScalarPI * i / 12;
+            path->lineTo(48 + SkScalarMul(radius, SkScalarCos(angle)),
+                         48 + SkScalarMul(radius, SkScalarSin(angle)));
+        }
+        path->close();
+
+        // A frame with rounded corners
+        path = &fPaths[1];
+        path->addRoundRect(SkRect::MakeLTRB(4, 12, 92, 84), 16, 16);
+        path->addRoundRect(SkRect::MakeLTRB(20, 28, 76, 68), 8, 8);
+        path->setFillType(SkPath::kEvenOdd_FillType);
+
+        // A gear with a hole
+        path = &fPaths[2];
+        static const SkScalar kToothAngles[] = { 0, 0.3f, 0.5f, 0.8f };
+        static const SkScalar kToothRadii[] = { 36, 44, 44, 36 };
+        path->moveTo(84, 48);
+        for (int i = 1; i < 64; ++i) {
+            SkScalar angle = SK_ScalarPI * (i / 4 + kToothAngles[i % 4]) / 8;
+            path->lineTo(48 + SkScalarMul(kToothRadii[i % 4], SkScalarCos(angle)),
+                         48 + SkScalarMul(kToothRadii[i % 4], SkScalarSin(angle)));
+        }
+        path->close();
+        path->addCircle(48, 48, 16, SkPath::kCCW_Direction);
+
+        // A speech bubble
+        path = &fPaths[3];
+        path->moveTo(16, 8);
+        path->lineTo(80, 8);
+        path->cubicTo(90, 8, 90, 8, 90, 18);
+        path->lineTo(90, 58);
+        path->cubicTo(90, 68, 90, 68, 80, 68);
+        path->lineTo(40, 68);
+        path->lineTo(14, 90);
+        path->lineTo(24, 68);
+        path->lineTo(16, 68);
+        path->cubicTo(6, 68, 6, 68, 6, 58);
+        path->lineTo(6, 18);
+        path->cubicTo(6, 8, 6, 8, 16, 8);
+        path->close();
+
+        for (int i = 0; i < kPathCount; ++i) {
+            fPaths[i].setIsVolatile(fVolatile);
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) SK_OVERRIDE {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(true);
+        for (int loop = 0; loop < loops; ++loop) {
+            for (int i = 0; i < kColumns * kRows; ++i) {
+                canvas->save();
+                canvas->translate(SkIntToScalar(i % kColumns * kCellSize),
+                                  SkIntToScalar(i / kColumns * kCellSize));
+                paint.setColor(0xFF000000 | (0x3F << (i % 3 * 8)));
+                canvas->drawPath(fPaths[i % kPathCount], paint);
+                canvas->restore();
+            }
+        }
+    }
+
+private:
+    enum {
+        kPathCount = 4,
+        kColumns = 6,
+        kRows = 4,
+        kCellSize = 100,
+    };
+
+    SkString fName;
+    bool     fVolatile;
+    SkPath   fPaths[kPathCount];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(StaticPathBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(StaticPathBench, (true)); )
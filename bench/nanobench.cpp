@@ -75,6 +75,12 @@ DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+DEFINE_bool(gpuStats, false, "Only meaningful with gpu configurations. Report the draws, state "
+                             "flushes and GL calls of one frame of each bench. With the nullgpu "
+                             "config the timings are then the CPU cost per frame.");
+#endif
+
 static SkString humanize(double ms) {
     if (FLAGS_verbose) return SkStringPrintf("%llu", (uint64_t)(ms*1e6));
     if (ms > 1e+3)     return SkStringPrintf("%.3gs",  ms/1e3);
@@ -272,6 +278,26 @@ static int gpu_bench(SkGLContext* gl,
 }
 #endif
 
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+struct GpuFrameStats {
+    int fDraws;
+    int fStateFlushes;
+    int fGLCalls;
+};
+
+// Draws one more frame and counts how much work it gave the GPU backend.
+static GpuFrameStats gpu_frame_stats(GrContext* context, SkGLContext* gl,
+                                     Benchmark* bench, SkCanvas* canvas) {
+    const GrContext::GPUStats* stats = context->gpuStats();
+    GpuFrameStats frame = { -stats->draws(), -stats->stateFlushes(), -stats->glCalls() };
+    time(1, bench, canvas, gl);
+    frame.fDraws += stats->draws();
+    frame.fStateFlushes += stats->stateFlushes();
+    frame.fGLCalls += stats->glCalls();
+    return frame;
+}
+#endif
+
 static SkString to_lower(const char* str) {
     SkString lower(str);
     for (size_t i = 0; i < lower.size(); i++) {
@@ -709,6 +735,15 @@ int nanobench_main() {
 #endif
                  cpu_bench(       overhead, bench.get(), canvas, samples.get());
 
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+            GpuFrameStats frameStats = { 0, 0, 0 };
+            if (FLAGS_gpuStats && kFailedLoops != loops &&
+                Benchmark::kGPU_Backend == targets[j]->config.backend) {
+                frameStats = gpu_frame_stats(gGrFactory->get(targets[j]->config.ctxType),
+                                             targets[j]->gl, bench.get(), canvas);
+            }
+#endif
+
             bench->perCanvasPostDraw(canvas);
 
             if (canvas && !FLAGS_writePath.isEmpty() && FLAGS_writePath[0]) {
@@ -737,6 +772,13 @@ int nanobench_main() {
             log->metric("mean_ms",   stats.mean);
             log->metric("max_ms",    stats.max);
             log->metric("stddev_ms", sqrt(stats.var));
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+            if (FLAGS_gpuStats && Benchmark::kGPU_Backend == targets[j]->config.backend) {
+                log->metric("gpu_draws",         frameStats.fDraws);
+                log->metric("gpu_state_flushes", frameStats.fStateFlushes);
+                log->metric("gl_calls",          frameStats.fGLCalls);
+            }
+#endif
             if (runs++ % FLAGS_flushEvery == 0) {
                 log->flush();
             }
@@ -774,6 +816,13 @@ int nanobench_main() {
                         , bench->getUniqueName()
                         );
             }
+#if SK_SUPPORT_GPU && GR_GPU_STATS
+            if (FLAGS_gpuStats && Benchmark::kGPU_Backend == targets[j]->config.backend) {
+                SkDebugf("%s: %d draws, %d state flushes, %d GL calls per frame\n",
+                         bench->getUniqueName(),
+                         frameStats.fDraws, frameStats.fStateFlushes, frameStats.fGLCalls);
+            }
+#endif
 #if SK_SUPPORT_GPU && GR_CACHE_STATS
             if (FLAGS_veryVerbose &&
                 Benchmark::kGPU_Backend == targets[j]->config.backend) {
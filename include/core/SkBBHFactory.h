@@ -29,6 +29,17 @@ private:
     typedef SkBBHFactory INHERITED;
 };
 
+/**
+ *  Bounds kept in flat arrays and searched linearly, four at a time.  Cheaper than any hierarchy
+ *  for pictures with up to a few thousand ops.
+ */
+class SK_API SkLinearBBHFactory : public SkBBHFactory {
+public:
+    virtual SkBBoxHierarchy* operator()(const SkRect& bounds) const SK_OVERRIDE;
+private:
+    typedef SkBBHFactory INHERITED;
+};
+
 class SK_API SkTileGridFactory : public SkBBHFactory {
 public:
     struct TileGridInfo {
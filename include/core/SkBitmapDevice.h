@@ -11,6 +11,8 @@
 
 #include "SkDevice.h"
 
+class SkLayerPool;
+
 ///////////////////////////////////////////////////////////////////////////////
 class SK_API SkBitmapDevice : public SkBaseDevice {
 public:
@@ -29,7 +31,8 @@ private:
      *  any drawing to this device will have no effect.
     */
     SkBitmapDevice(const SkBitmap& bitmap, const SkDeviceProperties& deviceProperties);
-    static SkBitmapDevice* Create(const SkImageInfo&, const SkDeviceProperties*);
+    static SkBitmapDevice* Create(const SkImageInfo&, const SkDeviceProperties*,
+                                  SkLayerPool* = NULL);
 public:
     static SkBitmapDevice* Create(const SkImageInfo& info) {
         return Create(info, NULL);
@@ -155,7 +158,18 @@ private:
 
     virtual SkImageFilter::Cache* getImageFilterCache() SK_OVERRIDE;
 
+    virtual void willOverwriteAllPixels() SK_OVERRIDE { fPendingClear = false; }
+
+    // Clear pixels we got uninitialized from a pool, before anyone looks at them.
+    void resolvePendingClear() {
+        if (fPendingClear) {
+            this->clearPixels();
+        }
+    }
+    void clearPixels();
+
     SkBitmap    fBitmap;
+    bool        fPendingClear;
 
     typedef SkBaseDevice INHERITED;
 };
@@ -340,6 +340,9 @@ public:
         When the balancing call to restore() is made, the previous matrix, clip,
         and drawFilter are restored.
 
+        The copy is made lazily: a save() that is restored before the matrix,
+        clip or drawFilter is changed never copies anything.
+
         @return The value to pass to restoreToCount() to balance this save()
     */
     int save();
@@ -1276,8 +1279,11 @@ protected:
                         const SkImageFilter* imageFilter = NULL);
 
     // notify our surface (if we have one) that we are about to draw, so it
-    // can perform copy-on-write or invalidate any cached images
-    void predrawNotify();
+    // can perform copy-on-write or invalidate any cached images. If known, bounds
+    // are the local-space bounds of the draw (as passed to quickReject) made with paint.
+    void predrawNotify(const SkRect* bounds = NULL, const SkPaint* paint = NULL);
+    // as above, for a change to the given device-space rectangle
+    void predrawNotify(const SkIRect& deviceBounds);
 
     virtual void onPushCull(const SkRect& cullRect);
     virtual void onPopCull();
@@ -1294,6 +1300,7 @@ private:
 
     const SkSurfaceProps fProps;
 
+    int         fSaveCount;         // value returned by getSaveCount()
     int         fSaveLayerCount;    // number of successful saveLayer calls
     int         fCullCount;         // number of active culls
 
@@ -1363,12 +1370,13 @@ private:
     void internalDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                                 const SkRect& dst, const SkPaint* paint);
     void internalDrawPaint(const SkPaint& paint);
-    int internalSaveLayer(const SkRect* bounds, const SkPaint* paint,
-                          SaveFlags, bool justForImageFilter, SaveLayerStrategy strategy);
+    void internalSaveLayer(const SkRect* bounds, const SkPaint* paint,
+                           SaveFlags, bool justForImageFilter, SaveLayerStrategy strategy);
     void internalDrawDevice(SkBaseDevice*, int x, int y, const SkPaint*);
 
     // shared by save() and saveLayer()
-    int internalSave();
+    void checkForDeferredSave();
+    void internalSave();
     void internalRestore();
     static void DrawRect(const SkDraw& draw, const SkPaint& paint,
                          const SkRect& r, SkScalar textSize);
@@ -17,6 +17,7 @@
 class SkBitmap;
 class GrProcessor;
 class GrContext;
+template <typename T> class SkTDArray;
 
 /**
  *  ColorFilters are optional objects in the drawing pipeline. When present in
@@ -123,11 +124,37 @@ public:
     */
     static SkColorFilter* CreateLightingFilter(SkColor mul, SkColor add);
 
+    /** Construct a colorfilter whose effect is to first apply the inner filter and then apply
+     *  the outer filter to the result of the inner's.
+     *  The reference counts for outer and inner are incremented.
+     *
+     *  If either filter is NULL, the other is returned (with its ref count incremented).
+     *  Where the pair can be expressed as a single filter (see newComposed()), that filter
+     *  is returned instead, so the span is only processed once.
+     */
+    static SkColorFilter* CreateComposeFilter(SkColorFilter* outer, SkColorFilter* inner);
+
+    /**
+     *  If this filter and inner can be folded into a single filter that is equivalent to
+     *  applying inner followed by this filter, return it; otherwise return NULL. If the
+     *  return is non-NULL then the caller owns a ref on the returned object.
+     */
+    virtual SkColorFilter* newComposed(const SkColorFilter* inner) const;
+
     /** A subclass may implement this factory function to work with the GPU backend. If the return
-        is non-NULL then the caller owns a ref on the returned object.
+        is non-NULL then the caller owns a ref on the returned object. Filters that need more than
+        one processor (e.g. composed filters) return NULL here; use asFragmentProcessors() for them.
      */
     virtual GrFragmentProcessor* asFragmentProcessor(GrContext*) const;
 
+    /**
+     *  Append the GPU processors that implement this filter, in the order they must be applied,
+     *  to array. Returns true if the whole filter was appended; the caller owns a ref on each
+     *  processor. If false is returned the array is left as it was. The default implementation
+     *  wraps asFragmentProcessor().
+     */
+    virtual bool asFragmentProcessors(GrContext*, SkTDArray<GrFragmentProcessor*>* array) const;
+
     SK_TO_STRING_PUREVIRT()
 
     SK_DECLARE_FLATTENABLE_REGISTRAR_GROUP()
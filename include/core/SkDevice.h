@@ -393,9 +393,20 @@ private:
 
     virtual SkImageFilter::Cache* getImageFilterCache() { return NULL; }
 
+    /** Called by SkCanvas just before a draw that replaces every pixel of the device, so
+        the device may skip initializing pixels it has not handed out yet.
+     */
+    virtual void willOverwriteAllPixels() {}
+
+    // Like accessBitmap(true), but for SkCanvas's own drawing, which it tracks itself.
+    const SkBitmap& accessBitmapForDraw();
+
     SkIPoint    fOrigin;
     SkMetaData* fMetaData;
     SkDeviceProperties* fLeakyProperties;   // will always exist.
+    // Set when accessBitmap() or accessPixels() has given out our pixels, which may then be
+    // written to without SkCanvas knowing. SkSurface_Raster resets it once it has caught up.
+    bool        fPixelsHandedOut;
 
 #ifdef SK_DEBUG
     bool        fAttachedToCanvas;
@@ -192,16 +192,28 @@ protected:
                                            const SkIRect& clipBounds,
                                            NinePatch*) const;
 
+    /**
+     *  Override if your subclass can draw its filtered version of a device
+     *  space rect straight into the blitter, without an intermediate mask.
+     *  Return values are as for filterRectsToNine, which is only called if
+     *  this returns kUnimplemented_FilterReturn.
+     */
+    virtual FilterReturn filterRectToBlitter(const SkRect& devRect, const SkMatrix&,
+                                             const SkRasterClip&, SkBlitter*) const;
+
 private:
     friend class SkDraw;
 
     /** Helper method that, given a path in device space, will rasterize it into a kA8_Format mask
      and then call filterMask(). If this returns true, the specified blitter will be called
      to render that mask. Returns false if filterMask() returned false.
+     If devPath is a persistent path (with generation ID srcGenID) mapped by srcToDevice, a
+     blurred mask may be cached and reused for later draws of that path.
      This method is not exported to java.
      */
     bool filterPath(const SkPath& devPath, const SkMatrix& ctm, const SkRasterClip&, SkBlitter*,
-                    SkPaint::Style) const;
+                    SkPaint::Style, uint32_t srcGenID = 0,
+                    const SkMatrix* srcToDevice = NULL) const;
 
     /** Helper method that, given a roundRect in device space, will rasterize it into a kA8_Format
      mask and then call filterMask(). If this returns true, the specified blitter will be called
@@ -482,6 +482,17 @@ public:
         return this->mapRect(rect, *rect);
     }
 
+    /** Apply this matrix to each of the count rectangles in src, writing the
+        bounds of each transformed rectangle into the corresponding entry of
+        dst. The results match calling mapRect() on each rectangle, but the
+        matrix type is only examined once for the whole array.
+        @param dst  Where the transformed rectangles are written.
+        @param src  The original rectangles to be transformed.
+        @param count The number of rectangles in src.
+        Note: src and dst may point to the same storage.
+    */
+    void mapRects(SkRect dst[], const SkRect src[], int count) const;
+
     /** Apply this matrix to the src rectangle, and write the four transformed
         points into dst. The points written to dst will be the original top-left, top-right,
         bottom-right, and bottom-left points transformed by the matrix.
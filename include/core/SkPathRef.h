@@ -249,7 +249,8 @@ public:
     /**
      * Gets an ID that uniquely identifies the contents of the path ref. If two path refs have the
      * same ID then they have the same verbs and points. However, two path refs may have the same
-     * contents but different genIDs.
+     * contents but different genIDs. The ID is assigned on first use; it is safe to ask for it
+     * from several threads at once.
      */
     uint32_t genID() const;
 
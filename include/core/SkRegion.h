@@ -121,9 +121,10 @@ public:
     bool setRect(int32_t left, int32_t top, int32_t right, int32_t bottom);
 
     /**
-     *  Set this region to the union of an array of rects. This is generally
-     *  faster than calling region.op(rect, kUnion_Op) in a loop. If count is
-     *  0, then this region is set to the empty region.
+     *  Set this region to the union of an array of rects. The rects are
+     *  merged in a single sweep, which is much faster than calling
+     *  region.op(rect, kUnion_Op) in a loop. If count is 0, then this region
+     *  is set to the empty region.
      *  @return true if the resulting region is non-empty
      */
     bool setRects(const SkIRect rects[], int count);
@@ -297,6 +298,26 @@ public:
      */
     bool op(const SkRegion& rgna, const SkRegion& rgnb, Op op);
 
+    /**
+     *  Set this region to the result of applying the Op to this region and
+     *  each of the rects in turn, exactly as if op(rects[i], op) were called
+     *  for i = 0..count-1. Union, intersect and difference are computed with
+     *  a single sweep over the rects and at most one region op, instead of
+     *  one region op per rect.
+     *  Return true if the resulting region is non-empty.
+     */
+    bool opRects(const SkIRect rects[], int count, Op op);
+
+    /**
+     *  Set this region to the result of applying the Op to this region and
+     *  each of the regions in turn, exactly as if op(*rgns[i], op) were
+     *  called for i = 0..count-1. Union and difference are computed with a
+     *  single sweep over all of the regions' rects; intersection first
+     *  rejects on bounds and then visits the simplest regions first.
+     *  Return true if the resulting region is non-empty.
+     */
+    bool opRegions(const SkRegion* const rgns[], int count, Op op);
+
 #ifdef SK_BUILD_FOR_ANDROID
     /** Returns a new char* containing the list of rectangles in this region
      */
@@ -10,6 +10,7 @@
 
 #include "SkColorFilter.h"
 #include "SkData.h"
+#include "SkTemplates.h"
 
 class SK_API SkColorCubeFilter : public SkColorFilter {
 public:
@@ -35,34 +36,30 @@ protected:
     virtual void flatten(SkWriteBuffer&) const SK_OVERRIDE;
 
 private:
-    /** The cache is initialized on-demand when getProcessingLuts is called.
+    /** The cache is initialized on-demand when getLattice is called.
      */
     class ColorCubeProcesingCache {
     public:
-        ColorCubeProcesingCache(int cubeDimension);
+        ColorCubeProcesingCache(SkData* cubeData, int cubeDimension);
 
-        void getProcessingLuts(const int* (*colorToIndex)[2],
-                               const SkScalar* (*colorToFactors)[2],
-                               const SkScalar** colorToScalar);
+        /** Returns the cube expanded to 4 floats (r, g, b, 0) per entry, each in [0, 1].
+         */
+        const float* getLattice();
 
         int cubeDimension() const { return fCubeDimension; }
 
     private:
-        // Working pointers. If any of these is NULL,
-        // we need to recompute the corresponding cache values.
-        int* fColorToIndex[2];
-        SkScalar* fColorToFactors[2];
-        SkScalar* fColorToScalar;
+        SkData* fCubeData;  // owned by the filter
 
-        SkAutoMalloc fLutStorage;
+        SkAutoTMalloc<float> fLattice;
 
         const int fCubeDimension;
 
-        // Make sure we only initialize the caches once.
-        SkMutex fLutsMutex;
-        bool fLutsInited;
+        // Make sure we only initialize the lattice once.
+        SkMutex fLatticeMutex;
+        bool fLatticeInited;
 
-        static void initProcessingLuts(ColorCubeProcesingCache* cache);
+        static void initLattice(ColorCubeProcesingCache* cache);
     };
 
     SkAutoDataUnref fCubeData;
@@ -25,6 +25,7 @@ public:
     virtual void filterSpan16(const uint16_t src[], int count, uint16_t[]) const SK_OVERRIDE;
     virtual uint32_t getFlags() const SK_OVERRIDE;
     virtual bool asColorMatrix(SkScalar matrix[20]) const SK_OVERRIDE;
+    virtual SkColorFilter* newComposed(const SkColorFilter*) const SK_OVERRIDE;
 #if SK_SUPPORT_GPU
     virtual GrFragmentProcessor* asFragmentProcessor(GrContext*) const SK_OVERRIDE;
 #endif
@@ -52,6 +53,8 @@ private:
     Proc        fProc;
     State       fState;
     uint32_t    fFlags;
+    // fMatrix stored column by column, so each column loads straight into a 4-float vector.
+    float       fTranspose[20];
 
     void initState(const SkScalar array[20]);
 
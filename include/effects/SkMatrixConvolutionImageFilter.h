@@ -96,8 +96,15 @@ private:
     SkIPoint  fKernelOffset;
     TileMode  fTileMode;
     bool      fConvolveAlpha;
+    // If fKernel has rank one, its column factor (fKernelSize.fWidth entries) followed by its
+    // row factor (fKernelSize.fHeight entries), so it can be applied as two 1D passes.
+    // Otherwise NULL.
+    SkScalar* fSeparableKernel;
     typedef SkImageFilter INHERITED;
 
+    struct Band;
+    static void FilterBand(Band*);
+
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src,
                       SkBitmap* result,
@@ -108,6 +115,16 @@ private:
                       SkBitmap* result,
                       const SkIRect& rect,
                       const SkIRect& bounds) const;
+    template <class PixelFetcher, bool convolveAlpha>
+    void filterPixelsSeparable(const SkBitmap& src,
+                               SkBitmap* result,
+                               const SkIRect& rect,
+                               const SkIRect& bounds) const;
+    template <class PixelFetcher>
+    void filterPixelsSeparable(const SkBitmap& src,
+                               SkBitmap* result,
+                               const SkIRect& rect,
+                               const SkIRect& bounds) const;
     void filterInteriorPixels(const SkBitmap& src,
                               SkBitmap* result,
                               const SkIRect& rect,
@@ -116,6 +133,10 @@ private:
                             SkBitmap* result,
                             const SkIRect& rect,
                             const SkIRect& bounds) const;
+    void filterSeparablePixels(const SkBitmap& src,
+                               SkBitmap* result,
+                               const SkIRect& rect,
+                               const SkIRect& bounds) const;
 };
 
 #endif
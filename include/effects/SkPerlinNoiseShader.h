@@ -10,6 +10,8 @@
 
 #include "SkShader.h"
 
+class SkCachedData;
+
 /** \class SkPerlinNoiseShader
 
     SkPerlinNoiseShader creates an image using the Perlin turbulence function.
@@ -84,14 +86,18 @@ public:
 
     private:
         SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
-        SkScalar calculateTurbulenceValueForPoint(
-            int channel,
-            StitchData& stitchData, const SkPoint& point) const;
-        SkScalar noise2D(int channel,
-                         const StitchData& stitchData, const SkPoint& noiseVector) const;
+        SkPMColor shadeNoisePoint(const SkPoint& point, StitchData& stitchData) const;
+        // When stitching, looks up the colors of the whole tile the first time a span lands in
+        // it, and renders them once the spans have covered enough of the tile, so repeated
+        // draws of the tile only compute its noise once.
+        void findTileColors(int x, int y, int count);
 
         SkMatrix fMatrix;
         PaintingData* fPaintingData;
+        SkCachedData* fTileData;
+        const SkPMColor* fTileColors;
+        bool fTileLookedUp;
+        int fTilePixelsShaded;
 
         typedef SkShader::Context INHERITED;
     };
@@ -41,6 +41,7 @@ class GrVertexBuffer;
 class GrVertexBufferAllocPool;
 class GrStrokeInfo;
 class GrSoftwarePathRenderer;
+class GrSWMaskBatch;
 class SkStrokeRec;
 
 class SK_API GrContext : public SkRefCnt {
@@ -878,6 +879,7 @@ public:
     const GrGpu* getGpu() const { return fGpu; }
     GrFontCache* getFontCache() { return fFontCache; }
     GrLayerCache* getLayerCache() { return fLayerCache.get(); }
+    GrSWMaskBatch* getSWMaskBatch() { return fSWMaskBatch.get(); }
     GrDrawTarget* getTextTarget();
     const GrIndexBuffer* getQuadIndexBuffer() const;
     GrAARectRenderer* getAARectRenderer() { return fAARectRenderer; }
@@ -911,20 +913,45 @@ public:
     class GPUStats {
     public:
 #if GR_GPU_STATS
-        GPUStats() { this->reset(); }
-
-        void reset() { fRenderTargetBinds = 0; fShaderCompilations = 0; }
+        GPUStats() : fGLCallCount(NULL) { this->reset(); }
+
+        void reset() {
+            fRenderTargetBinds = 0;
+            fShaderCompilations = 0;
+            fDraws = 0;
+            fStateFlushes = 0;
+            fTextureUploads = 0;
+        }
 
         int renderTargetBinds() const { return fRenderTargetBinds; }
         void incRenderTargetBinds() { fRenderTargetBinds++; }
         int shaderCompilations() const { return fShaderCompilations; }
         void incShaderCompilations() { fShaderCompilations++; }
+        // Draw calls issued to the 3D API.
+        int draws() const { return fDraws; }
+        void incDraws() { fDraws++; }
+        // Times the full draw state (program, blend, stencil, scissor...) was flushed.
+        int stateFlushes() const { return fStateFlushes; }
+        void incStateFlushes() { fStateFlushes++; }
+        // Writes of pixels into existing textures, e.g. glyphs into the font atlases.
+        int textureUploads() const { return fTextureUploads; }
+        void incTextureUploads() { fTextureUploads++; }
+        // Running total of 3D API calls, when the backend can count them. Not affected by reset().
+        int glCalls() const { return fGLCallCount ? *fGLCallCount : 0; }
+        void setGLCallCount(const int* count) { fGLCallCount = count; }
     private:
         int fRenderTargetBinds;
         int fShaderCompilations;
+        int fDraws;
+        int fStateFlushes;
+        int fTextureUploads;
+        const int* fGLCallCount;
 #else
         void incRenderTargetBinds() {}
         void incShaderCompilations() {}
+        void incDraws() {}
+        void incStateFlushes() {}
+        void incTextureUploads() {}
 #endif
     };
 
@@ -941,6 +968,7 @@ private:
     GrResourceCache2*               fResourceCache2;
     GrFontCache*                    fFontCache;
     SkAutoTDelete<GrLayerCache>     fLayerCache;
+    SkAutoTDelete<GrSWMaskBatch>    fSWMaskBatch;
 
     GrPathRendererChain*            fPathRendererChain;
     GrSoftwarePathRenderer*         fSoftwarePathRenderer;
@@ -11,6 +11,7 @@
 #include "SkPicture.h"
 #include "SkTDArray.h"
 
+class SkCanvas;
 class SkData;
 struct SkRect;
 
@@ -86,6 +87,24 @@ public:
      *  SkRecord holds a reference to (e.g. paths, or pixels backing bitmaps).
      */
     static size_t ApproximateBytesUsed(const SkPicture* pict);
+
+    /**
+     *  Appends to damage a few rectangles (in picture space) that together cover every pixel that
+     *  may draw differently when newPict is played back in place of oldPict. Pictures that draw the
+     *  same ops the same way produce no damage. Ops that can't be compared cheaply always count
+     *  as changed, so the damage may be larger than the pixels that actually changed.
+     */
+    static void ComputeDamage(const SkPicture* oldPict, const SkPicture* newPict,
+                              SkTDArray<SkRect>* damage);
+
+    /**
+     *  Updates canvas, which must already hold the old picture drawn over transparent black, by
+     *  clearing the damaged rectangles and replaying pict once, clipped to them. If pict has a
+     *  bounding box hierarchy, only the ops that touch the damage's bounds are replayed. As with
+     *  any tiled redraw, edges that aren't axis-aligned may differ slightly from a full redraw.
+     */
+    static void PlaybackDamage(const SkPicture* pict, const SkTDArray<SkRect>& damage,
+                               SkCanvas* canvas);
 };
 
 #endif
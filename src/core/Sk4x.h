@@ -48,6 +48,7 @@ public:
     Sk4x subtract(const Sk4x&) const;
     Sk4x multiply(const Sk4x&) const;
     Sk4x   divide(const Sk4x&) const;
+    Sk4x     sqrt()            const;  // Sk4f only.
 
     Sk4i            equal(const Sk4x&) const;
     Sk4i         notEqual(const Sk4x&) const;
@@ -61,6 +62,8 @@ public:
 
     // Swizzles follow OpenCL xyzw convention.
     Sk4x zwxy() const;
+    Sk4x xxzz() const;
+    Sk4x yyww() const;
 
     // When there's a second argument, it's abcd.
     static Sk4x XYAB(const Sk4x& xyzw, const Sk4x& abcd);
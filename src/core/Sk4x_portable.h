@@ -2,6 +2,7 @@
 // This file will be intentionally included three times.
 
 #if defined(SK4X_PREAMBLE)
+    #include <math.h>
 
 #elif defined(SK4X_PRIVATE)
     typedef T Type;
@@ -59,6 +60,10 @@ M(Sk4x<T>) multiply(const Sk4x<T>& other) const { return Sk4x(BINOP(*)); }
 M(Sk4x<T>)   divide(const Sk4x<T>& other) const { return Sk4x(BINOP(/)); }
 #undef BINOP
 
+M(Sk4x<T>) sqrt() const {
+    return Sk4x(sqrtf(fVec[0]), sqrtf(fVec[1]), sqrtf(fVec[2]), sqrtf(fVec[3]));
+}
+
 #define BOOL_BINOP(op) fVec[0] op other.fVec[0] ? -1 : 0, \
                        fVec[1] op other.fVec[1] ? -1 : 0, \
                        fVec[2] op other.fVec[2] ? -1 : 0, \
@@ -93,6 +98,8 @@ M(template <int m, int a, int s, int k> Sk4x<T>) Shuffle(const Sk4x<T>& x, const
 }
 
 M(Sk4x<T>) zwxy() const                             { return Shuffle<2,3,0,1>(*this, *this); }
+M(Sk4x<T>) xxzz() const                             { return Shuffle<0,0,2,2>(*this, *this); }
+M(Sk4x<T>) yyww() const                             { return Shuffle<1,1,3,3>(*this, *this); }
 M(Sk4x<T>) XYAB(const Sk4x& xyzw, const Sk4x& abcd) { return Shuffle<0,1,4,5>( xyzw,  abcd); }
 M(Sk4x<T>) ZWCD(const Sk4x& xyzw, const Sk4x& abcd) { return Shuffle<2,3,6,7>( xyzw,  abcd); }
 
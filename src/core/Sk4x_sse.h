@@ -62,6 +62,12 @@ template <typename T> Sk4x<T>& Sk4x<T>::operator=(const Sk4x<T>& other) {
 template <typename T>
 Sk4x<T> Sk4x<T>::zwxy() const { return _mm_shuffle_epi32(as_4i(fVec), _MM_SHUFFLE(1,0,3,2)); }
 
+template <typename T>
+Sk4x<T> Sk4x<T>::xxzz() const { return _mm_shuffle_epi32(as_4i(fVec), _MM_SHUFFLE(2,2,0,0)); }
+
+template <typename T>
+Sk4x<T> Sk4x<T>::yyww() const { return _mm_shuffle_epi32(as_4i(fVec), _MM_SHUFFLE(3,3,1,1)); }
+
 template <typename T>
 Sk4x<T> Sk4x<T>::XYAB(const Sk4x<T>& a, const Sk4x<T>& b) {
     return _mm_movelh_ps(as_4f(a.fVec), as_4f(b.fVec));
@@ -84,10 +90,10 @@ M(void) store       (float fs[4]) const { _mm_storeu_ps(fs, fVec); }
 M(void) storeAligned(float fs[4]) const { _mm_store_ps (fs, fVec); }
 
 template <> template <>
-Sk4i Sk4f::reinterpret<Sk4i>() const { return as_4i(fVec); }
+inline Sk4i Sk4f::reinterpret<Sk4i>() const { return as_4i(fVec); }
 
 template <> template <>
-Sk4i Sk4f::cast<Sk4i>() const { return _mm_cvtps_epi32(fVec); }
+inline Sk4i Sk4f::cast<Sk4i>() const { return _mm_cvtps_epi32(fVec); }
 
 // We're going to try a little experiment here and skip allTrue(), anyTrue(), and bit-manipulators
 // for Sk4f.  Code that calls them probably does so accidentally.
@@ -97,6 +103,7 @@ M(Sk4f) add     (const Sk4f& o) const { return _mm_add_ps(fVec, o.fVec); }
 M(Sk4f) subtract(const Sk4f& o) const { return _mm_sub_ps(fVec, o.fVec); }
 M(Sk4f) multiply(const Sk4f& o) const { return _mm_mul_ps(fVec, o.fVec); }
 M(Sk4f) divide  (const Sk4f& o) const { return _mm_div_ps(fVec, o.fVec); }
+M(Sk4f) sqrt    ()              const { return _mm_sqrt_ps(fVec); }
 
 M(Sk4i) equal           (const Sk4f& o) const { return _mm_cmpeq_ps (fVec, o.fVec); }
 M(Sk4i) notEqual        (const Sk4f& o) const { return _mm_cmpneq_ps(fVec, o.fVec); }
@@ -121,10 +128,10 @@ M(void) store       (int32_t is[4]) const { _mm_storeu_si128((__m128i*)is, fVec)
 M(void) storeAligned(int32_t is[4]) const { _mm_store_si128 ((__m128i*)is, fVec); }
 
 template <> template <>
-Sk4f Sk4i::reinterpret<Sk4f>() const { return as_4f(fVec); }
+inline Sk4f Sk4i::reinterpret<Sk4f>() const { return as_4f(fVec); }
 
 template <> template <>
-Sk4f Sk4i::cast<Sk4f>() const { return _mm_cvtepi32_ps(fVec); }
+inline Sk4f Sk4i::cast<Sk4f>() const { return _mm_cvtepi32_ps(fVec); }
 
 M(bool) allTrue() const { return 0xf == _mm_movemask_ps(as_4f(fVec)); }
 M(bool) anyTrue() const { return 0x0 != _mm_movemask_ps(as_4f(fVec)); }
@@ -612,6 +612,129 @@ bool SkAAClip::trimBounds() {
     return this->trimTopBottom() && this->trimLeftRight();
 }
 
+// modify row in place, so that it starts [left] pixels in and is [width]
+// pixels wide. Unlike trim_row_left_right, the cropped pixels need not be
+// zeros. Returns the number of bytes that were completely eliminated from the
+// left.
+static int crop_row(uint8_t* row, int left, int width) {
+    SkASSERT(left >= 0 && width > 0);
+    int skip = 0;
+    while (left > 0) {
+        int n = row[0];
+        SkASSERT(n > 0);
+        if (n > left) {
+            row[0] = n - left;
+            break;
+        }
+        left -= n;
+        row += 2;
+        skip += 2;
+    }
+    for (;;) {
+        int n = row[0];
+        SkASSERT(n > 0);
+        if (n >= width) {
+            row[0] = width;
+            break;
+        }
+        width -= n;
+        row += 2;
+    }
+    return skip;
+}
+
+static size_t row_length(const uint8_t row[], int width) {
+    const uint8_t* origRow = row;
+    while (width > 0) {
+        width -= row[0];
+        row += 2;
+    }
+    SkASSERT(0 == width);
+    return row - origRow;
+}
+
+/*
+ *  Intersect with r (which must lie within our bounds) by editing the runs
+ *  directly: rows outside r are dropped and the rest are cropped in place. If
+ *  our runs are shared (e.g. with a saved copy of this clip) only the rows
+ *  that survive are copied.
+ */
+bool SkAAClip::cropToRect(const SkIRect& r) {
+    SkASSERT(!this->isEmpty());
+    SkASSERT(fBounds.contains(r) && !r.isEmpty());
+
+    const int width = fBounds.width();
+    const int top = r.fTop - fBounds.fTop;
+    const int lastY = r.fBottom - 1 - fBounds.fTop;
+
+    RunHead* head = fRunHead;
+    const YOffset* yoff = head->yoffsets();
+    int first = 0;
+    while (yoff[first].fY < top) {
+        first += 1;
+    }
+    int last = first;
+    while (yoff[last].fY < lastY) {
+        last += 1;
+    }
+    SkASSERT(last < head->fRowCount);
+
+    const int rowCount = last - first + 1;
+    const size_t dataStart = yoff[first].fOffset;
+    const size_t dataSize = yoff[last].fOffset - dataStart +
+                            row_length(head->data() + yoff[last].fOffset, width);
+
+    if (1 == head->fRefCnt) {
+        // slide the surviving YOffsets and then their data down to the front
+        const uint8_t* srcData = head->data() + dataStart;
+        memmove(head->yoffsets(), yoff + first, rowCount * sizeof(YOffset));
+        head->fRowCount = rowCount;
+        head->fDataSize = dataSize;
+        memmove(head->data(), srcData, dataSize);
+    } else {
+        RunHead* copy = RunHead::Alloc(rowCount, dataSize);
+        memcpy(copy->yoffsets(), yoff + first, rowCount * sizeof(YOffset));
+        memcpy(copy->data(), head->data() + dataStart, dataSize);
+        this->freeRuns();
+        fRunHead = head = copy;
+    }
+
+    const int left = r.fLeft - fBounds.fLeft;
+    uint8_t* base = head->data();
+    YOffset* dst = head->yoffsets();
+    for (int i = 0; i < rowCount; ++i) {
+        dst[i].fY -= top;
+        dst[i].fOffset -= SkToU32(dataStart);
+        dst[i].fOffset += crop_row(base + dst[i].fOffset, left, r.width());
+    }
+    dst[rowCount - 1].fY = r.height() - 1;
+    fBounds = r;
+
+    // cropping can make neighbouring rows identical, so merge them as the
+    // Builder would (isRect() relies on that)
+    const int newWidth = r.width();
+    int rows = 1;
+    size_t prevLength = row_length(base + dst[0].fOffset, newWidth);
+    for (int i = 1; i < rowCount; ++i) {
+        const uint8_t* prev = base + dst[rows - 1].fOffset;
+        const uint8_t* curr = base + dst[i].fOffset;
+        size_t currLength = row_length(curr, newWidth);
+        if (currLength == prevLength && !memcmp(prev, curr, currLength)) {
+            dst[rows - 1].fY = dst[i].fY;
+        } else {
+            dst[rows++] = dst[i];
+            prevLength = currLength;
+        }
+    }
+    if (rows < rowCount) {
+        memmove(dst + rows, dst + rowCount, head->fDataSize);
+        head->fRowCount = rows;
+    }
+
+    // the cropped rows may now begin or end with zeros
+    return this->trimTopBottom() && this->trimLeftRight();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkAAClip::freeRuns() {
@@ -752,6 +875,14 @@ bool SkAAClip::isRect() const {
     return true;
 }
 
+size_t SkAAClip::approximateBytesUsed() const {
+    size_t size = sizeof(SkAAClip);
+    if (fRunHead) {
+        size += sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) + fRunHead->fDataSize;
+    }
+    return size;
+}
+
 bool SkAAClip::setRect(const SkRect& r, bool doAA) {
     if (r.isEmpty()) {
         return this->setEmpty();
@@ -1747,8 +1878,9 @@ bool SkAAClip::op(const SkIRect& rOrig, SkRegion::Op op) {
                 // the intersection is wholly inside us, we're a rect
                 return this->setRect(rStorage);
             }
-            r = &rStorage;   // use the intersected bounds
-            break;
+            // intersecting with a rect only ever removes pixels, so crop our
+            // runs rather than building a rect clip and running the general op
+            return this->cropToRect(rStorage);
         case SkRegion::kDifference_Op:
             break;
         case SkRegion::kUnion_Op:
@@ -1781,6 +1913,15 @@ bool SkAAClip::op(const SkRect& rOrig, SkRegion::Op op, bool doAA) {
                 }
             }
             r = &rStorage;   // use the intersected bounds
+            if (SkRegion::kIntersect_Op == op) {
+                // an integral rect scan-converts to itself with or without aa,
+                // so we can crop in place (see op(const SkIRect&, ...))
+                SkIRect ir;
+                r->round(&ir);
+                if (SkRect::Make(ir) == *r) {
+                    return this->op(ir, op);
+                }
+            }
             break;
         case SkRegion::kUnion_Op:
             if (rOrig.contains(boundsStorage)) {
@@ -68,6 +68,9 @@ public:
     const uint8_t* findRow(int y, int* lastYForRow = NULL) const;
     const uint8_t* findX(const uint8_t data[], int x, int* initialCount = NULL) const;
 
+    // Number of bytes of run data (plus our own size) that this clip keeps alive.
+    size_t approximateBytesUsed() const;
+
     class Iter;
     struct RunHead;
     struct YOffset;
@@ -89,6 +92,7 @@ private:
     bool trimBounds();
     bool trimTopBottom();
     bool trimLeftRight();
+    bool cropToRect(const SkIRect&);
 
     friend class Builder;
     class BuilderBlitter;
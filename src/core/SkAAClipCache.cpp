@@ -0,0 +1,153 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAAClipCache.h"
+#include "SkChecksum.h"
+#include "SkTemplates.h"
+#include "SkThread.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Hashing (and keeping a copy of) the path is only worth it while that is cheap next to scan
+// converting it.
+static const int kMaxCachedPathPoints = 256;
+static const int kMaxCachedPathVerbs = 256;
+
+// Past this the scan converters trim their clip, which would make the result depend on the clip
+// even for paths it contains.
+static const int32_t kMaxClipCoord = 32767;
+
+namespace {
+static unsigned gAAClipPathKeyNamespaceLabel;
+
+struct AAClipPathKey : public SkResourceCache::Key {
+public:
+    AAClipPathKey(uint32_t contentHash, const SkPath& path, bool doAA, const SkIRect& clip)
+        : fContentHash(contentHash)
+        , fPointCount(path.countPoints())
+        , fVerbCount(path.countVerbs())
+        , fFillTypeAndAA((path.getFillType() << 1) | doAA)
+        , fClip(clip)
+    {
+        this->init(&gAAClipPathKeyNamespaceLabel,
+                   sizeof(fContentHash) + sizeof(fPointCount) + sizeof(fVerbCount) +
+                   sizeof(fFillTypeAndAA) + sizeof(fClip));
+    }
+
+    uint32_t    fContentHash;
+    int32_t     fPointCount;
+    int32_t     fVerbCount;
+    int32_t     fFillTypeAndAA;
+    SkIRect     fClip;  // empty if the path was inside the clip
+};
+
+struct AAClipPathRec : public SkResourceCache::Rec {
+    AAClipPathRec(const AAClipPathKey& key, const SkPath& path, const SkAAClip& clip)
+        : fKey(key)
+        , fPath(path)
+        , fClip(clip)
+    {}
+
+    AAClipPathKey   fKey;
+    SkPath          fPath;  // to rule out hash collisions
+    SkAAClip        fClip;
+
+    virtual const Key& getKey() const SK_OVERRIDE { return fKey; }
+    virtual size_t bytesUsed() const SK_OVERRIDE {
+        return sizeof(*this) + fPath.countPoints() * sizeof(SkPoint) + fPath.countVerbs() +
+               fClip.approximateBytesUsed();
+    }
+
+    struct Context {
+        const SkPath*   fPath;
+        SkAAClip*       fResult;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const AAClipPathRec& rec = static_cast<const AAClipPathRec&>(baseRec);
+        Context* context = (Context*)contextData;
+
+        if (rec.fPath != *context->fPath) {
+            return false;
+        }
+        // shares the runs, which SkAAClip copies before it edits them
+        *context->fResult = rec.fClip;
+        return true;
+    }
+};
+} // namespace
+
+// Unique or animated clips never hit, and adding them would only push reusable entries out of
+// the shared cache, so a clip is only added the second time its key misses. These are the
+// hashes of the keys of the last few clips that missed for the first time.
+static const int kSeenKeyCount = 64;
+SK_DECLARE_STATIC_MUTEX(gSeenKeysMutex);
+static uint32_t gSeenKeys[kSeenKeyCount];
+static int gNextSeenKey;
+
+// Returns true if the key missed recently, and remembers it otherwise.
+static bool check_seen_key(const SkResourceCache::Key& key) {
+    SkAutoMutexAcquire lock(gSeenKeysMutex);
+    for (int i = 0; i < kSeenKeyCount; ++i) {
+        if (gSeenKeys[i] == key.hash()) {
+            return true;
+        }
+    }
+    gSeenKeys[gNextSeenKey] = key.hash();
+    gNextSeenKey = (gNextSeenKey + 1) % kSeenKeyCount;
+    return false;
+}
+
+static uint32_t hash_path_contents(const SkPath& path) {
+    const int pointCount = path.countPoints();
+    const int verbCount = path.countVerbs();
+
+    SkAutoSTMalloc<32, SkPoint> points(pointCount);
+    path.getPoints(points.get(), pointCount);
+    uint32_t hash = SkChecksum::Murmur3((const uint32_t*)points.get(),
+                                        pointCount * sizeof(SkPoint));
+
+    // Murmur3 wants whole words, so zero-pad the verbs
+    SkAutoSTMalloc<16, uint32_t> verbs(SkAlign4(verbCount) >> 2);
+    if (verbCount > 0) {
+        verbs[(SkAlign4(verbCount) >> 2) - 1] = 0;
+        path.getVerbs((uint8_t*)verbs.get(), verbCount);
+    }
+    return SkChecksum::Murmur3(verbs.get(), SkAlign4(verbCount), hash);
+}
+
+bool SkAAClipCache::SetPath(SkAAClip* clip, const SkPath& path, const SkRegion& rgn, bool doAA,
+                            SkResourceCache* localCache) {
+    SkIRect ibounds;
+    path.getBounds().roundOut(&ibounds);
+
+    const SkIRect& clipBounds = rgn.getBounds();
+    if (!rgn.isRect() || !path.isFinite() || path.isVolatile() ||
+        path.countPoints() > kMaxCachedPathPoints || path.countVerbs() > kMaxCachedPathVerbs ||
+        SkTMax(clipBounds.fRight, clipBounds.fBottom) > kMaxClipCoord ||
+        SkTMin(clipBounds.fLeft, clipBounds.fTop) < -kMaxClipCoord) {
+        return clip->setPath(path, &rgn, doAA);
+    }
+
+    SkIRect keyClip = clipBounds;
+    if (!path.isInverseFillType() && clipBounds.contains(ibounds)) {
+        keyClip.setEmpty();
+    }
+
+    AAClipPathKey key(hash_path_contents(path), path, doAA, keyClip);
+    AAClipPathRec::Context context = { &path, clip };
+    if (CHECK_LOCAL(localCache, find, Find, key, AAClipPathRec::Visitor, &context)) {
+        return !clip->isEmpty();
+    }
+
+    clip->setPath(path, &rgn, doAA);
+    if (check_seen_key(key)) {
+        CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(AAClipPathRec, (key, path, *clip)));
+    }
+    return !clip->isEmpty();
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAAClipCache_DEFINED
+#define SkAAClipCache_DEFINED
+
+#include "SkAAClip.h"
+#include "SkPath.h"
+#include "SkResourceCache.h"
+
+class SkAAClipCache {
+public:
+    /**
+     *  Equivalent to clip->setPath(path, &rgn, doAA), but reuses the result of an earlier call
+     *  with the same path contents, fill type, aa setting and (rectangular) rgn if it is still
+     *  in the cache. A result is only added to the cache once the same clip has missed twice,
+     *  so clips that are only set once don't evict ones that are set repeatedly.
+     *
+     *  Clip paths are mapped into device space on every clipPath() call, so the key is the
+     *  device-space contents of the path rather than a generation ID; that lets the same clip,
+     *  re-applied after a restore() or on the next frame, skip scan conversion. When the path
+     *  lies wholly inside rgn, rgn is left out of the key.
+     *
+     *  Complex regions, volatile, large or non-finite paths are not cached, and go straight to
+     *  setPath().
+     */
+    static bool SetPath(SkAAClip* clip, const SkPath& path, const SkRegion& rgn, bool doAA,
+                        SkResourceCache* localCache = NULL);
+};
+
+#endif
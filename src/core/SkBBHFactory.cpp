@@ -6,6 +6,7 @@
  */
 
 #include "SkBBHFactory.h"
+#include "SkLinearBBH.h"
 #include "SkRTree.h"
 #include "SkTileGrid.h"
 
@@ -14,6 +15,10 @@ SkBBoxHierarchy* SkRTreeFactory::operator()(const SkRect& bounds) const {
     return SkNEW_ARGS(SkRTree, (aspectRatio));
 }
 
+SkBBoxHierarchy* SkLinearBBHFactory::operator()(const SkRect&) const {
+    return SkNEW(SkLinearBBH);
+}
+
 SkBBoxHierarchy* SkTileGridFactory::operator()(const SkRect& bounds) const {
     SkASSERT(fInfo.fMargin.width() >= 0);
     SkASSERT(fInfo.fMargin.height() >= 0);
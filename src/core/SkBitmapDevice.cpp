@@ -9,6 +9,7 @@
 #include "SkConfig8888.h"
 #include "SkDeviceProperties.h"
 #include "SkDraw.h"
+#include "SkLayerPool.h"
 #include "SkRasterClip.h"
 #include "SkShader.h"
 #include "SkSurface.h"
@@ -58,19 +59,21 @@ static bool valid_for_bitmap_device(const SkImageInfo& info,
     return true;
 }
 
-SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap) : fBitmap(bitmap) {
+SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap) : fBitmap(bitmap), fPendingClear(false) {
     SkASSERT(valid_for_bitmap_device(bitmap.info(), NULL));
 }
 
 SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap, const SkDeviceProperties& deviceProperties)
     : SkBaseDevice(deviceProperties)
     , fBitmap(bitmap)
+    , fPendingClear(false)
 {
     SkASSERT(valid_for_bitmap_device(bitmap.info(), NULL));
 }
 
 SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
-                                       const SkDeviceProperties* props) {
+                                       const SkDeviceProperties* props,
+                                       SkLayerPool* pool) {
     SkAlphaType newAT = origInfo.alphaType();
     if (!valid_for_bitmap_device(origInfo, &newAT)) {
         return NULL;
@@ -78,11 +81,17 @@ SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
 
     const SkImageInfo info = origInfo.makeAlphaType(newAT);
     SkBitmap bitmap;
+    bool isClear = true;
 
     if (kUnknown_SkColorType == info.colorType()) {
         if (!bitmap.setInfo(info)) {
             return NULL;
         }
+    } else if (pool) {
+        // Recycled pixels are only cleared once something needs them, which may be never.
+        if (!bitmap.setInfo(info) || !pool->allocUnclearedPixelRef(&bitmap, &isClear)) {
+            return NULL;
+        }
     } else {
         if (!bitmap.tryAllocPixels(info)) {
             return NULL;
@@ -92,11 +101,14 @@ SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
         }
     }
 
+    SkBitmapDevice* device;
     if (props) {
-        return SkNEW_ARGS(SkBitmapDevice, (bitmap, *props));
+        device = SkNEW_ARGS(SkBitmapDevice, (bitmap, *props));
     } else {
-        return SkNEW_ARGS(SkBitmapDevice, (bitmap));
+        device = SkNEW_ARGS(SkBitmapDevice, (bitmap));
     }
+    device->fPendingClear = !isClear && !info.isOpaque();
+    return device;
 }
 
 SkImageInfo SkBitmapDevice::imageInfo() const {
@@ -112,7 +124,11 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
 
 SkBaseDevice* SkBitmapDevice::onCreateCompatibleDevice(const CreateInfo& cinfo) {
     SkDeviceProperties leaky(cinfo.fPixelGeometry);
-    return SkBitmapDevice::Create(cinfo.fInfo, &leaky);
+    if (kGeneral_Usage == cinfo.fUsage) {
+        return SkBitmapDevice::Create(cinfo.fInfo, &leaky);
+    }
+    // Layers come and go with every saveLayer()/restore(), so recycle their pixels.
+    return SkBitmapDevice::Create(cinfo.fInfo, &leaky, SkLayerPool::Global());
 }
 
 void SkBitmapDevice::lockPixels() {
@@ -127,11 +143,22 @@ void SkBitmapDevice::unlockPixels() {
     }
 }
 
+void SkBitmapDevice::clearPixels() {
+    // Nobody has seen these pixels yet, so they need no change notification.
+    SkAutoLockPixels alp(fBitmap);
+    if (fBitmap.getPixels()) {
+        sk_bzero(fBitmap.getPixels(), fBitmap.getSize());
+    }
+    fPendingClear = false;
+}
+
 const SkBitmap& SkBitmapDevice::onAccessBitmap() {
+    this->resolvePendingClear();
     return fBitmap;
 }
 
 void* SkBitmapDevice::onAccessPixels(SkImageInfo* info, size_t* rowBytes) {
+    this->resolvePendingClear();
     if (fBitmap.getPixels()) {
         *info = fBitmap.info();
         *rowBytes = fBitmap.rowBytes();
@@ -149,6 +176,7 @@ bool SkBitmapDevice::onWritePixels(const SkImageInfo& srcInfo, const void* srcPi
     if (NULL == fBitmap.getPixels()) {
         return false;
     }
+    this->resolvePendingClear();
 
     const SkImageInfo dstInfo = fBitmap.info().makeWH(srcInfo.width(), srcInfo.height());
 
@@ -164,6 +192,7 @@ bool SkBitmapDevice::onWritePixels(const SkImageInfo& srcInfo, const void* srcPi
 
 bool SkBitmapDevice::onReadPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
                                   int x, int y) {
+    this->resolvePendingClear();
     return fBitmap.readPixels(dstInfo, dstPixels, dstRowBytes, x, y);
 }
 
@@ -357,6 +386,7 @@ SkSurface* SkBitmapDevice::newSurface(const SkImageInfo& info, const SkSurfacePr
 }
 
 const void* SkBitmapDevice::peekPixels(SkImageInfo* info, size_t* rowBytes) {
+    this->resolvePendingClear();
     const SkImageInfo bmInfo = fBitmap.info();
     if (fBitmap.getPixels() && (kUnknown_SkColorType != bmInfo.colorType())) {
         if (info) {
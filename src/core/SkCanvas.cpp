@@ -61,12 +61,6 @@
 
 typedef SkTLazy<SkPaint> SkLazyPaint;
 
-void SkCanvas::predrawNotify() {
-    if (fSurfaceBase) {
-        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode);
-    }
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 
 static uint32_t filter_paint_flags(const SkSurfaceProps& props, uint32_t flags) {
@@ -180,12 +174,18 @@ public:
         or a previous one in a lower level.)
     */
     DeviceCM*   fTopLayer;
+    /*  Number of save() calls made while this rec was on top that have not
+        yet been given a rec of their own. The copy is only made (see
+        SkCanvas::checkForDeferredSave) once the matrix/clip/filter changes.
+    */
+    int         fDeferredSaveCount;
 
     MCRec(bool conservativeRasterClip) : fRasterClip(conservativeRasterClip) {
         fMatrix.reset();
         fFilter     = NULL;
         fLayer      = NULL;
         fTopLayer   = NULL;
+        fDeferredSaveCount = 0;
 
         // don't bother initializing fNext
         inc_rec();
@@ -195,6 +195,7 @@ public:
         fFilter = SkSafeRef(prev.fFilter);
         fLayer = NULL;
         fTopLayer = prev.fTopLayer;
+        fDeferredSaveCount = 0;
 
         // don't bother initializing fNext
         inc_rec();
@@ -233,7 +234,7 @@ public:
             fClip   = &((SkRasterClip*)&rec->fClip)->forceGetBW();
             fRC     = &rec->fClip;
             fDevice = rec->fDevice;
-            fBitmap = &fDevice->accessBitmap(true);
+            fBitmap = &fDevice->accessBitmapForDraw();
             fPaint  = rec->fPaint;
             SkDEBUGCODE(this->validate();)
 
@@ -278,8 +279,8 @@ public:
         if (!skipLayerForImageFilter && fOrigPaint.getImageFilter()) {
             SkPaint tmp;
             tmp.setImageFilter(fOrigPaint.getImageFilter());
-            (void)canvas->internalSaveLayer(bounds, &tmp, SkCanvas::kARGB_ClipLayer_SaveFlag,
-                                            true, SkCanvas::kFullLayer_SaveLayerStrategy);
+            canvas->internalSaveLayer(bounds, &tmp, SkCanvas::kARGB_ClipLayer_SaveFlag,
+                                      true, SkCanvas::kFullLayer_SaveLayerStrategy);
             // we'll clear the imageFilter for the actual draws in next(), so
             // it will only be applied during the restore().
             fDoClearImageFilter = true;
@@ -387,6 +388,40 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
     return true;
 }
 
+void SkCanvas::predrawNotify(const SkRect* bounds, const SkPaint* paint) {
+    if (NULL == fSurfaceBase) {
+        return;
+    }
+    if (!fSurfaceBase->wantsDirtyBounds()) {
+        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode);
+        return;
+    }
+
+    // Nothing can be drawn outside of the clip. Within it, only trust the bounds if a draw
+    // filter can't change the paint they were computed with, and if mapping them is exact.
+    SkIRect dirty = fMCRec->fRasterClip.getBounds();
+    if (bounds && paint && paint->canComputeFastBounds() && NULL == fMCRec->fFilter &&
+        !fMCRec->fMatrix.hasPerspective()) {
+        SkRect devBounds;
+        fMCRec->fMatrix.mapRect(&devBounds, *bounds);
+        if (devBounds.isFinite()) {
+            SkIRect ir;
+            devBounds.roundOut(&ir);
+            ir.outset(1, 1);    // room for antialiasing
+            if (!dirty.intersect(ir)) {
+                dirty.setEmpty();
+            }
+        }
+    }
+    this->predrawNotify(dirty);
+}
+
+void SkCanvas::predrawNotify(const SkIRect& deviceBounds) {
+    if (fSurfaceBase) {
+        fSurfaceBase->aboutToDraw(SkSurface::kRetain_ContentChangeMode, &deviceBounds);
+    }
+}
+
 ////////// macros to place around the internal draw calls //////////////////
 
 #define LOOPER_BEGIN_DRAWDEVICE(paint, type)                        \
@@ -396,7 +431,7 @@ bool AutoDrawLooper::doNext(SkDrawFilter::Type drawType) {
         SkDrawIter          iter(this);
 
 #define LOOPER_BEGIN(paint, type, bounds)                           \
-    this->predrawNotify();                                          \
+    this->predrawNotify(bounds, &paint);                            \
     AutoDrawLooper  looper(this, fProps, paint, false, bounds);     \
     while (looper.next(type)) {                                     \
         SkDrawIter          iter(this);
@@ -412,6 +447,7 @@ SkBaseDevice* SkCanvas::init(SkBaseDevice* device, InitFlags flags) {
     fAllowSoftClip = true;
     fAllowSimplifyClip = false;
     fDeviceCMDirty = true;
+    fSaveCount = 1;
     fSaveLayerCount = 0;
     fCullCount = 0;
     fMetaData = NULL;
@@ -538,6 +574,7 @@ SkDrawFilter* SkCanvas::getDrawFilter() const {
 }
 
 SkDrawFilter* SkCanvas::setDrawFilter(SkDrawFilter* filter) {
+    this->checkForDeferredSave();
     SkRefCnt_SafeAssign(fMCRec->fFilter, filter);
     return filter;
 }
@@ -779,7 +816,7 @@ bool SkCanvas::writePixels(const SkImageInfo& origInfo, const void* pixels, size
     pixels = ((const char*)pixels - y * rowBytes - x * info.bytesPerPixel());
 
     // Tell our owning surface to bump its generation ID
-    this->predrawNotify();
+    this->predrawNotify(target);
 
     // The device can assert that the requested area is always contained in its bounds
     return device->writePixels(info, pixels, rowBytes, target.x(), target.y());
@@ -812,19 +849,38 @@ void SkCanvas::updateDeviceCMCache() {
 ///////////////////////////////////////////////////////////////////////////////
 
 int SkCanvas::getSaveCount() const {
-    return fMCStack.count();
+    return fSaveCount;
 }
 
 int SkCanvas::save() {
     this->willSave();
-    return this->internalSave();
+    // Just note the save; the rec is only copied if something changes before
+    // the matching restore().
+    fSaveCount += 1;
+    fMCRec->fDeferredSaveCount += 1;
+    return fSaveCount - 1;  // return our prev value
+}
+
+void SkCanvas::checkForDeferredSave() {
+    // Called before any change to fMCRec: give the innermost pending save()
+    // its own copy of the state.
+    if (fMCRec->fDeferredSaveCount > 0) {
+        fMCRec->fDeferredSaveCount -= 1;
+        this->internalSave();
+    }
 }
 
 void SkCanvas::restore() {
     // check for underflow
-    if (fMCStack.count() > 1) {
+    if (fSaveCount > 1) {
         this->willRestore();
-        this->internalRestore();
+        fSaveCount -= 1;
+        if (fMCRec->fDeferredSaveCount > 0) {
+            // nothing changed since the save(), so there is nothing to pop
+            fMCRec->fDeferredSaveCount -= 1;
+        } else {
+            this->internalRestore();
+        }
         this->didRestore();
     }
 }
@@ -841,16 +897,12 @@ void SkCanvas::restoreToCount(int count) {
     }
 }
 
-int SkCanvas::internalSave() {
-    int saveCount = this->getSaveCount(); // record this before the actual save
-
+void SkCanvas::internalSave() {
     MCRec* newTop = (MCRec*)fMCStack.push_back();
     new (newTop) MCRec(*fMCRec);    // balanced in restore()
     fMCRec = newTop;
 
     fClipStack.save();
-
-    return saveCount;
 }
 
 static bool bounds_affects_clip(SkCanvas::SaveFlags flags) {
@@ -907,36 +959,40 @@ bool SkCanvas::clipRectBounds(const SkRect* bounds, SaveFlags flags,
 
 int SkCanvas::saveLayer(const SkRect* bounds, const SkPaint* paint) {
     SaveLayerStrategy strategy = this->willSaveLayer(bounds, paint, kARGB_ClipLayer_SaveFlag);
-    return this->internalSaveLayer(bounds, paint, kARGB_ClipLayer_SaveFlag, false, strategy);
+    fSaveCount += 1;
+    this->internalSaveLayer(bounds, paint, kARGB_ClipLayer_SaveFlag, false, strategy);
+    return fSaveCount - 1;
 }
 
 int SkCanvas::saveLayer(const SkRect* bounds, const SkPaint* paint,
                         SaveFlags flags) {
     SaveLayerStrategy strategy = this->willSaveLayer(bounds, paint, flags);
-    return this->internalSaveLayer(bounds, paint, flags, false, strategy);
+    fSaveCount += 1;
+    this->internalSaveLayer(bounds, paint, flags, false, strategy);
+    return fSaveCount - 1;
 }
 
-int SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint, SaveFlags flags,
-                                bool justForImageFilter, SaveLayerStrategy strategy) {
+void SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint, SaveFlags flags,
+                                 bool justForImageFilter, SaveLayerStrategy strategy) {
 #ifndef SK_SUPPORT_LEGACY_CLIPTOLAYERFLAG
     flags |= kClipToLayer_SaveFlag;
 #endif
 
     // do this before we create the layer. We don't call the public save() since
     // that would invoke a possibly overridden virtual
-    int count = this->internalSave();
+    this->internalSave();
 
     fDeviceCMDirty = true;
 
     SkIRect ir;
     if (!this->clipRectBounds(bounds, flags, &ir, paint ? paint->getImageFilter() : NULL)) {
-        return count;
+        return;
     }
 
     // FIXME: do willSaveLayer() overriders returning kNoLayer_SaveLayerStrategy really care about
     // the clipRectBounds() call above?
     if (kNoLayer_SaveLayerStrategy == strategy) {
-        return count;
+        return;
     }
 
     // Kill the imagefilter if our device doesn't allow it
@@ -945,7 +1001,7 @@ int SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint, Save
         if (!this->getTopDevice()->allowImageFilter(paint->getImageFilter())) {
             if (justForImageFilter) {
                 // early exit if the layer was just for the imageFilter
-                return count;
+                return;
             }
             SkPaint* p = lazyP.set(*paint);
             p->setImageFilter(NULL);
@@ -960,7 +1016,7 @@ int SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint, Save
     SkBaseDevice* device = this->getTopDevice();
     if (NULL == device) {
         SkDebugf("Unable to find device for layer.");
-        return count;
+        return;
     }
 
     SkBaseDevice::Usage usage = SkBaseDevice::kSaveLayer_Usage;
@@ -971,7 +1027,7 @@ int SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint, Save
                                                                        fProps.pixelGeometry()));
     if (NULL == device) {
         SkDebugf("Unable to create device for layer.");
-        return count;
+        return;
     }
 
     device->setOrigin(ir.fLeft, ir.fTop);
@@ -984,7 +1040,6 @@ int SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint, Save
     fMCRec->fTopLayer = layer;    // this field is NOT an owner of layer
 
     fSaveLayerCount += 1;
-    return count;
 }
 
 int SkCanvas::saveLayerAlpha(const SkRect* bounds, U8CPU alpha) {
@@ -1312,6 +1367,7 @@ void SkCanvas::concat(const SkMatrix& matrix) {
         return;
     }
 
+    this->checkForDeferredSave();
     fDeviceCMDirty = true;
     fCachedLocalClipBoundsDirty = true;
     fMCRec->fMatrix.preConcat(matrix);
@@ -1320,6 +1376,7 @@ void SkCanvas::concat(const SkMatrix& matrix) {
 }
 
 void SkCanvas::setMatrix(const SkMatrix& matrix) {
+    this->checkForDeferredSave();
     fDeviceCMDirty = true;
     fCachedLocalClipBoundsDirty = true;
     fMCRec->fMatrix = matrix;
@@ -1336,6 +1393,7 @@ void SkCanvas::resetMatrix() {
 //////////////////////////////////////////////////////////////////////////////
 
 void SkCanvas::clipRect(const SkRect& rect, SkRegion::Op op, bool doAA) {
+    this->checkForDeferredSave();
     ClipEdgeStyle edgeStyle = doAA ? kSoft_ClipEdgeStyle : kHard_ClipEdgeStyle;
     this->onClipRect(rect, op, edgeStyle);
 }
@@ -1393,6 +1451,7 @@ static void rasterclip_path(SkRasterClip* rc, const SkCanvas* canvas, const SkPa
 }
 
 void SkCanvas::clipRRect(const SkRRect& rrect, SkRegion::Op op, bool doAA) {
+    this->checkForDeferredSave();
     ClipEdgeStyle edgeStyle = doAA ? kSoft_ClipEdgeStyle : kHard_ClipEdgeStyle;
     if (rrect.isRect()) {
         this->onClipRect(rrect.getBounds(), op, edgeStyle);
@@ -1428,6 +1487,7 @@ void SkCanvas::onClipRRect(const SkRRect& rrect, SkRegion::Op op, ClipEdgeStyle
 }
 
 void SkCanvas::clipPath(const SkPath& path, SkRegion::Op op, bool doAA) {
+    this->checkForDeferredSave();
     ClipEdgeStyle edgeStyle = doAA ? kSoft_ClipEdgeStyle : kHard_ClipEdgeStyle;
     SkRect r;
     if (!path.isInverseFillType() && path.isRect(&r)) {
@@ -1510,6 +1570,7 @@ void SkCanvas::onClipPath(const SkPath& path, SkRegion::Op op, ClipEdgeStyle edg
 }
 
 void SkCanvas::clipRegion(const SkRegion& rgn, SkRegion::Op op) {
+    this->checkForDeferredSave();
     this->onClipRegion(rgn, op);
 }
 
@@ -1717,7 +1778,34 @@ void SkCanvas::drawPaint(const SkPaint& paint) {
     this->internalDrawPaint(paint);
 }
 
+// Does filling with this paint replace the destination pixels, whatever they were?
+static bool paint_overwrites_dst(const SkPaint& paint) {
+    if (paint.getShader() || paint.getColorFilter() || paint.getMaskFilter() ||
+        paint.getImageFilter() || paint.getLooper() || paint.getRasterizer()) {
+        return false;
+    }
+    SkXfermode::Mode mode;
+    if (!SkXfermode::AsMode(paint.getXfermode(), &mode)) {
+        return false;
+    }
+    return SkXfermode::kSrc_Mode == mode ||
+           (SkXfermode::kSrcOver_Mode == mode && 0xFF == paint.getAlpha());
+}
+
 void SkCanvas::internalDrawPaint(const SkPaint& paint) {
+    // A layer that is filled right away (e.g. by clear()) doesn't need to be cleared first.
+    if (NULL == fMCRec->fFilter && fMCRec->fRasterClip.isRect() && paint_overwrites_dst(paint)) {
+        SkBaseDevice* device = this->getTopDevice();
+        if (device) {
+            const SkIRect devBounds = SkIRect::MakeXYWH(device->getOrigin().x(),
+                                                        device->getOrigin().y(),
+                                                        device->width(), device->height());
+            if (fMCRec->fRasterClip.getBounds().contains(devBounds)) {
+                device->willOverwriteAllPixels();
+            }
+        }
+    }
+
     LOOPER_BEGIN(paint, SkDrawFilter::kPaint_Type, NULL)
 
     while (iter.next()) {
@@ -12,6 +12,7 @@
 #include "SkShader.h"
 #include "SkUnPreMultiply.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 bool SkColorFilter::asColorMode(SkColor* color, SkXfermode::Mode* mode) const {
     return false;
@@ -40,6 +41,21 @@ SkColor SkColorFilter::filterColor(SkColor c) const {
     return SkUnPreMultiply::PMColorToColor(dst);
 }
 
+SkColorFilter* SkColorFilter::newComposed(const SkColorFilter*) const {
+    return NULL;
+}
+
 GrFragmentProcessor* SkColorFilter::asFragmentProcessor(GrContext*) const {
     return NULL;
 }
+
+bool SkColorFilter::asFragmentProcessors(GrContext* context,
+                                         SkTDArray<GrFragmentProcessor*>* array) const {
+    SkASSERT(array);
+    GrFragmentProcessor* fp = this->asFragmentProcessor(context);
+    if (fp) {
+        *array->append() = fp;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCompactPath.h"
+#include "SkTDArray.h"
+
+#include <math.h>
+
+SK_DEFINE_INST_COUNT(SkCompactPath)
+
+/*
+ *  Each coordinate c is stored as a signed 16-bit q, with c == offset + q * scale. The scale is
+ *  a power of two, so q * scale is exact, and the sum is exact whenever c is representable --
+ *  which Create() checks for every point rather than assuming.
+ */
+
+// Returns the exponent of the lowest set bit of x (x != 0, finite), i.e. the largest e such that
+// x is a multiple of 2^e.
+static int lowest_bit_exponent(float x) {
+    int exp;
+    float mantissa = frexpf(x, &exp);             // |mantissa| in [0.5, 1)
+    int32_t bits = (int32_t)ldexpf(mantissa, 24);   // exact: floats have 24 significant bits
+    SkASSERT(bits != 0);
+    exp -= 24;
+    while (0 == (bits & 1)) {
+        bits >>= 1;
+        exp += 1;
+    }
+    return exp;
+}
+
+// Picks the offset (a multiple of scale) that centres [min, max] on the int16 range, and returns
+// false if the range does not fit.
+static bool compute_offset(SkScalar min, SkScalar max, SkScalar scale, SkScalar* offset) {
+    double mid = (min + (double)max) * 0.5;
+    double off = floor(mid / scale + 0.5) * scale;
+    if ((min - off) / scale < -32768 || (max - off) / scale > 32767) {
+        return false;
+    }
+    *offset = (float)off;
+    return (double)*offset == off;
+}
+
+size_t SkCompactPath::StorageSize(int pointCount, int verbCount, int conicCount) {
+    size_t size = sizeof(SkCompactPath) + pointCount * 2 * sizeof(int16_t) + verbCount;
+    return SkAlign4(size) + conicCount * sizeof(SkScalar);
+}
+
+SkCompactPath::SkCompactPath(const SkRect& bounds, const SkPoint& offset, SkScalar scale,
+                             int pointCount, int verbCount, int conicCount,
+                             SkPath::FillType fillType, uint32_t segmentMasks)
+    : fBounds(bounds)
+    , fOffset(offset)
+    , fScale(scale)
+    , fPointCount(pointCount)
+    , fVerbCount(verbCount)
+    , fConicCount(conicCount)
+    , fFillType(SkToU8(fillType))
+    , fSegmentMasks(SkToU8(segmentMasks)) {
+}
+
+SkCompactPath::~SkCompactPath() {}
+
+SkCompactPath* SkCompactPath::Create(const SkPath& path) {
+    if (!path.isFinite()) {
+        return NULL;
+    }
+
+    const int pointCount = path.countPoints();
+    const int verbCount = path.countVerbs();
+
+    // Walk the path once to collect the points in order, the verbs and the conic weights.
+    SkTDArray<SkPoint>  points;
+    SkTDArray<uint8_t>  verbs;
+    SkTDArray<SkScalar> weights;
+    points.setReserve(pointCount);
+    verbs.setReserve(verbCount);
+
+    int lowestBit = SK_MaxS32;
+    SkPath::RawIter iter(path);
+    SkPath::Verb verb;
+    SkPoint pts[4];
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        int first = 1, count = 0;
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                first = 0;
+                count = 1;
+                break;
+            case SkPath::kLine_Verb:
+                count = 1;
+                break;
+            case SkPath::kConic_Verb:
+                *weights.append() = iter.conicWeight();
+                // fall through
+            case SkPath::kQuad_Verb:
+                count = 2;
+                break;
+            case SkPath::kCubic_Verb:
+                count = 3;
+                break;
+            default:
+                break;
+        }
+        for (int i = first; i < first + count; ++i) {
+            if (pts[i].fX) {
+                lowestBit = SkTMin(lowestBit, lowest_bit_exponent(pts[i].fX));
+            }
+            if (pts[i].fY) {
+                lowestBit = SkTMin(lowestBit, lowest_bit_exponent(pts[i].fY));
+            }
+        }
+        points.append(count, &pts[first]);
+        *verbs.append() = verb;
+    }
+    SkASSERT(points.count() == pointCount);
+    SkASSERT(verbs.count() == verbCount);
+
+    if (SK_MaxS32 == lowestBit) {
+        lowestBit = 0;   // no non-zero coordinates
+    }
+    if (lowestBit < -126 || lowestBit > 127) {
+        return NULL;     // the scale would not be a normal float
+    }
+    const SkScalar scale = ldexpf(1, lowestBit);
+
+    const SkRect& bounds = path.getBounds();
+    SkPoint offset = SkPoint::Make(0, 0);
+    if (pointCount > 0 &&
+        (!compute_offset(bounds.fLeft, bounds.fRight, scale, &offset.fX) ||
+         !compute_offset(bounds.fTop, bounds.fBottom, scale, &offset.fY))) {
+        return NULL;
+    }
+
+    const size_t size = StorageSize(pointCount, verbCount, weights.count());
+    void* storage = sk_malloc_throw(size);
+    SkCompactPath* cp = new (storage) SkCompactPath(bounds, offset, scale, pointCount, verbCount,
+                                                    weights.count(), path.getFillType(),
+                                                    path.getSegmentMasks());
+
+    const SkScalar invScale = SkScalarInvert(scale);
+    int16_t* dstPts = const_cast<int16_t*>(cp->points());
+    for (int i = 0; i < pointCount; ++i) {
+        dstPts[2 * i + 0] = SkToS16((int)((points[i].fX - offset.fX) * invScale));
+        dstPts[2 * i + 1] = SkToS16((int)((points[i].fY - offset.fY) * invScale));
+    }
+    memcpy(const_cast<uint8_t*>(cp->verbs()), verbs.begin(), verbCount);
+    memcpy(const_cast<SkScalar*>(cp->conicWeights()), weights.begin(),
+           weights.count() * sizeof(SkScalar));
+
+    // Make sure every point decodes to exactly what we were given.
+    for (int i = 0; i < pointCount; ++i) {
+        if (offset.fX + dstPts[2 * i + 0] * scale != points[i].fX ||
+            offset.fY + dstPts[2 * i + 1] * scale != points[i].fY) {
+            cp->unref();
+            return NULL;
+        }
+    }
+    return cp;
+}
+
+size_t SkCompactPath::approximateBytesUsed() const {
+    return StorageSize(fPointCount, fVerbCount, fConicCount);
+}
+
+void SkCompactPath::toPath(SkPath* path) const {
+    path->reset();
+    path->incReserve(fPointCount);
+
+    RawIter iter(*this);
+    SkPath::Verb verb;
+    SkPoint pts[4];
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                path->moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                path->lineTo(pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                path->quadTo(pts[1], pts[2]);
+                break;
+            case SkPath::kConic_Verb:
+                path->conicTo(pts[1], pts[2], iter.conicWeight());
+                break;
+            case SkPath::kCubic_Verb:
+                path->cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPath::kClose_Verb:
+                path->close();
+                break;
+            default:
+                SkDEBUGFAIL("unexpected verb");
+                break;
+        }
+    }
+    path->setFillType(this->getFillType());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkCompactPath::RawIter::RawIter(const SkCompactPath& path) {
+    fPts = path.points();
+    fVerbs = path.verbs();
+    fVerbStop = fVerbs + path.fVerbCount;
+    fConicWeights = path.conicWeights() - 1; // begin one behind
+    fOffset = path.fOffset;
+    fScale = path.fScale;
+    fMoveTo.set(0, 0);
+    fLastPt.set(0, 0);
+}
+
+// The offset and scale are passed by value so they stay in registers while we store to pts
+// (which could otherwise alias the iterator's own fields).
+static inline void decode_pts(SkPoint dst[], const int16_t src[], int count,
+                              SkScalar ox, SkScalar oy, SkScalar scale) {
+    for (int i = 0; i < count; ++i) {
+        dst[i].set(ox + src[2 * i] * scale, oy + src[2 * i + 1] * scale);
+    }
+}
+
+SkPath::Verb SkCompactPath::RawIter::next(SkPoint pts[4]) {
+    SkASSERT(pts);
+    if (fVerbs == fVerbStop) {
+        return SkPath::kDone_Verb;
+    }
+
+    unsigned verb = *fVerbs++;
+    const int16_t* srcPts = fPts;
+    const SkScalar ox = fOffset.fX, oy = fOffset.fY, scale = fScale;
+
+    switch (verb) {
+        case SkPath::kMove_Verb:
+            decode_pts(pts, srcPts, 1, ox, oy, scale);
+            fMoveTo = pts[0];
+            fLastPt = fMoveTo;
+            srcPts += 2;
+            break;
+        case SkPath::kLine_Verb:
+            pts[0] = fLastPt;
+            decode_pts(pts + 1, srcPts, 1, ox, oy, scale);
+            fLastPt = pts[1];
+            srcPts += 2;
+            break;
+        case SkPath::kConic_Verb:
+            fConicWeights += 1;
+            // fall-through
+        case SkPath::kQuad_Verb:
+            pts[0] = fLastPt;
+            decode_pts(pts + 1, srcPts, 2, ox, oy, scale);
+            fLastPt = pts[2];
+            srcPts += 4;
+            break;
+        case SkPath::kCubic_Verb:
+            pts[0] = fLastPt;
+            decode_pts(pts + 1, srcPts, 3, ox, oy, scale);
+            fLastPt = pts[3];
+            srcPts += 6;
+            break;
+        case SkPath::kClose_Verb:
+            fLastPt = fMoveTo;
+            pts[0] = fMoveTo;
+            break;
+    }
+    fPts = srcPts;
+    return (SkPath::Verb)verb;
+}
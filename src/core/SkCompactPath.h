@@ -0,0 +1,113 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCompactPath_DEFINED
+#define SkCompactPath_DEFINED
+
+#include "SkPath.h"
+#include "SkRefCnt.h"
+
+/** \class SkCompactPath
+
+    An immutable, read-only copy of an SkPath whose points are stored as 16-bit integers on a
+    per-path grid (a power-of-two scale plus an offset), with the verbs and conic weights packed
+    into the same allocation. For the small, grid-aligned paths that make up e.g. map tiles this
+    takes roughly half the memory of an SkPath.
+
+    Only paths that round-trip exactly are accepted: every point decoded by RawIter (or toPath())
+    equals the point that was passed to Create().
+
+    Nothing draws from an SkCompactPath directly yet (drawing goes through toPath()), so this
+    stays private to core until the edge builder can consume it.
+*/
+class SkCompactPath : public SkRefCnt {
+public:
+    SK_DECLARE_INST_COUNT(SkCompactPath)
+
+    /**
+     *  Returns a compact copy of path, or NULL if some point of path can not be represented
+     *  exactly (e.g. the path spans too many grid steps, or is not finite).
+     */
+    static SkCompactPath* Create(const SkPath& path);
+
+    virtual ~SkCompactPath();
+
+    const SkRect& getBounds() const { return fBounds; }
+    SkPath::FillType getFillType() const { return (SkPath::FillType)fFillType; }
+    uint32_t getSegmentMasks() const { return fSegmentMasks; }
+    int countPoints() const { return fPointCount; }
+    int countVerbs() const { return fVerbCount; }
+
+    /** Returns the spacing of the grid the points are stored on. */
+    SkScalar getScale() const { return fScale; }
+
+    /** Replaces the contents of path with the decoded path. */
+    void toPath(SkPath* path) const;
+
+    /** Returns the number of bytes this object occupies, including its point and verb data. */
+    size_t approximateBytesUsed() const;
+
+    /**
+     *  Walks the verbs and (decoded) points exactly as SkPath::RawIter walks the path this was
+     *  created from.
+     */
+    class SK_API RawIter {
+    public:
+        RawIter(const SkCompactPath&);
+
+        SkPath::Verb next(SkPoint pts[4]);
+
+        SkScalar conicWeight() const { return *fConicWeights; }
+
+    private:
+        const int16_t*  fPts;
+        const uint8_t*  fVerbs;
+        const uint8_t*  fVerbStop;
+        const SkScalar* fConicWeights;
+        SkPoint         fOffset;
+        SkScalar        fScale;
+        SkPoint         fMoveTo;
+        SkPoint         fLastPt;
+    };
+
+private:
+    SkCompactPath(const SkRect& bounds, const SkPoint& offset, SkScalar scale, int pointCount,
+                  int verbCount, int conicCount, SkPath::FillType fillType, uint32_t segmentMasks);
+
+    // Memory for objects of this class is created with sk_malloc rather than operator new and must
+    // be freed with sk_free.
+    void operator delete(void* p) { sk_free(p); }
+    void* operator new(size_t) {
+        SkFAIL("All compact paths are created by placement new.");
+        return sk_malloc_throw(0);
+    }
+    void* operator new(size_t, void* p) { return p; }
+
+    // The points, verbs (in path order) and conic weights follow the object.
+    static size_t StorageSize(int pointCount, int verbCount, int conicCount);
+    const int16_t* points() const { return reinterpret_cast<const int16_t*>(this + 1); }
+    const uint8_t* verbs() const {
+        return reinterpret_cast<const uint8_t*>(this->points() + 2 * fPointCount);
+    }
+    const SkScalar* conicWeights() const {
+        return reinterpret_cast<const SkScalar*>(SkAlign4((uintptr_t)(this->verbs() +
+                                                                      fVerbCount)));
+    }
+
+    const SkRect    fBounds;
+    const SkPoint   fOffset;
+    const SkScalar  fScale;
+    const int32_t   fPointCount;
+    const int32_t   fVerbCount;
+    const int32_t   fConicCount;
+    const uint8_t   fFillType;
+    const uint8_t   fSegmentMasks;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
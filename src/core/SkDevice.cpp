@@ -21,6 +21,7 @@ SkBaseDevice::SkBaseDevice()
 {
     fOrigin.setZero();
     fMetaData = NULL;
+    fPixelsHandedOut = false;
 }
 
 SkBaseDevice::SkBaseDevice(const SkDeviceProperties& dp)
@@ -31,6 +32,7 @@ SkBaseDevice::SkBaseDevice(const SkDeviceProperties& dp)
 {
     fOrigin.setZero();
     fMetaData = NULL;
+    fPixelsHandedOut = false;
 }
 
 SkBaseDevice::~SkBaseDevice() {
@@ -56,6 +58,14 @@ const SkBitmap& SkBaseDevice::accessBitmap(bool changePixels) {
     if (changePixels) {
         bitmap.notifyPixelsChanged();
     }
+    // Even a "read-only" bitmap gives access to writable pixels.
+    fPixelsHandedOut = true;
+    return bitmap;
+}
+
+const SkBitmap& SkBaseDevice::accessBitmapForDraw() {
+    const SkBitmap& bitmap = this->onAccessBitmap();
+    bitmap.notifyPixelsChanged();
     return bitmap;
 }
 
@@ -202,6 +212,7 @@ void* SkBaseDevice::accessPixels(SkImageInfo* info, size_t* rowBytes) {
     if (NULL == rowBytes) {
         rowBytes = &tmpRowBytes;
     }
+    fPixelsHandedOut = true;
     return this->onAccessPixels(info, rowBytes);
 }
 
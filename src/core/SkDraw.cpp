@@ -1078,6 +1078,16 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         return;
     }
 
+    // Only the caller's own path, if they keep it around, can identify its (cached) mask by
+    // genID. Mutable and volatile paths, and the transformed or stroked copies above, are
+    // temporaries whose genIDs never repeat. Only mask filters look at the genID, so don't
+    // make other draws compute it.
+    uint32_t srcGenID = 0;
+    if (paint->getMaskFilter() && pathPtr == &origSrcPath && !pathIsMutable &&
+            !origSrcPath.isVolatile()) {
+        srcGenID = origSrcPath.getGenerationID();
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
 
@@ -1096,7 +1106,8 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     if (paint->getMaskFilter()) {
         SkPaint::Style style = doFill ? SkPaint::kFill_Style :
             SkPaint::kStroke_Style;
-        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *fRC, blitter, style)) {
+        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *fRC, blitter, style,
+                                               srcGenID, matrix)) {
             return; // filterPath() called the blitter, so we're done
         }
     }
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLayerPool.h"
+#include "SkLazyPtr.h"
+#include "SkMallocPixelRef.h"
+#include "SkMath.h"
+
+// Limits for the global pool.  This memory is held outside of any cache budget, so only keep
+// enough for a few nested 512x512 layers; bigger layers are rare and go back to the heap.
+static const int    kGlobalMaxBuffers = 4;
+static const size_t kGlobalMaxBytes   = 4 * 1024 * 1024;
+
+// Smallest buffer we will allocate; tiny layers all share this class.
+static const size_t kMinBufferSize = 4096;
+
+// Each buffer starts with this header, followed by its pixels.
+struct SkLayerPool::Buffer {
+    SkLayerPool* fPool;     // owns a ref while the buffer is out of the pool
+    size_t       fSize;     // size class of the pixel storage
+
+    void* pixels() { return reinterpret_cast<char*>(this) + kHeaderSize; }
+
+    // Keep the pixels 16-byte aligned (like the allocation itself) for SIMD blitters.
+    static const size_t kHeaderSize = 16;
+};
+
+// Round size up to a multiple of a quarter of its highest power of two, so layers that differ by
+// a few pixels in either dimension still share buffers, and we waste at most 25% on rounding.
+static size_t size_class(size_t size) {
+    if (size <= kMinBufferSize) {
+        return kMinBufferSize;
+    }
+    SkASSERT(size <= SK_MaxS32);
+    const size_t quarter = (size_t)1 << (31 - SkCLZ((uint32_t)size) - 2);
+    return (size + quarter - 1) & ~(quarter - 1);
+}
+
+namespace {
+SkLayerPool* create_global_pool() {
+    return SkNEW_ARGS(SkLayerPool, (kGlobalMaxBuffers, kGlobalMaxBytes));
+}
+}  // namespace
+
+SK_DECLARE_STATIC_LAZY_PTR(SkLayerPool, global, create_global_pool);
+
+SkLayerPool* SkLayerPool::Global() {
+    return global.get();
+}
+
+SkLayerPool::SkLayerPool(int maxBuffers, size_t maxBytes)
+    : fBytes(0)
+    , fMaxBuffers(maxBuffers)
+    , fMaxBytes(maxBytes) {}
+
+SkLayerPool::~SkLayerPool() {
+    this->purge();
+}
+
+SkLayerPool::Buffer* SkLayerPool::removeBuffer(size_t size) {
+    SkAutoMutexAcquire lock(fMutex);
+    for (int i = fBuffers.count() - 1; i >= 0; --i) {
+        Buffer* buffer = fBuffers[i];
+        if (buffer->fSize == size) {
+            fBuffers.remove(i);
+            fBytes -= size;
+            return buffer;
+        }
+    }
+    return NULL;
+}
+
+void SkLayerPool::addBuffer(Buffer* buffer) {
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (fBuffers.count() < fMaxBuffers && fBytes + buffer->fSize <= fMaxBytes) {
+            *fBuffers.append() = buffer;
+            fBytes += buffer->fSize;
+            return;
+        }
+    }
+    sk_free(buffer);
+}
+
+void SkLayerPool::ReleaseProc(void*, void* context) {
+    Buffer* buffer = static_cast<Buffer*>(context);
+    SkLayerPool* pool = buffer->fPool;
+    buffer->fPool = NULL;
+    pool->addBuffer(buffer);
+    pool->unref();
+}
+
+bool SkLayerPool::allocPixelRef(SkBitmap* dst, SkColorTable*) {
+    bool isClear;
+    return this->alloc(dst, true, &isClear);
+}
+
+bool SkLayerPool::allocUnclearedPixelRef(SkBitmap* dst, bool* isClear) {
+    return this->alloc(dst, false, isClear);
+}
+
+bool SkLayerPool::alloc(SkBitmap* dst, bool clear, bool* isClear) {
+    SK_COMPILE_ASSERT(sizeof(Buffer) <= Buffer::kHeaderSize, header_fits);
+
+    const SkImageInfo info = dst->info();
+    if (kUnknown_SkColorType == info.colorType() || kIndex_8_SkColorType == info.colorType()) {
+        return false;
+    }
+
+    const size_t rowBytes = dst->rowBytes();
+    const int64_t bigSize = (int64_t)info.height() * rowBytes;
+    if (!sk_64_isS32(bigSize)) {
+        return false;
+    }
+    const size_t size = size_class(sk_64_asS32(bigSize));
+    const size_t allocSize = size + Buffer::kHeaderSize;
+    if (allocSize > SK_MaxS32) {
+        return false;
+    }
+
+    Buffer* buffer = this->removeBuffer(size);
+    if (buffer) {
+        *isClear = clear && !info.isOpaque();
+        if (*isClear) {
+            memset(buffer->pixels(), 0, sk_64_asS32(bigSize));
+        }
+    } else {
+        // Fresh memory from calloc is often already zero (straight from the OS), so this is
+        // cheaper than malloc followed by a clear.
+        void* addr = info.isOpaque() ? sk_malloc_flags(allocSize, 0) : sk_calloc(allocSize);
+        if (NULL == addr) {
+            return false;
+        }
+        buffer = static_cast<Buffer*>(addr);
+        buffer->fSize = size;
+        *isClear = !info.isOpaque();
+    }
+    buffer->fPool = SkRef(this);
+
+    SkPixelRef* pr = SkMallocPixelRef::NewWithProc(info, rowBytes, NULL, buffer->pixels(),
+                                                   ReleaseProc, buffer);
+    if (NULL == pr) {
+        ReleaseProc(buffer->pixels(), buffer);
+        return false;
+    }
+
+    dst->setPixelRef(pr)->unref();
+    // since we're already allocated, we lockPixels right away
+    dst->lockPixels();
+    return true;
+}
+
+void SkLayerPool::purge() {
+    SkTDArray<Buffer*> buffers;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        buffers.swap(fBuffers);
+        fBytes = 0;
+    }
+    for (int i = 0; i < buffers.count(); ++i) {
+        sk_free(buffers[i]);
+    }
+}
+
+int SkLayerPool::countBuffers() {
+    SkAutoMutexAcquire lock(fMutex);
+    return fBuffers.count();
+}
+
+size_t SkLayerPool::getTotalBytes() {
+    SkAutoMutexAcquire lock(fMutex);
+    return fBytes;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLayerPool_DEFINED
+#define SkLayerPool_DEFINED
+
+#include "SkBitmap.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
+
+/**
+ *  Allocator for saveLayer() backing stores.
+ *
+ *  Layers are created and freed on every saveLayer()/restore(), often many times a frame, so
+ *  rather than going back to the heap each time we keep a few recently released buffers around
+ *  and hand them out again by size class. A buffer only returns to the pool when the last ref on
+ *  its pixelref goes away, so layer pixels that are still in use elsewhere are never recycled.
+ *
+ *  Pixels are cleared to transparent black unless the bitmap is opaque, in which case they are
+ *  left uninitialized. Thread-safe.
+ */
+class SkLayerPool : public SkBitmap::Allocator {
+public:
+    /** The pool used for all raster layers. */
+    static SkLayerPool* Global();
+
+    /** Creates a pool holding at most maxBuffers buffers, totalling at most maxBytes. */
+    SkLayerPool(int maxBuffers, size_t maxBytes);
+    virtual ~SkLayerPool();
+
+    virtual bool allocPixelRef(SkBitmap*, SkColorTable*) SK_OVERRIDE;
+
+    /** Like allocPixelRef(), but recycled pixels are left as they were, for callers that may
+        overwrite them all anyway.  On success *isClear says whether the pixels are known to be
+        transparent black. */
+    bool allocUnclearedPixelRef(SkBitmap*, bool* isClear);
+
+    /** Free all buffers currently held by the pool. */
+    void purge();
+
+    /** Number of buffers, and their total size in bytes, currently held by the pool. */
+    int countBuffers();
+    size_t getTotalBytes();
+
+private:
+    struct Buffer;
+
+    static void ReleaseProc(void* addr, void* context);
+
+    bool alloc(SkBitmap*, bool clear, bool* isClear);
+    Buffer* removeBuffer(size_t size);
+    void addBuffer(Buffer*);
+
+    SkMutex             fMutex;
+    SkTDArray<Buffer*>  fBuffers;   // most recently released last
+    size_t              fBytes;
+    const int           fMaxBuffers;
+    const size_t        fMaxBytes;
+
+    typedef SkBitmap::Allocator INHERITED;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Sk4x.h"
+#include "SkLinearBBH.h"
+
+SkLinearBBH::SkLinearBBH() : fPaddedCount(0), fBounds(NULL) {}
+
+SkLinearBBH::~SkLinearBBH() {
+    sk_free(fBounds);
+}
+
+void SkLinearBBH::insert(SkAutoTMalloc<SkRect>* boundsArray, int N) {
+    SkASSERT(NULL == fBounds);
+
+    fPaddedCount = SkAlign4(N);
+    fBounds = (SkScalar*)sk_malloc_throw(4 * fPaddedCount * sizeof(SkScalar));
+
+    SkScalar* lefts   = fBounds;
+    SkScalar* tops    = lefts + fPaddedCount;
+    SkScalar* rights  = tops  + fPaddedCount;
+    SkScalar* bottoms = rights + fPaddedCount;
+    for (int i = 0; i < fPaddedCount; i++) {
+        if (i < N && !(*boundsArray)[i].isEmpty()) {
+            const SkRect& bounds = (*boundsArray)[i];
+            lefts[i]   = bounds.fLeft;
+            tops[i]    = bounds.fTop;
+            rights[i]  = bounds.fRight;
+            bottoms[i] = bounds.fBottom;
+        } else {
+            // Like SkRTree, we never return empty bounds.  This inside-out rect fails every test.
+            lefts[i] = tops[i] = SK_ScalarInfinity;
+            rights[i] = bottoms[i] = SK_ScalarNegativeInfinity;
+        }
+    }
+}
+
+void SkLinearBBH::search(const SkRect& query, SkTDArray<unsigned>* results) const {
+    if (query.isEmpty()) {
+        return;
+    }
+
+    const Sk4f queryLeft  (query.fLeft,   query.fLeft,   query.fLeft,   query.fLeft),
+               queryTop   (query.fTop,    query.fTop,    query.fTop,    query.fTop),
+               queryRight (query.fRight,  query.fRight,  query.fRight,  query.fRight),
+               queryBottom(query.fBottom, query.fBottom, query.fBottom, query.fBottom);
+
+    const SkScalar* lefts   = fBounds;
+    const SkScalar* tops    = lefts + fPaddedCount;
+    const SkScalar* rights  = tops  + fPaddedCount;
+    const SkScalar* bottoms = rights + fPaddedCount;
+    for (int i = 0; i < fPaddedCount; i += 4) {
+        // The same strict tests as SkRect::Intersects(), given that neither rect is empty.
+        const Sk4i hit = Sk4f::Load(lefts + i).lessThan(queryRight)
+                 .bitAnd(queryLeft.lessThan(Sk4f::Load(rights + i)))
+                 .bitAnd(Sk4f::Load(tops + i).lessThan(queryBottom))
+                 .bitAnd(queryTop.lessThan(Sk4f::Load(bottoms + i)));
+        if (hit.anyTrue()) {
+            int32_t lanes[4];
+            hit.store(lanes);
+            for (int j = 0; j < 4; j++) {
+                if (lanes[j]) {
+                    results->push(i + j);
+                }
+            }
+        }
+    }
+}
+
+size_t SkLinearBBH::bytesUsed() const {
+    return sizeof(SkLinearBBH) + 4 * fPaddedCount * sizeof(SkScalar);
+}
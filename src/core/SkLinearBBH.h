@@ -0,0 +1,37 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLinearBBH_DEFINED
+#define SkLinearBBH_DEFINED
+
+#include "SkBBoxHierarchy.h"
+
+/**
+ * Subclass of SkBBoxHierarchy that keeps no hierarchy at all: the bounds are stored as four flat
+ * arrays (lefts, tops, rights, bottoms) and search() tests four of them at a time.  For pictures
+ * with up to a few thousand ops this beats walking an R-Tree or tile grid.
+ */
+class SkLinearBBH : public SkBBoxHierarchy {
+public:
+    SkLinearBBH();
+    virtual ~SkLinearBBH();
+
+    virtual void insert(SkAutoTMalloc<SkRect>* boundsArray, int N) SK_OVERRIDE;
+    virtual void search(const SkRect& query, SkTDArray<unsigned>* results) const SK_OVERRIDE;
+    virtual size_t bytesUsed() const SK_OVERRIDE;
+
+private:
+    // The number of ops rounded up to a multiple of 4; the padding never intersects anything.
+    int fPaddedCount;
+
+    // One allocation holding 4 * fPaddedCount scalars: all lefts, then tops, rights, bottoms.
+    SkScalar* fBounds;
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+#endif
@@ -6,6 +6,7 @@
  */
 
 #include "SkMaskCache.h"
+#include "SkThread.h"
 
 #define CHECK_LOCAL(localCache, localName, globalName, ...) \
     ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
@@ -173,3 +174,126 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
     RectsBlurKey key(sigma, style, quality, rects, count);
     return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(RectsBlurRec, (key, mask, data)));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathBlurKeyNamespaceLabel;
+
+static SkIPoint integer_translate(const SkMatrix& srcToDevice) {
+    return SkIPoint::Make(SkScalarFloorToInt(srcToDevice.getTranslateX()),
+                          SkScalarFloorToInt(srcToDevice.getTranslateY()));
+}
+
+struct PathBlurKey : public SkResourceCache::Key {
+public:
+    PathBlurKey(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality, uint32_t genID,
+                SkPath::FillType fillType, SkPaint::Style paintStyle,
+                const SkMatrix& srcToDevice, const SkMatrix& ctm)
+        : fSigma(sigma)
+        , fStyle(style)
+        , fQuality(quality)
+        , fGenID(genID)
+        , fFillType(fillType)
+        , fPaintStyle(paintStyle)
+    {
+        const SkIPoint offset = integer_translate(srcToDevice);
+        fMatrix[0] = srcToDevice.getScaleX();
+        fMatrix[1] = srcToDevice.getSkewX();
+        fMatrix[2] = srcToDevice.getSkewY();
+        fMatrix[3] = srcToDevice.getScaleY();
+        fMatrix[4] = srcToDevice.getTranslateX() - SkIntToScalar(offset.fX);
+        fMatrix[5] = srcToDevice.getTranslateY() - SkIntToScalar(offset.fY);
+        fCTM[0] = ctm.getScaleX();
+        fCTM[1] = ctm.getSkewX();
+        fCTM[2] = ctm.getSkewY();
+        fCTM[3] = ctm.getScaleY();
+        this->init(&gPathBlurKeyNamespaceLabel,
+                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fQuality) + sizeof(fGenID) +
+                   sizeof(fFillType) + sizeof(fPaintStyle) + sizeof(fMatrix) + sizeof(fCTM));
+    }
+
+    SkScalar    fSigma;
+    int32_t     fStyle;
+    int32_t     fQuality;
+    uint32_t    fGenID;
+    int32_t     fFillType;
+    int32_t     fPaintStyle;
+    SkScalar    fMatrix[6];
+    SkScalar    fCTM[4];
+};
+
+struct PathBlurRec : public SkResourceCache::Rec {
+    PathBlurRec(PathBlurKey key, const SkMask& mask, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathBlurRec() {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathBlurKey    fKey;
+    MaskValue      fValue;
+
+    virtual const Key& getKey() const SK_OVERRIDE { return fKey; }
+    virtual size_t bytesUsed() const SK_OVERRIDE { return sizeof(*this) + fValue.fData->size(); }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathBlurRec& rec = static_cast<const PathBlurRec&>(baseRec);
+        MaskValue* result = (MaskValue*)contextData;
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (NULL == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+
+static int32_t gPathHits;
+static int32_t gPathMisses;
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                      uint32_t pathGenID, SkPath::FillType fillType,
+                                      SkPaint::Style paintStyle, const SkMatrix& srcToDevice,
+                                      const SkMatrix& ctm, SkMask* mask,
+                                      SkResourceCache* localCache) {
+    MaskValue result;
+    PathBlurKey key(sigma, style, quality, pathGenID, fillType, paintStyle, srcToDevice, ctm);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathBlurRec::Visitor, &result)) {
+        sk_atomic_inc(&gPathMisses);
+        return NULL;
+    }
+    sk_atomic_inc(&gPathHits);
+
+    const SkIPoint offset = integer_translate(srcToDevice);
+    *mask = result.fMask;
+    mask->fBounds.offset(offset.fX, offset.fY);
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                      uint32_t pathGenID, SkPath::FillType fillType, SkPaint::Style paintStyle,
+                      const SkMatrix& srcToDevice, const SkMatrix& ctm, const SkMask& mask,
+                      SkCachedData* data, SkResourceCache* localCache) {
+    PathBlurKey key(sigma, style, quality, pathGenID, fillType, paintStyle, srcToDevice, ctm);
+    const SkIPoint offset = integer_translate(srcToDevice);
+    SkMask relativeMask = mask;
+    relativeMask.fBounds.offset(-offset.fX, -offset.fY);
+    return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(PathBlurRec, (key, relativeMask, data)));
+}
+
+SkMaskCache::PathStats SkMaskCache::GetPathStats() {
+    PathStats stats;
+    stats.fHits = sk_acquire_load(&gPathHits);
+    stats.fMisses = sk_acquire_load(&gPathMisses);
+    return stats;
+}
@@ -11,6 +11,9 @@
 #include "SkBlurTypes.h"
 #include "SkCachedData.h"
 #include "SkMask.h"
+#include "SkMatrix.h"
+#include "SkPaint.h"
+#include "SkPath.h"
 #include "SkRect.h"
 #include "SkResourceCache.h"
 #include "SkRRect.h"
@@ -39,6 +42,31 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = NULL);
+
+    /**
+     * Blurred masks of arbitrary paths, keyed by the genID of the path before it was mapped to
+     * device space by srcToDevice, and by the ctm the blur sigma is mapped through. Only the
+     * fractional part of srcToDevice's translation is part of the key: the mask bounds are
+     * offset by its integer part, so the same shadow drawn at another pixel position hits.
+     */
+    static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                    uint32_t pathGenID, SkPath::FillType fillType,
+                                    SkPaint::Style paintStyle, const SkMatrix& srcToDevice,
+                                    const SkMatrix& ctm, SkMask* mask,
+                                    SkResourceCache* localCache = NULL);
+    static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                    uint32_t pathGenID, SkPath::FillType fillType, SkPaint::Style paintStyle,
+                    const SkMatrix& srcToDevice, const SkMatrix& ctm, const SkMask& mask,
+                    SkCachedData* data, SkResourceCache* localCache = NULL);
+
+    struct PathStats {
+        int32_t fHits;
+        int32_t fMisses;
+    };
+    /**
+     * Returns the number of path mask lookups that hit and missed since startup.
+     */
+    static PathStats GetPathStats();
 };
 
 #endif
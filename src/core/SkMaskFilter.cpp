@@ -9,7 +9,9 @@
 
 #include "SkMaskFilter.h"
 #include "SkBlitter.h"
+#include "SkCachedData.h"
 #include "SkDraw.h"
+#include "SkMaskCache.h"
 #include "SkRasterClip.h"
 #include "SkRRect.h"
 #include "SkTypes.h"
@@ -223,14 +225,29 @@ bool SkMaskFilter::filterRRect(const SkRRect& devRRect, const SkMatrix& matrix,
     return true;
 }
 
+// Blurred masks larger than this are not cached: they are rarely repeated, and would evict
+// many of the small shadows that are.
+static const size_t kMaxCachedPathMaskBytes = 256 * 1024;
+
 bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
                               const SkRasterClip& clip, SkBlitter* blitter,
-                              SkPaint::Style style) const {
+                              SkPaint::Style style, uint32_t srcGenID,
+                              const SkMatrix* srcToDevice) const {
     SkRect rects[2];
     int rectCount = 0;
     if (SkPaint::kFill_Style == style) {
         rectCount = countNestedRects(devPath, rects);
     }
+    if (1 == rectCount && !devPath.isInverseFillType()) {
+        switch (this->filterRectToBlitter(rects[0], matrix, clip, blitter)) {
+            case kFalse_FilterReturn:
+                return false;
+            case kTrue_FilterReturn:
+                return true;
+            case kUnimplemented_FilterReturn:
+                break;
+        }
+    }
     if (rectCount > 0) {
         NinePatch patch;
 
@@ -254,19 +271,49 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
         }
     }
 
-    SkMask  srcM, dstM;
-
-    if (!SkDraw::DrawToMask(devPath, &clip.getBounds(), this, &matrix, &srcM,
-                            SkMask::kComputeBoundsAndRenderImage_CreateMode,
-                            style)) {
-        return false;
+    // Blurs of persistent paths are cached by the path's genID, so that repeated shadows are a
+    // single mask blit. Those masks are rendered unclipped, so they can be reused under any clip.
+    BlurRec blurRec;
+    const SkRect& devBounds = devPath.getBounds();
+    const bool cacheable = 0 != srcGenID && srcToDevice && !srcToDevice->hasPerspective() &&
+                           !devPath.isInverseFillType() &&
+                           devBounds.width() * devBounds.height() <= kMaxCachedPathMaskBytes &&
+                           this->asABlur(&blurRec);
+
+    SkMask  dstM;
+    SkAutoTUnref<SkCachedData> cachedData;
+    if (cacheable) {
+        cachedData.reset(SkMaskCache::FindAndRef(blurRec.fSigma, blurRec.fStyle, blurRec.fQuality,
+                                                 srcGenID, devPath.getFillType(), style,
+                                                 *srcToDevice, matrix, &dstM));
     }
-    SkAutoMaskFreeImage autoSrc(srcM.fImage);
+    if (NULL == cachedData.get()) {
+        SkMask  srcM;
+        if (!SkDraw::DrawToMask(devPath, cacheable ? NULL : &clip.getBounds(), this, &matrix,
+                                &srcM, SkMask::kComputeBoundsAndRenderImage_CreateMode,
+                                style)) {
+            return false;
+        }
+        SkAutoMaskFreeImage autoSrc(srcM.fImage);
 
-    if (!this->filterMask(&dstM, srcM, matrix, NULL)) {
-        return false;
+        if (!this->filterMask(&dstM, srcM, matrix, NULL)) {
+            return false;
+        }
+
+        const size_t size = dstM.computeTotalImageSize();
+        if (cacheable && size <= kMaxCachedPathMaskBytes) {
+            cachedData.reset(SkResourceCache::NewCachedData(size));
+            if (cachedData.get()) {
+                memcpy(cachedData->writable_data(), dstM.fImage, size);
+                SkMask::FreeImage(dstM.fImage);
+                dstM.fImage = (uint8_t*)cachedData->writable_data();
+                SkMaskCache::Add(blurRec.fSigma, blurRec.fStyle, blurRec.fQuality, srcGenID,
+                                 devPath.getFillType(), style, *srcToDevice, matrix, dstM,
+                                 cachedData);
+            }
+        }
     }
-    SkAutoMaskFreeImage autoDst(dstM.fImage);
+    SkAutoMaskFreeImage autoDst(cachedData.get() ? NULL : dstM.fImage);
 
     // if we get here, we need to (possibly) resolve the clip and blitter
     SkAAClipBlitterWrapper wrapper(clip, blitter);
@@ -285,6 +332,12 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
     return true;
 }
 
+SkMaskFilter::FilterReturn
+SkMaskFilter::filterRectToBlitter(const SkRect&, const SkMatrix&,
+                                  const SkRasterClip&, SkBlitter*) const {
+    return kUnimplemented_FilterReturn;
+}
+
 SkMaskFilter::FilterReturn
 SkMaskFilter::filterRRectToNine(const SkRRect&, const SkMatrix&,
                                 const SkIRect& clipBounds, NinePatch*) const {
@@ -6,6 +6,7 @@
  */
 
 #include "SkMatrix.h"
+#include "Sk4x.h"
 #include "SkFloatBits.h"
 #include "SkString.h"
 
@@ -843,6 +844,10 @@ void SkMatrix::Identity_pts(const SkMatrix& m, SkPoint dst[],
         memcpy(dst, src, count * sizeof(SkPoint));
 }
 
+// The point mappers below handle two SkPoints per Sk4f, laid out as (x0, y0, x1, y1),
+// and finish any odd point with the scalar code.  The vector paths perform the same
+// operations in the same order as the scalar ones, so the results are bit-identical.
+
 void SkMatrix::Trans_pts(const SkMatrix& m, SkPoint dst[],
                          const SkPoint src[], int count) {
     SkASSERT(m.getType() == kTranslate_Mask);
@@ -850,12 +855,16 @@ void SkMatrix::Trans_pts(const SkMatrix& m, SkPoint dst[],
     if (count > 0) {
         SkScalar tx = m.fMat[kMTransX];
         SkScalar ty = m.fMat[kMTransY];
-        do {
+        const Sk4f trans(tx, ty, tx, ty);
+        for (int n = count >> 1; n > 0; --n) {
+            Sk4f::Load(&src->fX).add(trans).store(&dst->fX);
+            src += 2;
+            dst += 2;
+        }
+        if (count & 1) {
             dst->fY = src->fY + ty;
             dst->fX = src->fX + tx;
-            src += 1;
-            dst += 1;
-        } while (--count);
+        }
     }
 }
 
@@ -866,12 +875,16 @@ void SkMatrix::Scale_pts(const SkMatrix& m, SkPoint dst[],
     if (count > 0) {
         SkScalar mx = m.fMat[kMScaleX];
         SkScalar my = m.fMat[kMScaleY];
-        do {
+        const Sk4f scale(mx, my, mx, my);
+        for (int n = count >> 1; n > 0; --n) {
+            Sk4f::Load(&src->fX).multiply(scale).store(&dst->fX);
+            src += 2;
+            dst += 2;
+        }
+        if (count & 1) {
             dst->fY = src->fY * my;
             dst->fX = src->fX * mx;
-            src += 1;
-            dst += 1;
-        } while (--count);
+        }
     }
 }
 
@@ -884,15 +897,32 @@ void SkMatrix::ScaleTrans_pts(const SkMatrix& m, SkPoint dst[],
         SkScalar my = m.fMat[kMScaleY];
         SkScalar tx = m.fMat[kMTransX];
         SkScalar ty = m.fMat[kMTransY];
-        do {
+        const Sk4f scale(mx, my, mx, my);
+        const Sk4f trans(tx, ty, tx, ty);
+        for (int n = count >> 1; n > 0; --n) {
+            Sk4f::Load(&src->fX).multiply(scale).add(trans).store(&dst->fX);
+            src += 2;
+            dst += 2;
+        }
+        if (count & 1) {
             dst->fY = src->fY * my + ty;
             dst->fX = src->fX * mx + tx;
-            src += 1;
-            dst += 1;
-        } while (--count);
+        }
     }
 }
 
+// For two points xy = (x0, y0, x1, y1), the affine mappers below split the work into
+// xy.xxzz() * (sx, ky, sx, ky) and xy.yyww() * (kx, sy, kx, sy), so both lanes of a point
+// sum their terms in the same order the scalar code does.
+static inline Sk4f affine_map(const Sk4f& xx, const Sk4f& yy,
+                              const Sk4f& colX, const Sk4f& colY, const Sk4f& trans) {
+#ifdef SK_LEGACY_MATRIX_MATH_ORDER
+    return xx.multiply(colX).add(yy.multiply(colY).add(trans));
+#else
+    return xx.multiply(colX).add(yy.multiply(colY)).add(trans);
+#endif
+}
+
 void SkMatrix::Rot_pts(const SkMatrix& m, SkPoint dst[],
                        const SkPoint src[], int count) {
     SkASSERT((m.getType() & (kPerspective_Mask | kTranslate_Mask)) == 0);
@@ -902,14 +932,20 @@ void SkMatrix::Rot_pts(const SkMatrix& m, SkPoint dst[],
         SkScalar my = m.fMat[kMScaleY];
         SkScalar kx = m.fMat[kMSkewX];
         SkScalar ky = m.fMat[kMSkewY];
-        do {
+        const Sk4f colX(mx, ky, mx, ky);
+        const Sk4f colY(kx, my, kx, my);
+        for (int n = count >> 1; n > 0; --n) {
+            Sk4f xy = Sk4f::Load(&src->fX);
+            xy.xxzz().multiply(colX).add(xy.yyww().multiply(colY)).store(&dst->fX);
+            src += 2;
+            dst += 2;
+        }
+        if (count & 1) {
             SkScalar sy = src->fY;
             SkScalar sx = src->fX;
-            src += 1;
             dst->fY = sdot(sx, ky, sy, my);
             dst->fX = sdot(sx, mx, sy, kx);
-            dst += 1;
-        } while (--count);
+        }
     }
 }
 
@@ -924,10 +960,18 @@ void SkMatrix::RotTrans_pts(const SkMatrix& m, SkPoint dst[],
         SkScalar ky = m.fMat[kMSkewY];
         SkScalar tx = m.fMat[kMTransX];
         SkScalar ty = m.fMat[kMTransY];
-        do {
+        const Sk4f colX(mx, ky, mx, ky);
+        const Sk4f colY(kx, my, kx, my);
+        const Sk4f trans(tx, ty, tx, ty);
+        for (int n = count >> 1; n > 0; --n) {
+            Sk4f xy = Sk4f::Load(&src->fX);
+            affine_map(xy.xxzz(), xy.yyww(), colX, colY, trans).store(&dst->fX);
+            src += 2;
+            dst += 2;
+        }
+        if (count & 1) {
             SkScalar sy = src->fY;
             SkScalar sx = src->fX;
-            src += 1;
 #ifdef SK_LEGACY_MATRIX_MATH_ORDER
             dst->fY = sx * ky + (sy * my + ty);
             dst->fX = sx * mx + (sy * kx + tx);
@@ -935,8 +979,7 @@ void SkMatrix::RotTrans_pts(const SkMatrix& m, SkPoint dst[],
             dst->fY = sdot(sx, ky, sy, my) + ty;
             dst->fX = sdot(sx, mx, sy, kx) + tx;
 #endif
-            dst += 1;
-        } while (--count);
+        }
     }
 }
 
@@ -945,10 +988,35 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
     SkASSERT(m.hasPerspective());
 
     if (count > 0) {
-        do {
+        const SkScalar* mat = m.fMat;
+        const Sk4f colX(mat[kMScaleX], mat[kMSkewY],  mat[kMScaleX], mat[kMSkewY]);
+        const Sk4f colY(mat[kMSkewX],  mat[kMScaleY], mat[kMSkewX],  mat[kMScaleY]);
+        const Sk4f trans(mat[kMTransX], mat[kMTransY], mat[kMTransX], mat[kMTransY]);
+        const Sk4f p0(mat[kMPersp0], mat[kMPersp0], mat[kMPersp0], mat[kMPersp0]);
+        const Sk4f p1(mat[kMPersp1], mat[kMPersp1], mat[kMPersp1], mat[kMPersp1]);
+        const Sk4f p2(mat[kMPersp2], mat[kMPersp2], mat[kMPersp2], mat[kMPersp2]);
+        const Sk4f zero(0, 0, 0, 0);
+        const Sk4f one(1, 1, 1, 1);
+        for (int n = count >> 1; n > 0; --n) {
+            Sk4f xy = Sk4f::Load(&src->fX);
+            Sk4f xx = xy.xxzz();
+            Sk4f yy = xy.yyww();
+
+            Sk4f mapped = xx.multiply(colX).add(yy.multiply(colY)).add(trans);
+            // Each point's z lands in both of its lanes.
+            Sk4f z = affine_map(xx, yy, p0, p1, p2);
+
+            // Like the scalar code, a zero z maps the point to (0, 0) instead of dividing.
+            Sk4f invZ = one.divide(z);
+            invZ = z.equal(zero).bitNot().bitAnd(invZ.reinterpret<Sk4i>()).reinterpret<Sk4f>();
+
+            mapped.multiply(invZ).store(&dst->fX);
+            src += 2;
+            dst += 2;
+        }
+        if (count & 1) {
             SkScalar sy = src->fY;
             SkScalar sx = src->fX;
-            src += 1;
 
             SkScalar x = sdot(sx, m.fMat[kMScaleX], sy, m.fMat[kMSkewX])  + m.fMat[kMTransX];
             SkScalar y = sdot(sx, m.fMat[kMSkewY],  sy, m.fMat[kMScaleY]) + m.fMat[kMTransY];
@@ -963,8 +1031,7 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
 
             dst->fY = y * z;
             dst->fX = x * z;
-            dst += 1;
-        } while (--count);
+        }
     }
 }
 
@@ -1042,6 +1109,58 @@ void SkMatrix::mapVectors(SkPoint dst[], const SkPoint src[], int count) const {
     }
 }
 
+namespace {
+
+// Computes the bounds of an affine-mapped rect without forming its four corners.  Each mapped
+// coordinate sums one term per source axis plus translate, and rounding is monotonic, so the
+// extreme corner is the sum of the per-term extremes.  This matches mapping the corners with
+// RotTrans_pts and calling SkRect::set().
+class AffineRectMapper {
+public:
+    AffineRectMapper(const SkScalar mat[9])
+        : fColX(mat[SkMatrix::kMScaleX], mat[SkMatrix::kMSkewY],
+                mat[SkMatrix::kMScaleX], mat[SkMatrix::kMSkewY])
+        , fColY(mat[SkMatrix::kMSkewX], mat[SkMatrix::kMScaleY],
+                mat[SkMatrix::kMSkewX], mat[SkMatrix::kMScaleY])
+        , fTrans(mat[SkMatrix::kMTransX], mat[SkMatrix::kMTransY],
+                 mat[SkMatrix::kMTransX], mat[SkMatrix::kMTransY]) {}
+
+    void map(SkRect* dst, const SkRect& src) const {
+        const Sk4f zero(0, 0, 0, 0);
+        Sk4f ltrb = Sk4f::Load(&src.fLeft);
+
+        // (L*sx, L*ky, R*sx, R*ky) and (T*kx, T*sy, B*kx, B*sy)
+        Sk4f a = ltrb.xxzz().multiply(fColX);
+        Sk4f b = ltrb.yyww().multiply(fColY);
+
+        Sk4f lo = SumTerms(Sk4f::Min(a, a.zwxy()), Sk4f::Min(b, b.zwxy()), fTrans);
+        Sk4f hi = SumTerms(Sk4f::Max(a, a.zwxy()), Sk4f::Max(b, b.zwxy()), fTrans);
+
+        // Min and Max drop NaNs, so check the products as well as the sums.  Like
+        // SkRect::set(), any non-finite corner yields an empty rect.
+        Sk4f accum = a.multiply(zero).add(b.multiply(zero))
+                      .add(lo.multiply(zero)).add(hi.multiply(zero));
+        if (accum.equal(zero).allTrue()) {
+            Sk4f::XYAB(lo, hi).store(&dst->fLeft);
+        } else {
+            dst->setEmpty();
+        }
+    }
+
+private:
+    static Sk4f SumTerms(const Sk4f& a, const Sk4f& b, const Sk4f& trans) {
+#ifdef SK_LEGACY_MATRIX_MATH_ORDER
+        return a.add(b.add(trans));
+#else
+        return a.add(b).add(trans);
+#endif
+    }
+
+    Sk4f fColX, fColY, fTrans;
+};
+
+}  // namespace
+
 bool SkMatrix::mapRect(SkRect* dst, const SkRect& src) const {
     SkASSERT(dst);
 
@@ -1049,6 +1168,9 @@ bool SkMatrix::mapRect(SkRect* dst, const SkRect& src) const {
         this->mapPoints((SkPoint*)dst, (const SkPoint*)&src, 2);
         dst->sort();
         return true;
+    } else if (!this->hasPerspective()) {
+        AffineRectMapper(fMat).map(dst, src);
+        return false;
     } else {
         SkPoint quad[4];
 
@@ -1059,6 +1181,28 @@ bool SkMatrix::mapRect(SkRect* dst, const SkRect& src) const {
     }
 }
 
+void SkMatrix::mapRects(SkRect dst[], const SkRect src[], int count) const {
+    SkASSERT((dst && src && count > 0) || 0 == count);
+    // no partial overlap
+    SkASSERT(src == dst || &dst[count] <= &src[0] || &src[count] <= &dst[0]);
+
+    if (this->rectStaysRect()) {
+        this->mapPoints((SkPoint*)dst, (const SkPoint*)src, count << 1);
+        for (int i = 0; i < count; ++i) {
+            dst[i].sort();
+        }
+    } else if (!this->hasPerspective()) {
+        AffineRectMapper mapper(fMat);
+        for (int i = 0; i < count; ++i) {
+            mapper.map(&dst[i], src[i]);
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            this->mapRect(&dst[i], src[i]);
+        }
+    }
+}
+
 SkScalar SkMatrix::mapRadius(SkScalar radius) const {
     SkVector    vec[2];
 
@@ -421,19 +421,25 @@ SkPoint* SkPathRef::growForVerb(int /* SkPath::Verb*/ verb, SkScalar weight) {
 uint32_t SkPathRef::genID() const {
     SkASSERT(!fEditorsAttached);
     static const uint32_t kMask = (static_cast<int64_t>(1) << SkPath::kPathRefGenIDBitCnt) - 1;
-    if (!fGenerationID) {
+    // A path ref may be drawn (and so asked for its ID) on several threads at once, e.g. when a
+    // picture is played back in tiles, so only the first ID assigned may be returned.
+    uint32_t genID = sk_acquire_load(&fGenerationID);
+    if (!genID) {
         if (0 == fPointCnt && 0 == fVerbCnt) {
-            fGenerationID = kEmptyGenID;
+            genID = kEmptyGenID;
         } else {
             static int32_t  gPathRefGenerationID;
             // do a loop in case our global wraps around, as we never want to return a 0 or the
             // empty ID
             do {
-                fGenerationID = (sk_atomic_inc(&gPathRefGenerationID) + 1) & kMask;
-            } while (fGenerationID <= kEmptyGenID);
+                genID = (sk_atomic_inc(&gPathRefGenerationID) + 1) & kMask;
+            } while (genID <= kEmptyGenID);
+        }
+        if (!sk_atomic_cas(reinterpret_cast<int32_t*>(&fGenerationID), 0, (int32_t)genID)) {
+            genID = sk_acquire_load(&fGenerationID);
         }
     }
-    return fGenerationID;
+    return genID;
 }
 
 #ifdef SK_DEBUG
@@ -57,6 +57,7 @@ SkPicture* SkPictureRecorder::endRecordingAsPicture() {
     if (fBBH.get()) {
         if (saveLayerData) {
             SkRecordComputeLayers(fCullRect, *fRecord, pictList, fBBH.get(), saveLayerData);
+            SkRecordTightenLayerBounds(fRecord, *saveLayerData);
         } else {
             SkRecordFillBounds(fCullRect, *fRecord, fBBH.get());
         }
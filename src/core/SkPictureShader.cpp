@@ -14,6 +14,9 @@
 #include "SkPicture.h"
 #include "SkReadBuffer.h"
 #include "SkResourceCache.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+#include "SkThread.h"
 
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -89,18 +92,165 @@ static bool cache_try_alloc_pixels(SkBitmap* bitmap) {
         : bitmap->tryAllocPixels();
 }
 
+// Tiles are rendered at scales quantized to powers of sqrt(2), so that a continuously changing
+// matrix (e.g. pinch-zoom) reuses a handful of tiles instead of rasterizing one per frame.
+// The bucket is rounded up so a tile is never magnified by more than the requested scale.
+static int scale_to_bucket(SkScalar scale) {
+    // The slop keeps exact powers of two (and in particular 1) from spilling into the next
+    // bucket through rounding error.
+    static const SkScalar kBucketSlop = 1.0f / 1024;
+    return SkScalarCeilToInt(2 * SkScalarLog(scale) / SkScalarLog(2) - kBucketSlop);
+}
+
+static SkScalar bucket_to_scale(int bucket) {
+    return SkScalarPow(2, SkScalarHalf(SkIntToScalar(bucket)));
+}
+
+// Computes the pixel size of the tile rendered at the given scale buckets, and the actual scale
+// that results from rounding & clamping it. Returns false if the tile is empty.
+static bool bucket_tile(const SkRect& tile, int bucketX, int bucketY,
+                        SkISize* tileSize, SkSize* tileScale) {
+    SkSize scaledSize = SkSize::Make(bucket_to_scale(bucketX) * tile.width(),
+                                     bucket_to_scale(bucketY) * tile.height());
+
+    // Clamp the tile size to about 16M pixels
+    static const SkScalar kMaxTileArea = 4096 * 4096;
+    SkScalar tileArea = SkScalarMul(scaledSize.width(), scaledSize.height());
+    if (tileArea > kMaxTileArea) {
+        SkScalar clampScale = SkScalarSqrt(SkScalarDiv(kMaxTileArea, tileArea));
+        scaledSize.set(SkScalarMul(scaledSize.width(), clampScale),
+                       SkScalarMul(scaledSize.height(), clampScale));
+    }
+
+    *tileSize = scaledSize.toRound();
+    if (tileSize->isEmpty()) {
+        return false;
+    }
+
+    // The actual scale, compensating for rounding & clamping.
+    tileScale->set(SkIntToScalar(tileSize->width()) / tile.width(),
+                   SkIntToScalar(tileSize->height()) / tile.height());
+    return true;
+}
+
+// Rasterizes the picture tile, wraps it in a bitmap shader and adds that to the cache.
+static SkShader* render_tile_shader(const SkPicture* picture, const SkRect& tile,
+                                    SkShader::TileMode tmx, SkShader::TileMode tmy,
+                                    const SkMatrix& localMatrix, const SkISize& tileSize,
+                                    const SkSize& tileScale, const BitmapShaderKey& key) {
+    SkBitmap bm;
+    bm.setInfo(SkImageInfo::MakeN32Premul(tileSize));
+    if (!cache_try_alloc_pixels(&bm)) {
+        return NULL;
+    }
+    bm.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(bm);
+    canvas.scale(tileScale.width(), tileScale.height());
+    canvas.translate(tile.x(), tile.y());
+    canvas.drawPicture(picture);
+
+    SkMatrix shaderMatrix = localMatrix;
+    shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
+    SkShader* tileShader = SkShader::CreateBitmapShader(bm, tmx, tmy, &shaderMatrix);
+
+    SkResourceCache::Add(SkNEW_ARGS(BitmapShaderRec, (key, tileShader, bm.getSize())));
+    return tileShader;
+}
+
 } // namespace
 
+// The tiles one shader is rendering in the background, so each one is only scheduled once.
+// Destroying it waits for them, so none of them outlives the shader that scheduled it.
+class SkPictureShader::PendingTiles {
+public:
+    ~PendingTiles() {
+        fTasks.wait();
+    }
+
+    // Starts rendering the tile for key unless it's already being rendered.
+    void render(const BitmapShaderKey& key, const SkPicture* picture, const SkRect& tile,
+                SkShader::TileMode tmx, SkShader::TileMode tmy, const SkMatrix& localMatrix,
+                const SkISize& tileSize, const SkSize& tileScale) {
+        if (this->tryAdd(key)) {
+            fTasks.add(&Task::Run, SkNEW_ARGS(Task, (this, key, picture, tile, tmx, tmy,
+                                                     localMatrix, tileSize, tileScale)));
+        }
+    }
+
+private:
+    struct Task {
+        Task(PendingTiles* owner, const BitmapShaderKey& key, const SkPicture* picture,
+             const SkRect& tile, SkShader::TileMode tmx, SkShader::TileMode tmy,
+             const SkMatrix& localMatrix, const SkISize& tileSize, const SkSize& tileScale)
+            : fOwner(owner)
+            , fKey(key)
+            , fPicture(SkRef(picture))
+            , fTile(tile)
+            , fTmx(tmx)
+            , fTmy(tmy)
+            , fLocalMatrix(localMatrix)
+            , fTileSize(tileSize)
+            , fTileScale(tileScale) {}
+
+        static void Run(Task* task) {
+            SkSafeUnref(render_tile_shader(task->fPicture, task->fTile, task->fTmx, task->fTmy,
+                                           task->fLocalMatrix, task->fTileSize, task->fTileScale,
+                                           task->fKey));
+            task->fOwner->remove(task->fKey);
+            SkDELETE(task);
+        }
+
+        PendingTiles*                 fOwner;
+        BitmapShaderKey               fKey;
+        SkAutoTUnref<const SkPicture> fPicture;
+        SkRect                        fTile;
+        SkShader::TileMode            fTmx, fTmy;
+        SkMatrix                      fLocalMatrix;
+        SkISize                       fTileSize;
+        SkSize                        fTileScale;
+    };
+
+    // Returns false if the tile for this key is already scheduled.
+    bool tryAdd(const BitmapShaderKey& key) {
+        SkAutoMutexAcquire lock(fMutex);
+        for (int i = 0; i < fKeys.count(); ++i) {
+            if (fKeys[i] == key) {
+                return false;
+            }
+        }
+        *fKeys.append() = key;
+        return true;
+    }
+
+    void remove(const BitmapShaderKey& key) {
+        SkAutoMutexAcquire lock(fMutex);
+        for (int i = 0; i < fKeys.count(); ++i) {
+            if (fKeys[i] == key) {
+                fKeys.removeShuffle(i);
+                return;
+            }
+        }
+    }
+
+    SkMutex                    fMutex;
+    SkTDArray<BitmapShaderKey> fKeys;
+    SkTaskGroup                fTasks;
+};
+
 SkPictureShader::SkPictureShader(const SkPicture* picture, TileMode tmx, TileMode tmy,
                                  const SkMatrix* localMatrix, const SkRect* tile)
     : INHERITED(localMatrix)
     , fPicture(SkRef(picture))
     , fTile(tile ? *tile : picture->cullRect())
     , fTmx(tmx)
-    , fTmy(tmy) {
+    , fTmy(tmy)
+    , fPendingTiles(SkNEW(PendingTiles)) {
 }
 
 SkPictureShader::~SkPictureShader() {
+    // Waits for the tiles still rendering in the background.
+    fPendingTiles.free();
     fPicture->unref();
 }
 
@@ -147,26 +297,18 @@ SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatri
         scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
                   SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
     }
-    SkSize scaledSize = SkSize::Make(scale.x() * fTile.width(), scale.y() * fTile.height());
-
-    // Clamp the tile size to about 16M pixels
-    static const SkScalar kMaxTileArea = 4096 * 4096;
-    SkScalar tileArea = SkScalarMul(scaledSize.width(), scaledSize.height());
-    if (tileArea > kMaxTileArea) {
-        SkScalar clampScale = SkScalarSqrt(SkScalarDiv(kMaxTileArea, tileArea));
-        scaledSize.set(SkScalarMul(scaledSize.width(), clampScale),
-                       SkScalarMul(scaledSize.height(), clampScale));
+    if (!(scale.x() > 0 && scale.y() > 0 && SkScalarIsFinite(scale.x() + scale.y()))) {
+        return NULL;
     }
+    const int bucketX = scale_to_bucket(scale.x());
+    const int bucketY = scale_to_bucket(scale.y());
 
-    SkISize tileSize = scaledSize.toRound();
-    if (tileSize.isEmpty()) {
+    SkISize tileSize;
+    SkSize tileScale;
+    if (!bucket_tile(fTile, bucketX, bucketY, &tileSize, &tileScale)) {
         return NULL;
     }
 
-    // The actual scale, compensating for rounding & clamping.
-    SkSize tileScale = SkSize::Make(SkIntToScalar(tileSize.width()) / fTile.width(),
-                                    SkIntToScalar(tileSize.height()) / fTile.height());
-
     SkAutoTUnref<SkShader> tileShader;
     BitmapShaderKey key(fPicture->uniqueID(),
                         fTile,
@@ -175,27 +317,40 @@ SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatri
                         tileScale,
                         this->getLocalMatrix());
 
-    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
-        SkBitmap bm;
-        bm.setInfo(SkImageInfo::MakeN32Premul(tileSize));
-        if (!cache_try_alloc_pixels(&bm)) {
-            return NULL;
-        }
-        bm.eraseColor(SK_ColorTRANSPARENT);
-
-        SkCanvas canvas(bm);
-        canvas.scale(tileScale.width(), tileScale.height());
-        canvas.translate(fTile.x(), fTile.y());
-        canvas.drawPicture(fPicture);
-
-        SkMatrix shaderMatrix = this->getLocalMatrix();
-        shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
-        tileShader.reset(CreateBitmapShader(bm, fTmx, fTmy, &shaderMatrix));
+    if (SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+        return tileShader.detach();
+    }
 
-        SkResourceCache::Add(SkNEW_ARGS(BitmapShaderRec, (key, tileShader.get(), bm.getSize())));
+    // If a tile from a nearby bucket is cached, draw with it while the right one is rendered in
+    // the background. Larger (sharper) tiles are preferred.
+    static const int kNearbyBuckets[] = { 1, -1, 2, -2 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kNearbyBuckets); ++i) {
+        SkISize nearbySize;
+        SkSize nearbyScale;
+        if (!bucket_tile(fTile, bucketX + kNearbyBuckets[i], bucketY + kNearbyBuckets[i],
+                         &nearbySize, &nearbyScale)) {
+            continue;
+        }
+        BitmapShaderKey nearbyKey(fPicture->uniqueID(),
+                                  fTile,
+                                  fTmx,
+                                  fTmy,
+                                  nearbyScale,
+                                  this->getLocalMatrix());
+        if (SkResourceCache::Find(nearbyKey, BitmapShaderRec::Visitor, &tileShader)) {
+            fPendingTiles->render(key, fPicture, fTile, fTmx, fTmy, this->getLocalMatrix(),
+                                  tileSize, tileScale);
+            // Without a thread pool the task has already run, so the right tile is available.
+            SkAutoTUnref<SkShader> exactShader;
+            if (SkResourceCache::Find(key, BitmapShaderRec::Visitor, &exactShader)) {
+                return exactShader.detach();
+            }
+            return tileShader.detach();
+        }
     }
 
-    return tileShader.detach();
+    return render_tile_shader(fPicture, fTile, fTmx, fTmy, this->getLocalMatrix(),
+                              tileSize, tileScale, key);
 }
 
 size_t SkPictureShader::contextSize() const {
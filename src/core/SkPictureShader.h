@@ -9,6 +9,7 @@
 #define SkPictureShader_DEFINED
 
 #include "SkShader.h"
+#include "SkTemplates.h"
 
 class SkBitmap;
 class SkPicture;
@@ -43,9 +44,12 @@ private:
 
     SkShader* refBitmapShader(const SkMatrix&, const SkMatrix* localMatrix) const;
 
-    const SkPicture* fPicture;
-    SkRect           fTile;
-    TileMode         fTmx, fTmy;
+    class PendingTiles;
+
+    const SkPicture*            fPicture;
+    SkRect                      fTile;
+    TileMode                    fTmx, fTmy;
+    SkAutoTDelete<PendingTiles> fPendingTiles;
 
     class PictureShaderContext : public SkShader::Context {
     public:
@@ -6,6 +6,7 @@
  */
 
 #include "SkRasterClip.h"
+#include "SkAAClipCache.h"
 #include "SkPath.h"
 
 SkRasterClip::SkRasterClip(const SkRasterClip& src) {
@@ -156,7 +157,7 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA)
         if (this->isBW()) {
             this->convertToAA();
         }
-        (void)fAA.setPath(path, &clip, doAA);
+        (void)SkAAClipCache::SetPath(&fAA, path, clip, doAA);
     }
     return this->updateCacheAndReturnNonEmpty();
 }
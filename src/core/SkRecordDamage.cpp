@@ -0,0 +1,303 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRecordDamage.h"
+#include "SkPatchUtils.h"
+#include "SkRecordDraw.h"
+#include "SkRecords.h"
+
+// The damage is kept to a few rectangles: each one costs a (culled) playback of the picture.
+static const int kMaxDamageRects = 8;
+
+namespace {
+
+// Not really a hierarchy: SkRecordFillBounds() hands us the bounds of every op, and we keep them.
+class OpBounds : public SkBBoxHierarchy {
+public:
+    OpBounds() : fBounds(NULL), fCount(0) {}
+    virtual ~OpBounds() { sk_free(fBounds); }
+
+    virtual void insert(SkAutoTMalloc<SkRect>* boundsArray, int N) SK_OVERRIDE {
+        sk_free(fBounds);
+        fBounds = boundsArray->detach();
+        fCount = N;
+    }
+
+    virtual void search(const SkRect& query, SkTDArray<unsigned>* results) const SK_OVERRIDE {
+        for (int i = 0; i < fCount; ++i) {
+            if (SkRect::Intersects(fBounds[i], query)) {
+                *results->append() = i;
+            }
+        }
+    }
+
+    virtual size_t bytesUsed() const SK_OVERRIDE { return fCount * sizeof(SkRect); }
+
+    const SkRect& operator[](unsigned i) const {
+        SkASSERT((int)i < fCount);
+        return fBounds[i];
+    }
+
+private:
+    SkRect* fBounds;
+    int     fCount;
+};
+
+}  // namespace
+
+namespace SkRecords {
+
+// Equality of op arguments.  These may give false negatives (e.g. effects are compared by
+// pointer), which only cost us extra damage.
+static bool eq(const SkPaint& a, const SkPaint& b) { return a == b; }
+static bool eq(const SkRect& a, const SkRect& b) { return a == b; }
+static bool eq(const SkIRect& a, const SkIRect& b) { return a == b; }
+static bool eq(const SkRRect& a, const SkRRect& b) { return a == b; }
+static bool eq(const SkMatrix& a, const SkMatrix& b) { return a == b; }
+static bool eq(const SkPath& a, const SkPath& b) { return a == b; }
+static bool eq(const SkRegion& a, const SkRegion& b) { return a == b; }
+static bool eq(const RegionOpAndAA& a, const RegionOpAndAA& b) {
+    return a.op == b.op && a.aa == b.aa;
+}
+
+// Recorded bitmaps are immutable, so their pixels are identified by their generation ID.
+static bool eq(const SkBitmap& a, const SkBitmap& b) {
+    return a.pixelRef() == b.pixelRef() &&
+           a.pixelRefOrigin() == b.pixelRefOrigin() &&
+           a.info() == b.info() &&
+           a.getGenerationID() == b.getGenerationID();
+}
+
+template <typename T>
+static bool eq(const Optional<T>& a, const Optional<T>& b) {
+    const T* pa = a;
+    const T* pb = b;
+    return pa == pb || (pa && pb && eq(*pa, *pb));
+}
+
+// Images, pictures, blobs and xfermodes are immutable, so we only need to compare pointers.
+template <typename T>
+static bool eq(const RefBox<T>& a, const RefBox<T>& b) {
+    return (T*)a == (T*)b;
+}
+
+static bool same_bytes(const void* a, const void* b, size_t length) {
+    if (NULL == a || NULL == b) {
+        return a == b;
+    }
+    return 0 == memcmp(a, b, length);
+}
+
+// Returns true if a and b certainly draw the same way.  No base case, so we'll be compile-time
+// checked that we handle every type of op.
+template <typename T> static bool same_op(const T& a, const T& b);
+
+#define SAME(T, expr) template <> bool same_op(const T& a, const T& b) { return expr; }
+
+SAME(NoOp, true);
+SAME(Restore, eq(a.devBounds, b.devBounds) && eq(a.matrix, b.matrix));
+SAME(Save, true);
+SAME(SaveLayer, eq(a.bounds, b.bounds) && eq(a.paint, b.paint) && a.flags == b.flags);
+SAME(PushCull, eq(a.rect, b.rect));
+SAME(PopCull, true);
+SAME(SetMatrix, eq(a.matrix, b.matrix));
+
+SAME(ClipPath, eq(a.devBounds, b.devBounds) && eq(a.path, b.path) && eq(a.opAA, b.opAA));
+SAME(ClipRRect, eq(a.devBounds, b.devBounds) && eq(a.rrect, b.rrect) && eq(a.opAA, b.opAA));
+SAME(ClipRect, eq(a.devBounds, b.devBounds) && eq(a.rect, b.rect) && eq(a.opAA, b.opAA));
+SAME(ClipRegion, eq(a.devBounds, b.devBounds) && eq(a.region, b.region) && a.op == b.op);
+SAME(Clear, a.color == b.color);
+
+// Comments and data don't draw anything.
+SAME(BeginCommentGroup, true);
+SAME(AddComment, true);
+SAME(EndCommentGroup, true);
+SAME(DrawData, true);
+
+SAME(DrawBitmap, eq(a.paint, b.paint) && eq(a.bitmap, b.bitmap) &&
+                 a.left == b.left && a.top == b.top);
+SAME(DrawBitmapMatrix, eq(a.paint, b.paint) && eq(a.bitmap, b.bitmap) && eq(a.matrix, b.matrix));
+SAME(DrawBitmapNine, eq(a.paint, b.paint) && eq(a.bitmap, b.bitmap) &&
+                     eq(a.center, b.center) && eq(a.dst, b.dst));
+SAME(DrawBitmapRectToRect, eq(a.paint, b.paint) && eq(a.bitmap, b.bitmap) &&
+                           eq(a.src, b.src) && eq(a.dst, b.dst));
+SAME(DrawBitmapRectToRectBleed, eq(a.paint, b.paint) && eq(a.bitmap, b.bitmap) &&
+                                eq(a.src, b.src) && eq(a.dst, b.dst));
+SAME(DrawDRRect, eq(a.paint, b.paint) && eq(a.outer, b.outer) && eq(a.inner, b.inner));
+// A drawable can draw something different every time.
+SAME(DrawDrawable, false);
+SAME(DrawImage, eq(a.paint, b.paint) && eq(a.image, b.image) &&
+                a.left == b.left && a.top == b.top);
+SAME(DrawImageRect, eq(a.paint, b.paint) && eq(a.image, b.image) &&
+                    eq(a.src, b.src) && eq(a.dst, b.dst));
+SAME(DrawOval, eq(a.paint, b.paint) && eq(a.oval, b.oval));
+SAME(DrawPaint, eq(a.paint, b.paint));
+SAME(DrawPath, eq(a.paint, b.paint) && eq(a.path, b.path));
+SAME(DrawPicture, eq(a.paint, b.paint) && eq(a.picture, b.picture) && eq(a.matrix, b.matrix));
+SAME(DrawPoints, eq(a.paint, b.paint) && a.mode == b.mode && a.count == b.count &&
+                 same_bytes(a.pts, b.pts, a.count * sizeof(SkPoint)));
+SAME(DrawPosText, eq(a.paint, b.paint) && a.byteLength == b.byteLength &&
+                  same_bytes(a.text, b.text, a.byteLength) &&
+                  same_bytes(a.pos, b.pos,
+                             a.paint.countText(a.text, a.byteLength) * sizeof(SkPoint)));
+SAME(DrawPosTextH, eq(a.paint, b.paint) && a.byteLength == b.byteLength && a.y == b.y &&
+                   same_bytes(a.text, b.text, a.byteLength) &&
+                   same_bytes(a.xpos, b.xpos,
+                              a.paint.countText(a.text, a.byteLength) * sizeof(SkScalar)));
+SAME(DrawText, eq(a.paint, b.paint) && a.byteLength == b.byteLength &&
+               same_bytes(a.text, b.text, a.byteLength) && a.x == b.x && a.y == b.y);
+SAME(DrawTextOnPath, eq(a.paint, b.paint) && a.byteLength == b.byteLength &&
+                     same_bytes(a.text, b.text, a.byteLength) &&
+                     eq(a.path, b.path) && eq(a.matrix, b.matrix));
+SAME(DrawRRect, eq(a.paint, b.paint) && eq(a.rrect, b.rrect));
+SAME(DrawRect, eq(a.paint, b.paint) && eq(a.rect, b.rect));
+SAME(DrawSprite, eq(a.paint, b.paint) && eq(a.bitmap, b.bitmap) &&
+                 a.left == b.left && a.top == b.top);
+SAME(DrawTextBlob, eq(a.paint, b.paint) && eq(a.blob, b.blob) && a.x == b.x && a.y == b.y);
+SAME(DrawPatch, eq(a.paint, b.paint) && eq(a.xmode, b.xmode) &&
+                same_bytes(a.cubics, b.cubics, SkPatchUtils::kNumCtrlPts * sizeof(SkPoint)) &&
+                same_bytes(a.colors, b.colors, SkPatchUtils::kNumCorners * sizeof(SkColor)) &&
+                same_bytes(a.texCoords, b.texCoords,
+                           SkPatchUtils::kNumCorners * sizeof(SkPoint)));
+SAME(DrawVertices, eq(a.paint, b.paint) && a.vmode == b.vmode &&
+                   a.vertexCount == b.vertexCount && a.indexCount == b.indexCount &&
+                   a.xmode.get() == b.xmode.get() &&
+                   same_bytes(a.vertices, b.vertices, a.vertexCount * sizeof(SkPoint)) &&
+                   same_bytes(a.texs, b.texs, a.vertexCount * sizeof(SkPoint)) &&
+                   same_bytes(a.colors, b.colors, a.vertexCount * sizeof(SkColor)) &&
+                   same_bytes(a.indices, b.indices, a.indexCount * sizeof(uint16_t)));
+
+#undef SAME
+
+// Visits an op to find out its type and where it lives.
+struct OpRef {
+    template <typename T> void operator()(const T& op) {
+        fType = T::kType;
+        fOp = &op;
+    }
+
+    Type        fType;
+    const void* fOp;
+};
+
+// Visits an op to compare it to the one in fOther.
+struct SameAs {
+    explicit SameAs(const OpRef& other) : fOther(other) {}
+
+    template <typename T> bool operator()(const T& op) {
+        return T::kType == fOther.fType && same_op(op, *static_cast<const T*>(fOther.fOp));
+    }
+
+    const OpRef& fOther;
+};
+
+}  // namespace SkRecords
+
+static float area(const SkRect& r) {
+    return r.width() * r.height();
+}
+
+// Adds r to damage, merging it with any rect it overlaps, and keeping the damage to at most
+// kMaxDamageRects rects.
+static void add_damage(SkTDArray<SkRect>* damage, SkRect r) {
+    if (r.isEmpty()) {
+        return;
+    }
+    for (;;) {
+        int merge = -1;
+        for (int i = 0; i < damage->count(); ++i) {
+            if (SkRect::Intersects(r, (*damage)[i])) {
+                merge = i;
+                break;
+            }
+        }
+        if (merge < 0 && damage->count() >= kMaxDamageRects) {
+            // Merge with whichever rect grows least.
+            float bestGrowth = SK_ScalarInfinity;
+            for (int i = 0; i < damage->count(); ++i) {
+                SkRect joined = (*damage)[i];
+                joined.join(r);
+                const float growth = area(joined) - area((*damage)[i]);
+                if (growth < bestGrowth) {
+                    bestGrowth = growth;
+                    merge = i;
+                }
+            }
+        }
+        if (merge < 0) {
+            break;
+        }
+        // The merged rect may now overlap others, so go around again.
+        r.join((*damage)[merge]);
+        damage->removeShuffle(merge);
+    }
+    *damage->append() = r;
+}
+
+void SkRecordComputeDamage(const SkRect& oldCullRect, const SkRecord& oldRecord,
+                           const SkRect& newCullRect, const SkRecord& newRecord,
+                           SkTDArray<SkRect>* damage) {
+    OpBounds oldBounds, newBounds;
+    SkRecordFillBounds(oldCullRect, oldRecord, &oldBounds);
+    SkRecordFillBounds(newCullRect, newRecord, &newBounds);
+
+    struct Same {
+        Same(const SkRecord& oldRecord, const OpBounds& oldBounds,
+             const SkRecord& newRecord, const OpBounds& newBounds)
+            : fOldRecord(oldRecord), fOldBounds(oldBounds)
+            , fNewRecord(newRecord), fNewBounds(newBounds) {}
+
+        // Two ops draw the same pixels if they are equal and draw in the same place: the
+        // bounds catch changes to the matrix and clip the op is drawn with.
+        bool operator()(unsigned oldIndex, unsigned newIndex) const {
+            if (fOldBounds[oldIndex] != fNewBounds[newIndex]) {
+                return false;
+            }
+            SkRecords::OpRef newOp;
+            fNewRecord.visit<void>(newIndex, newOp);
+            SkRecords::SameAs sameAs(newOp);
+            return fOldRecord.visit<bool>(oldIndex, sameAs);
+        }
+
+        const SkRecord& fOldRecord;
+        const OpBounds& fOldBounds;
+        const SkRecord& fNewRecord;
+        const OpBounds& fNewBounds;
+    } same(oldRecord, oldBounds, newRecord, newBounds);
+
+    const unsigned oldCount = oldRecord.count(),
+                   newCount = newRecord.count();
+
+    unsigned prefix = 0;
+    while (prefix < oldCount && prefix < newCount && same(prefix, prefix)) {
+        prefix++;
+    }
+    unsigned suffix = 0;
+    while (prefix + suffix < oldCount && prefix + suffix < newCount &&
+           same(oldCount - 1 - suffix, newCount - 1 - suffix)) {
+        suffix++;
+    }
+
+    const unsigned oldStop = oldCount - suffix,
+                   newStop = newCount - suffix;
+    if (oldStop == newStop) {
+        // Most likely some ops changed in place.
+        for (unsigned i = prefix; i < oldStop; i++) {
+            if (!same(i, i)) {
+                add_damage(damage, oldBounds[i]);
+                add_damage(damage, newBounds[i]);
+            }
+        }
+    } else {
+        for (unsigned i = prefix; i < oldStop; i++) {
+            add_damage(damage, oldBounds[i]);
+        }
+        for (unsigned i = prefix; i < newStop; i++) {
+            add_damage(damage, newBounds[i]);
+        }
+    }
+}
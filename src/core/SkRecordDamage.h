@@ -0,0 +1,26 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordDamage_DEFINED
+#define SkRecordDamage_DEFINED
+
+#include "SkRecord.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+// Appends to damage rectangles (in record space) covering every pixel that could draw differently
+// when playing back newRecord instead of oldRecord.
+//
+// Ops are matched up in order: the common prefix and suffix of the two records are compared op by
+// op (type, arguments and bounds), and whatever lies between is damaged as a whole, unless it has
+// the same number of ops in both records, in which case it is compared op by op too.  Damage is
+// conservative: ops that can't be compared cheaply (e.g. drawables) always count as changed.
+void SkRecordComputeDamage(const SkRect& oldCullRect, const SkRecord& oldRecord,
+                           const SkRect& newCullRect, const SkRecord& newRecord,
+                           SkTDArray<SkRect>* damage);
+
+#endif//SkRecordDamage_DEFINED
@@ -808,3 +808,91 @@ void SkRecordComputeLayers(const SkRect& cullRect, const SkRecord& record,
     visitor.cleanUp(bbh);
 }
 
+
+namespace {
+
+// Finds the SaveLayer (if that is what it is) at a given index of an SkRecord.
+struct FindSaveLayer {
+    FindSaveLayer() : fOp(NULL) {}
+
+    template <typename T> void operator()(T*) {}
+    void operator()(SkRecords::SaveLayer* op) { fOp = op; }
+
+    SkRecords::SaveLayer* fOp;
+};
+
+// Is the block, or any layer it is nested in, drawn with an image filter?  block.fBounds has been
+// through the paints of all the enclosing layers, and a filter may move or shrink what it draws,
+// so the bounds are no longer a bound on what the block's own layer holds.
+bool under_image_filter(const SkLayerInfo& data, int index) {
+    const SkLayerInfo::BlockInfo& block = data.block(index);
+    if (block.fPaint && block.fPaint->getImageFilter()) {
+        return true;
+    }
+    if (!block.fIsNested) {
+        return false;
+    }
+    for (int i = 0; i < data.numBlocks(); ++i) {
+        const SkLayerInfo::BlockInfo& outer = data.block(i);
+        if (NULL == outer.fPicture &&
+            outer.fSaveLayerOpID < block.fSaveLayerOpID &&
+            outer.fRestoreOpID > block.fRestoreOpID &&
+            outer.fPaint && outer.fPaint->getImageFilter()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+void SkRecordTightenLayerBounds(SkRecord* record, const SkLayerInfo& data) {
+    for (int i = 0; i < data.numBlocks(); ++i) {
+        const SkLayerInfo::BlockInfo& block = data.block(i);
+
+        // Layers inside nested pictures live in those pictures' records.
+        if (block.fPicture) {
+            continue;
+        }
+        // An image filter may read (or move) pixels from outside the drawn area, so its
+        // source must keep the full extent of the layer.
+        if (under_image_filter(data, i)) {
+            continue;
+        }
+
+        // block.fBounds are in identity space; the SaveLayer's bounds are in its local space.
+        SkMatrix inverse;
+        if (!block.fLocalMat.invert(&inverse)) {
+            continue;
+        }
+        SkRect bounds;
+        inverse.mapRect(&bounds, block.fBounds);
+
+        FindSaveLayer find;
+        record->mutate<void>(block.fSaveLayerOpID, find);
+        SkRecords::SaveLayer* op = find.fOp;
+        if (NULL == op) {
+            SkASSERT(false);
+            continue;
+        }
+
+        if (op->bounds) {
+            if (!bounds.intersect(*op->bounds)) {
+                bounds.setEmpty();
+            }
+            *op->bounds = bounds;
+        } else {
+            // There is no bounds to write to, so rebuild the SaveLayer with one. replace()
+            // destroys the old op, so its paint must be copied first.
+            SkRect* newBounds = record->alloc<SkRect>();
+            *newBounds = bounds;
+            SkPaint* paint = NULL;
+            if (op->paint) {
+                paint = SkNEW_PLACEMENT_ARGS(record->alloc<SkPaint>(), SkPaint, (*op->paint));
+            }
+            const SkCanvas::SaveFlags flags = op->flags;
+            SkNEW_PLACEMENT_ARGS(record->replace<SkRecords::SaveLayer>(block.fSaveLayerOpID),
+                                 SkRecords::SaveLayer, (newBounds, paint, flags));
+        }
+    }
+}
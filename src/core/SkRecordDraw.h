@@ -24,6 +24,12 @@ void SkRecordComputeLayers(const SkRect& cullRect, const SkRecord& record,
                            const SkPicture::SnapshotArray*,
                            SkBBoxHierarchy* bbh, SkLayerInfo* data);
 
+// Shrink the bounds of each SaveLayer in the record (nested ones too, but not those inside
+// nested pictures) to the layer bounds found by SkRecordComputeLayers, so that playback allocates
+// no more layer than is drawn into.  Layers that have, or are nested in, a layer with an image
+// filter are left alone.
+void SkRecordTightenLayerBounds(SkRecord*, const SkLayerInfo&);
+
 // Draw an SkRecord into an SkCanvas.  A convenience wrapper around SkRecords::Draw.
 void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePicts[],
                   SkCanvasDrawable* const drawables[], int drawableCount,
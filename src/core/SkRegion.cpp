@@ -8,6 +8,8 @@
 
 
 #include "SkRegionPriv.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkThread.h"
 #include "SkUtils.h"
@@ -281,9 +283,18 @@ bool SkRegion::setRuns(RunType runs[], int count) {
 
     //  if we get here, we need to become a complex region
 
-    if (!this->isComplex() || fRunHead->fRunCount != count) {
-        this->freeRuns();
+    if (!this->isComplex()) {
         this->allocateRuns(count);
+    } else if (fRunHead->fRunCount != count) {
+        if (1 == fRunHead->fRefCnt) {
+            // We're the only owner, so resize in place rather than free + alloc.
+            fRunHead = (RunHead*)sk_realloc_throw(fRunHead,
+                                                 sizeof(RunHead) + count * sizeof(RunType));
+            fRunHead->fRunCount = count;
+        } else {
+            this->freeRuns();
+            this->allocateRuns(count);
+        }
     }
 
     // must call this before we can write directly into runs()
@@ -585,16 +596,123 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static bool rect_top_lt(const SkIRect& a, const SkIRect& b) {
+    return a.fTop < b.fTop;
+}
+
+/*  Build the runs for the union of rects (none of which may be empty) with a
+    single sweep down the Y edges. The active rects are kept sorted by left,
+    so each band's intervals come from one linear merge, and a band that
+    matches the one above it just extends that band's bottom. The rects array
+    is reordered.
+ */
+static void union_rects_to_runs(SkIRect rects[], int count,
+                                SkTDArray<SkRegion::RunType>* runs) {
+    SkASSERT(count > 0);
+
+    SkTQSort(rects, rects + count - 1, rect_top_lt);
+
+    SkAutoSTMalloc<64, int32_t> ys(2 * count);
+    for (int i = 0; i < count; ++i) {
+        SkASSERT(!rects[i].isEmpty());
+        ys[2 * i + 0] = rects[i].fTop;
+        ys[2 * i + 1] = rects[i].fBottom;
+    }
+    SkTQSort(ys.get(), ys.get() + 2 * count - 1);
+    int yCount = 1;
+    for (int i = 1; i < 2 * count; ++i) {
+        if (ys[i] != ys[yCount - 1]) {
+            ys[yCount++] = ys[i];
+        }
+    }
+
+    SkAutoSTMalloc<32, const SkIRect*> active(count);
+    int activeCount = 0;
+    int nextRect = 0;
+
+    runs->setCount(0);
+    runs->setReserve(8 * count + 2);
+    *runs->append() = ys[0];        // top
+
+    int prevIntervals = -1;         // index of the previous band's first left
+    int prevLen = -1;               // 2 * its interval count
+
+    for (int i = 0; i + 1 < yCount; ++i) {
+        const int top = ys[i];
+        const int bot = ys[i + 1];
+
+        // Retire rects that ended above this band, keeping the rest in order.
+        int keep = 0;
+        for (int j = 0; j < activeCount; ++j) {
+            if (active[j]->fBottom > top) {
+                active[keep++] = active[j];
+            }
+        }
+        activeCount = keep;
+
+        // Insert rects that start at this band, sorted by left.
+        while (nextRect < count && rects[nextRect].fTop <= top) {
+            const SkIRect* r = &rects[nextRect++];
+            int j = activeCount++;
+            while (j > 0 && active[j - 1]->fLeft > r->fLeft) {
+                active[j] = active[j - 1];
+                j -= 1;
+            }
+            active[j] = r;
+        }
+
+        const int band = runs->count();
+        runs->append(2);            // bottom, interval count
+        for (int j = 0; j < activeCount; ++j) {
+            const SkIRect* r = active[j];
+            SkRegion::RunType* last = runs->end() - 1;
+            if (runs->count() > band + 2 && r->fLeft <= *last) {
+                if (r->fRight > *last) {
+                    *last = r->fRight;
+                }
+            } else {
+                SkRegion::RunType* pair = runs->append(2);
+                pair[0] = r->fLeft;
+                pair[1] = r->fRight;
+            }
+        }
+        const int len = runs->count() - band - 2;
+
+        if (len == prevLen && !memcmp(&(*runs)[prevIntervals], &(*runs)[band + 2],
+                                      len * sizeof(SkRegion::RunType))) {
+            // Same intervals as the band above: just extend it down.
+            runs->setCount(band);
+            (*runs)[prevIntervals - 2] = bot;
+        } else {
+            (*runs)[band] = bot;
+            (*runs)[band + 1] = len >> 1;
+            *runs->append() = SkRegion::kRunTypeSentinel;
+            prevIntervals = band + 2;
+            prevLen = len;
+        }
+    }
+    *runs->append() = SkRegion::kRunTypeSentinel;
+}
+
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
+    SkAutoSTMalloc<32, SkIRect> nonEmpty(count);
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!rects[i].isEmpty()) {
+            nonEmpty[n++] = rects[i];
         }
     }
-    return !this->isEmpty();
+
+    if (0 == n) {
+        return this->setEmpty();
+    }
+    if (1 == n) {
+        return this->setRect(nonEmpty[0]);
+    }
+
+    SkTDArray<RunType> runs;
+    union_rects_to_runs(nonEmpty.get(), n, &runs);
+    return this->setRuns(runs.begin(), runs.count());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -741,6 +859,77 @@ static SkRegion::RunType* operate_on_span(const SkRegion::RunType a_runs[],
 #pragma warning ( pop )
 #endif
 
+/*  Union and intersection are by far the most common ops (clipping), so they
+    get dedicated mergers that walk the two interval lists directly instead of
+    splitting them into inside/outside pieces like operate_on_span(). Both
+    produce the same canonical intervals (touching intervals are joined).
+ */
+static SkRegion::RunType* union_spans(const SkRegion::RunType a_runs[],
+                                      const SkRegion::RunType b_runs[],
+                                      SkRegion::RunType dst[]) {
+    SkRegion::RunType* const start = dst;
+
+    for (;;) {
+        const SkRegion::RunType* src;
+        if (*a_runs < *b_runs) {
+            src = a_runs;
+            a_runs += 2;
+        } else if (*b_runs < SkRegion::kRunTypeSentinel) {
+            src = b_runs;
+            b_runs += 2;
+        } else {
+            break;  // both lists are at their sentinel
+        }
+
+        if (dst > start && src[0] <= dst[-1]) {
+            if (src[1] > dst[-1]) {
+                dst[-1] = src[1];
+            }
+        } else {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst += 2;
+        }
+    }
+
+    *dst++ = SkRegion::kRunTypeSentinel;
+    return dst;
+}
+
+static SkRegion::RunType* intersect_spans(const SkRegion::RunType a_runs[],
+                                          const SkRegion::RunType b_runs[],
+                                          SkRegion::RunType dst[]) {
+    SkRegion::RunType* const start = dst;
+
+    while (*a_runs < SkRegion::kRunTypeSentinel &&
+           *b_runs < SkRegion::kRunTypeSentinel) {
+        SkRegion::RunType left = SkMax32(a_runs[0], b_runs[0]);
+        SkRegion::RunType rite = SkMin32(a_runs[1], b_runs[1]);
+        if (left < rite) {
+            if (dst > start && left <= dst[-1]) {
+                dst[-1] = rite;
+            } else {
+                dst[0] = left;
+                dst[1] = rite;
+                dst += 2;
+            }
+        }
+
+        // advance whichever interval ends first (or both)
+        SkRegion::RunType a_rite = a_runs[1];
+        SkRegion::RunType b_rite = b_runs[1];
+        if (a_rite <= b_rite) {
+            a_runs += 2;
+        }
+        if (b_rite <= a_rite) {
+            b_runs += 2;
+        }
+    }
+
+    *dst++ = SkRegion::kRunTypeSentinel;
+    return dst;
+}
+
 static const struct {
     uint8_t fMin;
     uint8_t fMax;
@@ -766,6 +955,7 @@ public:
         fPrevLen = 0;       // will never match a length from operate_on_span
         fTop = (SkRegion::RunType)(top);    // just a first guess, we might update this
 
+        fOp = op;
         fMin = gOpMinMax[op].fMin;
         fMax = gOpMinMax[op].fMax;
     }
@@ -775,7 +965,18 @@ public:
         // skip X values and slots for the next Y+intervalCount
         SkRegion::RunType*  start = fPrevDst + fPrevLen + 2;
         // start points to beginning of dst interval
-        SkRegion::RunType*  stop = operate_on_span(a_runs, b_runs, start, fMin, fMax);
+        SkRegion::RunType*  stop;
+        switch (fOp) {
+            case SkRegion::kUnion_Op:
+                stop = union_spans(a_runs, b_runs, start);
+                break;
+            case SkRegion::kIntersect_Op:
+                stop = intersect_spans(a_runs, b_runs, start);
+                break;
+            default:
+                stop = operate_on_span(a_runs, b_runs, start, fMin, fMax);
+                break;
+        }
         size_t              len = stop - start;
         SkASSERT(len >= 1 && (len & 1) == 1);
         SkASSERT(SkRegion::kRunTypeSentinel == stop[-1]);
@@ -805,6 +1006,7 @@ public:
 
     bool isEmpty() const { return 0 == fPrevLen; }
 
+    SkRegion::Op fOp;
     uint8_t fMin, fMax;
 
 private:
@@ -1090,6 +1292,90 @@ bool SkRegion::op(const SkRegion& rgna, const SkRegion& rgnb, Op op) {
     return SkRegion::Oper(rgna, rgnb, op, this);
 }
 
+bool SkRegion::opRects(const SkIRect rects[], int count, Op op) {
+    SkDEBUGCODE(this->validate();)
+    SkASSERT(count >= 0);
+
+    if (count <= 1) {
+        return 1 == count ? this->op(rects[0], op) : !this->isEmpty();
+    }
+
+    switch (op) {
+        case kIntersect_Op: {
+            SkIRect bounds = rects[0];
+            for (int i = 1; i < count; ++i) {
+                if (!bounds.intersect(rects[i])) {
+                    return this->setEmpty();
+                }
+            }
+            return this->op(bounds, kIntersect_Op);
+        }
+        case kUnion_Op:
+        case kDifference_Op: {
+            // this op r0 op r1 ... == this op (r0 U r1 U ...)
+            SkRegion all;
+            all.setRects(rects, count);
+            return this->op(all, op);
+        }
+        default:
+            for (int i = 0; i < count; ++i) {
+                this->op(rects[i], op);
+            }
+            return !this->isEmpty();
+    }
+}
+
+static bool complexity_lt(const SkRegion* a, const SkRegion* b) {
+    return a->computeRegionComplexity() < b->computeRegionComplexity();
+}
+
+bool SkRegion::opRegions(const SkRegion* const rgns[], int count, Op op) {
+    SkDEBUGCODE(this->validate();)
+    SkASSERT(count >= 0);
+
+    if (count <= 1) {
+        return 1 == count ? this->op(*rgns[0], op) : !this->isEmpty();
+    }
+
+    switch (op) {
+        case kIntersect_Op: {
+            SkIRect bounds = fBounds;
+            for (int i = 0; i < count; ++i) {
+                if (this->isEmpty() || !bounds.intersect(rgns[i]->getBounds())) {
+                    return this->setEmpty();
+                }
+            }
+            // Intersect the cheap regions first, so the running result shrinks early.
+            SkAutoSTMalloc<16, const SkRegion*> sorted(count);
+            memcpy(sorted.get(), rgns, count * sizeof(const SkRegion*));
+            SkTQSort(sorted.get(), sorted.get() + count - 1, complexity_lt);
+
+            this->op(bounds, kIntersect_Op);
+            for (int i = 0; i < count && !this->isEmpty(); ++i) {
+                this->op(*sorted[i], kIntersect_Op);
+            }
+            return !this->isEmpty();
+        }
+        case kUnion_Op:
+        case kDifference_Op: {
+            SkTDArray<SkIRect> rects;
+            for (int i = 0; i < count; ++i) {
+                for (Iterator iter(*rgns[i]); !iter.done(); iter.next()) {
+                    *rects.append() = iter.rect();
+                }
+            }
+            SkRegion all;
+            all.setRects(rects.begin(), rects.count());
+            return this->op(all, op);
+        }
+        default:
+            for (int i = 0; i < count; ++i) {
+                this->op(*rgns[i], op);
+            }
+            return !this->isEmpty();
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkBuffer.h"
@@ -529,6 +529,7 @@ void SkResourceCache::Add(Rec* rec) {
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SkGraphics.h"
+#include "SkLayerPool.h"
 
 size_t SkGraphics::GetResourceCacheTotalBytesUsed() {
     return SkResourceCache::GetTotalBytesUsed();
@@ -551,6 +552,7 @@ size_t SkGraphics::SetResourceCacheSingleAllocationByteLimit(size_t newLimit) {
 }
 
 void SkGraphics::PurgeResourceCache() {
+    SkLayerPool::Global()->purge();
     return SkResourceCache::PurgeAll();
 }
 
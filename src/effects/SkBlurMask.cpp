@@ -8,7 +8,9 @@
 
 
 #include "SkBlurMask.h"
+#include "SkBlitter.h"
 #include "SkMath.h"
+#include "SkRasterClip.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
 
@@ -847,6 +849,161 @@ bool SkBlurMask::BlurRRect(SkScalar sigma, SkMask *dst,
     return false;
 }
 
+// Blits a run of constant coverage on row y; runs and aa must hold width + 1 entries.
+static void blit_constant_row(SkBlitter* blitter, int x, int y, int width, SkAlpha alpha,
+                              int16_t runs[], SkAlpha aa[]) {
+    if (0 == alpha || width <= 0) {
+        return;
+    }
+    if (0xFF == alpha) {
+        blitter->blitH(x, y, width);
+        return;
+    }
+    // A run's length must fit in an int16_t.
+    while (width > 0) {
+        const int n = SkMin32(width, SK_MaxS16);
+        runs[0] = SkToS16(n);
+        runs[n] = 0;
+        aa[0] = alpha;
+        blitter->blitAntiH(x, y, aa, runs);
+        x += n;
+        width -= n;
+    }
+}
+
+// BlitRect() fills at most this many bytes of corner coverage before blitting it.
+static const int kCornerChunkBytes = 4096;
+
+bool SkBlurMask::BlitRect(SkScalar sigma, const SkRect& src, SkBlurStyle style,
+                          const SkRasterClip& clip, SkBlitter* blitter) {
+    if (kNormal_SkBlurStyle != style) {
+        return false;
+    }
+
+    SkMask dstM;
+    BlurRect(sigma, &dstM, src, style, NULL, SkMask::kJustComputeBounds_CreateMode);
+    const SkIRect& bounds = dstM.fBounds;
+    if (bounds.isEmpty()) {
+        return true;
+    }
+    const int width = bounds.width();
+    const int height = bounds.height();
+
+    uint8_t* profile = NULL;
+    ComputeBlurProfile(sigma, &profile);
+    SkAutoTDeleteArray<uint8_t> ada(profile);
+
+    // The same scanlines BlurRect() multiplies together, so the coverage matches its mask.
+    SkAutoTMalloc<uint8_t> horizontalScanline(width);
+    SkAutoTMalloc<uint8_t> verticalScanline(height);
+    ComputeBlurredScanline(horizontalScanline, profile, width, sigma);
+    ComputeBlurredScanline(verticalScanline, profile, height, sigma);
+
+    SkAutoSMalloc<kCornerChunkBytes> corner(SkMax32(width, kCornerChunkBytes));
+    SkAutoSMalloc<1024> storage((width + 1) * (sizeof(int16_t) + sizeof(SkAlpha)));
+    int16_t* runs = (int16_t*)storage.get();
+    SkAlpha* aa = (SkAlpha*)(runs + width + 1);
+
+    // The opaque core, where both scanlines are 255. Beside it the coverage is the horizontal
+    // scanline alone, and above and below it the vertical one, so only the corners need to be
+    // computed per pixel. If either scanline never reaches 255 the core is empty, and sits at
+    // the right or bottom so that everything else is a corner.
+    int x0 = 0;
+    while (x0 < width && 255 != horizontalScanline[x0]) {
+        ++x0;
+    }
+    int x1 = x0;
+    while (x1 < width && 255 == horizontalScanline[x1]) {
+        ++x1;
+    }
+    int y0 = 0;
+    while (y0 < height && 255 != verticalScanline[y0]) {
+        ++y0;
+    }
+    int y1 = y0;
+    while (y1 < height && 255 == verticalScanline[y1]) {
+        ++y1;
+    }
+    if (x0 == x1) {
+        x0 = x1 = width;
+    }
+    if (y0 == y1) {
+        y0 = y1 = height;
+    }
+    SkIRect core = SkIRect::MakeLTRB(x0, y0, x1, y1);
+    core.offset(bounds.fLeft, bounds.fTop);
+
+    SkAAClipBlitterWrapper wrapper(clip, blitter);
+    blitter = wrapper.getBlitter();
+
+    for (SkRegion::Cliperator clipper(wrapper.getRgn(), bounds); !clipper.done();
+         clipper.next()) {
+        const SkIRect& cr = clipper.rect();
+        const int coreLeft = SkPin32(core.fLeft, cr.fLeft, cr.fRight);
+        const int coreRight = SkPin32(core.fRight, cr.fLeft, cr.fRight);
+        const int coreTop = SkPin32(core.fTop, cr.fTop, cr.fBottom);
+        const int coreBottom = SkPin32(core.fBottom, cr.fTop, cr.fBottom);
+
+        if (coreLeft < coreRight && coreTop < coreBottom) {
+            blitter->blitRect(coreLeft, coreTop, coreRight - coreLeft, coreBottom - coreTop);
+        }
+
+        // Left and right of the core.
+        if (coreTop < coreBottom) {
+            for (int x = cr.fLeft; x < cr.fRight; ++x) {
+                if (x == coreLeft) {
+                    x = coreRight;
+                    if (x == cr.fRight) {
+                        break;
+                    }
+                }
+                const SkAlpha alpha = horizontalScanline[x - bounds.fLeft];
+                if (alpha) {
+                    blitter->blitV(x, coreTop, coreBottom - coreTop, alpha);
+                }
+            }
+        }
+
+        // Above and below the core; the corners are computed in chunks of rows.
+        const int bands[2][2] = { { cr.fTop, coreTop }, { coreBottom, cr.fBottom } };
+        const int spans[2][2] = { { cr.fLeft, coreLeft }, { coreRight, cr.fRight } };
+        for (int i = 0; i < 2; ++i) {
+            const int top = bands[i][0];
+            const int bottom = bands[i][1];
+            for (int y = top; y < bottom; ++y) {
+                blit_constant_row(blitter, coreLeft, y, coreRight - coreLeft,
+                                  verticalScanline[y - bounds.fTop], runs, aa);
+            }
+            for (int j = 0; j < 2; ++j) {
+                const int left = spans[j][0];
+                const int w = spans[j][1] - left;
+                if (w <= 0) {
+                    continue;
+                }
+                const int chunkRows = SkMax32(1, kCornerChunkBytes / w);
+                for (int chunkTop = top; chunkTop < bottom; chunkTop += chunkRows) {
+                    const int chunkBottom = SkMin32(bottom, chunkTop + chunkRows);
+                    uint8_t* dst = (uint8_t*)corner.get();
+                    for (int y = chunkTop; y < chunkBottom; ++y) {
+                        const unsigned v = verticalScanline[y - bounds.fTop];
+                        const uint8_t* h = horizontalScanline.get() + left - bounds.fLeft;
+                        for (int x = 0; x < w; ++x) {
+                            *dst++ = SkMulDiv255Round(h[x], v);
+                        }
+                    }
+                    SkMask mask;
+                    mask.fImage = (uint8_t*)corner.get();
+                    mask.fBounds.set(left, chunkTop, left + w, chunkBottom);
+                    mask.fRowBytes = w;
+                    mask.fFormat = SkMask::kA8_Format;
+                    blitter->blitMask(mask, mask.fBounds);
+                }
+            }
+        }
+    }
+    return true;
+}
+
 // The "simple" blur is a direct implementation of separable convolution with a discrete
 // gaussian kernel.  It's "ground truth" in a sense; too slow to be used, but very
 // useful for correctness comparisons.
@@ -13,6 +13,9 @@
 #include "SkMask.h"
 #include "SkRRect.h"
 
+class SkBlitter;
+class SkRasterClip;
+
 class SkBlurMask {
 public:
     static bool BlurRect(SkScalar sigma, SkMask *dst, const SkRect &src, SkBlurStyle,
@@ -24,6 +27,14 @@ public:
                          SkMask::CreateMode createMode =
                                                 SkMask::kComputeBoundsAndRenderImage_CreateMode);
 
+    /** Draw the blur of src straight into the blitter, clipped to clip, without allocating a
+        mask. Memory use grows with the width plus the height of the blurred rect, and the
+        coverage is identical to blitting the mask from BlurRect(). Only the normal style is
+        supported; returns false for the others.
+    */
+    static bool BlitRect(SkScalar sigma, const SkRect& src, SkBlurStyle,
+                         const SkRasterClip& clip, SkBlitter*);
+
     // forceQuality will prevent BoxBlur from falling back to the low quality approach when sigma
     // is very small -- this can be used predict the margin bump ahead of time without completely
     // replicating the internal logic.  This permits not only simpler caching of blurred results,
@@ -78,6 +78,10 @@ protected:
                                            const SkIRect& clipBounds,
                                            NinePatch*) const SK_OVERRIDE;
 
+    virtual FilterReturn filterRectToBlitter(const SkRect&, const SkMatrix&,
+                                             const SkRasterClip&,
+                                             SkBlitter*) const SK_OVERRIDE;
+
     bool filterRectMask(SkMask* dstM, const SkRect& r, const SkMatrix& matrix,
                         SkIPoint* margin, SkMask::CreateMode createMode) const;
     bool filterRRectMask(SkMask* dstM, const SkRRect& r, const SkMatrix& matrix,
@@ -452,6 +456,27 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
 
 SK_CONF_DECLARE( bool, c_analyticBlurNinepatch, "mask.filter.analyticNinePatch", true, "Use the faster analytic blur approach for ninepatch rects" );
 
+SK_CONF_DECLARE( bool, c_analyticBlurDirect, "mask.filter.blur.analyticdirect", true, "Draw analytic rect blurs straight into the blitter, without a mask" );
+
+SkMaskFilter::FilterReturn
+SkBlurMaskFilterImpl::filterRectToBlitter(const SkRect& rect, const SkMatrix& matrix,
+                                          const SkRasterClip& clip,
+                                          SkBlitter* blitter) const {
+    // The other styles still go through a mask. Turning off the analytic rect blur turns this
+    // off too, since it is the same blur.
+    if (!c_analyticBlurDirect || !c_analyticBlurNinepatch || kNormal_SkBlurStyle != fBlurStyle) {
+        return kUnimplemented_FilterReturn;
+    }
+
+    // Skip too-large src rects (to take the old code path), as filterRectsToNine does.
+    if (rect_exceeds(rect, SkIntToScalar(32767))) {
+        return kUnimplemented_FilterReturn;
+    }
+
+    return SkBlurMask::BlitRect(this->computeXformedSigma(matrix), rect, fBlurStyle, clip,
+                                blitter) ? kTrue_FilterReturn : kFalse_FilterReturn;
+}
+
 SkMaskFilter::FilterReturn
 SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
                                         const SkMatrix& matrix,
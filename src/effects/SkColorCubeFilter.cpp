@@ -6,6 +6,7 @@
  */
 
 #include "SkColorCubeFilter.h"
+#include "Sk4x.h"
 #include "SkColorPriv.h"
 #include "SkOnce.h"
 #include "SkReadBuffer.h"
@@ -56,107 +57,136 @@ SkColorFilter* SkColorCubeFilter::Create(SkData* cubeData, int cubeDimension) {
 SkColorCubeFilter::SkColorCubeFilter(SkData* cubeData, int cubeDimension)
   : fCubeData(SkRef(cubeData))
   , fUniqueID(SkNextColorCubeUniqueID())
-  , fCache(cubeDimension) {
+  , fCache(cubeData, cubeDimension) {
 }
 
 uint32_t SkColorCubeFilter::getFlags() const {
     return this->INHERITED::getFlags() | kAlphaUnchanged_Flag;
 }
 
-SkColorCubeFilter::ColorCubeProcesingCache::ColorCubeProcesingCache(int cubeDimension)
-  : fCubeDimension(cubeDimension)
-  , fLutsInited(false) {
-    fColorToIndex[0] = fColorToIndex[1] = NULL;
-    fColorToFactors[0] = fColorToFactors[1] = NULL;
-    fColorToScalar = NULL;
-}
+namespace {
 
-void SkColorCubeFilter::ColorCubeProcesingCache::getProcessingLuts(
-    const int* (*colorToIndex)[2], const SkScalar* (*colorToFactors)[2],
-    const SkScalar** colorToScalar) {
-    SkOnce(&fLutsInited, &fLutsMutex,
-           SkColorCubeFilter::ColorCubeProcesingCache::initProcessingLuts, this);
-    SkASSERT((fColorToIndex[0] != NULL) &&
-             (fColorToIndex[1] != NULL) &&
-             (fColorToFactors[0] != NULL) &&
-             (fColorToFactors[1] != NULL) &&
-             (fColorToScalar != NULL));
-    (*colorToIndex)[0] = fColorToIndex[0];
-    (*colorToIndex)[1] = fColorToIndex[1];
-    (*colorToFactors)[0] = fColorToFactors[0];
-    (*colorToFactors)[1] = fColorToFactors[1];
-    (*colorToScalar) = fColorToScalar;
-}
+// The lattice indices and interpolation factors for each 8 bit component only depend on the
+// cube dimension, so they are computed once per dimension and shared by every filter.
+struct ColorCubeLuts {
+    // fIndex[c][i][v] is the lattice offset of the i'th (lower or upper) neighbour of value v
+    // along component c (0 = r, 1 = g, 2 = b), already multiplied by that component's stride.
+    int fIndex[3][2][256];
+    // fFactors[i][v] is the interpolation weight of that neighbour.
+    SkScalar fFactors[2][256];
+};
 
-void SkColorCubeFilter::ColorCubeProcesingCache::initProcessingLuts(
-    SkColorCubeFilter::ColorCubeProcesingCache* cache) {
+ColorCubeLuts* gColorCubeLuts[MAX_CUBE_SIZE + 1];
+SK_DECLARE_STATIC_ONCE(gColorCubeLutsOnce[MAX_CUBE_SIZE + 1]);
+
+void init_color_cube_luts(int cubeDimension) {
     static const SkScalar inv8bit = SkScalarInvert(SkIntToScalar(255));
 
-    // We need 256 int * 2 for fColorToIndex, so a total of 512 int.
-    // We need 256 SkScalar * 2 for fColorToFactors and 256 SkScalar
-    // for fColorToScalar, so a total of 768 SkScalar.
-    cache->fLutStorage.reset(512 * sizeof(int) + 768 * sizeof(SkScalar));
-    uint8_t* storage = (uint8_t*)cache->fLutStorage.get();
-    cache->fColorToIndex[0] = (int*)storage;
-    cache->fColorToIndex[1] = cache->fColorToIndex[0] + 256;
-    cache->fColorToFactors[0] = (SkScalar*)(storage + (512 * sizeof(int)));
-    cache->fColorToFactors[1] = cache->fColorToFactors[0] + 256;
-    cache->fColorToScalar = cache->fColorToFactors[1] + 256;
-
-    SkScalar size = SkIntToScalar(cache->fCubeDimension);
+    ColorCubeLuts* luts = SkNEW(ColorCubeLuts);
+    SkScalar size = SkIntToScalar(cubeDimension);
     SkScalar scale = (size - SK_Scalar1) * inv8bit;
+    const int strides[3] = { 1, cubeDimension, cubeDimension * cubeDimension };
 
     for (int i = 0; i < 256; ++i) {
         SkScalar index = scale * i;
-        cache->fColorToIndex[0][i] = SkScalarFloorToInt(index);
-        cache->fColorToIndex[1][i] = cache->fColorToIndex[0][i] + 1;
-        cache->fColorToScalar[i] = inv8bit * i;
-        if (cache->fColorToIndex[1][i] < cache->fCubeDimension) {
-            cache->fColorToFactors[1][i] = index - SkIntToScalar(cache->fColorToIndex[0][i]);
-            cache->fColorToFactors[0][i] = SK_Scalar1 - cache->fColorToFactors[1][i];
+        int index0 = SkScalarFloorToInt(index);
+        int index1 = index0 + 1;
+        if (index1 < cubeDimension) {
+            luts->fFactors[1][i] = index - SkIntToScalar(index0);
+            luts->fFactors[0][i] = SK_Scalar1 - luts->fFactors[1][i];
         } else {
-            cache->fColorToIndex[1][i] = cache->fColorToIndex[0][i];
-            cache->fColorToFactors[0][i] = SK_Scalar1;
-            cache->fColorToFactors[1][i] = 0;
+            index1 = index0;
+            luts->fFactors[0][i] = SK_Scalar1;
+            luts->fFactors[1][i] = 0;
+        }
+        for (int c = 0; c < 3; ++c) {
+            luts->fIndex[c][0][i] = index0 * strides[c];
+            luts->fIndex[c][1][i] = index1 * strides[c];
         }
     }
+    gColorCubeLuts[cubeDimension] = luts;
+}
+
+const ColorCubeLuts& get_color_cube_luts(int cubeDimension) {
+    SkASSERT(cubeDimension >= MIN_CUBE_SIZE && cubeDimension <= MAX_CUBE_SIZE);
+    SkOnce(&gColorCubeLutsOnce[cubeDimension], init_color_cube_luts, cubeDimension);
+    return *gColorCubeLuts[cubeDimension];
+}
+
+} // end namespace
+
+SkColorCubeFilter::ColorCubeProcesingCache::ColorCubeProcesingCache(SkData* cubeData,
+                                                                     int cubeDimension)
+  : fCubeData(cubeData)
+  , fCubeDimension(cubeDimension)
+  , fLatticeInited(false) {
+}
+
+const float* SkColorCubeFilter::ColorCubeProcesingCache::getLattice() {
+    SkOnce(&fLatticeInited, &fLatticeMutex,
+           SkColorCubeFilter::ColorCubeProcesingCache::initLattice, this);
+    SkASSERT(fLattice.get() != NULL);
+    return fLattice.get();
+}
+
+void SkColorCubeFilter::ColorCubeProcesingCache::initLattice(
+    SkColorCubeFilter::ColorCubeProcesingCache* cache) {
+    static const SkScalar inv8bit = SkScalarInvert(SkIntToScalar(255));
+
+    const int count = cache->fCubeDimension * cache->fCubeDimension * cache->fCubeDimension;
+    const SkColor* colorCube = (const SkColor*)cache->fCubeData->data();
+    cache->fLattice.reset(4 * count);
+    float* lattice = cache->fLattice.get();
+    for (int i = 0; i < count; ++i) {
+        *lattice++ = SkScalarToFloat(inv8bit * SkColorGetR(colorCube[i]));
+        *lattice++ = SkScalarToFloat(inv8bit * SkColorGetG(colorCube[i]));
+        *lattice++ = SkScalarToFloat(inv8bit * SkColorGetB(colorCube[i]));
+        *lattice++ = 0;
+    }
 }
 
 void SkColorCubeFilter::filterSpan(const SkPMColor src[], int count, SkPMColor dst[]) const {
-    const int* colorToIndex[2];
-    const SkScalar* colorToFactors[2];
-    const SkScalar* colorToScalar;
-    fCache.getProcessingLuts(&colorToIndex, &colorToFactors, &colorToScalar);
+    const ColorCubeLuts& luts = get_color_cube_luts(fCache.cubeDimension());
+    const float* lattice = fCache.getLattice();
 
-    const int dim = fCache.cubeDimension();
-    SkColor* colorCube = (SkColor*)fCubeData->data();
     for (int i = 0; i < count; ++i) {
-        SkColor inputColor = SkUnPreMultiply::PMColorToColor(src[i]);
-        uint8_t r = SkColorGetR(inputColor);
-        uint8_t g = SkColorGetG(inputColor);
-        uint8_t b = SkColorGetB(inputColor);
-        uint8_t a = SkColorGetA(inputColor);
-        SkScalar rOut(0), gOut(0), bOut(0);
+        SkPMColor c = src[i];
+        unsigned a = SkGetPackedA32(c);
+        unsigned r, g, b;
+        if (255 == a) {
+            // Opaque colors don't need to be unpremultiplied.
+            r = SkGetPackedR32(c);
+            g = SkGetPackedG32(c);
+            b = SkGetPackedB32(c);
+        } else {
+            SkColor inputColor = SkUnPreMultiply::PMColorToColor(c);
+            r = SkColorGetR(inputColor);
+            g = SkColorGetG(inputColor);
+            b = SkColorGetB(inputColor);
+        }
+
+        // Interpolate r, g and b together, one lattice entry per corner of the cell.
+        Sk4f out(0, 0, 0, 0);
         for (int x = 0; x < 2; ++x) {
             for (int y = 0; y < 2; ++y) {
+                const int indexRG = luts.fIndex[0][x][r] + luts.fIndex[1][y][g];
+                const SkScalar factorRG = luts.fFactors[x][r] * luts.fFactors[y][g];
                 for (int z = 0; z < 2; ++z) {
-                    SkColor lutColor = colorCube[colorToIndex[x][r] +
-                                                (colorToIndex[y][g] +
-                                                 colorToIndex[z][b] * dim) * dim];
-                    SkScalar factor = colorToFactors[x][r] *
-                                      colorToFactors[y][g] *
-                                      colorToFactors[z][b];
-                    rOut += colorToScalar[SkColorGetR(lutColor)] * factor;
-                    gOut += colorToScalar[SkColorGetG(lutColor)] * factor;
-                    bOut += colorToScalar[SkColorGetB(lutColor)] * factor;
+                    const int index = indexRG + luts.fIndex[2][z][b];
+                    const float factor = SkScalarToFloat(factorRG * luts.fFactors[z][b]);
+                    out = out.add(Sk4f::Load(lattice + 4 * index)
+                                  .multiply(Sk4f(factor, factor, factor, factor)));
                 }
             }
         }
-        const SkScalar aOut = SkIntToScalar(a);
+
+        const float aOut = (float)a;
+        float result[4];
+        out.multiply(Sk4f(aOut, aOut, aOut, aOut)).store(result);
         dst[i] = SkPackARGB32(a,
-            SkScalarRoundToInt(rOut * aOut),
-            SkScalarRoundToInt(gOut * aOut),
-            SkScalarRoundToInt(bOut * aOut));
+            SkScalarRoundToInt(result[0]),
+            SkScalarRoundToInt(result[1]),
+            SkScalarRoundToInt(result[2]));
     }
 }
 
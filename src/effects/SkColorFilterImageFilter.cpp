@@ -8,71 +8,25 @@
 #include "SkColorFilterImageFilter.h"
 #include "SkBitmap.h"
 #include "SkCanvas.h"
-#include "SkColorMatrixFilter.h"
 #include "SkDevice.h"
 #include "SkColorFilter.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkWriteBuffer.h"
 
-namespace {
-
-void mult_color_matrix(SkScalar a[20], SkScalar b[20], SkScalar out[20]) {
-    for (int j = 0; j < 4; ++j) {
-        for (int i = 0; i < 5; ++i) {
-            out[i+j*5] = 4 == i ? a[4+j*5] : 0;
-            for (int k = 0; k < 4; ++k)
-                out[i+j*5] += SkScalarMul(a[k+j*5], b[i+k*5]);
-        }
-    }
-}
-
-// To detect if we need to apply clamping after applying a matrix, we check if
-// any output component might go outside of [0, 255] for any combination of
-// input components in [0..255].
-// Each output component is an affine transformation of the input component, so
-// the minimum and maximum values are for any combination of minimum or maximum
-// values of input components (i.e. 0 or 255).
-// E.g. if R' = x*R + y*G + z*B + w*A + t
-// Then the maximum value will be for R=255 if x>0 or R=0 if x<0, and the
-// minimum value will be for R=0 if x>0 or R=255 if x<0.
-// Same goes for all components.
-bool component_needs_clamping(SkScalar row[5]) {
-    SkScalar maxValue = row[4] / 255;
-    SkScalar minValue = row[4] / 255;
-    for (int i = 0; i < 4; ++i) {
-        if (row[i] > 0)
-            maxValue += row[i];
-        else
-            minValue += row[i];
-    }
-    return (maxValue > 1) || (minValue < 0);
-}
-
-bool matrix_needs_clamping(SkScalar matrix[20]) {
-    return component_needs_clamping(matrix)
-        || component_needs_clamping(matrix+5)
-        || component_needs_clamping(matrix+10)
-        || component_needs_clamping(matrix+15);
-}
-
-};
-
 SkColorFilterImageFilter* SkColorFilterImageFilter::Create(SkColorFilter* cf,
         SkImageFilter* input, const CropRect* cropRect, uint32_t uniqueID) {
     SkASSERT(cf);
     if (NULL == cf) {
         return NULL;
     }
-    SkScalar colorMatrix[20], inputMatrix[20];
     SkColorFilter* inputColorFilter;
-    if (input && cf->asColorMatrix(colorMatrix)
-              && input->asColorFilter(&inputColorFilter)
-              && (inputColorFilter)) {
+    if (input && input->asColorFilter(&inputColorFilter) && (inputColorFilter)) {
         SkAutoUnref autoUnref(inputColorFilter);
-        if (inputColorFilter->asColorMatrix(inputMatrix) && !matrix_needs_clamping(inputMatrix)) {
-            SkScalar combinedMatrix[20];
-            mult_color_matrix(colorMatrix, inputMatrix, combinedMatrix);
-            SkAutoTUnref<SkColorFilter> newCF(SkColorMatrixFilter::Create(combinedMatrix));
+        // If the two filters fold into one (e.g. concatenated color matrices or composed
+        // tables), collapse the input node so the pixels are only filtered once.
+        SkAutoTUnref<SkColorFilter> newCF(cf->newComposed(inputColorFilter));
+        if (newCF) {
             return SkNEW_ARGS(SkColorFilterImageFilter, (newCF, input->getInput(0), cropRect, 0));
         }
     }
@@ -99,6 +53,73 @@ SkColorFilterImageFilter::~SkColorFilterImageFilter() {
     fColorFilter->unref();
 }
 
+namespace {
+
+// Filtering is done in bands of rows so that large images can be spread across threads.
+static const int kRowsPerBand = 32;
+
+struct FilterBand {
+    const SkColorFilter* fFilter;
+    const SkBitmap*      fSrc;
+    const SkBitmap*      fDst;
+    SkIPoint             fSrcOrigin;
+    SkIPoint             fDstOrigin;
+    int                  fWidth;
+    int                  fTop;
+    int                  fBottom;
+};
+
+void filter_band(FilterBand* band) {
+    for (int y = band->fTop; y < band->fBottom; ++y) {
+        band->fFilter->filterSpan(band->fSrc->getAddr32(band->fSrcOrigin.fX,
+                                                        band->fSrcOrigin.fY + y),
+                                  band->fWidth,
+                                  band->fDst->getAddr32(band->fDstOrigin.fX,
+                                                        band->fDstOrigin.fY + y));
+    }
+}
+
+// Applies filter to the N32 pixels of src, written to dst at (dx, dy). Equivalent to drawing
+// src as a sprite with the filter in kSrc_Mode, but split into bands that can run in parallel.
+// Returns false unless both bitmaps are raster N32, so the caller can draw instead.
+bool filter_bitmap(const SkColorFilter* filter, const SkBitmap& src, const SkBitmap& dst,
+                   int dx, int dy) {
+    if (kN32_SkColorType != src.colorType() || kN32_SkColorType != dst.colorType() ||
+        src.getTexture() || dst.getTexture()) {
+        return false;
+    }
+    SkAutoLockPixels alpSrc(src), alpDst(dst);
+    if (NULL == src.getPixels() || NULL == dst.getPixels()) {
+        return false;
+    }
+
+    SkIRect dstRect = SkIRect::MakeXYWH(dx, dy, src.width(), src.height());
+    if (!dstRect.intersect(SkIRect::MakeWH(dst.width(), dst.height()))) {
+        return true;
+    }
+
+    const int bandCount = (dstRect.height() + kRowsPerBand - 1) / kRowsPerBand;
+    SkAutoTMalloc<FilterBand> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        FilterBand& band = bands[i];
+        band.fFilter = filter;
+        band.fSrc = &src;
+        band.fDst = &dst;
+        band.fSrcOrigin.set(dstRect.fLeft - dx, dstRect.fTop - dy);
+        band.fDstOrigin.set(dstRect.fLeft, dstRect.fTop);
+        band.fWidth = dstRect.width();
+        band.fTop = i * kRowsPerBand;
+        band.fBottom = SkTMin(band.fTop + kRowsPerBand, dstRect.height());
+    }
+
+    SkTaskGroup tg;
+    tg.batch(filter_band, bands.get(), bandCount);
+    tg.wait();
+    return true;
+}
+
+} // end namespace
+
 bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& source,
                                              const Context& ctx,
                                              SkBitmap* result,
@@ -118,12 +139,16 @@ bool SkColorFilterImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& sourc
     if (NULL == device.get()) {
         return false;
     }
-    SkCanvas canvas(device.get());
-    SkPaint paint;
-
-    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
-    paint.setColorFilter(fColorFilter);
-    canvas.drawSprite(src, srcOffset.fX - bounds.fLeft, srcOffset.fY - bounds.fTop, &paint);
+    const int dx = srcOffset.fX - bounds.fLeft;
+    const int dy = srcOffset.fY - bounds.fTop;
+    if (!filter_bitmap(fColorFilter, src, device->accessBitmap(true), dx, dy)) {
+        SkCanvas canvas(device.get());
+        SkPaint paint;
+
+        paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+        paint.setColorFilter(fColorFilter);
+        canvas.drawSprite(src, dx, dy, &paint);
+    }
 
     *result = device.get()->accessBitmap(false);
     offset->fX = bounds.fLeft;
@@ -12,6 +12,7 @@
 #include "SkWriteBuffer.h"
 #include "SkUtils.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 #include "SkValidationUtils.h"
 #include "SkColorMatrixFilter.h"
 
@@ -442,6 +443,11 @@ public:
         sk_memset16(result, SkPixel32ToPixel16(this->getPMColor()), count);
     }
 
+    virtual SkColorFilter* newComposed(const SkColorFilter*) const SK_OVERRIDE {
+        // Our output ignores the input colors, so whatever ran before us is moot.
+        return SkRef(const_cast<Src_SkModeColorFilter*>(this));
+    }
+
 private:
     typedef SkModeColorFilter INHERITED;
 };
@@ -548,6 +554,114 @@ SkColorFilter* SkColorFilter::CreateLightingFilter(SkColor mul, SkColor add) {
     return SkColorMatrixFilter::Create(matrix);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  Applies fInner and then fOuter. Used when the two filters could not be folded into a
+ *  single filter by SkColorFilter::newComposed().
+ */
+class SkComposeColorFilter : public SkColorFilter {
+public:
+    SkComposeColorFilter(SkColorFilter* outer, SkColorFilter* inner)
+        : fOuter(SkRef(outer))
+        , fInner(SkRef(inner)) {}
+
+    virtual uint32_t getFlags() const SK_OVERRIDE {
+        // We can only claim alpha-unchanged and 16bit support if both of our filters do.
+        return fOuter->getFlags() & fInner->getFlags();
+    }
+
+    virtual void filterSpan(const SkPMColor shader[], int count,
+                            SkPMColor result[]) const SK_OVERRIDE {
+        fInner->filterSpan(shader, count, result);
+        fOuter->filterSpan(result, count, result);
+    }
+
+    virtual void filterSpan16(const uint16_t shader[], int count,
+                              uint16_t result[]) const SK_OVERRIDE {
+        SkASSERT(this->getFlags() & kHasFilter16_Flag);
+        fInner->filterSpan16(shader, count, result);
+        fOuter->filterSpan16(result, count, result);
+    }
+
+#ifndef SK_IGNORE_TO_STRING
+    virtual void toString(SkString* str) const SK_OVERRIDE {
+        SkString outerS, innerS;
+        fOuter->toString(&outerS);
+        fInner->toString(&innerS);
+        str->appendf("SkComposeColorFilter: outer(%s) inner(%s)", outerS.c_str(),
+                     innerS.c_str());
+    }
+#endif
+
+    virtual GrFragmentProcessor* asFragmentProcessor(GrContext* context) const SK_OVERRIDE {
+        // Callers that take a single processor can only use us if the pair reduces to one stage.
+        SkTDArray<GrFragmentProcessor*> array;
+        if (!this->asFragmentProcessors(context, &array)) {
+            return NULL;
+        }
+        if (1 == array.count()) {
+            return array[0];
+        }
+        array.unrefAll();
+        return NULL;
+    }
+
+    virtual bool asFragmentProcessors(GrContext* context,
+                                      SkTDArray<GrFragmentProcessor*>* array) const SK_OVERRIDE {
+        // Dropping either stage would draw the wrong colors, so both must be expressible.
+        int count = array->count();
+        if (fInner->asFragmentProcessors(context, array) &&
+            fOuter->asFragmentProcessors(context, array)) {
+            return true;
+        }
+        for (int i = count; i < array->count(); ++i) {
+            (*array)[i]->unref();
+        }
+        array->setCount(count);
+        return false;
+    }
+
+    SK_DECLARE_PUBLIC_FLATTENABLE_DESERIALIZATION_PROCS(SkComposeColorFilter)
+
+protected:
+    virtual void flatten(SkWriteBuffer& buffer) const SK_OVERRIDE {
+        buffer.writeFlattenable(fOuter.get());
+        buffer.writeFlattenable(fInner.get());
+    }
+
+private:
+    SkAutoTUnref<SkColorFilter> fOuter;
+    SkAutoTUnref<SkColorFilter> fInner;
+
+    friend class SkColorFilter;
+
+    typedef SkColorFilter INHERITED;
+};
+
+SkFlattenable* SkComposeColorFilter::CreateProc(SkReadBuffer& buffer) {
+    SkAutoTUnref<SkColorFilter> outer(buffer.readColorFilter());
+    SkAutoTUnref<SkColorFilter> inner(buffer.readColorFilter());
+    return CreateComposeFilter(outer, inner);
+}
+
+SkColorFilter* SkColorFilter::CreateComposeFilter(SkColorFilter* outer, SkColorFilter* inner) {
+    if (NULL == outer) {
+        return SkSafeRef(inner);
+    }
+    if (NULL == inner) {
+        return SkRef(outer);
+    }
+
+    // Give the outer filter a chance to fold the pair into a single span pass.
+    SkColorFilter* composition = outer->newComposed(inner);
+    if (NULL == composition) {
+        composition = SkNEW_ARGS(SkComposeColorFilter, (outer, inner));
+    }
+    return composition;
+}
+
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_START(SkColorFilter)
     SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkModeColorFilter)
+    SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposeColorFilter)
 SK_DEFINE_FLATTENABLE_REGISTRAR_GROUP_END
@@ -6,6 +6,7 @@
  * found in the LICENSE file.
  */
 #include "SkColorMatrixFilter.h"
+#include "Sk4x.h"
 #include "SkColorMatrix.h"
 #include "SkColorPriv.h"
 #include "SkReadBuffer.h"
@@ -123,6 +124,12 @@ static void Add16(const SkColorMatrixFilter::State& state,
 // src is [20] but some compilers won't accept __restrict__ on anything
 // but an raw pointer or reference
 void SkColorMatrixFilter::initState(const SkScalar* SK_RESTRICT src) {
+    for (int j = 0; j < 5; j++) {
+        for (int i = 0; i < 4; i++) {
+            fTranspose[j * 4 + i] = SkScalarToFloat(src[i * 5 + j]);
+        }
+    }
+
     int32_t* array = fState.fArray;
     SkFixed max = 0;
     for (int i = 0; i < 20; i++) {
@@ -222,47 +229,68 @@ uint32_t SkColorMatrixFilter::getFlags() const {
 
 void SkColorMatrixFilter::filterSpan(const SkPMColor src[], int count,
                                      SkPMColor dst[]) const {
-    Proc proc = fProc;
-    const State& state = fState;
-    int32_t result[4];
-
-    if (NULL == proc) {
+    if (NULL == fProc) {
         if (src != dst) {
             memcpy(dst, src, count * sizeof(SkPMColor));
         }
         return;
     }
 
-    const SkUnPreMultiply::Scale* table = SkUnPreMultiply::GetScaleTable();
-
+    const Sk4f c0 = Sk4f::Load(fTranspose + 0);
+    const Sk4f c1 = Sk4f::Load(fTranspose + 4);
+    const Sk4f c2 = Sk4f::Load(fTranspose + 8);
+    const Sk4f c3 = Sk4f::Load(fTranspose + 12);
+    const Sk4f c4 = Sk4f::Load(fTranspose + 16);
+    const Sk4f zero(0, 0, 0, 0);
+    const Sk4f max255(255, 255, 255, 255);
+    // The alpha column's contribution for opaque input, which is nonzero when any of r, g or b
+    // read alpha, even though alpha itself is unchanged.
+    const Sk4f opaqueAlpha = c3.multiply(max255);
+    const bool alphaUnchanged = SkToBool(fFlags & SkColorFilter::kAlphaUnchanged_Flag);
+
+    float result[4];
     for (int i = 0; i < count; i++) {
         SkPMColor c = src[i];
 
-        unsigned r = SkGetPackedR32(c);
-        unsigned g = SkGetPackedG32(c);
-        unsigned b = SkGetPackedB32(c);
+        float r = (float)SkGetPackedR32(c);
+        float g = (float)SkGetPackedG32(c);
+        float b = (float)SkGetPackedB32(c);
         unsigned a = SkGetPackedA32(c);
 
-        // need our components to be un-premultiplied
-        if (255 != a) {
-            SkUnPreMultiply::Scale scale = table[a];
-            r = SkUnPreMultiply::ApplyScale(scale, r);
-            g = SkUnPreMultiply::ApplyScale(scale, g);
-            b = SkUnPreMultiply::ApplyScale(scale, b);
-
-            SkASSERT(r <= 255);
-            SkASSERT(g <= 255);
-            SkASSERT(b <= 255);
+        // Each output component is a row of the matrix dotted with the unpremultiplied input,
+        // so we compute all four at once as a sum of (column * input component).
+        Sk4f rgb = c0.multiply(Sk4f(r, r, r, r))
+              .add(c1.multiply(Sk4f(g, g, g, g)))
+              .add(c2.multiply(Sk4f(b, b, b, b)));
+
+        if (255 == a) {
+            if (alphaUnchanged) {
+                // Opaque in and opaque out: no unpremul, and no premul on the way out.
+                Sk4f::Min(Sk4f::Max(rgb.add(opaqueAlpha).add(c4), zero), max255).store(result);
+                dst[i] = SkPackARGB32(255,
+                                      (int)(result[0] + 0.5f),
+                                      (int)(result[1] + 0.5f),
+                                      (int)(result[2] + 0.5f));
+                continue;
+            }
+        } else {
+            // Unpremultiplying scales r, g and b by the same factor, so we can apply it to
+            // their combined contribution instead of to each component.
+            float scale = a ? 255.0f / a : 0;
+            rgb = rgb.multiply(Sk4f(scale, scale, scale, scale));
         }
 
-        proc(state, r, g, b, a, result);
-
-        r = pin(result[0], SK_R32_MASK);
-        g = pin(result[1], SK_G32_MASK);
-        b = pin(result[2], SK_B32_MASK);
-        a = pin(result[3], SK_A32_MASK);
-        // re-prepremultiply if needed
-        dst[i] = SkPremultiplyARGBInline(a, r, g, b);
+        float fa = (float)a;
+        Sk4f::Min(Sk4f::Max(rgb.add(c3.multiply(Sk4f(fa, fa, fa, fa))).add(c4), zero),
+                  max255).store(result);
+
+        // re-premultiply if needed
+        float outA = result[3];
+        float premul = outA * (1.0f / 255);
+        dst[i] = SkPackARGB32((int)(outA + 0.5f),
+                              (int)(result[0] * premul + 0.5f),
+                              (int)(result[1] * premul + 0.5f),
+                              (int)(result[2] * premul + 0.5f));
     }
 }
 
@@ -322,6 +350,65 @@ bool SkColorMatrixFilter::asColorMatrix(SkScalar matrix[20]) const {
     return true;
 }
 
+// To detect if we need to apply clamping after applying a matrix, we check if
+// any output component might go outside of [0, 255] for any combination of
+// input components in [0..255].
+// Each output component is an affine transformation of the input component, so
+// the minimum and maximum values are for any combination of minimum or maximum
+// values of input components (i.e. 0 or 255).
+// E.g. if R' = x*R + y*G + z*B + w*A + t
+// Then the maximum value will be for R=255 if x>0 or R=0 if x<0, and the
+// minimum value will be for R=0 if x>0 or R=255 if x<0.
+// Same goes for all components.
+static bool component_needs_clamping(const SkScalar row[5]) {
+    SkScalar maxValue = row[4] / 255;
+    SkScalar minValue = row[4] / 255;
+    for (int i = 0; i < 4; ++i) {
+        if (row[i] > 0) {
+            maxValue += row[i];
+        } else {
+            minValue += row[i];
+        }
+    }
+    return (maxValue > 1) || (minValue < 0);
+}
+
+static bool needs_clamping(const SkScalar matrix[20]) {
+    return component_needs_clamping(matrix)
+        || component_needs_clamping(matrix+5)
+        || component_needs_clamping(matrix+10)
+        || component_needs_clamping(matrix+15);
+}
+
+static void set_concat(SkScalar result[20], const SkScalar outer[20], const SkScalar inner[20]) {
+    int index = 0;
+    for (int j = 0; j < 20; j += 5) {
+        for (int i = 0; i < 4; i++) {
+            result[index++] =   outer[j + 0] * inner[i + 0] +
+                                outer[j + 1] * inner[i + 5] +
+                                outer[j + 2] * inner[i + 10] +
+                                outer[j + 3] * inner[i + 15];
+        }
+        result[index++] =   outer[j + 0] * inner[4] +
+                            outer[j + 1] * inner[9] +
+                            outer[j + 2] * inner[14] +
+                            outer[j + 3] * inner[19] +
+                            outer[j + 4];
+    }
+}
+
+SkColorFilter* SkColorMatrixFilter::newComposed(const SkColorFilter* innerFilter) const {
+    SkScalar innerMatrix[20];
+    // If the inner filter clamps, its output is no longer an affine function of its input,
+    // so the two matrices can only be concatenated when it doesn't.
+    if (innerFilter->asColorMatrix(innerMatrix) && !needs_clamping(innerMatrix)) {
+        SkScalar concat[20];
+        set_concat(concat, fMatrix.fMat, innerMatrix);
+        return SkColorMatrixFilter::Create(concat);
+    }
+    return NULL;
+}
+
 #if SK_SUPPORT_GPU
 #include "GrFragmentProcessor.h"
 #include "GrInvariantOutput.h"
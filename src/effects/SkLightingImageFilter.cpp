@@ -6,9 +6,13 @@
  */
 
 #include "SkLightingImageFilter.h"
+#include "Sk4x.h"
 #include "SkBitmap.h"
+#include "SkCachedData.h"
 #include "SkColorPriv.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
+#include "SkTaskGroup.h"
 #include "SkWriteBuffer.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
@@ -48,15 +52,7 @@ void setUniformNormal3(const GrGLProgramDataManager& pdman, UniformHandle uni,
 }
 #endif
 
-// Shift matrix components to the left, as we advance pixels to the right.
-inline void shiftMatrixLeft(int m[9]) {
-    m[0] = m[1];
-    m[3] = m[4];
-    m[6] = m[7];
-    m[1] = m[2];
-    m[4] = m[5];
-    m[7] = m[8];
-}
+inline Sk4f splat(float f) { return Sk4f(f, f, f, f); }
 
 class DiffuseLightingType {
 public:
@@ -72,6 +68,24 @@ public:
                             SkClampMax(SkScalarRoundToInt(color.fY), 255),
                             SkClampMax(SkScalarRoundToInt(color.fZ), 255));
     }
+    // Lights four pixels, given their normals and surface-to-light vectors as x, y and z planes.
+    // lightColor's components are at most 255, so the rounded channels need no upper clamp.
+    void light4(const Sk4f normal[3], const Sk4f surfaceToLight[3], const SkPoint3& lightColor,
+                SkPMColor dst[4]) const {
+        Sk4f dot = normal[0].multiply(surfaceToLight[0])
+                            .add(normal[1].multiply(surfaceToLight[1]))
+                            .add(normal[2].multiply(surfaceToLight[2]));
+        Sk4f colorScale = Sk4f::Max(Sk4f::Min(splat(fKD).multiply(dot), splat(SK_Scalar1)),
+                                    splat(0));
+        const Sk4f half = splat(0.5f);
+        float r[4], g[4], b[4];
+        colorScale.multiply(splat(lightColor.fX)).add(half).store(r);
+        colorScale.multiply(splat(lightColor.fY)).add(half).store(g);
+        colorScale.multiply(splat(lightColor.fZ)).add(half).store(b);
+        for (int i = 0; i < 4; ++i) {
+            dst[i] = SkPackARGB32(255, (int)r[i], (int)g[i], (int)b[i]);
+        }
+    }
 private:
     SkScalar fKD;
 };
@@ -166,97 +180,109 @@ inline SkPoint3 bottomRightNormal(int m[9], SkScalar surfaceScale) {
                          surfaceScale);
 }
 
-template <class LightingType, class LightType> void lightBitmap(
-        const LightingType& lightingType, const SkLight* light, const SkBitmap& src, SkBitmap* dst,
-        SkScalar surfaceScale, const SkIRect& bounds) {
-    SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
-    const LightType* l = static_cast<const LightType*>(light);
-    int left = bounds.left(), right = bounds.right();
-    int bottom = bounds.bottom();
-    int y = bounds.top();
-    SkPMColor* dptr = dst->getAddr32(0, 0);
-    {
-        int x = left;
-        const SkPMColor* row1 = src.getAddr32(x, y);
-        const SkPMColor* row2 = src.getAddr32(x, y + 1);
-        int m[9];
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        m[7] = SkGetPackedA32(*row2++);
-        m[8] = SkGetPackedA32(*row2++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[5] = SkGetPackedA32(*row1++);
-            m[8] = SkGetPackedA32(*row2++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(topNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+typedef SkPoint3 (*NormalProc)(int m[9], SkScalar surfaceScale);
+
+// The normal map for a width x height region holds, for each row, four planes of width floats:
+// the x, y and z components of the surface normal followed by the height (the source alpha).
+// Keeping the planes separate lets the interior of both the normal and lighting passes work on
+// four adjacent pixels at once.
+inline size_t normal_map_size(int width, int height) {
+    return 4 * sizeof(float) * width * height;
+}
+
+inline float* normal_map_row(float* map, int width, int y) { return map + 4 * width * y; }
+inline const float* normal_map_row(const float* map, int width, int y) {
+    return map + 4 * width * y;
+}
+
+// Fills in the heights of rows [top, bottom) of bounds, which start at row 0 of map.
+void fill_heights(const SkBitmap& src, const SkIRect& bounds, int top, int bottom, float* map) {
+    const int width = bounds.width();
+    for (int y = top; y < bottom; ++y) {
+        const SkPMColor* row = src.getAddr32(bounds.left(), bounds.top() + y);
+        float* heights = normal_map_row(map, width, y - top) + 3 * width;
+        for (int x = 0; x < width; ++x) {
+            heights[x] = (float)SkGetPackedA32(row[x]);
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
-
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        const SkPMColor* row0 = src.getAddr32(x, y - 1);
-        const SkPMColor* row1 = src.getAddr32(x, y);
-        const SkPMColor* row2 = src.getAddr32(x, y + 1);
-        int m[9];
-        m[1] = SkGetPackedA32(*row0++);
-        m[2] = SkGetPackedA32(*row0++);
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        m[7] = SkGetPackedA32(*row2++);
-        m[8] = SkGetPackedA32(*row2++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
-            m[2] = SkGetPackedA32(*row0++);
-            m[5] = SkGetPackedA32(*row1++);
-            m[8] = SkGetPackedA32(*row2++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+    }
+}
+
+// Computes the normal at (x, y) with proc, reading the 3x3 neighbourhood from the height planes.
+// Entries that fall outside the map are never read by the border procs and are left at zero.
+void compute_normal(float* map, int width, int height, int x, int y, SkScalar surfaceScale,
+                    NormalProc proc) {
+    int m[9];
+    for (int j = 0; j < 3; ++j) {
+        const int yy = y + j - 1;
+        const float* heights = (yy >= 0 && yy < height) ?
+                               normal_map_row(map, width, yy) + 3 * width : NULL;
+        for (int i = 0; i < 3; ++i) {
+            const int xx = x + i - 1;
+            m[3 * j + i] = (heights && xx >= 0 && xx < width) ? (int)heights[xx] : 0;
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
     }
+    SkPoint3 normal = proc(m, surfaceScale);
+    float* row = normal_map_row(map, width, y);
+    row[x] = normal.fX;
+    row[width + x] = normal.fY;
+    row[2 * width + x] = normal.fZ;
+}
+
+// Four-wide interiorNormal(). The Sobel sums are small integers, so this matches the scalar
+// version bit for bit.
+void compute_interior_normals(float* map, int width, int height, int y, SkScalar surfaceScale) {
+    const float* r0 = normal_map_row(map, width, y - 1) + 3 * width;
+    const float* r1 = normal_map_row(map, width, y) + 3 * width;
+    const float* r2 = normal_map_row(map, width, y + 1) + 3 * width;
+    float* row = normal_map_row(map, width, y);
+    const Sk4f two = splat(2);
+    const Sk4f scale = splat(gOneQuarter).multiply(splat(-surfaceScale));
+    const Sk4f one = splat(SK_Scalar1);
+    const Sk4f epsilon = splat(SK_ScalarNearlyZero);
+    int x = 1;
+    for (; x + 4 <= width - 1; x += 4) {
+        Sk4f tl = Sk4f::Load(r0 + x - 1), t = Sk4f::Load(r0 + x), tr = Sk4f::Load(r0 + x + 1);
+        Sk4f l = Sk4f::Load(r1 + x - 1),                          r = Sk4f::Load(r1 + x + 1);
+        Sk4f bl = Sk4f::Load(r2 + x - 1), b = Sk4f::Load(r2 + x), br = Sk4f::Load(r2 + x + 1);
+        Sk4f sobelX = tr.subtract(tl).add(two.multiply(r.subtract(l))).add(br.subtract(bl));
+        Sk4f sobelY = bl.subtract(tl).add(two.multiply(b.subtract(t))).add(br.subtract(tr));
+        Sk4f nx = sobelX.multiply(scale);
+        Sk4f ny = sobelY.multiply(scale);
+        Sk4f length = nx.multiply(nx).add(ny.multiply(ny)).add(one).sqrt();
+        Sk4f invLength = one.divide(length.add(epsilon));
+        nx.multiply(invLength).store(row + x);
+        ny.multiply(invLength).store(row + width + x);
+        invLength.store(row + 2 * width + x);
+    }
+    for (; x < width - 1; ++x) {
+        compute_normal(map, width, height, x, y, surfaceScale, interiorNormal);
+    }
+}
 
-    {
-        int x = left;
-        const SkPMColor* row0 = src.getAddr32(x, bottom - 2);
-        const SkPMColor* row1 = src.getAddr32(x, bottom - 1);
-        int m[9];
-        m[1] = SkGetPackedA32(*row0++);
-        m[2] = SkGetPackedA32(*row0++);
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[2] = SkGetPackedA32(*row0++);
-            m[5] = SkGetPackedA32(*row1++);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(bottomNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+// Computes the normals of rows [top, bottom) of a region height rows high. map holds rows
+// [mapTop, mapBottom) of the region, which must include the heights of the rows next to those.
+void compute_normal_rows(float* map, int mapTop, int mapBottom, int width, int height, int top,
+                         int bottom, SkScalar surfaceScale) {
+    const int mapHeight = mapBottom - mapTop;
+    for (int y = top; y < bottom; ++y) {
+        NormalProc left, middle, right;
+        if (0 == y) {
+            left = topLeftNormal, middle = topNormal, right = topRightNormal;
+        } else if (height - 1 == y) {
+            left = bottomLeftNormal, middle = bottomNormal, right = bottomRightNormal;
+        } else {
+            left = leftNormal, middle = NULL, right = rightNormal;
+        }
+        const int mapY = y - mapTop;
+        compute_normal(map, width, mapHeight, 0, mapY, surfaceScale, left);
+        if (middle) {
+            for (int x = 1; x < width - 1; ++x) {
+                compute_normal(map, width, mapHeight, x, mapY, surfaceScale, middle);
+            }
+        } else {
+            compute_interior_normals(map, width, mapHeight, mapY, surfaceScale);
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
+        compute_normal(map, width, mapHeight, width - 1, mapY, surfaceScale, right);
     }
 }
 
@@ -589,6 +615,12 @@ public:
     SkPoint3 surfaceToLight(int x, int y, int z, SkScalar surfaceScale) const {
         return fDirection;
     };
+    void surfaceToLight4(const Sk4f&, const Sk4f&, const Sk4f&, SkScalar,
+                         Sk4f surfaceToLight[3]) const {
+        surfaceToLight[0] = splat(fDirection.fX);
+        surfaceToLight[1] = splat(fDirection.fY);
+        surfaceToLight[2] = splat(fDirection.fZ);
+    }
     SkPoint3 lightColor(const SkPoint3&) const { return color(); }
     virtual LightType type() const { return kDistant_LightType; }
     const SkPoint3& direction() const { return fDirection; }
@@ -646,6 +678,18 @@ public:
         direction.normalize();
         return direction;
     };
+    // Four-wide surfaceToLight(), returning x, y and z planes.
+    void surfaceToLight4(const Sk4f& x, const Sk4f& y, const Sk4f& z, SkScalar surfaceScale,
+                         Sk4f surfaceToLight[3]) const {
+        Sk4f dx = splat(fLocation.fX).subtract(x);
+        Sk4f dy = splat(fLocation.fY).subtract(y);
+        Sk4f dz = splat(fLocation.fZ).subtract(z.multiply(splat(surfaceScale)));
+        Sk4f length = dx.multiply(dx).add(dy.multiply(dy)).add(dz.multiply(dz)).sqrt();
+        Sk4f scale = splat(SK_Scalar1).divide(length.add(splat(SK_ScalarNearlyZero)));
+        surfaceToLight[0] = dx.multiply(scale);
+        surfaceToLight[1] = dy.multiply(scale);
+        surfaceToLight[2] = dz.multiply(scale);
+    }
     SkPoint3 lightColor(const SkPoint3&) const { return color(); }
     virtual LightType type() const { return kPoint_LightType; }
     const SkPoint3& location() const { return fLocation; }
@@ -833,6 +877,263 @@ const SkScalar SkSpotLight::kSpecularExponentMax = 128.0f;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+template <class LightingType, class LightType>
+inline SkPMColor light_pixel(const LightingType& lightingType, const LightType* light,
+                             const float* row, int width, int x, int left, int y,
+                             SkScalar surfaceScale) {
+    SkPoint3 normal(row[x], row[width + x], row[2 * width + x]);
+    SkPoint3 surfaceToLight = light->surfaceToLight(left + x, y, (int)row[3 * width + x],
+                                                    surfaceScale);
+    return lightingType.light(normal, surfaceToLight, light->lightColor(surfaceToLight));
+}
+
+// Lights one row of the normal map into dst. left and y are the source coordinates of the row's
+// first pixel.
+template <class LightingType, class LightType>
+void light_row(const LightingType& lightingType, const LightType* light, const float* row,
+               int width, int left, int y, SkScalar surfaceScale, SkPMColor* dst) {
+    for (int x = 0; x < width; ++x) {
+        dst[x] = light_pixel(lightingType, light, row, width, x, left, y, surfaceScale);
+    }
+}
+
+// Distant and point lights have a constant color, so diffuse lighting from them can be computed
+// four pixels at a time.
+template <class LightType>
+void diffuse_light_row(const DiffuseLightingType& lightingType, const LightType* light,
+                       const float* row, int width, int left, int y, SkScalar surfaceScale,
+                       SkPMColor* dst) {
+    const Sk4f ys = splat(SkIntToScalar(y));
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        const Sk4f normal[3] = {
+            Sk4f::Load(row + x), Sk4f::Load(row + width + x), Sk4f::Load(row + 2 * width + x)
+        };
+        const float fx = SkIntToScalar(left + x);
+        Sk4f surfaceToLight[3];
+        light->surfaceToLight4(Sk4f(fx, fx + 1, fx + 2, fx + 3), ys,
+                               Sk4f::Load(row + 3 * width + x), surfaceScale, surfaceToLight);
+        lightingType.light4(normal, surfaceToLight, light->color(), dst + x);
+    }
+    for (; x < width; ++x) {
+        dst[x] = light_pixel(lightingType, light, row, width, x, left, y, surfaceScale);
+    }
+}
+
+template <>
+void light_row<DiffuseLightingType, SkDistantLight>(const DiffuseLightingType& lightingType,
+                                                    const SkDistantLight* light, const float* row,
+                                                    int width, int left, int y,
+                                                    SkScalar surfaceScale, SkPMColor* dst) {
+    diffuse_light_row(lightingType, light, row, width, left, y, surfaceScale, dst);
+}
+
+template <>
+void light_row<DiffuseLightingType, SkPointLight>(const DiffuseLightingType& lightingType,
+                                                  const SkPointLight* light, const float* row,
+                                                  int width, int left, int y,
+                                                  SkScalar surfaceScale, SkPMColor* dst) {
+    diffuse_light_row(lightingType, light, row, width, left, y, surfaceScale, dst);
+}
+
+// Rows of both passes are processed in bands of this height, which may run on different threads.
+const int kRowsPerBand = 32;
+
+struct NormalBand {
+    float*   fNormals;
+    int      fWidth;
+    int      fHeight;
+    int      fTop;
+    int      fBottom;
+    SkScalar fSurfaceScale;
+};
+
+void compute_normal_band(NormalBand* band) {
+    compute_normal_rows(band->fNormals, 0, band->fHeight, band->fWidth, band->fHeight,
+                        band->fTop, band->fBottom, band->fSurfaceScale);
+}
+
+template <class LightingType, class LightType>
+struct LightingBand {
+    const LightingType* fLightingType;
+    const LightType*    fLight;
+    const float*        fNormals;   // the whole normal map, or NULL to compute the band's own
+    const SkBitmap*     fSrc;
+    SkBitmap*           fDst;
+    SkIRect             fBounds;
+    int                 fTop;
+    int                 fBottom;
+    SkScalar            fSurfaceScale;
+};
+
+template <class LightingType, class LightType>
+void light_band(LightingBand<LightingType, LightType>* band) {
+    const int width = band->fBounds.width();
+    const float* normals = band->fNormals;
+    int mapTop = 0;
+    SkAutoTMalloc<float> bandNormals;
+    if (NULL == normals) {
+        // Only this band's rows, plus the rows next to them for their heights.
+        const int height = band->fBounds.height();
+        mapTop = SkTMax(band->fTop - 1, 0);
+        const int mapBottom = SkTMin(band->fBottom + 1, height);
+        bandNormals.reset(normal_map_size(width, mapBottom - mapTop) / sizeof(float));
+        fill_heights(*band->fSrc, band->fBounds, mapTop, mapBottom, bandNormals.get());
+        compute_normal_rows(bandNormals.get(), mapTop, mapBottom, width, height, band->fTop,
+                            band->fBottom, band->fSurfaceScale);
+        normals = bandNormals.get();
+    }
+    for (int y = band->fTop; y < band->fBottom; ++y) {
+        light_row(*band->fLightingType, band->fLight,
+                  normal_map_row(normals, width, y - mapTop), width, band->fBounds.left(),
+                  band->fBounds.top() + y, band->fSurfaceScale, band->fDst->getAddr32(0, y));
+    }
+}
+
+// Normal maps depend only on the source alpha and the surface scale, so they are cached by the
+// source's generation ID. Animating just the light then only pays for the lighting pass. At
+// 16 bytes a pixel they are big, so only small ones are cached; for the rest each band of the
+// lighting pass computes the normals it needs.
+static const size_t kMaxCachedNormalMapBytes = 256 * 1024;
+
+static unsigned gNormalMapKeyNamespaceLabel;
+
+struct NormalMapKey : public SkResourceCache::Key {
+public:
+    NormalMapKey(uint32_t genID, const SkIRect& bounds, SkScalar surfaceScale)
+        : fGenID(genID)
+        , fBounds(bounds)
+        , fSurfaceScale(surfaceScale)
+    {
+        this->init(&gNormalMapKeyNamespaceLabel,
+                   sizeof(fGenID) + sizeof(fBounds) + sizeof(fSurfaceScale));
+    }
+
+    uint32_t fGenID;
+    SkIRect  fBounds;
+    SkScalar fSurfaceScale;
+};
+
+struct NormalMapRec : public SkResourceCache::Rec {
+    NormalMapRec(const NormalMapKey& key, SkCachedData* data)
+        : fKey(key)
+        , fData(data)
+    {
+        fData->attachToCacheAndRef();
+    }
+    ~NormalMapRec() {
+        fData->detachFromCacheAndUnref();
+    }
+
+    NormalMapKey  fKey;
+    SkCachedData* fData;
+
+    virtual const Key& getKey() const SK_OVERRIDE { return fKey; }
+    virtual size_t bytesUsed() const SK_OVERRIDE { return sizeof(*this) + fData->size(); }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const NormalMapRec& rec = static_cast<const NormalMapRec&>(baseRec);
+        SkCachedData** result = (SkCachedData**)contextData;
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (NULL == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+
+// Returns a ref to the cached normal map for bounds (in src's coordinates), computing it if
+// need be, or NULL on failure.
+SkCachedData* find_or_compute_normal_map(const SkBitmap& src, const SkIRect& bounds,
+                                         SkScalar surfaceScale) {
+    SkIRect pixelRefBounds = bounds;
+    pixelRefBounds.offset(src.pixelRefOrigin());
+    NormalMapKey key(src.getGenerationID(), pixelRefBounds, surfaceScale);
+    SkCachedData* data = NULL;
+    if (SkResourceCache::Find(key, NormalMapRec::Visitor, &data)) {
+        return data;
+    }
+
+    const int width = bounds.width(), height = bounds.height();
+    data = SkResourceCache::NewCachedData(normal_map_size(width, height));
+    if (NULL == data) {
+        return NULL;
+    }
+    float* normals = (float*)data->writable_data();
+    fill_heights(src, bounds, 0, height, normals);
+
+    const int bandCount = (height + kRowsPerBand - 1) / kRowsPerBand;
+    SkAutoTMalloc<NormalBand> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        NormalBand& band = bands[i];
+        band.fNormals = normals;
+        band.fWidth = width;
+        band.fHeight = height;
+        band.fTop = i * kRowsPerBand;
+        band.fBottom = SkTMin(band.fTop + kRowsPerBand, height);
+        band.fSurfaceScale = surfaceScale;
+    }
+    SkTaskGroup tg;
+    tg.batch(compute_normal_band, bands.get(), bandCount);
+    tg.wait();
+
+    SkResourceCache::Add(SkNEW_ARGS(NormalMapRec, (key, data)));
+    return data;
+}
+
+// Only a source that is drawn again unchanged can hit in the cache. The output of an input
+// filter, or a copy made to pad out the crop rect, has a new generation ID every time it's
+// made, so caching their normals would only evict entries that could be reused. A mutable
+// bitmap may change its pixels without changing its ID (e.g. when written to directly), so
+// its normals can't be trusted later.
+bool has_stable_source(const SkBitmap& source, const SkBitmap& src) {
+    return src.getGenerationID() == source.getGenerationID() && source.isImmutable();
+}
+
+template <class LightingType, class LightType> bool lightBitmap(
+        const LightingType& lightingType, const SkLight* light, const SkBitmap& src, SkBitmap* dst,
+        SkScalar surfaceScale, const SkIRect& bounds, bool cacheNormals) {
+    SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
+    SkAutoTUnref<SkCachedData> normals;
+    if (cacheNormals &&
+        normal_map_size(bounds.width(), bounds.height()) <= kMaxCachedNormalMapBytes) {
+        normals.reset(find_or_compute_normal_map(src, bounds, surfaceScale));
+        if (NULL == normals.get()) {
+            return false;
+        }
+    }
+
+    typedef LightingBand<LightingType, LightType> Band;
+    const int bandCount = (bounds.height() + kRowsPerBand - 1) / kRowsPerBand;
+    SkAutoTMalloc<Band> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        Band& band = bands[i];
+        band.fLightingType = &lightingType;
+        band.fLight = static_cast<const LightType*>(light);
+        band.fNormals = normals.get() ? (const float*)normals->data() : NULL;
+        band.fSrc = &src;
+        band.fDst = dst;
+        band.fBounds = bounds;
+        band.fTop = i * kRowsPerBand;
+        band.fBottom = SkTMin(band.fTop + kRowsPerBand, bounds.height());
+        band.fSurfaceScale = surfaceScale;
+    }
+    SkTaskGroup tg;
+    tg.batch(light_band<LightingType, LightType>, bands.get(), bandCount);
+    tg.wait();
+    return true;
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
 void SkLight::flattenLight(SkWriteBuffer& buffer) const {
     // Write type first, then baseclass, then subclass.
     buffer.writeInt(this->type());
@@ -1016,20 +1317,18 @@ bool SkDiffuseLightingImageFilter::onFilterImage(Proxy* proxy,
 
     SkAutoTUnref<SkLight> transformedLight(light()->transform(ctx.ctm()));
 
+    bool cacheNormals = has_stable_source(source, src);
     DiffuseLightingType lightingType(fKD);
     offset->fX = bounds.left();
     offset->fY = bounds.top();
     bounds.offset(-srcOffset);
     switch (transformedLight->type()) {
         case SkLight::kDistant_LightType:
-            lightBitmap<DiffuseLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
-            break;
+            return lightBitmap<DiffuseLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, cacheNormals);
         case SkLight::kPoint_LightType:
-            lightBitmap<DiffuseLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
-            break;
+            return lightBitmap<DiffuseLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, cacheNormals);
         case SkLight::kSpot_LightType:
-            lightBitmap<DiffuseLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
-            break;
+            return lightBitmap<DiffuseLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, cacheNormals);
     }
 
     return true;
@@ -1128,16 +1427,14 @@ bool SkSpecularLightingImageFilter::onFilterImage(Proxy* proxy,
     offset->fY = bounds.top();
     bounds.offset(-srcOffset);
     SkAutoTUnref<SkLight> transformedLight(light()->transform(ctx.ctm()));
+    bool cacheNormals = has_stable_source(source, src);
     switch (transformedLight->type()) {
         case SkLight::kDistant_LightType:
-            lightBitmap<SpecularLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
-            break;
+            return lightBitmap<SpecularLightingType, SkDistantLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, cacheNormals);
         case SkLight::kPoint_LightType:
-            lightBitmap<SpecularLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
-            break;
+            return lightBitmap<SpecularLightingType, SkPointLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, cacheNormals);
         case SkLight::kSpot_LightType:
-            lightBitmap<SpecularLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds);
-            break;
+            return lightBitmap<SpecularLightingType, SkSpotLight>(lightingType, transformedLight, src, dst, surfaceScale(), bounds, cacheNormals);
     }
     return true;
 }
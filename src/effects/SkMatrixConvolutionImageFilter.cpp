@@ -6,11 +6,13 @@
  */
 
 #include "SkMatrixConvolutionImageFilter.h"
+#include "Sk4x.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkRect.h"
+#include "SkTaskGroup.h"
 #include "SkUnPreMultiply.h"
 
 #if SK_SUPPORT_GPU
@@ -21,6 +23,58 @@
 // by the size of a scalar to know how many scalars we can read.
 static const int32_t gMaxKernelSize = SK_MaxS32 / sizeof(SkScalar);
 
+// Rows are filtered in bands of this height, which may run on different threads.
+static const int kRowsPerBand = 32;
+
+// If kernel[y][x] == kernelY[y] * kernelX[x] for all x, y (up to float precision), writes the
+// two factors to kernelXY (width entries for kernelX, followed by height entries for kernelY)
+// and returns true.
+static bool factor_separable_kernel(const SkISize& size, const SkScalar* kernel,
+                                    SkScalar* kernelXY) {
+    const int width = size.width(), height = size.height();
+    if (width < 2 || height < 2) {
+        // Splitting a single row or column into two passes would only add one.
+        return false;
+    }
+
+    // Pivot on the largest entry.
+    int pivotX = 0, pivotY = 0;
+    SkScalar maxAbs = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            SkScalar v = SkScalarAbs(kernel[y * width + x]);
+            if (v > maxAbs) {
+                maxAbs = v;
+                pivotX = x;
+                pivotY = y;
+            }
+        }
+    }
+    if (0 == maxAbs) {
+        return false;
+    }
+
+    SkScalar* kernelX = kernelXY;
+    SkScalar* kernelY = kernelXY + width;
+    const SkScalar pivot = kernel[pivotY * width + pivotX];
+    for (int x = 0; x < width; ++x) {
+        kernelX[x] = kernel[pivotY * width + x];
+    }
+    for (int y = 0; y < height; ++y) {
+        kernelY[y] = kernel[y * width + pivotX] / pivot;
+    }
+
+    const SkScalar tolerance = maxAbs * 1e-6f;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (SkScalarAbs(kernelY[y] * kernelX[x] - kernel[y * width + x]) > tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 SkMatrixConvolutionImageFilter::SkMatrixConvolutionImageFilter(
     const SkISize& kernelSize,
     const SkScalar* kernel,
@@ -42,6 +96,11 @@ SkMatrixConvolutionImageFilter::SkMatrixConvolutionImageFilter(
     size_t size = (size_t) sk_64_mul(fKernelSize.width(), fKernelSize.height());
     fKernel = SkNEW_ARRAY(SkScalar, size);
     memcpy(fKernel, kernel, size * sizeof(SkScalar));
+    fSeparableKernel = SkNEW_ARRAY(SkScalar, fKernelSize.width() + fKernelSize.height());
+    if (!factor_separable_kernel(fKernelSize, fKernel, fSeparableKernel)) {
+        delete[] fSeparableKernel;
+        fSeparableKernel = NULL;
+    }
     SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
     SkASSERT(kernelOffset.fX >= 0 && kernelOffset.fX < kernelSize.fWidth);
     SkASSERT(kernelOffset.fY >= 0 && kernelOffset.fY < kernelSize.fHeight);
@@ -117,6 +176,7 @@ void SkMatrixConvolutionImageFilter::flatten(SkWriteBuffer& buffer) const {
 
 SkMatrixConvolutionImageFilter::~SkMatrixConvolutionImageFilter() {
     delete[] fKernel;
+    delete[] fSeparableKernel;
 }
 
 class UncheckedPixelFetcher {
@@ -161,6 +221,34 @@ public:
     }
 };
 
+// Components in r, g, b, a order.
+static inline Sk4f pixel_to_4f(SkPMColor s) {
+    return Sk4f(SkIntToScalar(SkGetPackedR32(s)), SkIntToScalar(SkGetPackedG32(s)),
+                SkIntToScalar(SkGetPackedB32(s)), SkIntToScalar(SkGetPackedA32(s)));
+}
+
+static inline Sk4f splat(SkScalar k) {
+    return Sk4f(k, k, k, k);
+}
+
+// Applies gain and bias to the convolution sum and writes the pixel.
+template<class PixelFetcher, bool convolveAlpha>
+static inline SkPMColor convolution_result(const Sk4f& sum, SkScalar gain, SkScalar bias,
+                                           const SkBitmap& src, int x, int y,
+                                           const SkIRect& bounds) {
+    SkScalar rgba[4];
+    sum.multiply(splat(gain)).add(splat(bias)).store(rgba);
+    int a = convolveAlpha ? SkClampMax(SkScalarFloorToInt(rgba[3]), 255) : 255;
+    int r = SkClampMax(SkScalarFloorToInt(rgba[0]), a);
+    int g = SkClampMax(SkScalarFloorToInt(rgba[1]), a);
+    int b = SkClampMax(SkScalarFloorToInt(rgba[2]), a);
+    if (!convolveAlpha) {
+        a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
+        return SkPreMultiplyARGB(a, r, g, b);
+    }
+    return SkPackARGB32(a, r, g, b);
+}
+
 template<class PixelFetcher, bool convolveAlpha>
 void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
                                                   SkBitmap* result,
@@ -173,38 +261,84 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     for (int y = rect.fTop; y < rect.fBottom; ++y) {
         SkPMColor* dptr = result->getAddr32(rect.fLeft - bounds.fLeft, y - bounds.fTop);
         for (int x = rect.fLeft; x < rect.fRight; ++x) {
-            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
+            Sk4f sum(0, 0, 0, 0);
+            const SkScalar* k = fKernel;
             for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
                 for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
                     SkPMColor s = PixelFetcher::fetch(src,
                                                       x + cx - fKernelOffset.fX,
                                                       y + cy - fKernelOffset.fY,
                                                       bounds);
-                    SkScalar k = fKernel[cy * fKernelSize.fWidth + cx];
-                    if (convolveAlpha) {
-                        sumA += SkScalarMul(SkIntToScalar(SkGetPackedA32(s)), k);
-                    }
-                    sumR += SkScalarMul(SkIntToScalar(SkGetPackedR32(s)), k);
-                    sumG += SkScalarMul(SkIntToScalar(SkGetPackedG32(s)), k);
-                    sumB += SkScalarMul(SkIntToScalar(SkGetPackedB32(s)), k);
+                    sum = sum.add(pixel_to_4f(s).multiply(splat(*k++)));
                 }
             }
-            int a = convolveAlpha
-                  ? SkClampMax(SkScalarFloorToInt(SkScalarMul(sumA, fGain) + fBias), 255)
-                  : 255;
-            int r = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumR, fGain) + fBias), a);
-            int g = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumG, fGain) + fBias), a);
-            int b = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumB, fGain) + fBias), a);
-            if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
-            } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
+            *dptr++ = convolution_result<PixelFetcher, convolveAlpha>(sum, fGain, fBias,
+                                                                     src, x, y, bounds);
+        }
+    }
+}
+
+template<class PixelFetcher, bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterPixelsSeparable(const SkBitmap& src,
+                                                           SkBitmap* result,
+                                                           const SkIRect& r,
+                                                           const SkIRect& bounds) const {
+    SkIRect rect(r);
+    if (!rect.intersect(bounds)) {
+        return;
+    }
+    const SkScalar* kernelX = fSeparableKernel;
+    const SkScalar* kernelY = fSeparableKernel + fKernelSize.fWidth;
+    const int width = rect.width();
+    const int top = rect.fTop - fKernelOffset.fY;
+    const int rows = rect.height() + fKernelSize.fHeight - 1;
+
+    // Horizontal pass, over every source row the vertical pass will read.
+    SkAutoTMalloc<SkScalar> storage(4 * width * rows);
+    SkScalar* temp = storage.get();
+    for (int j = 0; j < rows; ++j) {
+        const int y = top + j;
+        for (int x = rect.fLeft; x < rect.fRight; ++x) {
+            Sk4f sum(0, 0, 0, 0);
+            for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
+                SkPMColor s = PixelFetcher::fetch(src, x + cx - fKernelOffset.fX, y, bounds);
+                sum = sum.add(pixel_to_4f(s).multiply(splat(kernelX[cx])));
+            }
+            sum.store(temp);
+            temp += 4;
+        }
+    }
+
+    // Vertical pass.
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        SkPMColor* dptr = result->getAddr32(rect.fLeft - bounds.fLeft, y - bounds.fTop);
+        const SkScalar* column = storage.get() + 4 * width * (y - rect.fTop);
+        for (int x = rect.fLeft; x < rect.fRight; ++x) {
+            Sk4f sum(0, 0, 0, 0);
+            const SkScalar* t = column;
+            for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
+                sum = sum.add(Sk4f::Load(t).multiply(splat(kernelY[cy])));
+                t += 4 * width;
             }
+            column += 4;
+            *dptr++ = convolution_result<PixelFetcher, convolveAlpha>(sum, fGain, fBias,
+                                                                     src, x, y, bounds);
         }
     }
 }
 
+template<class PixelFetcher>
+void SkMatrixConvolutionImageFilter::filterPixelsSeparable(const SkBitmap& src,
+                                                           SkBitmap* result,
+                                                           const SkIRect& rect,
+                                                           const SkIRect& bounds) const {
+    if (fConvolveAlpha) {
+        filterPixelsSeparable<PixelFetcher, true>(src, result, rect, bounds);
+    } else {
+        filterPixelsSeparable<PixelFetcher, false>(src, result, rect, bounds);
+    }
+}
+
 template<class PixelFetcher>
 void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
                                                   SkBitmap* result,
@@ -241,6 +375,68 @@ void SkMatrixConvolutionImageFilter::filterBorderPixels(const SkBitmap& src,
     }
 }
 
+void SkMatrixConvolutionImageFilter::filterSeparablePixels(const SkBitmap& src,
+                                                           SkBitmap* result,
+                                                           const SkIRect& rect,
+                                                           const SkIRect& bounds) const {
+    SkASSERT(fSeparableKernel);
+    switch (fTileMode) {
+        case kClamp_TileMode:
+            filterPixelsSeparable<ClampPixelFetcher>(src, result, rect, bounds);
+            break;
+        case kRepeat_TileMode:
+            filterPixelsSeparable<RepeatPixelFetcher>(src, result, rect, bounds);
+            break;
+        case kClampToBlack_TileMode:
+            filterPixelsSeparable<ClampToBlackPixelFetcher>(src, result, rect, bounds);
+            break;
+    }
+}
+
+struct SkMatrixConvolutionImageFilter::Band {
+    const SkMatrixConvolutionImageFilter* fFilter;
+    const SkBitmap* fSrc;
+    SkBitmap*       fResult;
+    SkIRect         fBounds;
+    SkIRect         fInterior;
+    int             fTop;
+    int             fBottom;
+};
+
+void SkMatrixConvolutionImageFilter::FilterBand(Band* band) {
+    const SkMatrixConvolutionImageFilter* filter = band->fFilter;
+    const SkBitmap& src = *band->fSrc;
+    SkBitmap* result = band->fResult;
+    const SkIRect& bounds = band->fBounds;
+    const SkIRect& interior = band->fInterior;
+    const SkIRect rows = SkIRect::MakeLTRB(bounds.left(), band->fTop,
+                                           bounds.right(), band->fBottom);
+
+    if (filter->fSeparableKernel) {
+        filter->filterSeparablePixels(src, result, rows, bounds);
+        return;
+    }
+
+    // Split the band into the pixels whose kernel fits in bounds, which can be fetched
+    // without checking, and the border around them.
+    const int interiorTop = SkPin32(interior.top(), rows.top(), rows.bottom());
+    const int interiorBottom = SkPin32(interior.bottom(), interiorTop, rows.bottom());
+    SkIRect top = SkIRect::MakeLTRB(bounds.left(), rows.top(), bounds.right(), interiorTop);
+    SkIRect bottom = SkIRect::MakeLTRB(bounds.left(), interiorBottom,
+                                       bounds.right(), rows.bottom());
+    SkIRect left = SkIRect::MakeLTRB(bounds.left(), interiorTop,
+                                     interior.left(), interiorBottom);
+    SkIRect right = SkIRect::MakeLTRB(interior.right(), interiorTop,
+                                      bounds.right(), interiorBottom);
+    SkIRect middle = SkIRect::MakeLTRB(interior.left(), interiorTop,
+                                       interior.right(), interiorBottom);
+    filter->filterBorderPixels(src, result, top, bounds);
+    filter->filterBorderPixels(src, result, left, bounds);
+    filter->filterInteriorPixels(src, result, middle, bounds);
+    filter->filterBorderPixels(src, result, right, bounds);
+    filter->filterBorderPixels(src, result, bottom, bounds);
+}
+
 // FIXME:  This should be refactored to SkImageFilterUtils for
 // use by other filters.  For now, we assume the input is always
 // premultiplied and unpremultiply it
@@ -304,18 +500,22 @@ bool SkMatrixConvolutionImageFilter::onFilterImage(Proxy* proxy,
                                          bounds.top() + fKernelOffset.fY,
                                          bounds.width() - fKernelSize.fWidth + 1,
                                          bounds.height() - fKernelSize.fHeight + 1);
-    SkIRect top = SkIRect::MakeLTRB(bounds.left(), bounds.top(), bounds.right(), interior.top());
-    SkIRect bottom = SkIRect::MakeLTRB(bounds.left(), interior.bottom(),
-                                       bounds.right(), bounds.bottom());
-    SkIRect left = SkIRect::MakeLTRB(bounds.left(), interior.top(),
-                                     interior.left(), interior.bottom());
-    SkIRect right = SkIRect::MakeLTRB(interior.right(), interior.top(),
-                                      bounds.right(), interior.bottom());
-    filterBorderPixels(src, result, top, bounds);
-    filterBorderPixels(src, result, left, bounds);
-    filterInteriorPixels(src, result, interior, bounds);
-    filterBorderPixels(src, result, right, bounds);
-    filterBorderPixels(src, result, bottom, bounds);
+
+    const int bandCount = (bounds.height() + kRowsPerBand - 1) / kRowsPerBand;
+    SkAutoTMalloc<Band> bands(bandCount);
+    for (int i = 0; i < bandCount; ++i) {
+        Band& band = bands[i];
+        band.fFilter = this;
+        band.fSrc = &src;
+        band.fResult = result;
+        band.fBounds = bounds;
+        band.fInterior = interior;
+        band.fTop = bounds.top() + i * kRowsPerBand;
+        band.fBottom = SkTMin(band.fTop + kRowsPerBand, bounds.bottom());
+    }
+    SkTaskGroup tg;
+    tg.batch(FilterBand, bands.get(), bandCount);
+    tg.wait();
     return true;
 }
 
@@ -35,15 +35,93 @@ void SkMorphologyImageFilter::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fRadius.fHeight);
 }
 
+enum MorphType {
+    kDilate, kErode
+};
+
 enum MorphDirection {
     kX, kY
 };
 
+template<MorphType type>
+static inline unsigned morph_pick_component(unsigned a, unsigned b) {
+    return type == kDilate ? SkTMax(a, b) : SkTMin(a, b);
+}
+
+template<MorphType type>
+static inline SkPMColor morph_pick(SkPMColor a, SkPMColor b) {
+    return SkPackARGB32(morph_pick_component<type>(SkGetPackedA32(a), SkGetPackedA32(b)),
+                        morph_pick_component<type>(SkGetPackedR32(a), SkGetPackedR32(b)),
+                        morph_pick_component<type>(SkGetPackedG32(a), SkGetPackedG32(b)),
+                        morph_pick_component<type>(SkGetPackedB32(a), SkGetPackedB32(b)));
+}
+
+/*  van Herk/Gil-Werman: split each line into blocks of one window width, and record the
+    running min/max from the start of each block (prefix) and to its end (suffix). Any window
+    covers at most two blocks, so its result is the suffix at its first pixel combined with
+    the prefix at its last one: three picks per pixel whatever the radius.
+ */
+template<MorphType type, MorphDirection direction>
+static void morph_van_herk(const SkPMColor* src, SkPMColor* dst,
+                           int radius, int width, int height,
+                           int srcStride, int dstStride)
+{
+    const int srcStrideX = direction == kX ? 1 : srcStride;
+    const int dstStrideX = direction == kX ? 1 : dstStride;
+    const int srcStrideY = direction == kX ? srcStride : 1;
+    const int dstStrideY = direction == kX ? dstStride : 1;
+    radius = SkMin32(radius, width - 1);
+    const int blockSize = 2 * radius + 1;
+    const int lastBlockStart = (width - 1) / blockSize * blockSize;
+
+    SkAutoTMalloc<SkPMColor> storage(2 * width);
+    SkPMColor* prefix = storage.get();
+    SkPMColor* suffix = prefix + width;
+    for (int y = 0; y < height; ++y) {
+        const SkPMColor* sptr = src + y * srcStrideY;
+        for (int x = 0, blockX = 0; x < width; ++x, ++blockX) {
+            SkPMColor p = sptr[x * srcStrideX];
+            if (blockX == blockSize) {
+                blockX = 0;
+            }
+            prefix[x] = blockX ? morph_pick<type>(prefix[x - 1], p) : p;
+        }
+        for (int x = width - 1, blockX = width - 1 - lastBlockStart; x >= 0; --x, --blockX) {
+            SkPMColor p = sptr[x * srcStrideX];
+            if (blockX < 0) {
+                blockX = blockSize - 1;
+            }
+            bool blockEnd = (x == width - 1) || (blockX == blockSize - 1);
+            suffix[x] = blockEnd ? p : morph_pick<type>(suffix[x + 1], p);
+        }
+
+        SkPMColor* dptr = dst + y * dstStrideY;
+        for (int x = 0; x < width; ++x) {
+            const int lower = x - radius;
+            const int upper = SkMin32(x + radius, width - 1);
+            if (lower <= 0) {
+                // The window is clipped to the start of the line, where the first block begins.
+                *dptr = prefix[upper];
+            } else if (lower >= lastBlockStart) {
+                // The window is clipped to the end of the line, inside the last block.
+                *dptr = suffix[lower];
+            } else {
+                *dptr = morph_pick<type>(suffix[lower], prefix[upper]);
+            }
+            dptr += dstStrideX;
+        }
+    }
+}
+
 template<MorphDirection direction>
 static void erode(const SkPMColor* src, SkPMColor* dst,
                   int radius, int width, int height,
                   int srcStride, int dstStride)
 {
+    if (radius >= kSkMorphologyVanHerkMinRadius) {
+        morph_van_herk<kErode, direction>(src, dst, radius, width, height, srcStride, dstStride);
+        return;
+    }
     const int srcStrideX = direction == kX ? 1 : srcStride;
     const int dstStrideX = direction == kX ? 1 : dstStride;
     const int srcStrideY = direction == kX ? srcStride : 1;
@@ -82,6 +160,10 @@ static void dilate(const SkPMColor* src, SkPMColor* dst,
                    int radius, int width, int height,
                    int srcStride, int dstStride)
 {
+    if (radius >= kSkMorphologyVanHerkMinRadius) {
+        morph_van_herk<kDilate, direction>(src, dst, radius, width, height, srcStride, dstStride);
+        return;
+    }
     const int srcStrideX = direction == kX ? 1 : srcStride;
     const int dstStrideX = direction == kX ? 1 : dstStride;
     const int srcStrideY = direction == kX ? srcStride : 1;
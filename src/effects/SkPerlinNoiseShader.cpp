@@ -7,8 +7,11 @@
 
 #include "SkDither.h"
 #include "SkPerlinNoiseShader.h"
+#include "Sk4x.h"
+#include "SkCachedData.h"
 #include "SkColorFilter.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkWriteBuffer.h"
 #include "SkShader.h"
 #include "SkUnPreMultiply.h"
@@ -27,6 +30,11 @@ static const int kBlockSize = 256;
 static const int kBlockMask = kBlockSize - 1;
 static const int kPerlinNoise = 4096;
 static const int kRandMaximum = SK_MaxS32; // 2**31 - 1
+// Stitch tiles up to this many pixels have their colors cached; see findTileColors().
+static const int kMaxCachedTilePixels = 512 * 512;
+// A context only renders the whole tile once it has shaded this fraction of the tile's pixels
+// itself, so small draws of a large tile don't pay for all of it.
+static const int kTileCoverageDivisor = 4;
 
 namespace {
 
@@ -50,6 +58,236 @@ inline SkScalar smoothCurve(SkScalar t) {
     return SkScalarMul(SkScalarSquare(t), SK_Scalar3 - 2 * t);
 }
 
+inline Sk4f splat(float f) { return Sk4f(f, f, f, f); }
+
+// According to the SVG spec, we must truncate (not round) the seed value, and then clamp it to
+// the range [1, kRandMaximum - 1].
+inline int clampSeed(SkScalar seed) {
+    int result = SkScalarTruncToInt(seed);
+    if (result <= 0) {
+        result = -(result % (kRandMaximum - 1)) + 1;
+    }
+    if (result > kRandMaximum - 1) {
+        result = kRandMaximum - 1;
+    }
+    return result;
+}
+
+// The lattice selector and gradients only depend on the seed, so they are built once per seed
+// and shared through SkResourceCache by all the contexts and GPU effects that use it.
+class PerlinNoiseTables : public SkRefCnt {
+public:
+    explicit PerlinNoiseTables(int seed);
+
+    int         fSeed;
+    uint8_t     fLatticeSelector[kBlockSize];
+    uint16_t    fNoise[4][kBlockSize][2];
+    // The normalized gradients, with the four channels of each lattice point side by side so
+    // that all channels can be evaluated at once.
+    SkScalar    fGradientX[kBlockSize][4];
+    SkScalar    fGradientY[kBlockSize][4];
+
+#if SK_SUPPORT_GPU
+    SkBitmap    fPermutationsBitmap;
+    SkBitmap    fNoiseBitmap;
+#endif
+
+private:
+    inline int random()  {
+        static const int gRandAmplitude = 16807; // 7**5; primitive root of m
+        static const int gRandQ = 127773; // m / a
+        static const int gRandR = 2836; // m % a
+
+        int result = gRandAmplitude * (fRandSeed % gRandQ) - gRandR * (fRandSeed / gRandQ);
+        if (result <= 0)
+            result += kRandMaximum;
+        fRandSeed = result;
+        return result;
+    }
+
+    int         fRandSeed;
+
+    typedef SkRefCnt INHERITED;
+};
+
+PerlinNoiseTables::PerlinNoiseTables(int seed)
+    : fSeed(seed)
+    , fRandSeed(seed) {
+    static const SkScalar gInvBlockSizef = SkScalarInvert(SkIntToScalar(kBlockSize));
+
+    for (int channel = 0; channel < 4; ++channel) {
+        for (int i = 0; i < kBlockSize; ++i) {
+            fLatticeSelector[i] = i;
+            fNoise[channel][i][0] = (random() % (2 * kBlockSize));
+            fNoise[channel][i][1] = (random() % (2 * kBlockSize));
+        }
+    }
+    for (int i = kBlockSize - 1; i > 0; --i) {
+        int k = fLatticeSelector[i];
+        int j = random() % kBlockSize;
+        SkASSERT(j >= 0);
+        SkASSERT(j < kBlockSize);
+        fLatticeSelector[i] = fLatticeSelector[j];
+        fLatticeSelector[j] = k;
+    }
+
+    // Perform the permutations now
+    {
+        // Copy noise data
+        uint16_t noise[4][kBlockSize][2];
+        for (int i = 0; i < kBlockSize; ++i) {
+            for (int channel = 0; channel < 4; ++channel) {
+                for (int j = 0; j < 2; ++j) {
+                    noise[channel][i][j] = fNoise[channel][i][j];
+                }
+            }
+        }
+        // Do permutations on noise data
+        for (int i = 0; i < kBlockSize; ++i) {
+            for (int channel = 0; channel < 4; ++channel) {
+                for (int j = 0; j < 2; ++j) {
+                    fNoise[channel][i][j] = noise[channel][fLatticeSelector[i]][j];
+                }
+            }
+        }
+    }
+
+    // Half of the largest possible value for 16 bit unsigned int
+    static const SkScalar gHalfMax16bits = 32767.5f;
+
+    // Compute gradients from permutated noise data
+    for (int channel = 0; channel < 4; ++channel) {
+        for (int i = 0; i < kBlockSize; ++i) {
+            SkPoint gradient = SkPoint::Make(
+                SkScalarMul(SkIntToScalar(fNoise[channel][i][0] - kBlockSize),
+                            gInvBlockSizef),
+                SkScalarMul(SkIntToScalar(fNoise[channel][i][1] - kBlockSize),
+                            gInvBlockSizef));
+            gradient.normalize();
+            fGradientX[i][channel] = gradient.fX;
+            fGradientY[i][channel] = gradient.fY;
+            // Put the normalized gradient back into the noise data
+            fNoise[channel][i][0] = SkScalarRoundToInt(SkScalarMul(
+                gradient.fX + SK_Scalar1, gHalfMax16bits));
+            fNoise[channel][i][1] = SkScalarRoundToInt(SkScalarMul(
+                gradient.fY + SK_Scalar1, gHalfMax16bits));
+        }
+    }
+
+#if SK_SUPPORT_GPU
+    fPermutationsBitmap.setInfo(SkImageInfo::MakeA8(kBlockSize, 1));
+    fPermutationsBitmap.setPixels(fLatticeSelector);
+
+    fNoiseBitmap.setInfo(SkImageInfo::MakeN32Premul(kBlockSize, 4));
+    fNoiseBitmap.setPixels(fNoise[0][0]);
+#endif
+}
+
+static unsigned gPerlinNoiseTablesKeyNamespaceLabel;
+
+struct PerlinNoiseTablesKey : public SkResourceCache::Key {
+public:
+    PerlinNoiseTablesKey(int32_t seed)
+        : fSeed(seed)
+    {
+        this->init(&gPerlinNoiseTablesKeyNamespaceLabel, sizeof(fSeed));
+    }
+
+    int32_t fSeed;
+};
+
+struct PerlinNoiseTablesRec : public SkResourceCache::Rec {
+    PerlinNoiseTablesRec(const PerlinNoiseTablesKey& key, const PerlinNoiseTables* tables)
+        : fKey(key)
+        , fTables(SkRef(tables))
+    {}
+
+    PerlinNoiseTablesKey                   fKey;
+    SkAutoTUnref<const PerlinNoiseTables>  fTables;
+
+    virtual const Key& getKey() const SK_OVERRIDE { return fKey; }
+    virtual size_t bytesUsed() const SK_OVERRIDE {
+        return sizeof(*this) + sizeof(PerlinNoiseTables);
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PerlinNoiseTablesRec& rec = static_cast<const PerlinNoiseTablesRec&>(baseRec);
+        const PerlinNoiseTables** result = (const PerlinNoiseTables**)contextData;
+        *result = SkRef(rec.fTables.get());
+        return true;
+    }
+};
+
+// Returns a ref to the tables for seed, which must already be clamped.
+const PerlinNoiseTables* refTables(int seed) {
+    PerlinNoiseTablesKey key(seed);
+    const PerlinNoiseTables* tables = NULL;
+    if (!SkResourceCache::Find(key, PerlinNoiseTablesRec::Visitor, &tables)) {
+        tables = SkNEW_ARGS(PerlinNoiseTables, (seed));
+        SkResourceCache::Add(SkNEW_ARGS(PerlinNoiseTablesRec, (key, tables)));
+    }
+    return tables;
+}
+
+static unsigned gPerlinNoiseTileKeyNamespaceLabel;
+
+// Identifies the colors of one stitch tile: everything shadeNoisePoint() depends on.
+struct PerlinNoiseTileKey : public SkResourceCache::Key {
+public:
+    PerlinNoiseTileKey(int32_t type, int32_t numOctaves, int32_t seed, int32_t alpha,
+                       const SkVector& baseFrequency, const SkISize& tileSize)
+        : fType(type)
+        , fNumOctaves(numOctaves)
+        , fSeed(seed)
+        , fAlpha(alpha)
+        , fBaseFrequency(baseFrequency)
+        , fTileSize(tileSize)
+    {
+        this->init(&gPerlinNoiseTileKeyNamespaceLabel,
+                   sizeof(fType) + sizeof(fNumOctaves) + sizeof(fSeed) + sizeof(fAlpha) +
+                   sizeof(fBaseFrequency) + sizeof(fTileSize));
+    }
+
+    int32_t  fType;
+    int32_t  fNumOctaves;
+    int32_t  fSeed;
+    int32_t  fAlpha;
+    SkVector fBaseFrequency;
+    SkISize  fTileSize;
+};
+
+struct PerlinNoiseTileRec : public SkResourceCache::Rec {
+    PerlinNoiseTileRec(const PerlinNoiseTileKey& key, SkCachedData* data)
+        : fKey(key)
+        , fData(data)
+    {
+        fData->attachToCacheAndRef();
+    }
+    ~PerlinNoiseTileRec() {
+        fData->detachFromCacheAndUnref();
+    }
+
+    PerlinNoiseTileKey fKey;
+    SkCachedData*      fData;
+
+    virtual const Key& getKey() const SK_OVERRIDE { return fKey; }
+    virtual size_t bytesUsed() const SK_OVERRIDE { return sizeof(*this) + fData->size(); }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PerlinNoiseTileRec& rec = static_cast<const PerlinNoiseTileRec&>(baseRec);
+        SkCachedData** result = (SkCachedData**)contextData;
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (NULL == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+
 } // end namespace
 
 struct SkPerlinNoiseShader::StitchData {
@@ -77,6 +315,7 @@ struct SkPerlinNoiseShader::PaintingData {
     PaintingData(const SkISize& tileSize, SkScalar seed,
                  SkScalar baseFrequencyX, SkScalar baseFrequencyY,
                  const SkMatrix& matrix)
+      : fTables(refTables(clampSeed(seed)))
     {
         SkVector wavelength = SkVector::Make(SkScalarInvert(baseFrequencyX),
                                              SkScalarInvert(baseFrequencyY));
@@ -88,119 +327,18 @@ struct SkPerlinNoiseShader::PaintingData {
         matrix.mapVectors(&sizeVec, 1);
         fTileSize.fWidth = SkScalarRoundToInt(sizeVec.fX);
         fTileSize.fHeight = SkScalarRoundToInt(sizeVec.fY);
-        this->init(seed);
         if (!fTileSize.isEmpty()) {
             this->stitch();
         }
-
-#if SK_SUPPORT_GPU
-        fPermutationsBitmap.setInfo(SkImageInfo::MakeA8(kBlockSize, 1));
-        fPermutationsBitmap.setPixels(fLatticeSelector);
-
-        fNoiseBitmap.setInfo(SkImageInfo::MakeN32Premul(kBlockSize, 4));
-        fNoiseBitmap.setPixels(fNoise[0][0]);
-#endif
     }
 
-    int         fSeed;
-    uint8_t     fLatticeSelector[kBlockSize];
-    uint16_t    fNoise[4][kBlockSize][2];
-    SkPoint     fGradient[4][kBlockSize];
+    SkAutoTUnref<const PerlinNoiseTables> fTables;
     SkISize     fTileSize;
     SkVector    fBaseFrequency;
     StitchData  fStitchDataInit;
 
 private:
 
-#if SK_SUPPORT_GPU
-    SkBitmap   fPermutationsBitmap;
-    SkBitmap   fNoiseBitmap;
-#endif
-
-    inline int random()  {
-        static const int gRandAmplitude = 16807; // 7**5; primitive root of m
-        static const int gRandQ = 127773; // m / a
-        static const int gRandR = 2836; // m % a
-
-        int result = gRandAmplitude * (fSeed % gRandQ) - gRandR * (fSeed / gRandQ);
-        if (result <= 0)
-            result += kRandMaximum;
-        fSeed = result;
-        return result;
-    }
-
-    // Only called once. Could be part of the constructor.
-    void init(SkScalar seed)
-    {
-        static const SkScalar gInvBlockSizef = SkScalarInvert(SkIntToScalar(kBlockSize));
-
-        // According to the SVG spec, we must truncate (not round) the seed value.
-        fSeed = SkScalarTruncToInt(seed);
-        // The seed value clamp to the range [1, kRandMaximum - 1].
-        if (fSeed <= 0) {
-            fSeed = -(fSeed % (kRandMaximum - 1)) + 1;
-        }
-        if (fSeed > kRandMaximum - 1) {
-            fSeed = kRandMaximum - 1;
-        }
-        for (int channel = 0; channel < 4; ++channel) {
-            for (int i = 0; i < kBlockSize; ++i) {
-                fLatticeSelector[i] = i;
-                fNoise[channel][i][0] = (random() % (2 * kBlockSize));
-                fNoise[channel][i][1] = (random() % (2 * kBlockSize));
-            }
-        }
-        for (int i = kBlockSize - 1; i > 0; --i) {
-            int k = fLatticeSelector[i];
-            int j = random() % kBlockSize;
-            SkASSERT(j >= 0);
-            SkASSERT(j < kBlockSize);
-            fLatticeSelector[i] = fLatticeSelector[j];
-            fLatticeSelector[j] = k;
-        }
-
-        // Perform the permutations now
-        {
-            // Copy noise data
-            uint16_t noise[4][kBlockSize][2];
-            for (int i = 0; i < kBlockSize; ++i) {
-                for (int channel = 0; channel < 4; ++channel) {
-                    for (int j = 0; j < 2; ++j) {
-                        noise[channel][i][j] = fNoise[channel][i][j];
-                    }
-                }
-            }
-            // Do permutations on noise data
-            for (int i = 0; i < kBlockSize; ++i) {
-                for (int channel = 0; channel < 4; ++channel) {
-                    for (int j = 0; j < 2; ++j) {
-                        fNoise[channel][i][j] = noise[channel][fLatticeSelector[i]][j];
-                    }
-                }
-            }
-        }
-
-        // Half of the largest possible value for 16 bit unsigned int
-        static const SkScalar gHalfMax16bits = 32767.5f;
-
-        // Compute gradients from permutated noise data
-        for (int channel = 0; channel < 4; ++channel) {
-            for (int i = 0; i < kBlockSize; ++i) {
-                fGradient[channel][i] = SkPoint::Make(
-                    SkScalarMul(SkIntToScalar(fNoise[channel][i][0] - kBlockSize),
-                                gInvBlockSizef),
-                    SkScalarMul(SkIntToScalar(fNoise[channel][i][1] - kBlockSize),
-                                gInvBlockSizef));
-                fGradient[channel][i].normalize();
-                // Put the normalized gradient back into the noise data
-                fNoise[channel][i][0] = SkScalarRoundToInt(SkScalarMul(
-                    fGradient[channel][i].fX + SK_Scalar1, gHalfMax16bits));
-                fNoise[channel][i][1] = SkScalarRoundToInt(SkScalarMul(
-                    fGradient[channel][i].fY + SK_Scalar1, gHalfMax16bits));
-            }
-        }
-    }
-
     // Only called once. Could be part of the constructor.
     void stitch() {
         SkScalar tileWidth  = SkIntToScalar(fTileSize.width());
@@ -245,9 +383,9 @@ private:
 public:
 
 #if SK_SUPPORT_GPU
-    const SkBitmap& getPermutationsBitmap() const { return fPermutationsBitmap; }
+    const SkBitmap& getPermutationsBitmap() const { return fTables->fPermutationsBitmap; }
 
-    const SkBitmap& getNoiseBitmap() const { return fNoiseBitmap; }
+    const SkBitmap& getNoiseBitmap() const { return fTables->fNoiseBitmap; }
 #endif
 };
 
@@ -315,8 +453,11 @@ void SkPerlinNoiseShader::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
+// noise2D() from the SVG spec, evaluated for all four channels at once. The lattice positions
+// are shared by the channels; only the gradients differ. Returns the noise as (r, g, b, a).
+static Sk4f noise2D(const SkPerlinNoiseShader::PaintingData& paintingData, bool stitchTiles,
+                    const SkPerlinNoiseShader::StitchData& stitchData,
+                    const SkPoint& noiseVector) {
     struct Noise {
         int noisePositionIntegerValue;
         int nextNoisePositionIntegerValue;
@@ -331,10 +472,8 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
     };
     Noise noiseX(noiseVector.x());
     Noise noiseY(noiseVector.y());
-    SkScalar u, v;
-    const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
     // If stitching, adjust lattice points accordingly.
-    if (perlinNoiseShader.fStitchTiles) {
+    if (stitchTiles) {
         noiseX.noisePositionIntegerValue =
             checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
         noiseY.noisePositionIntegerValue =
@@ -348,46 +487,58 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
     noiseY.noisePositionIntegerValue &= kBlockMask;
     noiseX.nextNoisePositionIntegerValue &= kBlockMask;
     noiseY.nextNoisePositionIntegerValue &= kBlockMask;
+    const PerlinNoiseTables& tables = *paintingData.fTables;
     int i =
-        fPaintingData->fLatticeSelector[noiseX.noisePositionIntegerValue];
+        tables.fLatticeSelector[noiseX.noisePositionIntegerValue];
     int j =
-        fPaintingData->fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
+        tables.fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
     int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
     int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
     int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
     int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
-    SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
+    Sk4f sx = splat(smoothCurve(noiseX.noisePositionFractionValue));
+    Sk4f sy = splat(smoothCurve(noiseY.noisePositionFractionValue));
     // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData->fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData->fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData->fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData->fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
+    Sk4f fx0 = splat(noiseX.noisePositionFractionValue);
+    Sk4f fy0 = splat(noiseY.noisePositionFractionValue);
+    Sk4f fx1 = splat(noiseX.noisePositionFractionValue - SK_Scalar1);
+    Sk4f fy1 = splat(noiseY.noisePositionFractionValue - SK_Scalar1);
+    // Offset (0,0)
+    Sk4f u = Sk4f::Load(tables.fGradientX[b00]).multiply(fx0)
+                 .add(Sk4f::Load(tables.fGradientY[b00]).multiply(fy0));
+    // Offset (-1,0)
+    Sk4f v = Sk4f::Load(tables.fGradientX[b10]).multiply(fx1)
+                 .add(Sk4f::Load(tables.fGradientY[b10]).multiply(fy0));
+    Sk4f a = u.add(v.subtract(u).multiply(sx));
+    // Offset (-1,-1)
+    v = Sk4f::Load(tables.fGradientX[b11]).multiply(fx1)
+            .add(Sk4f::Load(tables.fGradientY[b11]).multiply(fy1));
+    // Offset (0,-1)
+    u = Sk4f::Load(tables.fGradientX[b01]).multiply(fx0)
+            .add(Sk4f::Load(tables.fGradientY[b01]).multiply(fy1));
+    Sk4f b = u.add(v.subtract(u).multiply(sx));
+    return a.add(b.subtract(a).multiply(sy));
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
+SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeNoisePoint(
+        const SkPoint& point, StitchData& stitchData) const {
     const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
     if (perlinNoiseShader.fStitchTiles) {
         // Set up TurbulenceInitial stitch values.
         stitchData = fPaintingData->fStitchDataInit;
     }
-    SkScalar turbulenceFunctionResult = 0;
+    const Sk4f zero = splat(0);
+    Sk4f turbulenceFunctionResult = zero;
     SkPoint noiseVector(SkPoint::Make(SkScalarMul(point.x(), fPaintingData->fBaseFrequency.fX),
                                       SkScalarMul(point.y(), fPaintingData->fBaseFrequency.fY)));
     SkScalar ratio = SK_Scalar1;
     for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        turbulenceFunctionResult += SkScalarDiv(
-            (perlinNoiseShader.fType == kFractalNoise_Type) ? noise : SkScalarAbs(noise), ratio);
+        Sk4f noise = noise2D(*fPaintingData, perlinNoiseShader.fStitchTiles, stitchData,
+                             noiseVector);
+        if (perlinNoiseShader.fType != kFractalNoise_Type) {
+            noise = Sk4f::Max(noise, zero.subtract(noise));
+        }
+        turbulenceFunctionResult = turbulenceFunctionResult.add(noise.divide(splat(ratio)));
         noiseVector.fX *= 2;
         noiseVector.fY *= 2;
         ratio *= 2;
@@ -404,16 +555,18 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValue
     // by fractalNoise and (turbulenceFunctionResult) by turbulence.
     if (perlinNoiseShader.fType == kFractalNoise_Type) {
         turbulenceFunctionResult =
-            SkScalarMul(turbulenceFunctionResult, SK_ScalarHalf) + SK_ScalarHalf;
+            turbulenceFunctionResult.multiply(splat(SK_ScalarHalf)).add(splat(SK_ScalarHalf));
     }
 
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult = SkScalarMul(turbulenceFunctionResult,
-            SkScalarDiv(SkIntToScalar(getPaintAlpha()), SkIntToScalar(255)));
-    }
+    // Scale alpha by paint value
+    turbulenceFunctionResult = turbulenceFunctionResult.multiply(Sk4f(SK_Scalar1, SK_Scalar1,
+        SK_Scalar1, SkScalarDiv(SkIntToScalar(getPaintAlpha()), SkIntToScalar(255))));
 
-    // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
+    // Clamp result. It is then non-negative, so truncating floors it.
+    float rgba[4];
+    Sk4f::Max(Sk4f::Min(turbulenceFunctionResult, splat(SK_Scalar1)), zero)
+        .multiply(splat(255)).store(rgba);
+    return SkPreMultiplyARGB((U8CPU)rgba[3], (U8CPU)rgba[0], (U8CPU)rgba[1], (U8CPU)rgba[2]);
 }
 
 SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
@@ -423,12 +576,66 @@ SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
     newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
     newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
 
-    U8CPU rgba[4];
-    for (int channel = 3; channel >= 0; --channel) {
-        rgba[channel] = SkScalarFloorToInt(255 *
-            calculateTurbulenceValueForPoint(channel, stitchData, newPoint));
+    if (fTileColors) {
+        const SkISize& tileSize = fPaintingData->fTileSize;
+        if (newPoint.fX >= 0 && newPoint.fX < SkIntToScalar(tileSize.width()) &&
+            newPoint.fY >= 0 && newPoint.fY < SkIntToScalar(tileSize.height())) {
+            return fTileColors[SkScalarTruncToInt(newPoint.fY) * tileSize.width() +
+                               SkScalarTruncToInt(newPoint.fX)];
+        }
+    }
+    return this->shadeNoisePoint(newPoint, stitchData);
+}
+
+void SkPerlinNoiseShader::PerlinNoiseShaderContext::findTileColors(int x, int y, int count) {
+    const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
+    const SkISize& tileSize = fPaintingData->fTileSize;
+    if (!perlinNoiseShader.fStitchTiles || fTileData || tileSize.isEmpty() ||
+        (int64_t)tileSize.width() * tileSize.height() > kMaxCachedTilePixels) {
+        return;
+    }
+    // Only spans that land in the tile count towards rendering it. fMatrix only translates.
+    SkPoint ends[2] = {
+        SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y)),
+        SkPoint::Make(SkIntToScalar(x + count - 1), SkIntToScalar(y)),
+    };
+    fMatrix.mapPoints(ends, 2);
+    const SkScalar spanY = SkScalarRoundToScalar(ends[0].fY);
+    const int left = SkTMax(SkScalarRoundToInt(ends[0].fX), 0);
+    const int right = SkTMin(SkScalarRoundToInt(ends[1].fX), tileSize.width() - 1);
+    if (spanY < 0 || spanY >= SkIntToScalar(tileSize.height()) || right < left) {
+        return;
+    }
+
+    PerlinNoiseTileKey key(perlinNoiseShader.fType, perlinNoiseShader.fNumOctaves,
+                           fPaintingData->fTables->fSeed, this->getPaintAlpha(),
+                           fPaintingData->fBaseFrequency, tileSize);
+    if (!fTileLookedUp) {
+        fTileLookedUp = true;
+        if (SkResourceCache::Find(key, PerlinNoiseTileRec::Visitor, &fTileData)) {
+            fTileColors = (const SkPMColor*)fTileData->data();
+            return;
+        }
+    }
+    fTilePixelsShaded += right - left + 1;
+    if (fTilePixelsShaded < tileSize.width() * tileSize.height() / kTileCoverageDivisor) {
+        return;
+    }
+    fTileData = SkResourceCache::NewCachedData(
+        tileSize.width() * tileSize.height() * sizeof(SkPMColor));
+    if (NULL == fTileData) {
+        return;
     }
-    return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
+    SkPMColor* colors = (SkPMColor*)fTileData->writable_data();
+    StitchData stitchData;
+    for (int ty = 0; ty < tileSize.height(); ++ty) {
+        for (int tx = 0; tx < tileSize.width(); ++tx) {
+            *colors++ = this->shadeNoisePoint(
+                SkPoint::Make(SkIntToScalar(tx), SkIntToScalar(ty)), stitchData);
+        }
+    }
+    SkResourceCache::Add(SkNEW_ARGS(PerlinNoiseTileRec, (key, fTileData)));
+    fTileColors = (const SkPMColor*)fTileData->data();
 }
 
 SkShader::Context* SkPerlinNoiseShader::onCreateContext(const ContextRec& rec,
@@ -453,14 +660,22 @@ SkPerlinNoiseShader::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
     // (as opposed to 0 based, usually). The same adjustment is in the setData() function.
     fMatrix.setTranslate(-newMatrix.getTranslateX() + SK_Scalar1, -newMatrix.getTranslateY() + SK_Scalar1);
     fPaintingData = SkNEW_ARGS(PaintingData, (shader.fTileSize, shader.fSeed, shader.fBaseFrequencyX, shader.fBaseFrequencyY, newMatrix));
+    fTileData = NULL;
+    fTileColors = NULL;
+    fTileLookedUp = false;
+    fTilePixelsShaded = 0;
 }
 
 SkPerlinNoiseShader::PerlinNoiseShaderContext::~PerlinNoiseShaderContext() {
     SkDELETE(fPaintingData);
+    if (fTileData) {
+        fTileData->unref();
+    }
 }
 
 void SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeSpan(
         int x, int y, SkPMColor result[], int count) {
+    this->findTileColors(x, y, count);
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
     StitchData stitchData;
     for (int i = 0; i < count; ++i) {
@@ -471,6 +686,7 @@ void SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeSpan(
 
 void SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeSpan16(
         int x, int y, uint16_t result[], int count) {
+    this->findTileColors(x, y, count);
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
     StitchData stitchData;
     DITHER_565_SCAN(y);
@@ -41,6 +41,7 @@ public:
     }
 
     virtual bool asComponentTable(SkBitmap* table) const SK_OVERRIDE;
+    virtual SkColorFilter* newComposed(const SkColorFilter* inner) const SK_OVERRIDE;
 
 #if SK_SUPPORT_GPU
     virtual GrFragmentProcessor* asFragmentProcessor(GrContext* context) const SK_OVERRIDE;
@@ -64,6 +65,8 @@ protected:
     virtual void flatten(SkWriteBuffer&) const SK_OVERRIDE;
 
 private:
+    void getTables(const uint8_t* tables[4]) const;
+
     mutable const SkBitmap* fBitmap; // lazily allocated
 
     uint8_t fStorage[256 * 4];
@@ -109,25 +112,30 @@ static const uint8_t gIdentityTable[] = {
     0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF
 };
 
-void SkTable_ColorFilter::filterSpan(const SkPMColor src[], int count,
-                                     SkPMColor dst[]) const {
+// Fills tables[] (in ARGB order) with our tables, substituting the identity for the
+// components we leave alone.
+void SkTable_ColorFilter::getTables(const uint8_t* tables[4]) const {
+    static const unsigned kFlags[] = { kA_Flag, kR_Flag, kG_Flag, kB_Flag };
+
     const uint8_t* table = fStorage;
-    const uint8_t* tableA = gIdentityTable;
-    const uint8_t* tableR = gIdentityTable;
-    const uint8_t* tableG = gIdentityTable;
-    const uint8_t* tableB = gIdentityTable;
-    if (fFlags & kA_Flag) {
-        tableA = table; table += 256;
-    }
-    if (fFlags & kR_Flag) {
-        tableR = table; table += 256;
-    }
-    if (fFlags & kG_Flag) {
-        tableG = table; table += 256;
-    }
-    if (fFlags & kB_Flag) {
-        tableB = table;
+    for (int i = 0; i < 4; ++i) {
+        if (fFlags & kFlags[i]) {
+            tables[i] = table;
+            table += 256;
+        } else {
+            tables[i] = gIdentityTable;
+        }
     }
+}
+
+void SkTable_ColorFilter::filterSpan(const SkPMColor src[], int count,
+                                     SkPMColor dst[]) const {
+    const uint8_t* tables[4];
+    this->getTables(tables);
+    const uint8_t* tableA = tables[0];
+    const uint8_t* tableR = tables[1];
+    const uint8_t* tableG = tables[2];
+    const uint8_t* tableB = tables[3];
 
     const SkUnPreMultiply::Scale* scaleTable = SkUnPreMultiply::GetScaleTable();
     for (int i = 0; i < count; ++i) {
@@ -249,6 +257,37 @@ bool SkTable_ColorFilter::asComponentTable(SkBitmap* table) const {
     return true;
 }
 
+// Both filters look up unpremultiplied components, so applying inner and then us is the same
+// as looking up through the composition of the two tables, provided inner leaves alpha alone.
+// If inner changes alpha, the premultiply between the two passes loses (or zeroes) the color
+// that our tables would see, so we leave that pair as a chain.
+SkColorFilter* SkTable_ColorFilter::newComposed(const SkColorFilter* innerFilter) const {
+    SkBitmap innerBM;
+    if (!innerFilter->asComponentTable(&innerBM)) {
+        return NULL;
+    }
+
+    SkAutoLockPixels alp(innerBM);
+    if (NULL == innerBM.getPixels()) {
+        return NULL;
+    }
+    if (memcmp(innerBM.getAddr8(0, 0), gIdentityTable, sizeof(gIdentityTable))) {
+        return NULL;
+    }
+
+    const uint8_t* tables[4];
+    this->getTables(tables);
+
+    uint8_t concat[4][256];
+    for (int y = 0; y < 4; ++y) {
+        const uint8_t* innerRow = innerBM.getAddr8(0, y);
+        for (int x = 0; x < 256; ++x) {
+            concat[y][x] = tables[y][innerRow[x]];
+        }
+    }
+    return SkTableColorFilter::CreateARGB(concat[0], concat[1], concat[2], concat[3]);
+}
+
 #if SK_SUPPORT_GPU
 
 #include "GrFragmentProcessor.h"
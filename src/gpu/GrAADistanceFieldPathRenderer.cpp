@@ -161,7 +161,7 @@ GrAADistanceFieldPathRenderer::PathData* GrAADistanceFieldPathRenderer::addPathT
         SkISize textureSize = SkISize::Make(ATLAS_TEXTURE_WIDTH, ATLAS_TEXTURE_HEIGHT);
         fAtlas = SkNEW_ARGS(GrAtlas, (fContext->getGpu(), kAlpha_8_GrPixelConfig,
                                       kNone_GrSurfaceFlags, textureSize,
-                                      NUM_PLOTS_X, NUM_PLOTS_Y, false));
+                                      NUM_PLOTS_X, NUM_PLOTS_Y, 1, false));
         if (NULL == fAtlas) {
             return NULL;
         }
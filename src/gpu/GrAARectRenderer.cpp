@@ -297,12 +297,23 @@ void GrAARectRenderer::geometryFillAARect(GrDrawTarget* target,
         }
     }
 
+    // The outer fan holds the extent of the geometry.
+    SkRect devBounds;
+    devBounds.set(*fan0Pos, *fan0Pos);
+    for (int i = 1; i < 4; ++i) {
+        const SkPoint* pt = reinterpret_cast<const SkPoint*>(
+            reinterpret_cast<intptr_t>(fan0Pos) + i * vstride);
+        devBounds.growToInclude(pt->fX, pt->fY);
+    }
+    drawState->getViewMatrix().mapRect(&devBounds);
+
     target->setIndexSourceToBuffer(indexBuffer);
     target->drawIndexedInstances(drawState,
                                  kTriangles_GrPrimitiveType,
                                  1,
                                  kVertsPerAAFillRect,
-                                 kIndicesPerAAFillRect);
+                                 kIndicesPerAAFillRect,
+                                 &devBounds);
     target->resetIndexSource();
 }
 
@@ -499,12 +510,20 @@ void GrAARectRenderer::geometryStrokeAARect(GrDrawTarget* target,
         }
     }
 
+    SkRect devBounds = devOutside;
+    if (!miterStroke) {
+        devBounds.join(devOutsideAssist);
+    }
+    devBounds.outset(SK_ScalarHalf, SK_ScalarHalf);
+    drawState->getViewMatrix().mapRect(&devBounds);
+
     target->setIndexSourceToBuffer(indexBuffer);
     target->drawIndexedInstances(drawState,
                                  kTriangles_GrPrimitiveType,
                                  1,
                                  totalVertexNum,
-                                 aa_stroke_rect_index_count(miterStroke));
+                                 aa_stroke_rect_index_count(miterStroke),
+                                 &devBounds);
     target->resetIndexSource();
 }
 
@@ -145,47 +145,31 @@ void GrPlot::resetRects() {
 
 GrAtlas::GrAtlas(GrGpu* gpu, GrPixelConfig config, GrSurfaceFlags flags,
                  const SkISize& backingTextureSize,
-                 int numPlotsX, int numPlotsY, bool batchUploads) {
+                 int numPlotsX, int numPlotsY, int maxPages, bool batchUploads) {
     fGpu = SkRef(gpu);
     fPixelConfig = config;
     fFlags = flags;
     fBackingTextureSize = backingTextureSize;
     fNumPlotsX = numPlotsX;
     fNumPlotsY = numPlotsY;
+    fMaxPages = maxPages;
     fBatchUploads = batchUploads;
-    fTexture = NULL;
 
-    int textureWidth = fBackingTextureSize.width();
-    int textureHeight = fBackingTextureSize.height();
-
-    int plotWidth = textureWidth / fNumPlotsX;
-    int plotHeight = textureHeight / fNumPlotsY;
-
-    SkASSERT(plotWidth * fNumPlotsX == textureWidth);
-    SkASSERT(plotHeight * fNumPlotsY == textureHeight);
+    SkASSERT(fMaxPages >= 1);
+    SkASSERT((fBackingTextureSize.width() / fNumPlotsX) * fNumPlotsX ==
+             fBackingTextureSize.width());
+    SkASSERT((fBackingTextureSize.height() / fNumPlotsY) * fNumPlotsY ==
+             fBackingTextureSize.height());
 
     // We currently do not support compressed atlases...
     SkASSERT(!GrPixelConfigIsCompressed(config));
-
-    // set up allocated plots
-    size_t bpp = GrBytesPerPixel(fPixelConfig);
-    fPlotArray = SkNEW_ARRAY(GrPlot, (fNumPlotsX*fNumPlotsY));
-
-    GrPlot* currPlot = fPlotArray;
-    for (int y = numPlotsY-1; y >= 0; --y) {
-        for (int x = numPlotsX-1; x >= 0; --x) {
-            currPlot->init(this, y*numPlotsX+x, x, y, plotWidth, plotHeight, bpp, batchUploads);
-
-            // build LRU list
-            fPlotList.addToHead(currPlot);
-            ++currPlot;
-        }
-    }
 }
 
 GrAtlas::~GrAtlas() {
-    SkSafeUnref(fTexture);
-    SkDELETE_ARRAY(fPlotArray);
+    for (int i = 0; i < fTextures.count(); ++i) {
+        fTextures[i]->unref();
+        SkDELETE_ARRAY(fPlotArrays[i]);
+    }
 
     fGpu->unref();
 #if FONT_CACHE_STATS
@@ -193,14 +177,47 @@ GrAtlas::~GrAtlas() {
 #endif
 }
 
-void GrAtlas::makeMRU(GrPlot* plot) {
-    if (fPlotList.head() == plot) {
-        return;
+bool GrAtlas::addPage() {
+    SkASSERT(fTextures.count() < fMaxPages);
+
+    // TODO: Update this to use the cache rather than directly creating a texture.
+    GrSurfaceDesc desc;
+    desc.fFlags = fFlags;
+    desc.fWidth = fBackingTextureSize.width();
+    desc.fHeight = fBackingTextureSize.height();
+    desc.fConfig = fPixelConfig;
+
+    GrTexture* texture = fGpu->createTexture(desc, NULL, 0);
+    if (NULL == texture) {
+        return false;
     }
 
-    fPlotList.remove(plot);
-    fPlotList.addToHead(plot);
-};
+    int plotWidth = fBackingTextureSize.width() / fNumPlotsX;
+    int plotHeight = fBackingTextureSize.height() / fNumPlotsY;
+    int numPlots = fNumPlotsX * fNumPlotsY;
+    int firstID = fTextures.count() * numPlots;
+
+    // set up allocated plots
+    size_t bpp = GrBytesPerPixel(fPixelConfig);
+    GrPlot* plotArray = SkNEW_ARRAY(GrPlot, (numPlots));
+
+    GrPlot* currPlot = plotArray;
+    for (int y = 0; y < fNumPlotsY; ++y) {
+        for (int x = 0; x < fNumPlotsX; ++x) {
+            currPlot->init(this, firstID + y*fNumPlotsX+x, x, y, plotWidth, plotHeight, bpp,
+                           fBatchUploads);
+            currPlot->fTexture = texture;
+
+            // build LRU list, so that within a page the lowest ids are used first
+            fPlotList.addToTail(currPlot);
+            ++currPlot;
+        }
+    }
+
+    *fTextures.append() = texture;
+    *fPlotArrays.append() = plotArray;
+    return true;
+}
 
 GrPlot* GrAtlas::addToAtlas(ClientPlotUsage* usage,
                             int width, int height, const void* image,
@@ -217,18 +234,8 @@ GrPlot* GrAtlas::addToAtlas(ClientPlotUsage* usage,
     }
 
     // before we get a new plot, make sure we have a backing texture
-    if (NULL == fTexture) {
-        // TODO: Update this to use the cache rather than directly creating a texture.
-        GrSurfaceDesc desc;
-        desc.fFlags = fFlags;
-        desc.fWidth = fBackingTextureSize.width();
-        desc.fHeight = fBackingTextureSize.height();
-        desc.fConfig = fPixelConfig;
-
-        fTexture = fGpu->createTexture(desc, NULL, 0);
-        if (NULL == fTexture) {
-            return NULL;
-        }
+    if (fTextures.isEmpty() && !this->addPage()) {
+        return NULL;
     }
 
     // now look through all allocated plots for one we can share, in MRU order
@@ -236,20 +243,28 @@ GrPlot* GrAtlas::addToAtlas(ClientPlotUsage* usage,
     plotIter.init(fPlotList, GrPlotList::Iter::kHead_IterStart);
     GrPlot* plot;
     while ((plot = plotIter.get())) {
-        // make sure texture is set for quick lookup
-        plot->fTexture = fTexture;
         if (plot->addSubImage(width, height, image, loc)) {
-            this->makeMRU(plot);
-            // new plot for atlas, put at end of array
-            SkASSERT(!usage->fPlots.contains(plot));
-            *(usage->fPlots.append()) = plot;
-            return plot;
+            break;
         }
         plotIter.next();
     }
 
-    // If the above fails, then the current plot list has no room
-    return NULL;
+    // If the above fails, then the current plot list has no room. Rather than have the client
+    // evict a plot it may well draw from again, use an empty one from a new page.
+    if (NULL == plot && fTextures.count() < fMaxPages && this->addPage()) {
+        plot = fPlotList.tail();
+        if (!plot->addSubImage(width, height, image, loc)) {
+            plot = NULL;
+        }
+    }
+
+    if (plot) {
+        this->makeMRU(plot);
+        // new plot for atlas, put at end of array
+        SkASSERT(!usage->fPlots.contains(plot));
+        *(usage->fPlots.append()) = plot;
+    }
+    return plot;
 }
 
 void GrAtlas::RemovePlot(ClientPlotUsage* usage, const GrPlot* plot) {
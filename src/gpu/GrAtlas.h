@@ -25,16 +25,20 @@ class GrAtlas;
 // GrPlot is "full" (i.e. there is no room for the new subimage according to the GrRectanizer), the
 // GrAtlas can request a new GrPlot via GrAtlas::addToAtlas().
 //
+// A GrAtlas may be given more than one page, i.e. more than one backing texture, each with its
+// own grid of GrPlots. When every GrPlot is full another page is allocated, up to the maximum.
+//
 // If all GrPlots are allocated, the replacement strategy is up to the client. The drawToken is
-// available to ensure that all draw calls are finished for that particular GrPlot.
-// GrAtlas::removeUnusedPlots() will free up any finished plots for a given GrAtlas.
+// available to ensure that all draw calls are finished for that particular GrPlot. Setting it
+// also marks the GrPlot as most recently used, so GrAtlas::getUnusedPlot() returns the finished
+// GrPlot that was drawn from the longest ago.
 
 class GrPlot {
 public:
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(GrPlot);
 
     // This returns a plot ID unique to each plot in a given GrAtlas. They are
-    // consecutive and start at 0.
+    // consecutive and start at 0, and the plots of one page come before those of the next.
     int id() const { return fID; }
 
     GrTexture* texture() const { return fTexture; }
@@ -42,7 +46,7 @@ public:
     bool addSubImage(int width, int height, const void*, SkIPoint16*);
 
     GrDrawTarget::DrawToken drawToken() const { return fDrawToken; }
-    void setDrawToken(GrDrawTarget::DrawToken draw) { fDrawToken = draw; }
+    inline void setDrawToken(GrDrawTarget::DrawToken draw);
 
     void uploadToTexture();
 
@@ -95,12 +99,12 @@ public:
 
     GrAtlas(GrGpu*, GrPixelConfig, GrSurfaceFlags flags, 
             const SkISize& backingTextureSize,
-            int numPlotsX, int numPlotsY, bool batchUploads);
+            int numPlotsX, int numPlotsY, int maxPages, bool batchUploads);
     ~GrAtlas();
 
     // Adds a width x height subimage to the atlas. Upon success it returns 
-    // the containing GrPlot and absolute location in the backing texture. 
-    // NULL is returned if the subimage cannot fit in the atlas.
+    // the containing GrPlot and absolute location in its backing texture. 
+    // NULL is returned if the subimage cannot fit in the atlas, even after adding a page.
     // If provided, the image data will either be immediately uploaded or
     // written to the CPU-side backing bitmap.
     GrPlot* addToAtlas(ClientPlotUsage*, int width, int height, const void* image, SkIPoint16* loc);
@@ -112,10 +116,14 @@ public:
     // this allows us to overwrite this plot without flushing
     GrPlot* getUnusedPlot();
 
+    // The backing texture of the first page
     GrTexture* getTexture() const {
-        return fTexture;
+        return fTextures.isEmpty() ? NULL : fTextures[0];
     }
 
+    int numPages() const { return fTextures.count(); }
+    GrTexture* getTexture(int page) const { return fTextures[page]; }
+
     void uploadPlotsToTexture();
 
     enum IterOrder {
@@ -131,21 +139,37 @@ public:
     }
 
 private:
-    void makeMRU(GrPlot* plot);
+    void makeMRU(GrPlot* plot) {
+        if (fPlotList.head() != plot) {
+            fPlotList.remove(plot);
+            fPlotList.addToHead(plot);
+        }
+    }
+
+    // Allocates the backing texture and the plots of another page. Its plots go at the LRU end.
+    bool addPage();
 
     GrGpu*         fGpu;
     GrPixelConfig  fPixelConfig;
     GrSurfaceFlags fFlags;
-    GrTexture*     fTexture;
     SkISize        fBackingTextureSize;
     int            fNumPlotsX;
     int            fNumPlotsY;
+    int            fMaxPages;
     bool           fBatchUploads;
 
-    // allocated array of GrPlots
-    GrPlot*       fPlotArray;
+    // backing texture and allocated array of GrPlots for each page
+    SkTDArray<GrTexture*> fTextures;
+    SkTDArray<GrPlot*>    fPlotArrays;
     // LRU list of GrPlots (MRU at head - LRU at tail)
     GrPlotList    fPlotList;
+
+    friend class GrPlot;
 };
 
+inline void GrPlot::setDrawToken(GrDrawTarget::DrawToken draw) {
+    fDrawToken = draw;
+    fAtlas->makeMRU(this);
+}
+
 #endif
@@ -16,7 +16,11 @@ class GrTexture;
 
 /**
  * The stencil buffer stores the last clip path - providing a single entry
- * "cache". This class provides similar functionality for AA clip paths
+ * "cache". This class provides similar functionality for AA clip paths, but
+ * keeps the few most recently used masks, keyed by the clip stack generation
+ * and bounds they were made for, so draws alternating between a few clips
+ * don't have to regenerate the masks every time the clip changes. Only the
+ * last mask is kept from one flush to the next.
  */
 class GrClipMaskCache : SkNoncopyable {
 public:
@@ -40,14 +44,8 @@ public:
 
         // We could reuse the mask if bounds is a subset of last bounds. We'd have to communicate
         // an offset to the caller.
-        if (back->fLastMask &&
-            !back->fLastMask->wasDestroyed() &&
-            back->fLastBound == bounds &&
-            back->fLastClipGenID == clipGenID) {
-            return true;
-        }
-
-        return false;
+        // On success the reused mask becomes the last mask.
+        return back->findMask(clipGenID, bounds);
     }
 
     void reset() {
@@ -86,7 +84,7 @@ public:
             return SkClipStack::kInvalidGenID;
         }
 
-        return ((GrClipStackFrame*) fStack.back())->fLastClipGenID;
+        return ((GrClipStackFrame*) fStack.back())->last().fClipGenID;
     }
 
     GrTexture* getLastMask() {
@@ -98,7 +96,7 @@ public:
 
         GrClipStackFrame* back = (GrClipStackFrame*) fStack.back();
 
-        return back->fLastMask;
+        return back->last().fMask;
     }
 
     const GrTexture* getLastMask() const {
@@ -110,7 +108,7 @@ public:
 
         GrClipStackFrame* back = (GrClipStackFrame*) fStack.back();
 
-        return back->fLastMask;
+        return back->last().fMask;
     }
 
     void acquireMask(int32_t clipGenID,
@@ -136,11 +134,11 @@ public:
 
         GrClipStackFrame* back = (GrClipStackFrame*) fStack.back();
 
-        if (NULL == back->fLastMask) {
+        if (NULL == back->last().fMask) {
             return -1;
         }
 
-        return back->fLastMask->width();
+        return back->last().fMask->width();
     }
 
     int getLastMaskHeight() const {
@@ -152,11 +150,11 @@ public:
 
         GrClipStackFrame* back = (GrClipStackFrame*) fStack.back();
 
-        if (NULL == back->fLastMask) {
+        if (NULL == back->last().fMask) {
             return -1;
         }
 
-        return back->fLastMask->height();
+        return back->last().fMask->height();
     }
 
     void getLastBound(SkIRect* bound) const {
@@ -169,7 +167,7 @@ public:
 
         GrClipStackFrame* back = (GrClipStackFrame*) fStack.back();
 
-        *bound = back->fLastBound;
+        *bound = back->last().fBound;
     }
 
     void setContext(GrContext* context) {
@@ -190,45 +188,116 @@ public:
         }
     }
 
+    /**
+     * Releases all but the most recently used mask of each frame. The others are only kept for
+     * draws within the same flush, so they don't hold on to up to a render target's worth of
+     * texture each until the next purge.
+     */
+    void purgeExtraMasks() {
+        SkDeque::F2BIter iter(fStack);
+        for (GrClipStackFrame* frame = (GrClipStackFrame*) iter.next();
+                frame != NULL;
+                frame = (GrClipStackFrame*) iter.next()) {
+            frame->purgeExtraMasks();
+        }
+    }
+
 private:
     struct GrClipStackFrame {
 
-        GrClipStackFrame() {
+        GrClipStackFrame() : fMaskCount(0) {
             this->reset();
         }
 
+        ~GrClipStackFrame() {
+            this->reset();
+        }
+
+        struct CachedMask {
+            int32_t                 fClipGenID;
+            // The mask's width & height values are used by GrClipMaskManager to correctly scale
+            // the texture coords for the geometry drawn with this mask. TODO: This should be a
+            // cache key and not a hard ref to a texture.
+            GrTexture*              fMask;
+            // fBound stores the bounding box of the clip mask in clip-stack space. This rect is
+            // used by GrClipMaskManager to position a rect and compute texture coords for the mask.
+            SkIRect                 fBound;
+        };
+
+        // The most recently used mask, or an empty one.
+        const CachedMask& last() const {
+            return fMasks[0];
+        }
+
+        bool findMask(int32_t clipGenID, const SkIRect& bound) {
+            for (int i = 0; i < fMaskCount; ++i) {
+                if (fMasks[i].fMask &&
+                    !fMasks[i].fMask->wasDestroyed() &&
+                    fMasks[i].fBound == bound &&
+                    fMasks[i].fClipGenID == clipGenID) {
+                    this->moveToFront(i);
+                    return true;
+                }
+            }
+            return false;
+        }
+
         void acquireMask(GrContext* context,
                          int32_t clipGenID,
                          const GrSurfaceDesc& desc,
                          const SkIRect& bound) {
 
-            fLastClipGenID = clipGenID;
+            // Free up the least recently used mask first so its texture can be reused.
+            if (kMaxMasks == fMaskCount) {
+                --fMaskCount;
+                SkSafeSetNull(fMasks[fMaskCount].fMask);
+            }
+            ++fMaskCount;
+            this->moveToFront(fMaskCount - 1);
+
+            CachedMask& mask = fMasks[0];
+            mask.fClipGenID = clipGenID;
 
             // HACK: set the last param to true to indicate that this request is at
             // flush time and therefore we require a scratch texture with no pending IO operations.
-            fLastMask.reset(context->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch,
-                                                       /*flushing=*/true));
+            mask.fMask = context->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch,
+                                                    /*flushing=*/true);
 
-            fLastBound = bound;
+            mask.fBound = bound;
         }
 
         void reset () {
-            fLastClipGenID = SkClipStack::kInvalidGenID;
+            for (int i = 0; i < fMaskCount; ++i) {
+                SkSafeUnref(fMasks[i].fMask);
+            }
+            fMaskCount = 0;
+
+            // Leave an empty mask in front for the getters.
+            fMasks[0].fClipGenID = SkClipStack::kInvalidGenID;
+            fMasks[0].fMask = NULL;
+            fMasks[0].fBound.setEmpty();
+        }
+
+        void purgeExtraMasks() {
+            for (int i = 1; i < fMaskCount; ++i) {
+                SkSafeSetNull(fMasks[i].fMask);
+            }
+            fMaskCount = SkTMin(fMaskCount, 1);
+        }
 
-            GrSurfaceDesc desc;
+        enum {
+            // A mask covers up to the whole render target, so only a few are kept.
+            kMaxMasks = 4
+        };
 
-            fLastMask.reset(NULL);
-            fLastBound.setEmpty();
+        void moveToFront(int index) {
+            CachedMask mask = fMasks[index];
+            memmove(&fMasks[1], &fMasks[0], index * sizeof(CachedMask));
+            fMasks[0] = mask;
         }
 
-        int32_t                 fLastClipGenID;
-        // The mask's width & height values are used by GrClipMaskManager to correctly scale the
-        // texture coords for the geometry drawn with this mask. TODO: This should be a cache key
-        // and not a hard ref to a texture.
-        SkAutoTUnref<GrTexture> fLastMask;
-        // fLastBound stores the bounding box of the clip mask in clip-stack space. This rect is
-        // used by GrClipMaskManager to position a rect and compute texture coords for the mask.
-        SkIRect                 fLastBound;
+        CachedMask              fMasks[kMaxMasks];
+        int                     fMaskCount;
     };
 
     GrContext*   fContext;
@@ -17,6 +17,7 @@
 #include "GrSWMaskHelper.h"
 #include "SkRasterClip.h"
 #include "SkStrokeRec.h"
+#include "SkTaskGroup.h"
 #include "SkTLazy.h"
 #include "effects/GrTextureDomain.h"
 #include "effects/GrConvexPolyEffect.h"
@@ -489,10 +490,7 @@ GrTexture* GrClipMaskManager::getCachedMaskTexture(int32_t elementsGenID,
 GrTexture* GrClipMaskManager::allocMaskTexture(int32_t elementsGenID,
                                                const SkIRect& clipSpaceIBounds,
                                                bool willUpload) {
-    // Since we are setting up the cache we should free up the
-    // currently cached mask so it can be reused.
-    fAACache.reset();
-
+    // The cache frees up its least recently used mask, if it's full, so it can be reused.
     GrSurfaceDesc desc;
     desc.fFlags = willUpload ? kNone_GrSurfaceFlags : kRenderTarget_GrSurfaceFlag;
     desc.fWidth = clipSpaceIBounds.width();
@@ -995,32 +993,26 @@ void GrClipMaskManager::adjustStencilParams(GrStencilSettings* settings,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
-                                                     GrReducedClip::InitialState initialState,
-                                                     const GrReducedClip::ElementList& elements,
-                                                     const SkIRect& clipSpaceIBounds) {
-    SkASSERT(kNone_ClipMaskType == fCurrClipMaskType);
-
-    GrTexture* result = this->getCachedMaskTexture(elementsGenID, clipSpaceIBounds);
-    if (result) {
-        return result;
-    }
-
-    // The mask texture may be larger than necessary. We round out the clip space bounds and pin
-    // the top left corner of the resulting rect to the top left of the texture.
-    SkIRect maskSpaceIBounds = SkIRect::MakeWH(clipSpaceIBounds.width(), clipSpaceIBounds.height());
+namespace {
 
-    GrSWMaskHelper helper(this->getContext());
+// Software clip masks are split into bands of rows that are rasterized in parallel. Each band
+// walks all of the clip's elements, so they aren't made thinner than this.
+const int kMinSoftwareClipBandHeight = 64;
+const int kMaxSoftwareClipBands = 8;
 
-    SkMatrix matrix;
-    matrix.setTranslate(SkIntToScalar(-clipSpaceIBounds.fLeft),
-                        SkIntToScalar(-clipSpaceIBounds.fTop));
+struct SoftwareClipBand {
+    GrSWMaskHelper*                     fHelper;
+    const GrReducedClip::ElementList*   fElements;
+    SkIRect                             fClipSpaceIBounds;
+};
 
-    helper.init(maskSpaceIBounds, &matrix, false);
-    helper.clear(GrReducedClip::kAllIn_InitialState == initialState ? 0xFF : 0x00);
+void draw_software_clip_band(SoftwareClipBand* band) {
+    GrSWMaskHelper* helper = band->fHelper;
     SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
 
-    for (GrReducedClip::ElementList::Iter iter(elements.headIter()) ; iter.get(); iter.next()) {
+    for (GrReducedClip::ElementList::Iter iter(band->fElements->headIter());
+         iter.get();
+         iter.next()) {
         const Element* element = iter.get();
         SkRegion::Op op = element->getOp();
 
@@ -1030,26 +1022,89 @@ GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
             // but leave the pixels inside the geometry alone. For reverse difference we invert all
             // the pixels before clearing the ones outside the geometry.
             if (SkRegion::kReverseDifference_Op == op) {
-                SkRect temp = SkRect::Make(clipSpaceIBounds);
+                SkRect temp = SkRect::Make(band->fClipSpaceIBounds);
                 // invert the entire scene
-                helper.draw(temp, SkRegion::kXOR_Op, false, 0xFF);
+                helper->draw(temp, SkRegion::kXOR_Op, false, 0xFF);
             }
             SkPath clipPath;
             element->asPath(&clipPath);
             clipPath.toggleInverseFillType();
-            helper.draw(clipPath, stroke, SkRegion::kReplace_Op, element->isAA(), 0x00);
+            helper->draw(clipPath, stroke, SkRegion::kReplace_Op, element->isAA(), 0x00);
             continue;
         }
 
         // The other ops (union, xor, diff) only affect pixels inside
         // the geometry so they can just be drawn normally
         if (Element::kRect_Type == element->getType()) {
-            helper.draw(element->getRect(), op, element->isAA(), 0xFF);
+            helper->draw(element->getRect(), op, element->isAA(), 0xFF);
         } else {
             SkPath path;
             element->asPath(&path);
-            helper.draw(path, stroke, op, element->isAA(), 0xFF);
+            helper->draw(path, stroke, op, element->isAA(), 0xFF);
+        }
+    }
+}
+
+}
+
+GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
+                                                     GrReducedClip::InitialState initialState,
+                                                     const GrReducedClip::ElementList& elements,
+                                                     const SkIRect& clipSpaceIBounds) {
+    SkASSERT(kNone_ClipMaskType == fCurrClipMaskType);
+
+    GrTexture* result = this->getCachedMaskTexture(elementsGenID, clipSpaceIBounds);
+    if (result) {
+        return result;
+    }
+
+    // The mask texture may be larger than necessary. We round out the clip space bounds and pin
+    // the top left corner of the resulting rect to the top left of the texture.
+    SkIRect maskSpaceIBounds = SkIRect::MakeWH(clipSpaceIBounds.width(), clipSpaceIBounds.height());
+
+    GrSWMaskHelper helper(this->getContext());
+
+    SkMatrix matrix;
+    matrix.setTranslate(SkIntToScalar(-clipSpaceIBounds.fLeft),
+                        SkIntToScalar(-clipSpaceIBounds.fTop));
+
+    if (!helper.init(maskSpaceIBounds, &matrix, false)) {
+        return NULL;
+    }
+    helper.clear(GrReducedClip::kAllIn_InitialState == initialState ? 0xFF : 0x00);
+
+    // The elements touch each pixel independently of the others, so each band of rows can draw
+    // all of them on its own thread. The flush that needs the mask waits for all of the bands.
+    int bandCount = SkPin32(maskSpaceIBounds.height() / kMinSoftwareClipBandHeight,
+                            1, kMaxSoftwareClipBands);
+    SoftwareClipBand bands[kMaxSoftwareClipBands];
+    SkAutoTDelete<GrSWMaskHelper> bandHelpers[kMaxSoftwareClipBands];
+    for (int i = 0; i < bandCount; ++i) {
+        if (1 == bandCount) {
+            bands[i].fHelper = &helper;
+        } else {
+            bandHelpers[i].reset(SkNEW_ARGS(GrSWMaskHelper, (this->getContext())));
+            bandHelpers[i]->initBand(helper,
+                                     maskSpaceIBounds.height() * i / bandCount,
+                                     maskSpaceIBounds.height() * (i + 1) / bandCount);
+            bands[i].fHelper = bandHelpers[i].get();
         }
+        bands[i].fElements = &elements;
+        bands[i].fClipSpaceIBounds = clipSpaceIBounds;
+    }
+    if (1 == bandCount) {
+        draw_software_clip_band(&bands[0]);
+    } else {
+        // Each band draws its own copy of the paths, which shares their points and the generation
+        // ID they compute lazily without synchronization, so compute it before they're shared.
+        for (GrReducedClip::ElementList::Iter iter(elements.headIter()); iter.get(); iter.next()) {
+            if (Element::kPath_Type == iter.get()->getType()) {
+                iter.get()->getPath().getGenerationID();
+            }
+        }
+        SkTaskGroup tasks;
+        tasks.batch(draw_software_clip_band, bands, bandCount);
+        tasks.wait();
     }
 
     // Allocate clip mask texture
@@ -1069,6 +1124,10 @@ void GrClipMaskManager::purgeResources() {
     fAACache.purgeResources();
 }
 
+void GrClipMaskManager::purgeExtraMasks() {
+    fAACache.purgeExtraMasks();
+}
+
 void GrClipMaskManager::setClipTarget(GrClipTarget* clipTarget) {
     fClipTarget = clipTarget;
     fAACache.setContext(clipTarget->getContext());
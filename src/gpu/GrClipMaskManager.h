@@ -76,6 +76,12 @@ public:
      */
     void purgeResources();
 
+    /**
+     * Called at the end of each flush to release the masks kept for reuse within it, other than
+     * the last one.
+     */
+    void purgeExtraMasks();
+
     bool isClipInStencil() const {
         return kStencil_ClipMaskType == fCurrClipMaskType;
     }
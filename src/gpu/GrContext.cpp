@@ -24,6 +24,7 @@
 #include "GrPathRenderer.h"
 #include "GrPathUtils.h"
 #include "GrResourceCache2.h"
+#include "GrSWMaskBatch.h"
 #include "GrSoftwarePathRenderer.h"
 #include "GrStencilAndCoverTextContext.h"
 #include "GrStrokeInfo.h"
@@ -126,6 +127,8 @@ void GrContext::initCommon() {
 
     fLayerCache.reset(SkNEW_ARGS(GrLayerCache, (this)));
 
+    fSWMaskBatch.reset(SkNEW_ARGS(GrSWMaskBatch, (this)));
+
     fAARectRenderer = SkNEW_ARGS(GrAARectRenderer, (fGpu));
     fOvalRenderer = SkNEW(GrOvalRenderer);
 
@@ -145,6 +148,9 @@ GrContext::~GrContext() {
         (*fCleanUpData[i].fFunc)(this, fCleanUpData[i].fInfo);
     }
 
+    // The flush uploaded any pending software masks, but they hold textures until they're freed.
+    fSWMaskBatch.free();
+
     SkDELETE(fResourceCache2);
     SkDELETE(fFontCache);
     SkDELETE(fDrawBuffer);
@@ -160,6 +166,9 @@ GrContext::~GrContext() {
 }
 
 void GrContext::abandonContext() {
+    // The masks waiting for upload won't be drawn with.
+    fSWMaskBatch->reset();
+
     // abandon first to so destructors
     // don't try to free the resources in the API.
     fResourceCache2->abandonAll();
@@ -1190,6 +1199,7 @@ void GrContext::flush(int flagsBitfield) {
     }
 
     if (kDiscard_FlushBit & flagsBitfield) {
+        fSWMaskBatch->reset();
         fDrawBuffer->reset();
     } else {
         fDrawBuffer->flush();
@@ -662,13 +662,16 @@ void GrDistanceFieldTextContext::flush() {
             SkASSERT(drawState.hasColorVertexAttribute());
         }
         int nGlyphs = fCurrVertex / kVerticesPerGlyph;
+        // The glyph quads are positioned in source space.
+        SkRect devBounds;
+        drawState.getViewMatrix().mapRect(&devBounds, fVertexBounds);
         fDrawTarget->setIndexSourceToBuffer(fContext->getQuadIndexBuffer());
         fDrawTarget->drawIndexedInstances(&drawState,
                                           kTriangles_GrPrimitiveType,
                                           nGlyphs,
                                           kVerticesPerGlyph,
                                           kIndicesPerGlyph,
-                                          &fVertexBounds);
+                                          &devBounds);
         fDrawTarget->resetVertexSource();
         fVertices = NULL;
         fTotalVertexCount -= fCurrVertex;
@@ -546,6 +546,7 @@ public:
             fDevBoundsStorage = bounds;
             fDevBounds = &fDevBoundsStorage;
         }
+        void clearDevBounds() { fDevBounds = NULL; }
         const GrVertexBuffer* vertexBuffer() const { return fVertexBuffer.get(); }
         const GrIndexBuffer* indexBuffer() const { return fIndexBuffer.get(); }
         void setVertexBuffer(const GrVertexBuffer* vb) {
@@ -9,6 +9,7 @@
 #include "GrContext.h"
 #include "GrFontCache.h"
 #include "GrGpu.h"
+#include "GrSWMaskBatch.h"
 #include "GrBufferAllocPool.h"
 
 GrFlushToGpuDrawTarget::GrFlushToGpuDrawTarget(GrGpu* gpu,
@@ -87,12 +88,14 @@ void GrFlushToGpuDrawTarget::flush() {
     fFlushing = true;
 
     fGpu->getContext()->getFontCache()->updateTextures();
+    fGpu->getContext()->getSWMaskBatch()->uploadMasks();
     fVertexPool->unmap();
     fIndexPool->unmap();
 
     fGpu->saveActiveTraceMarkers();
 
     this->onFlush();
+    fClipMaskManager.purgeExtraMasks();
 
     fGpu->restoreActiveTraceMarkers();
 
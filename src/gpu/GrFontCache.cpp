@@ -24,6 +24,11 @@
 #define GR_NUM_PLOTS_X   (GR_ATLAS_TEXTURE_WIDTH / GR_PLOT_WIDTH)
 #define GR_NUM_PLOTS_Y   (GR_ATLAS_TEXTURE_HEIGHT / GR_PLOT_HEIGHT)
 
+// Atlases grow to this many textures before glyphs start evicting each other. Color glyphs take
+// two or four times the memory, so they get fewer.
+#define GR_A8_ATLAS_MAX_PAGES    4
+#define GR_COLOR_ATLAS_MAX_PAGES 2
+
 #define FONT_CACHE_STATS 0
 #if FONT_CACHE_STATS
 static int g_PurgeCount = 0;
@@ -123,10 +128,13 @@ GrPlot* GrFontCache::addToAtlas(GrMaskFormat format, GrAtlas::ClientPlotUsage* u
     if (NULL == fAtlases[atlasIndex]) {
         SkISize textureSize = SkISize::Make(GR_ATLAS_TEXTURE_WIDTH,
                                             GR_ATLAS_TEXTURE_HEIGHT);
+        int maxPages = kA8_AtlasType == atlasIndex ? GR_A8_ATLAS_MAX_PAGES
+                                                   : GR_COLOR_ATLAS_MAX_PAGES;
         fAtlases[atlasIndex] = SkNEW_ARGS(GrAtlas, (fGpu, config, kNone_GrSurfaceFlags,
                                                     textureSize,
                                                     GR_NUM_PLOTS_X,
                                                     GR_NUM_PLOTS_Y,
+                                                    maxPages,
                                                     true));
     }
     return fAtlases[atlasIndex]->addToAtlas(usage, width, height, image, loc);
@@ -197,13 +205,13 @@ void GrFontCache::dump() const {
     static int gDumpCount = 0;
     for (int i = 0; i < kAtlasCount; ++i) {
         if (fAtlases[i]) {
-            GrTexture* texture = fAtlases[i]->getTexture();
-            if (texture) {
+            for (int page = 0; page < fAtlases[i]->numPages(); ++page) {
+                GrTexture* texture = fAtlases[i]->getTexture(page);
                 SkString filename;
 #ifdef SK_BUILD_FOR_ANDROID
-                filename.printf("/sdcard/fontcache_%d%d.png", gDumpCount, i);
+                filename.printf("/sdcard/fontcache_%d%d_%d.png", gDumpCount, i, page);
 #else
-                filename.printf("fontcache_%d%d.png", gDumpCount, i);
+                filename.printf("fontcache_%d%d_%d.png", gDumpCount, i, page);
 #endif
                 texture->surfacePriv().savePixels(filename.c_str());
             }
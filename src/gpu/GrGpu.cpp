@@ -199,8 +199,12 @@ bool GrGpu::writeTexturePixels(GrTexture* texture,
                                GrPixelConfig config, const void* buffer,
                                size_t rowBytes) {
     this->handleDirtyContext();
-    return this->onWriteTexturePixels(texture, left, top, width, height,
-                                      config, buffer, rowBytes);
+    if (this->onWriteTexturePixels(texture, left, top, width, height,
+                                   config, buffer, rowBytes)) {
+        fGPUStats.incTextureUploads();
+        return true;
+    }
+    return false;
 }
 
 void GrGpu::resolveRenderTarget(GrRenderTarget* target) {
@@ -283,6 +287,19 @@ void GrGpu::draw(const GrOptDrawState& ds, const GrDrawTarget::DrawInfo& info) {
     this->onDraw(ds, info);
 }
 
+void GrGpu::drawBatch(const GrOptDrawState& ds,
+                      const GrDrawTarget::DrawInfo* const infos[],
+                      int count) {
+    SkASSERT(count > 0);
+    this->handleDirtyContext();
+    if (!this->flushGraphicsState(ds)) {
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        this->onDraw(ds, *infos[i]);
+    }
+}
+
 void GrGpu::stencilPath(const GrOptDrawState& ds,
                         const GrPath* path,
                         const GrStencilSettings& stencilSettings) {
@@ -358,6 +358,10 @@ public:
                              const SkIPoint& dstPoint) = 0;
 
     virtual void draw(const GrOptDrawState&, const GrDrawTarget::DrawInfo&);
+    // Issues several draws that share one state, which is only flushed once.
+    virtual void drawBatch(const GrOptDrawState&,
+                           const GrDrawTarget::DrawInfo* const infos[],
+                           int count);
     virtual void stencilPath(const GrOptDrawState&,
                              const GrPath*,
                              const GrStencilSettings&);
@@ -207,6 +207,15 @@ int GrInOrderDrawBuffer::concatInstancedDraw(const GrDrawState& ds, const DrawIn
 
     draw->fInfo.adjustInstanceCount(instancesToConcat);
 
+    // The combined draw touches the pixels of both.
+    if (draw->fInfo.getDevBounds() && info.getDevBounds()) {
+        SkRect bounds = *draw->fInfo.getDevBounds();
+        bounds.join(*info.getDevBounds());
+        draw->fInfo.setDevBounds(bounds);
+    } else {
+        draw->fInfo.clearDevBounds();
+    }
+
     // update last fGpuCmdMarkers to include any additional trace markers that have been added
     if (this->getActiveTraceMarkers().count() > 0) {
         if (cmd_has_trace_marker(draw->fType)) {
@@ -376,6 +385,7 @@ void GrInOrderDrawBuffer::discard(GrRenderTarget* renderTarget) {
 
 void GrInOrderDrawBuffer::onReset() {
     fCmdBuffer.reset();
+    fStateCache.reset();
     fPrevState = NULL;
     reset_data_buffer(&fPathIndexBuffer, kPathIdxBufferMinReserve);
     reset_data_buffer(&fPathTransformBuffer, kPathXformBufferMinReserve);
@@ -387,7 +397,6 @@ void GrInOrderDrawBuffer::onFlush() {
         return;
     }
 
-
     CmdBuffer::Iter iter(fCmdBuffer);
 
     int currCmdMarker = 0;
@@ -397,32 +406,130 @@ void GrInOrderDrawBuffer::onFlush() {
     GrOptDrawState* currentOptState = NULL;
 
     while (iter.next()) {
-        GrGpuTraceMarker newMarker("", -1);
-        SkString traceString;
+        int marker = -1;
         if (cmd_has_trace_marker(iter->fType)) {
-            traceString = fGpuCmdMarkers[currCmdMarker].toString();
-            newMarker.fMarker = traceString.c_str();
-            this->getGpu()->addGpuTraceMarker(&newMarker);
-            ++currCmdMarker;
+            marker = currCmdMarker++;
         }
 
         if (kSetState_Cmd == strip_trace_bit(iter->fType)) {
             SetState* ss = reinterpret_cast<SetState*>(iter.get());
-            currentOptState = &ss->fState;
+            // Interned states are set many times but only need to be finalized once.
+            currentOptState = ss->fState;
             currentOptState->finalize(this->getGpu());
         } else {
-            iter->execute(this, currentOptState);
+            this->batchCmd(iter.get(), currentOptState, marker);
         }
+    }
 
-        if (cmd_has_trace_marker(iter->fType)) {
-            this->getGpu()->removeGpuTraceMarker(&newMarker);
+    SkASSERT(fGpuCmdMarkers.count() == currCmdMarker);
+
+    for (int i = 0; i < fBatches.count(); ++i) {
+        const Batch& batch = fBatches[i];
+        if (!batch.fIsDraw) {
+            this->executeCmd(fBatchCmds[batch.fHead], batch.fState);
+            continue;
+        }
+        for (int c = batch.fHead; c >= 0; c = fBatchCmds[c].fNext) {
+            const BatchCmd& batchCmd = fBatchCmds[c];
+            if (batchCmd.fMarker < 0) {
+                *fBatchDraws.append() = &static_cast<Draw*>(batchCmd.fCmd)->fInfo;
+            } else {
+                // Draws with a trace marker are issued on their own so the marker surrounds them.
+                this->flushBatchDraws(batch.fState);
+                this->executeCmd(batchCmd, batch.fState);
+            }
         }
+        this->flushBatchDraws(batch.fState);
     }
 
-    SkASSERT(fGpuCmdMarkers.count() == currCmdMarker);
+    fBatchCmds.rewind();
+    fBatches.rewind();
     ++fDrawID;
 }
 
+// The pixels a draw may touch. Draws without (sane) bounds are assumed to touch everything.
+static SkIRect draw_pixel_bounds(const GrDrawTarget::DrawInfo& info) {
+    static const SkScalar kMaxCoord = SkIntToScalar(1 << 24);
+    const SkRect* devBounds = info.getDevBounds();
+    if (NULL == devBounds ||
+        !SkRect::MakeLTRB(-kMaxCoord, -kMaxCoord, kMaxCoord, kMaxCoord).contains(*devBounds)) {
+        return SkIRect::MakeLargest();
+    }
+    SkIRect bounds;
+    devBounds->roundOut(&bounds);
+    // Leave room for antialiasing and rasterization rules reaching a little past the bounds.
+    bounds.outset(1, 1);
+    return bounds;
+}
+
+void GrInOrderDrawBuffer::batchCmd(Cmd* cmd, const GrOptDrawState* state, int marker) {
+    const int index = fBatchCmds.count();
+    BatchCmd* batchCmd = fBatchCmds.append();
+    batchCmd->fCmd = cmd;
+    batchCmd->fMarker = marker;
+    batchCmd->fNext = -1;
+
+    if (kDraw_Cmd != strip_trace_bit(cmd->fType)) {
+        Batch* batch = fBatches.append();
+        batch->fState = state;
+        batch->fBounds.setEmpty();
+        batch->fHead = batch->fTail = index;
+        batch->fIsDraw = false;
+        return;
+    }
+
+    SkASSERT(state);
+    const SkIRect bounds = draw_pixel_bounds(static_cast<Draw*>(cmd)->fInfo);
+    const int stop = SkTMax(0, fBatches.count() - kMaxBatchLookback);
+    for (int i = fBatches.count() - 1; i >= stop; --i) {
+        Batch& batch = fBatches[i];
+        if (!batch.fIsDraw) {
+            break;
+        }
+        // States are interned, so equal states are the same object.
+        if (batch.fState == state) {
+            fBatchCmds[batch.fTail].fNext = index;
+            batch.fTail = index;
+            batch.fBounds.join(bounds);
+            return;
+        }
+        // Moving this draw ahead of the batch must not change the result.
+        if (batch.fState->getRenderTarget() != state->getRenderTarget() ||
+            SkIRect::Intersects(batch.fBounds, bounds)) {
+            break;
+        }
+    }
+
+    Batch* batch = fBatches.append();
+    batch->fState = state;
+    batch->fBounds = bounds;
+    batch->fHead = batch->fTail = index;
+    batch->fIsDraw = true;
+}
+
+void GrInOrderDrawBuffer::flushBatchDraws(const GrOptDrawState* state) {
+    if (fBatchDraws.count() > 0) {
+        this->getGpu()->drawBatch(*state, fBatchDraws.begin(), fBatchDraws.count());
+        fBatchDraws.rewind();
+    }
+}
+
+void GrInOrderDrawBuffer::executeCmd(const BatchCmd& batchCmd, const GrOptDrawState* state) {
+    GrGpuTraceMarker newMarker("", -1);
+    SkString traceString;
+    if (batchCmd.fMarker >= 0) {
+        traceString = fGpuCmdMarkers[batchCmd.fMarker].toString();
+        newMarker.fMarker = traceString.c_str();
+        this->getGpu()->addGpuTraceMarker(&newMarker);
+    }
+
+    batchCmd.fCmd->execute(this, state);
+
+    if (batchCmd.fMarker >= 0) {
+        this->getGpu()->removeGpuTraceMarker(&newMarker);
+    }
+}
+
 void GrInOrderDrawBuffer::Draw::execute(GrInOrderDrawBuffer* buf, const GrOptDrawState* optState) {
     SkASSERT(optState);
     buf->getGpu()->draw(*optState, fInfo);
@@ -486,17 +593,14 @@ bool GrInOrderDrawBuffer::recordStateAndShouldDraw(const GrDrawState& ds,
                                                    GrGpu::DrawType drawType,
                                                    const GrClipMaskManager::ScissorState& scissor,
                                                    const GrDeviceCoordTexture* dstCopy) {
-    SetState* ss = GrNEW_APPEND_TO_RECORDER(fCmdBuffer, SetState,
-                                            (ds, *this->getGpu()->caps(), scissor, dstCopy,
-                                             drawType));
-    if (ss->fState.mustSkip()) {
-        fCmdBuffer.pop_back();
+    GrOptDrawState* state = fStateCache.intern(ds, *this->getGpu()->caps(), scissor, dstCopy,
+                                               drawType);
+    if (NULL == state) {
         return false;
     }
-    if (fPrevState && *fPrevState == ss->fState) {
-        fCmdBuffer.pop_back();
-    } else {
-        fPrevState = &ss->fState;
+    if (fPrevState != state) {
+        GrNEW_APPEND_TO_RECORDER(fCmdBuffer, SetState, (state));
+        fPrevState = state;
         this->recordTraceMarkersIfNecessary();
     }
     return true;
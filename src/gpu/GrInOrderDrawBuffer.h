@@ -10,6 +10,7 @@
 
 #include "GrFlushToGpuDrawTarget.h"
 #include "GrOptDrawState.h"
+#include "GrOptDrawStateCache.h"
 #include "GrPath.h"
 #include "GrTRecorder.h"
 
@@ -171,20 +172,34 @@ private:
     };
 
     struct SetState : public Cmd {
-        SetState(const GrDrawState& drawState, const GrDrawTargetCaps& caps,
-                 const ScissorState& scissor, const GrDeviceCoordTexture* dstCopy,
-                 GrGpu::DrawType drawType)
-        : Cmd(kSetState_Cmd)
-        , fState(drawState, caps, scissor, dstCopy, drawType) {}
+        SetState(GrOptDrawState* state) : Cmd(kSetState_Cmd), fState(state) {}
 
         void execute(GrInOrderDrawBuffer*, const GrOptDrawState*) SK_OVERRIDE;
 
-        GrOptDrawState          fState;
+        GrOptDrawState*         fState;     // owned by fStateCache
     };
 
     typedef void* TCmdAlign; // This wouldn't be enough align if a command used long double.
     typedef GrTRecorder<Cmd, TCmdAlign> CmdBuffer;
 
+    // At flush time the commands are grouped into batches that are replayed in order. A draw batch
+    // is a list of draws that share a state and are issued together; a draw may join an earlier
+    // batch when every batch in between draws to the same render target and touches none of its
+    // pixels. Any other command is a batch of its own that draws can't be moved across.
+    struct BatchCmd {
+        Cmd*    fCmd;
+        int     fMarker;    // index into fGpuCmdMarkers, or -1
+        int     fNext;      // index of the next command in the same batch, or -1
+    };
+
+    struct Batch {
+        const GrOptDrawState*   fState;
+        SkIRect                 fBounds;    // pixels the batch's draws may touch
+        int                     fHead;      // indices into fBatchCmds
+        int                     fTail;
+        bool                    fIsDraw;
+    };
+
     void onReset() SK_OVERRIDE;
     void onFlush() SK_OVERRIDE;
 
@@ -230,9 +245,9 @@ private:
     // instanced draw. The caller must have already recorded a new draw state and clip if necessary.
     int concatInstancedDraw(const GrDrawState&, const DrawInfo&);
 
-    // Determines whether the current draw operation requires a new GrOptDrawState and if so
-    // records it. If the draw can be skipped false is returned and no new GrOptDrawState is
-    // recorded.
+    // Interns the GrOptDrawState for the current draw operation and, if it differs from the
+    // previous one, records it. If the draw can be skipped false is returned and no new
+    // GrOptDrawState is recorded.
     bool SK_WARN_UNUSED_RESULT recordStateAndShouldDraw(const GrDrawState&,
                                                         GrGpu::DrawType,
                                                         const GrClipMaskManager::ScissorState&,
@@ -242,6 +257,14 @@ private:
     // Records any trace markers for a command after adding it to the buffer.
     void recordTraceMarkersIfNecessary();
 
+    // Adds a recorded command to fBatches, either joining a compatible draw batch or starting a
+    // new batch.
+    void batchCmd(Cmd*, const GrOptDrawState*, int marker);
+    // Issues the draws gathered in fBatchDraws with the given state.
+    void flushBatchDraws(const GrOptDrawState*);
+    // Executes a single command, surrounded by its trace marker if it has one.
+    void executeCmd(const BatchCmd&, const GrOptDrawState*);
+
     virtual bool isIssued(uint32_t drawID) { return drawID != fDrawID; }
 
     // TODO: Use a single allocator for commands and records
@@ -249,15 +272,23 @@ private:
         kCmdBufferInitialSizeInBytes = 8 * 1024,
         kPathIdxBufferMinReserve     = 2 * 64,  // 64 uint16_t's
         kPathXformBufferMinReserve   = 2 * 64,  // 64 two-float transforms
+        // How many batches back a draw may look for one to join.
+        kMaxBatchLookback            = 8,
     };
 
     CmdBuffer                           fCmdBuffer;
+    GrOptDrawStateCache                 fStateCache;
     const GrOptDrawState*               fPrevState;
     SkTArray<GrTraceMarkerSet, false>   fGpuCmdMarkers;
     SkTDArray<char>                     fPathIndexBuffer;
     SkTDArray<float>                    fPathTransformBuffer;
     uint32_t                            fDrawID;
 
+    // Scratch space for onFlush().
+    SkTDArray<BatchCmd>                 fBatchCmds;
+    SkTDArray<Batch>                    fBatches;
+    SkTDArray<const DrawInfo*>          fBatchDraws;
+
     typedef GrFlushToGpuDrawTarget INHERITED;
 };
 
@@ -104,7 +104,7 @@ void GrLayerCache::initAtlas() {
     SkISize textureSize = SkISize::Make(kAtlasTextureWidth, kAtlasTextureHeight);
     fAtlas.reset(SkNEW_ARGS(GrAtlas, (fContext->getGpu(), kSkia8888_GrPixelConfig,
                                       kRenderTarget_GrSurfaceFlag,
-                                      textureSize, kNumPlotsX, kNumPlotsY, false)));
+                                      textureSize, kNumPlotsX, kNumPlotsY, 1, false)));
 }
 
 void GrLayerCache::freeAll() {
@@ -17,7 +17,8 @@ GrOptDrawState::GrOptDrawState(const GrDrawState& drawState,
                                const ScissorState& scissorState,
                                const GrDeviceCoordTexture* dstCopy,
                                GrGpu::DrawType drawType)
-    : fFinalized(false) {
+    : fFinalized(false)
+    , fNextWithSameKey(NULL) {
     fDrawType = drawType;
     GrBlendCoeff optSrcCoeff;
     GrBlendCoeff optDstCoeff;
@@ -129,6 +130,29 @@ GrOptDrawState::GrOptDrawState(const GrDrawState& drawState,
     }
 }
 
+void GrOptDrawState::setKey() {
+    // The key is computed for every draw, so it leaves out the parts that rarely tell states apart
+    // (the scissor rect and the view matrix beyond its type).
+    uint32_t data[kKeyLength];
+    int i = 0;
+    data[i++] = fRenderTarget.get()->getUniqueID();
+    data[i++] = fDstCopy.texture() ? fDstCopy.texture()->getUniqueID() : SK_InvalidUniqueID;
+    // Like operator==, ignore the color and coverage when they come from the vertices.
+    data[i++] = fDescInfo.fHasVertexColor ? 0 : fColor;
+    data[i++] = (fDescInfo.fHasVertexCoverage ? 0 : fCoverage) | (fFlags << 8) |
+                ((fDrawFace & 0xFF) << 16) | (fDrawType << 24);
+    data[i++] = (fSrcBlend << 16) | (fDstBlend << 8) | fScissorState.fEnabled;
+    data[i++] = fBlendConstant;
+    data[i++] = fViewMatrix.getType();
+    data[i++] = (fFragmentStages.count() << 16) | fNumColorStages;
+    data[i++] = this->hasGeometryProcessor() ? fGeometryProcessor->classID() : 0;
+    for (int s = 0; s < kMaxKeyedProcessors; ++s) {
+        data[i++] = s < fFragmentStages.count() ? fFragmentStages[s].getProcessor()->classID() : 0;
+    }
+    SkASSERT(kKeyLength == i);
+    fKey.setKeyData(data);
+}
+
 void GrOptDrawState::setOutputStateInfo(const GrDrawState& ds,
                                         GrDrawState::BlendOpt blendOpt,
                                         const GrDrawTargetCaps& caps) {
@@ -225,6 +249,9 @@ void GrOptDrawState::getStageStats(const GrDrawState& ds, int firstColorStageIdx
 }
 
 void GrOptDrawState::finalize(GrGpu* gpu) {
+    if (fFinalized) {
+        return;
+    }
     gpu->buildProgramDesc(*this, fDescInfo, fDrawType, &fDesc);
     fFinalized = true;
 }
@@ -10,6 +10,7 @@
 
 #include "GrColor.h"
 #include "GrGpu.h"
+#include "GrMurmur3HashKey.h"
 #include "GrPendingFragmentStage.h"
 #include "GrProgramDesc.h"
 #include "GrStencil.h"
@@ -36,6 +37,21 @@ public:
     bool operator== (const GrOptDrawState& that) const;
     bool operator!= (const GrOptDrawState& that) const { return !(*this == that); }
 
+    enum {
+        // How many processors are keyed by class in Key.
+        kMaxKeyedProcessors = 4,
+        kKeyLength = 9 + kMaxKeyedProcessors,
+    };
+
+    /**
+     * A hash key over the parts of the state that are cheap to compare. Equal states have equal
+     * keys, but not the other way around: processors are only keyed by class, so operator== has the
+     * final say. Only set for states that have been interned.
+     */
+    typedef GrMurmur3HashKey<kKeyLength * sizeof(uint32_t)> Key;
+
+    const Key& getKey() const { return fKey; }
+
     /// @}
 
     ///////////////////////////////////////////////////////////////////////////
@@ -185,7 +201,7 @@ public:
 
     const GrDeviceCoordTexture* getDstCopy() const { return fDstCopy.texture() ? &fDstCopy : NULL; }
 
-    // Finalize *MUST* be called before programDesc()
+    // Finalize *MUST* be called before programDesc(). Finalizing again has no effect.
     void finalize(GrGpu*);
 
     const GrProgramDesc& programDesc() const { SkASSERT(fFinalized); return fDesc; }
@@ -211,6 +227,8 @@ private:
      */
     void setOutputStateInfo(const GrDrawState& ds, GrDrawState::BlendOpt, const GrDrawTargetCaps&);
 
+    void setKey();
+
     enum Flags {
         kDither_Flag            = 0x1,
         kHWAA_Flag              = 0x2,
@@ -246,6 +264,12 @@ private:
 
     GrProgramDesc fDesc;
 
+    // Set by GrOptDrawStateCache.
+    Key                                 fKey;
+    GrOptDrawState*                     fNextWithSameKey;
+
+    friend class GrOptDrawStateCache;
+
     typedef SkRefCnt INHERITED;
 };
 
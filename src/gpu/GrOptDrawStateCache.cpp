@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrOptDrawStateCache.h"
+
+GrOptDrawStateCache::GrOptDrawStateCache()
+    : fStates(kStorageInitialSizeInBytes)
+    , fLast(NULL)
+    , fCount(0) {
+}
+
+GrOptDrawStateCache::~GrOptDrawStateCache() {
+    this->reset();
+}
+
+GrOptDrawState* GrOptDrawStateCache::intern(const GrDrawState& drawState,
+                                            const GrDrawTargetCaps& caps,
+                                            const ScissorState& scissor,
+                                            const GrDeviceCoordTexture* dstCopy,
+                                            GrGpu::DrawType drawType) {
+    GrOptDrawState* state = GrNEW_APPEND_TO_RECORDER(fStates, GrOptDrawState,
+                                                     (drawState, caps, scissor, dstCopy,
+                                                      drawType));
+    if (state->mustSkip()) {
+        fStates.pop_back();
+        return NULL;
+    }
+
+    // Consecutive draws often share their state, so try that before hashing.
+    if (fLast && *fLast == *state) {
+        fStates.pop_back();
+        return fLast;
+    }
+
+    state->setKey();
+    GrOptDrawState* first = fHash.find(state->getKey());
+    for (GrOptDrawState* cached = first; cached; cached = cached->fNextWithSameKey) {
+        if (*cached == *state) {
+            fStates.pop_back();
+            fLast = cached;
+            return cached;
+        }
+    }
+
+    if (first) {
+        state->fNextWithSameKey = first->fNextWithSameKey;
+        first->fNextWithSameKey = state;
+    } else {
+        fHash.add(state);
+    }
+    ++fCount;
+    fLast = state;
+    return state;
+}
+
+void GrOptDrawStateCache::reset() {
+    fHash.rewind();
+    fStates.reset();
+    fLast = NULL;
+    fCount = 0;
+}
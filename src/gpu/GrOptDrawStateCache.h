@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrOptDrawStateCache_DEFINED
+#define GrOptDrawStateCache_DEFINED
+
+#include "GrOptDrawState.h"
+#include "GrTRecorder.h"
+#include "SkTDynamicHash.h"
+
+/**
+ * Interns GrOptDrawStates: a state equal to one already in the cache is not kept, the cached one
+ * is returned instead. Draws that share a state then share the object, which is finalized once
+ * and compared by pointer.
+ *
+ * The states hold pending IO on their render targets and textures, so the cache must be reset as
+ * soon as the draws using them have been issued.
+ */
+class GrOptDrawStateCache : SkNoncopyable {
+public:
+    typedef GrOptDrawState::ScissorState ScissorState;
+
+    GrOptDrawStateCache();
+    ~GrOptDrawStateCache();
+
+    /**
+     * Returns the cached state for a draw, adding it to the cache if there is no equal state yet.
+     * Returns NULL if the draw can be skipped.
+     */
+    GrOptDrawState* intern(const GrDrawState&, const GrDrawTargetCaps&, const ScissorState&,
+                           const GrDeviceCoordTexture* dstCopy, GrGpu::DrawType);
+
+    /** Deletes all the cached states. */
+    void reset();
+
+    int count() const { return fCount; }
+
+private:
+    struct HashTraits {
+        static const GrOptDrawState::Key& GetKey(const GrOptDrawState& state) {
+            return state.getKey();
+        }
+        static uint32_t Hash(const GrOptDrawState::Key& key) { return key.getHash(); }
+    };
+
+    enum {
+        kStorageInitialSizeInBytes = 8 * 1024,
+    };
+
+    typedef void* TStateAlign;
+    typedef GrTRecorder<GrOptDrawState, TStateAlign> StateStorage;
+    // Holds the first state for each key, the others are chained through fNextWithSameKey.
+    typedef SkTDynamicHash<GrOptDrawState, GrOptDrawState::Key, HashTraits> StateHash;
+
+    StateStorage    fStates;
+    StateHash       fHash;
+    GrOptDrawState* fLast;      // the last state returned by intern()
+    int             fCount;
+};
+
+#endif
@@ -882,8 +882,11 @@ bool GrOvalRenderer::drawDIEllipse(GrDrawTarget* target,
     verts[3].fOuterOffset = SkPoint::Make(1.0f + offsetDx, -1.0f - offsetDy);
     verts[3].fInnerOffset = SkPoint::Make(innerRatioX + offsetDx, -innerRatioY - offsetDy);
 
+    // The quad is positioned in source space.
+    SkRect devBounds;
+    vm.mapRect(&devBounds, bounds);
     target->setIndexSourceToBuffer(context->getGpu()->getQuadIndexBuffer());
-    target->drawIndexedInstances(drawState, kTriangles_GrPrimitiveType, 1, 4, 6, &bounds);
+    target->drawIndexedInstances(drawState, kTriangles_GrPrimitiveType, 1, 4, 6, &devBounds);
     target->resetIndexSource();
 
     return true;
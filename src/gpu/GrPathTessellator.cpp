@@ -0,0 +1,606 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrPathTessellator.h"
+
+#include "GrPathUtils.h"
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkTArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+#include <math.h>
+
+// The sweep works in doubles: edges are split where they cross and compared again right below, and
+// floats don't keep enough of the difference on paths far from the origin.
+
+// Below this cosine of half the angle between two edges' normals, the side of the corner that
+// isn't mitered exactly is beveled, as the miter would be more than twice the ramp's half width.
+static const double kMiterLimit = 0.5;
+
+// Distances below this fraction of the path's size are considered zero.
+static const double kRelativeEpsilon = 1e-9;
+
+namespace {
+
+struct Point {
+    double fX;
+    double fY;
+};
+
+enum Side {
+    kUnknown_Side,
+    kNone_Side,      // the contour doesn't separate the inside from the outside
+    kPositive_Side,  // the inside is on the side (-dy, dx) points to, for a direction (dx, dy)
+    kNegative_Side,
+    kMixed_Side,
+};
+
+enum FillRule {
+    kNonZero_FillRule,
+    kEvenOdd_FillRule,
+    // Like non-zero, but no point may be wound more than once in either direction.
+    kDisjoint_FillRule,
+};
+
+// A closed contour, without two consecutive points the same.
+struct Contour {
+    SkTDArray<Point> fPoints;
+    Side             fSide;
+    int              fDirection;  // 1, or -1 to sweep it as if it were reversed
+};
+
+// One line segment of a contour, pointing down.
+struct Edge {
+    double fX0;
+    double fY0;
+    double fX1;
+    double fY1;
+    double fDXDY;
+    int    fWinding;  // 1 if the contour runs down along the edge, -1 if up
+    int    fContour;
+    int    fIndex;    // the edge runs from point fIndex to the next one of its contour
+    int    fCount;    // the number of points in its contour
+
+    // The open trapezoid this is the left side of, if any
+    Edge*  fTrapRight;
+    double fTrapTop;
+    int    fTrapBand;
+
+    double fSortX;
+
+    double x(double y) const { return fX0 + (y - fY0) * fDXDY; }
+};
+
+// Where a contour's ramp turns a corner: one point on the inset and outset contours, or two for a
+// bevel.
+struct Join {
+    Point fInner[2];
+    Point fOuter[2];
+    int   fInnerCount;
+    int   fOuterCount;
+};
+
+struct EdgeTopLT {
+    bool operator()(const Edge* a, const Edge* b) const { return a->fY0 < b->fY0; }
+};
+
+struct EdgeSortXLT {
+    bool operator()(const Edge* a, const Edge* b) const { return a->fSortX < b->fSortX; }
+};
+
+}
+
+typedef GrPathTessellator::Vertex Vertex;
+
+static void append_point(Contour* contour, SkScalar x, SkScalar y) {
+    Point* pt = contour->fPoints.append();
+    pt->fX = x;
+    pt->fY = y;
+}
+
+static void append_points(Contour* contour, const SkPoint pts[], int count) {
+    for (int i = 0; i < count; ++i) {
+        append_point(contour, pts[i].fX, pts[i].fY);
+    }
+}
+
+static void append_quad(Contour* contour, const SkPoint pts[3], SkScalar tol, SkScalar tolSqd) {
+    uint32_t maxCount = GrPathUtils::quadraticPointCount(pts, tol);
+    SkAutoSTMalloc<32, SkPoint> storage(maxCount);
+    SkPoint* end = storage.get();
+    int count = GrPathUtils::generateQuadraticPoints(pts[0], pts[1], pts[2], tolSqd, &end,
+                                                     maxCount);
+    append_points(contour, storage.get(), count);
+}
+
+static void append_cubic(Contour* contour, const SkPoint pts[4], SkScalar tol, SkScalar tolSqd) {
+    uint32_t maxCount = GrPathUtils::cubicPointCount(pts, tol);
+    SkAutoSTMalloc<32, SkPoint> storage(maxCount);
+    SkPoint* end = storage.get();
+    int count = GrPathUtils::generateCubicPoints(pts[0], pts[1], pts[2], pts[3], tolSqd, &end,
+                                                 maxCount);
+    append_points(contour, storage.get(), count);
+}
+
+// Removes repeated points, including the last one if it's the same as the first.
+static void remove_repeated_points(Contour* contour) {
+    SkTDArray<Point>& pts = contour->fPoints;
+    int count = 0;
+    for (int i = 0; i < pts.count(); ++i) {
+        if (0 == count || pts[i].fX != pts[count - 1].fX || pts[i].fY != pts[count - 1].fY) {
+            pts[count++] = pts[i];
+        }
+    }
+    while (count > 1 && pts[count - 1].fX == pts[0].fX && pts[count - 1].fY == pts[0].fY) {
+        --count;
+    }
+    pts.setCount(count);
+}
+
+// Flattens the path into contours and returns the distance below which two points are the same.
+static double flatten(const SkPath& path, SkScalar tol, SkTArray<Contour>* contours) {
+    SkScalar tolSqd = SkScalarMul(tol, tol);
+    SkAutoConicToQuads converter;
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    Contour* contour = NULL;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                contour = &contours->push_back();
+                contour->fSide = kUnknown_Side;
+                contour->fDirection = 1;
+                append_point(contour, pts[0].fX, pts[0].fY);
+                break;
+            case SkPath::kLine_Verb:
+                append_point(contour, pts[1].fX, pts[1].fY);
+                break;
+            case SkPath::kQuad_Verb:
+                append_quad(contour, pts, tol, tolSqd);
+                break;
+            case SkPath::kConic_Verb: {
+                const SkPoint* quadPts = converter.computeQuads(pts, iter.conicWeight(), tol);
+                for (int i = 0; i < converter.countQuads(); ++i) {
+                    append_quad(contour, quadPts + 2 * i, tol, tolSqd);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                append_cubic(contour, pts, tol, tolSqd);
+                break;
+            default:
+                break;
+        }
+    }
+
+    double extent = 0;
+    for (int i = contours->count() - 1; i >= 0; --i) {
+        Contour& c = (*contours)[i];
+        remove_repeated_points(&c);
+        // Less than a triangle has no area.
+        if (c.fPoints.count() < 3) {
+            contours->removeShuffle(i);
+            continue;
+        }
+        for (int j = 0; j < c.fPoints.count(); ++j) {
+            extent = SkTMax(extent, SkTMax(fabs(c.fPoints[j].fX), fabs(c.fPoints[j].fY)));
+        }
+    }
+    return extent * kRelativeEpsilon;
+}
+
+// Appends the edges of the contours, numbering the contours from firstContour.
+static void add_edges(const SkTArray<Contour>& contours, int firstContour,
+                      SkTDArray<Edge>* edges) {
+    for (int c = 0; c < contours.count(); ++c) {
+        const SkTDArray<Point>& pts = contours[c].fPoints;
+        int count = pts.count();
+        for (int i = 0; i < count; ++i) {
+            const Point& p0 = pts[i];
+            const Point& p1 = pts[i + 1 == count ? 0 : i + 1];
+            // Horizontal edges don't bound any band.
+            if (p0.fY == p1.fY) {
+                continue;
+            }
+            Edge* edge = edges->append();
+            if (p0.fY < p1.fY) {
+                edge->fX0 = p0.fX;
+                edge->fY0 = p0.fY;
+                edge->fX1 = p1.fX;
+                edge->fY1 = p1.fY;
+                edge->fWinding = 1;
+            } else {
+                edge->fX0 = p1.fX;
+                edge->fY0 = p1.fY;
+                edge->fX1 = p0.fX;
+                edge->fY1 = p0.fY;
+                edge->fWinding = -1;
+            }
+            edge->fWinding *= contours[c].fDirection;
+            edge->fDXDY = (edge->fX1 - edge->fX0) / (edge->fY1 - edge->fY0);
+            edge->fContour = firstContour + c;
+            edge->fIndex = i;
+            edge->fCount = count;
+            edge->fTrapRight = NULL;
+            edge->fTrapTop = 0;
+            edge->fTrapBand = -1;
+        }
+    }
+}
+
+// Do a and b share an end, by being next to each other in their contour?
+static bool are_consecutive(const Edge* a, const Edge* b) {
+    if (a->fContour != b->fContour) {
+        return false;
+    }
+    int afterA = a->fIndex + 1 == a->fCount ? 0 : a->fIndex + 1;
+    int afterB = b->fIndex + 1 == b->fCount ? 0 : b->fIndex + 1;
+    return afterA == b->fIndex || afterB == a->fIndex;
+}
+
+static inline bool is_inside(int winding, FillRule rule) {
+    return kEvenOdd_FillRule == rule ? SkToBool(winding & 1) : 0 != winding;
+}
+
+static void append_triangle(SkTDArray<Vertex>* verts, const Point& p0, float c0,
+                            const Point& p1, float c1, const Point& p2, float c2) {
+    Vertex* v = verts->append(3);
+    v[0].fPosition.set(SkDoubleToScalar(p0.fX), SkDoubleToScalar(p0.fY));
+    v[0].fCoverage = c0;
+    v[1].fPosition.set(SkDoubleToScalar(p1.fX), SkDoubleToScalar(p1.fY));
+    v[1].fCoverage = c1;
+    v[2].fPosition.set(SkDoubleToScalar(p2.fX), SkDoubleToScalar(p2.fY));
+    v[2].fCoverage = c2;
+}
+
+// Ends the trapezoid left is the left side of at bottom, and appends it to verts if there are any.
+static void close_trapezoid(Edge* left, double bottom, SkTDArray<Vertex>* verts) {
+    Edge* right = left->fTrapRight;
+    left->fTrapRight = NULL;
+    double top = left->fTrapTop;
+    if (NULL == verts || bottom <= top) {
+        return;
+    }
+    Point tl = { left->x(top), top };
+    Point tr = { right->x(top), top };
+    Point bl = { left->x(bottom), bottom };
+    Point br = { right->x(bottom), bottom };
+    if (tr.fX > tl.fX) {
+        append_triangle(verts, tl, 1, tr, 1, br, 1);
+    }
+    if (br.fX > bl.fX) {
+        append_triangle(verts, tl, 1, br, 1, bl, 1);
+    }
+}
+
+// Records which side of the edge's contour is inside, given whether its left and right are.
+static void classify(const Edge* edge, bool insideLeft, bool insideRight,
+                     SkTArray<Contour>* contours) {
+    Side side = kNone_Side;
+    if (insideLeft != insideRight) {
+        // (-dy, dx) points left of an edge going down, and right of one going up.
+        bool insidePositive = edge->fWinding > 0 ? insideLeft : insideRight;
+        side = insidePositive ? kPositive_Side : kNegative_Side;
+    }
+    Contour& contour = (*contours)[edge->fContour];
+    if (kUnknown_Side == contour.fSide) {
+        contour.fSide = side;
+    } else if (side != contour.fSide) {
+        contour.fSide = kMixed_Side;
+    }
+}
+
+/**
+ * Sweeps the edges top to bottom, appending trapezoids covering the inside to verts and recording
+ * which side of each contour is inside in contours, each if not NULL. Returns false if two edges
+ * cross, or touch anywhere but where consecutive edges of a contour meet, or if the rule is
+ * kDisjoint_FillRule and a point is wound more than once.
+ */
+static bool sweep(SkTDArray<Edge>* edges, FillRule rule, double eps,
+                  SkTArray<Contour>* contours, SkTDArray<Vertex>* verts) {
+    if (edges->isEmpty()) {
+        return true;
+    }
+    bool simple = true;
+
+    SkTDArray<Edge*> sorted;
+    sorted.setCount(edges->count());
+    for (int i = 0; i < edges->count(); ++i) {
+        sorted[i] = &(*edges)[i];
+    }
+    SkTQSort(sorted.begin(), sorted.end() - 1, EdgeTopLT());
+
+    SkTDArray<Edge*> active, previous;
+    int next = 0;
+    double y = sorted[0]->fY0;
+    for (int band = 0; ; ++band) {
+        // Edges that end at y leave, and the ones that start there join.
+        previous.swap(active);
+        active.rewind();
+        for (int i = 0; i < previous.count(); ++i) {
+            if (previous[i]->fY1 > y) {
+                *active.append() = previous[i];
+            }
+        }
+        while (next < sorted.count() && sorted[next]->fY0 <= y) {
+            *active.append() = sorted[next++];
+        }
+
+        double bottom = next < sorted.count() ? sorted[next]->fY0 : HUGE_VAL;
+        for (int i = 0; i < active.count(); ++i) {
+            bottom = SkTMin(bottom, active[i]->fY1);
+        }
+
+        // Order the edges across the band, cutting it short where two of them cross.
+        for (;;) {
+            double mid = 0.5 * (y + bottom);
+            for (int i = 0; i < active.count(); ++i) {
+                active[i]->fSortX = active[i]->x(mid);
+            }
+            if (active.count() > 1) {
+                SkTQSort(active.begin(), active.end() - 1, EdgeSortXLT());
+            }
+
+            double cut = bottom;
+            for (int i = 0; i + 1 < active.count(); ++i) {
+                Edge* a = active[i];
+                Edge* b = active[i + 1];
+                double dTop = a->x(y) - b->x(y);
+                double dBottom = a->x(bottom) - b->x(bottom);
+                if (dTop > eps || dBottom > eps) {
+                    simple = false;
+                    if (a->fDXDY != b->fDXDY) {
+                        double cross = y - dTop / (a->fDXDY - b->fDXDY);
+                        if (cross > y + eps && cross < cut - eps) {
+                            cut = cross;
+                        }
+                    }
+                } else if ((fabs(dTop) <= eps || fabs(dBottom) <= eps) &&
+                           !are_consecutive(a, b)) {
+                    simple = false;
+                }
+            }
+            if (cut == bottom) {
+                break;
+            }
+            bottom = cut;
+        }
+
+        // Open a trapezoid on each span inside the path, or carry on the one above.
+        int winding = 0;
+        for (int i = 0; i < active.count(); ++i) {
+            Edge* edge = active[i];
+            bool insideLeft = is_inside(winding, rule);
+            winding += edge->fWinding;
+            bool insideRight = is_inside(winding, rule);
+            if (kDisjoint_FillRule == rule && (winding > 1 || winding < -1)) {
+                simple = false;
+            }
+            if (contours) {
+                classify(edge, insideLeft, insideRight, contours);
+            }
+            if (insideRight && i + 1 < active.count()) {
+                Edge* right = active[i + 1];
+                if (edge->fTrapRight != right) {
+                    if (edge->fTrapRight) {
+                        close_trapezoid(edge, y, verts);
+                    }
+                    edge->fTrapRight = right;
+                    edge->fTrapTop = y;
+                }
+                edge->fTrapBand = band;
+            }
+        }
+
+        // Close the ones that don't carry on.
+        for (int i = 0; i < previous.count(); ++i) {
+            if (previous[i]->fTrapRight && previous[i]->fTrapBand != band) {
+                close_trapezoid(previous[i], y, verts);
+            }
+        }
+
+        if (active.isEmpty() && next == sorted.count()) {
+            break;
+        }
+        y = bottom;
+    }
+    return simple;
+}
+
+static double signed_area(const Contour& contour) {
+    const SkTDArray<Point>& pts = contour.fPoints;
+    double area = 0;
+    for (int i = 0; i < pts.count(); ++i) {
+        const Point& p0 = pts[i];
+        const Point& p1 = pts[i + 1 == pts.count() ? 0 : i + 1];
+        area += p0.fX * p1.fY - p1.fX * p0.fY;
+    }
+    return 0.5 * area;
+}
+
+static inline Point offset(const Point& p, const Point& dir, double dist) {
+    Point result = { p.fX + dir.fX * dist, p.fY + dir.fY * dist };
+    return result;
+}
+
+static inline bool runs_along(const Point& from, const Point& to, const Point& dir) {
+    return (to.fX - from.fX) * dir.fX + (to.fY - from.fY) * dir.fY > 0;
+}
+
+/**
+ * Appends the contour inset and outset by halfWidth to inner and outer, and the triangles of the
+ * ramp between the two to verts. Returns false if the contour doubles back on itself, or has edges
+ * too short for the ramp to follow.
+ */
+static bool add_ramp(const Contour& contour, double halfWidth, SkTArray<Contour>* inner,
+                     SkTArray<Contour>* outer, SkTDArray<Vertex>* verts) {
+    const SkTDArray<Point>& pts = contour.fPoints;
+    int count = pts.count();
+    SkAutoSTMalloc<64, Point> dirs(count);
+    SkAutoSTMalloc<64, Point> normals(count);
+    // Normals point out of the path.
+    double outward = kPositive_Side == contour.fSide ? -1 : 1;
+    for (int i = 0; i < count; ++i) {
+        const Point& p0 = pts[i];
+        const Point& p1 = pts[i + 1 == count ? 0 : i + 1];
+        double dx = p1.fX - p0.fX;
+        double dy = p1.fY - p0.fY;
+        double length = sqrt(dx * dx + dy * dy);
+        dirs[i].fX = dx / length;
+        dirs[i].fY = dy / length;
+        normals[i].fX = -outward * dirs[i].fY;
+        normals[i].fY = outward * dirs[i].fX;
+    }
+
+    // The exact offset of a corner is the miter on the side where the angle is less than 180
+    // degrees, and an arc on the other side, which is mitered or beveled instead.
+    SkAutoSTMalloc<64, Join> joins(count);
+    for (int i = 0; i < count; ++i) {
+        int prev = 0 == i ? count - 1 : i - 1;
+        const Point& a = normals[prev];
+        const Point& b = normals[i];
+        Point m = { a.fX + b.fX, a.fY + b.fY };
+        double length = sqrt(m.fX * m.fX + m.fY * m.fY);
+        if (length < 1e-6) {
+            return false;
+        }
+        m.fX /= length;
+        m.fY /= length;
+        double cosine = m.fX * a.fX + m.fY * a.fY;
+        double miter = halfWidth / cosine;
+        double cross = dirs[prev].fX * dirs[i].fY - dirs[prev].fY * dirs[i].fX;
+        bool convex = kPositive_Side == contour.fSide ? cross >= 0 : cross <= 0;
+
+        Join& join = joins[i];
+        const Point& p = pts[i];
+        if (convex) {
+            join.fInner[0] = offset(p, m, -miter);
+            join.fInnerCount = 1;
+            if (cosine >= kMiterLimit) {
+                join.fOuter[0] = offset(p, m, miter);
+                join.fOuterCount = 1;
+            } else {
+                join.fOuter[0] = offset(p, a, halfWidth);
+                join.fOuter[1] = offset(p, b, halfWidth);
+                join.fOuterCount = 2;
+            }
+        } else {
+            join.fOuter[0] = offset(p, m, miter);
+            join.fOuterCount = 1;
+            if (cosine >= kMiterLimit) {
+                join.fInner[0] = offset(p, m, -miter);
+                join.fInnerCount = 1;
+            } else {
+                join.fInner[0] = offset(p, a, -halfWidth);
+                join.fInner[1] = offset(p, b, -halfWidth);
+                join.fInnerCount = 2;
+            }
+        }
+    }
+
+    Contour& in = inner->push_back();
+    Contour& out = outer->push_back();
+    in.fSide = out.fSide = contour.fSide;
+    in.fDirection = out.fDirection = 1;
+    for (int i = 0; i < count; ++i) {
+        const Join& j = joins[i];
+        const Join& k = joins[i + 1 == count ? 0 : i + 1];
+        in.fPoints.append(j.fInnerCount, j.fInner);
+        out.fPoints.append(j.fOuterCount, j.fOuter);
+        if (2 == j.fInnerCount) {
+            append_triangle(verts, j.fInner[0], 1, j.fInner[1], 1, j.fOuter[0], 0);
+        }
+        if (2 == j.fOuterCount) {
+            append_triangle(verts, j.fOuter[0], 0, j.fOuter[1], 0, j.fInner[0], 1);
+        }
+        const Point& innerStart = j.fInner[j.fInnerCount - 1];
+        const Point& outerStart = j.fOuter[j.fOuterCount - 1];
+        // An edge shorter than the corners' offsets would run backwards, folding its ramp over.
+        if (!runs_along(innerStart, k.fInner[0], dirs[i]) ||
+            !runs_along(outerStart, k.fOuter[0], dirs[i])) {
+            return false;
+        }
+        append_triangle(verts, innerStart, 1, k.fInner[0], 1, k.fOuter[0], 0);
+        append_triangle(verts, innerStart, 1, k.fOuter[0], 0, outerStart, 0);
+    }
+    remove_repeated_points(&in);
+    remove_repeated_points(&out);
+
+    return true;
+}
+
+bool GrPathTessellator::Tessellate(const SkPath& path, SkScalar tolerance, SkScalar aaWidth,
+                                   SkTDArray<Vertex>* verts) {
+    SkASSERT(!path.isInverseFillType());
+    if (!path.isFinite()) {
+        return false;
+    }
+
+    SkTArray<Contour> contours;
+    double eps = flatten(path, tolerance, &contours);
+    FillRule rule = SkPath::kEvenOdd_FillType == path.getFillType() ? kEvenOdd_FillRule :
+                                                                      kNonZero_FillRule;
+    SkTDArray<Edge> edges;
+    add_edges(contours, 0, &edges);
+
+    if (aaWidth <= 0) {
+        sweep(&edges, rule, eps, NULL, verts);
+        return true;
+    }
+
+    if (!sweep(&edges, rule, eps, &contours, NULL)) {
+        return false;
+    }
+
+    SkTArray<Contour> inner, outer;
+    SkTDArray<Vertex> rampVerts;
+    for (int i = 0; i < contours.count(); ++i) {
+        const Contour& contour = contours[i];
+        if (kMixed_Side == contour.fSide) {
+            return false;
+        }
+        if (kPositive_Side != contour.fSide && kNegative_Side != contour.fSide) {
+            continue;
+        }
+        if (!add_ramp(contour, 0.5 * aaWidth, &inner, &outer, &rampVerts)) {
+            return false;
+        }
+        // An inset that turned inside out means the contour is thinner than the ramp.
+        Contour& in = inner.back();
+        Contour& out = outer.back();
+        double area = signed_area(contour);
+        double innerArea = signed_area(in);
+        double outerArea = signed_area(out);
+        if (in.fPoints.count() < 3 || (area > 0) != (innerArea > 0) ||
+            (area > 0) != (outerArea > 0)) {
+            return false;
+        }
+        // Wind the ramp the same way whether it's around an island or inside a hole.
+        int sign = area > 0 ? 1 : -1;
+        bool outerEnclosesInner = fabs(outerArea) > fabs(innerArea);
+        out.fDirection = outerEnclosesInner ? sign : -sign;
+        in.fDirection = -out.fDirection;
+    }
+
+    // The ramps must not cross or overlap each other, and since they're between the inside and the
+    // outside, that keeps them off the rest of the inside too.
+    SkTDArray<Edge> rampEdges;
+    add_edges(inner, 0, &rampEdges);
+    add_edges(outer, inner.count(), &rampEdges);
+    if (!sweep(&rampEdges, kDisjoint_FillRule, eps, NULL, NULL)) {
+        return false;
+    }
+
+    SkTDArray<Edge> innerEdges;
+    add_edges(inner, 0, &innerEdges);
+    sweep(&innerEdges, kEvenOdd_FillRule, eps, NULL, verts);
+    verts->append(rampVerts.count(), rampVerts.begin());
+    return true;
+}
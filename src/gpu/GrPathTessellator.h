@@ -0,0 +1,53 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrPathTessellator_DEFINED
+#define GrPathTessellator_DEFINED
+
+#include "SkPoint.h"
+#include "SkTDArray.h"
+
+class SkPath;
+
+/**
+ * Turns the fill of a path into triangles that cover every point inside the path exactly once and
+ * nothing outside of it, so they can be drawn without the stencil buffer and kept for as long as
+ * the path doesn't change.
+ *
+ * The path is flattened to line segments and swept top to bottom. It's cut into horizontal bands
+ * wherever a segment starts, ends or crosses another one. The spans of each band that are inside
+ * the path become trapezoids, merged with the ones above when both sides are the same segments.
+ *
+ * With antialiasing, every segment between the inside and the outside gets a ramp centered on it.
+ * The ramp's coverage goes from 1 on its inner edge to 0 on its outer edge, and what's left of the
+ * inside is filled with coverage 1. The ramps are built by insetting and outsetting each contour
+ * with mitered or beveled corners. That only works if the flattened path doesn't cross or touch
+ * itself, and neither do the inset and outset contours, so Tessellate() fails otherwise.
+ */
+class GrPathTessellator {
+public:
+    struct Vertex {
+        SkPoint fPosition;
+        float   fCoverage;
+    };
+
+    /**
+     * Appends the triangles covering the fill of path to verts, three vertices per triangle.
+     *
+     * @param path       The path to tessellate. Inverse fills are not supported.
+     * @param tolerance  The largest distance allowed between a curve and the lines replacing it.
+     * @param aaWidth    The width of the antialiasing ramps, in the path's units, or 0 for none.
+     *                   Without it, every vertex has coverage 1.
+     * @param verts      The array the triangles are appended to.
+     *
+     * @return false, with verts left alone, if the path isn't finite or can't be antialiased.
+     */
+    static bool Tessellate(const SkPath& path, SkScalar tolerance, SkScalar aaWidth,
+                           SkTDArray<Vertex>* verts);
+};
+
+#endif
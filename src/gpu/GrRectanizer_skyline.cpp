@@ -15,6 +15,11 @@ bool GrRectanizerSkyline::addRect(int width, int height, SkIPoint16* loc) {
         return false;
     }
 
+    if (fUseWasteMap && this->addRectToWaste(width, height, loc)) {
+        fAreaSoFar += width*height;
+        return true;
+    }
+
     // find position for new rectangle
     int bestWidth = this->width() + 1;
     int bestX;
@@ -35,6 +40,9 @@ bool GrRectanizerSkyline::addRect(int width, int height, SkIPoint16* loc) {
 
     // add rectangle to skyline
     if (-1 != bestIndex) {
+        if (fUseWasteMap) {
+            this->addWaste(bestIndex, bestY, width);
+        }
         this->addSkylineLevel(bestIndex, bestX, bestY, width, height);
         loc->fX = bestX;
         loc->fY = bestY;
@@ -115,6 +123,61 @@ void GrRectanizerSkyline::addSkylineLevel(int skylineIndex, int x, int y, int wi
     }
 }
 
+bool GrRectanizerSkyline::addRectToWaste(int width, int height, SkIPoint16* loc) {
+    int bestIndex = -1;
+    int bestArea = SK_MaxS32;
+    for (int i = 0; i < fWaste.count(); ++i) {
+        const SkIRect& free = fWaste[i];
+        if (free.width() >= width && free.height() >= height) {
+            int area = free.width() * free.height();
+            if (area < bestArea) {
+                bestIndex = i;
+                bestArea = area;
+            }
+        }
+    }
+
+    if (-1 == bestIndex) {
+        return false;
+    }
+
+    SkIRect free = fWaste[bestIndex];
+    fWaste.removeShuffle(bestIndex);
+    loc->fX = free.fLeft;
+    loc->fY = free.fTop;
+
+    // Split along the longer leftover, so that the bigger of the two pieces is as square as
+    // possible.
+    int rightLeft = free.width() - width;
+    int belowLeft = free.height() - height;
+    SkIRect right, below;
+    if (rightLeft > belowLeft) {
+        right.setLTRB(free.fLeft + width, free.fTop, free.fRight, free.fBottom);
+        below.setLTRB(free.fLeft, free.fTop + height, free.fLeft + width, free.fBottom);
+    } else {
+        right.setLTRB(free.fLeft + width, free.fTop, free.fRight, free.fTop + height);
+        below.setLTRB(free.fLeft, free.fTop + height, free.fRight, free.fBottom);
+    }
+    if (!right.isEmpty()) {
+        *fWaste.append() = right;
+    }
+    if (!below.isEmpty()) {
+        *fWaste.append() = below;
+    }
+    return true;
+}
+
+void GrRectanizerSkyline::addWaste(int skylineIndex, int y, int width) {
+    int right = fSkyline[skylineIndex].fX + width;
+    for (int i = skylineIndex; i < fSkyline.count() && fSkyline[i].fX < right; ++i) {
+        if (fSkyline[i].fY < y) {
+            *fWaste.append() = SkIRect::MakeLTRB(fSkyline[i].fX, fSkyline[i].fY,
+                                                 SkTMin(right, fSkyline[i].fX + fSkyline[i].fWidth),
+                                                 y);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 GrRectanizer* GrRectanizer::Factory(int width, int height) {
@@ -9,13 +9,19 @@
 #define GrRectanizer_skyline_DEFINED
 
 #include "GrRectanizer.h"
+#include "SkRect.h"
 #include "SkTDArray.h"
 
 // Pack rectangles and track the current silhouette
 // Based, in part, on Jukka Jylanki's work at http://clb.demon.fi
+//
+// With a waste map, the space left below the silhouette when a rectangle is placed above a lower
+// stretch of it is remembered and filled first, which packs noticeably tighter.
 class GrRectanizerSkyline : public GrRectanizer {
 public:
-    GrRectanizerSkyline(int w, int h) : INHERITED(w, h) {
+    GrRectanizerSkyline(int w, int h, bool useWasteMap = true)
+        : INHERITED(w, h)
+        , fUseWasteMap(useWasteMap) {
         this->reset();
     }
 
@@ -23,6 +29,7 @@ public:
 
     virtual void reset() SK_OVERRIDE{
         fAreaSoFar = 0;
+        fWaste.reset();
         fSkyline.reset();
         SkylineSegment* seg = fSkyline.append(1);
         seg->fX = 0;
@@ -44,8 +51,11 @@ private:
     };
 
     SkTDArray<SkylineSegment> fSkyline;
+    // Free rectangles below the skyline
+    SkTDArray<SkIRect>        fWaste;
 
     int32_t fAreaSoFar;
+    bool    fUseWasteMap;
 
     // Can a width x height rectangle fit in the free space represented by
     // the skyline segments >= 'skylineIndex'? If so, return true and fill in
@@ -55,6 +65,12 @@ private:
     // Update the skyline structure to include a width x height rect located
     // at x,y.
     void addSkylineLevel(int skylineIndex, int x, int y, int width, int height);
+    // Place a width x height rect in the smallest free rect of the waste map that holds it, and
+    // split what is left of that free rect in two.
+    bool addRectToWaste(int width, int height, SkIPoint16* loc);
+    // Add the space between the skyline and y, under a width wide rect placed at the start of
+    // 'skylineIndex's segment, to the waste map.
+    void addWaste(int skylineIndex, int y, int width);
 
     typedef GrRectanizer INHERITED;
 };
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrSWMaskBatch.h"
+
+#include "GrContext.h"
+#include "GrSWMaskHelper.h"
+#include "GrTexture.h"
+
+#include "SkPath.h"
+#include "SkStrokeRec.h"
+
+// Once the masks waiting for the next flush hold this many bytes they are uploaded early, so
+// recording a long run of software path draws doesn't keep all of their bitmaps around.
+static const size_t kMaxPendingBytes = 4 * 1024 * 1024;
+
+struct GrSWMaskBatch::PendingMask {
+    PendingMask(GrContext* context, const SkPath& path, const SkStrokeRec& stroke, bool antiAlias)
+        : fHelper(context)
+        , fPath(path)
+        , fStroke(stroke)
+        , fAntiAlias(antiAlias) {
+        // The copy shares its points with the path being recorded, and the generation ID they
+        // compute lazily isn't thread safe. Compute it here, on the recording thread, and keep the
+        // copy from being used as a cache key while it's drawn.
+        path.getGenerationID();
+        fPath.setIsVolatile(true);
+    }
+
+    // Set up on the thread recording the draw, then only drawn into by the task until it's done.
+    GrSWMaskHelper          fHelper;
+    SkPath                  fPath;
+    SkStrokeRec             fStroke;
+    bool                    fAntiAlias;
+    SkAutoTUnref<GrTexture> fTexture;
+};
+
+GrSWMaskBatch::GrSWMaskBatch(GrContext* context)
+    : fContext(context)
+    , fPendingBytes(0) {
+}
+
+GrSWMaskBatch::~GrSWMaskBatch() {
+    this->reset();
+}
+
+void GrSWMaskBatch::RasterizeMask(PendingMask* mask) {
+    mask->fHelper.draw(mask->fPath, mask->fStroke, SkRegion::kReplace_Op, mask->fAntiAlias, 0xFF);
+}
+
+GrTexture* GrSWMaskBatch::addPathMask(const SkPath& path,
+                                      const SkStrokeRec& stroke,
+                                      const SkIRect& resultBounds,
+                                      bool antiAlias,
+                                      const SkMatrix& matrix) {
+    SkAutoTDelete<PendingMask> mask(SkNEW_ARGS(PendingMask, (fContext, path, stroke, antiAlias)));
+    if (!mask->fHelper.init(resultBounds, &matrix)) {
+        return NULL;
+    }
+
+    // The mask is written at the start of the next flush, which must not change what any of the
+    // draws already recorded see.
+    mask->fTexture.reset(mask->fHelper.createTexture(true));
+    if (NULL == mask->fTexture) {
+        return NULL;
+    }
+
+    // With a compressing blitter the bitmap has no pixels, but its size still bounds the data.
+    size_t bytes = mask->fHelper.fBM.getSize();
+    if (fPendingBytes + bytes > kMaxPendingBytes) {
+        this->uploadMasks();
+    }
+    fPendingBytes += bytes;
+
+    GrTexture* texture = SkRef(mask->fTexture.get());
+    *fMasks.append() = mask.detach();
+    fTasks.add(RasterizeMask, fMasks.top());
+    return texture;
+}
+
+void GrSWMaskBatch::uploadMasks() {
+    if (fMasks.isEmpty()) {
+        return;
+    }
+    fTasks.wait();
+
+    // No draw has read the textures yet, so there's nothing to flush first. This is also called at
+    // the start of a flush, which mustn't be started again.
+    for (int i = 0; i < fMasks.count(); ++i) {
+        PendingMask* mask = fMasks[i];
+        mask->fHelper.uploadToTexture(mask->fTexture, GrContext::kDontFlush_PixelOpsFlag);
+    }
+    this->reset();
+}
+
+void GrSWMaskBatch::reset() {
+    fTasks.wait();
+    fMasks.deleteAll();
+    fPendingBytes = 0;
+}
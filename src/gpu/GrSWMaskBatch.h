@@ -0,0 +1,70 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrSWMaskBatch_DEFINED
+#define GrSWMaskBatch_DEFINED
+
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+#include "SkTypes.h"
+
+class GrContext;
+class GrTexture;
+class SkMatrix;
+class SkPath;
+class SkStrokeRec;
+struct SkIRect;
+
+/**
+ * Collects the path masks the software path renderer needs between two flushes of the draw
+ * buffer. Each mask is rasterized on an SkTaskGroup thread as soon as its draw is recorded, while
+ * the draws after it are being recorded, and they are all uploaded together when the draw buffer
+ * is flushed, before any of the draws reading them are played back.
+ */
+class GrSWMaskBatch : SkNoncopyable {
+public:
+    GrSWMaskBatch(GrContext* context);
+    ~GrSWMaskBatch();
+
+    /**
+     * Starts rasterizing the path's mask within resultBounds, in device space, and returns a ref'ed
+     * texture the mask will be in the upper left corner of once uploadMasks() is called, or NULL if
+     * the texture couldn't be made. Draws reading the texture can be recorded right away.
+     */
+    GrTexture* addPathMask(const SkPath& path,
+                           const SkStrokeRec& stroke,
+                           const SkIRect& resultBounds,
+                           bool antiAlias,
+                           const SkMatrix& matrix);
+
+    /**
+     * Waits for the masks added since the last call to be rasterized, and uploads them.
+     */
+    void uploadMasks();
+
+    /**
+     * Drops the masks added since the last upload without uploading them, for when the draws
+     * reading them are discarded.
+     */
+    void reset();
+
+private:
+    struct PendingMask;
+
+    static void RasterizeMask(PendingMask*);
+
+    GrContext*                fContext;
+    SkTDArray<PendingMask*>   fMasks;
+    // Bytes of mask the pending masks have allocated, which bounds how much memory a long run of
+    // draws without a flush can keep waiting for upload.
+    size_t                    fPendingBytes;
+    SkTaskGroup               fTasks;
+
+    typedef SkNoncopyable INHERITED;
+};
+
+#endif
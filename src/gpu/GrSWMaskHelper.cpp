@@ -216,6 +216,25 @@ bool GrSWMaskHelper::init(const SkIRect& resultBounds,
         fBM.setInfo(bmImageInfo);
     }
 
+    this->setupDraw(bounds);
+    return true;
+}
+
+void GrSWMaskHelper::initBand(const GrSWMaskHelper& mask, int top, int bottom) {
+    SkASSERT(kNone_CompressionMode == mask.fCompressionMode);
+    SkASSERT(0 <= top && top < bottom && bottom <= mask.fBM.height());
+
+    // The band's rows are mask's, so drawing through the same matrix moved up by top lands on
+    // the same pixels.
+    fMatrix = mask.fMatrix;
+    fMatrix.postTranslate(0, -SkIntToScalar(top));
+    fBM.installPixels(SkImageInfo::MakeA8(mask.fBM.width(), bottom - top),
+                      const_cast<void*>(mask.fBM.getAddr(0, top)), mask.fBM.rowBytes());
+
+    this->setupDraw(SkIRect::MakeWH(fBM.width(), fBM.height()));
+}
+
+void GrSWMaskHelper::setupDraw(const SkIRect& bounds) {
     sk_bzero(&fDraw, sizeof(fDraw));
 
     fRasterClip.setRect(bounds);
@@ -223,13 +242,12 @@ bool GrSWMaskHelper::init(const SkIRect& resultBounds,
     fDraw.fClip  = &fRasterClip.bwRgn();
     fDraw.fMatrix = &fMatrix;
     fDraw.fBitmap = &fBM;
-    return true;
 }
 
 /**
  * Get a texture (from the texture cache) of the correct size & format.
  */
-GrTexture* GrSWMaskHelper::createTexture() {
+GrTexture* GrSWMaskHelper::createTexture(bool requireNoPendingIO) {
     GrSurfaceDesc desc;
     desc.fWidth = fBM.width();
     desc.fHeight = fBM.height();
@@ -248,25 +266,22 @@ GrTexture* GrSWMaskHelper::createTexture() {
         SkASSERT(fContext->getGpu()->caps()->isConfigTexturable(desc.fConfig));
     }
 
-    return fContext->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch);
+    return fContext->refScratchTexture(desc, GrContext::kApprox_ScratchTexMatch,
+                                       requireNoPendingIO);
 }
 
 void GrSWMaskHelper::sendTextureData(GrTexture *texture, const GrSurfaceDesc& desc,
-                                     const void *data, int rowbytes) {
-    // If we aren't reusing scratch textures we don't need to flush before
-    // writing since no one else will be using 'texture'
-    bool reuseScratch = fContext->getGpu()->caps()->reuseScratchTextures();
-
+                                     const void *data, int rowbytes, uint32_t pixelOpsFlags) {
     // Since we're uploading to it, and it's compressed, 'texture' shouldn't
     // have a render target.
     SkASSERT(NULL == texture->asRenderTarget());
 
     texture->writePixels(0, 0, desc.fWidth, desc.fHeight,
-                         desc.fConfig, data, rowbytes,
-                         reuseScratch ? 0 : GrContext::kDontFlush_PixelOpsFlag);
+                         desc.fConfig, data, rowbytes, pixelOpsFlags);
 }
 
-void GrSWMaskHelper::compressTextureData(GrTexture *texture, const GrSurfaceDesc& desc) {
+void GrSWMaskHelper::compressTextureData(GrTexture *texture, const GrSurfaceDesc& desc,
+                                         uint32_t pixelOpsFlags) {
 
     SkASSERT(GrPixelConfigIsCompressed(desc.fConfig));
     SkASSERT(fmt_to_config(fCompressedFormat) == desc.fConfig);
@@ -274,13 +289,21 @@ void GrSWMaskHelper::compressTextureData(GrTexture *texture, const GrSurfaceDesc
     SkAutoDataUnref cmpData(SkTextureCompressor::CompressBitmapToFormat(fBM, fCompressedFormat));
     SkASSERT(cmpData);
 
-    this->sendTextureData(texture, desc, cmpData->data(), 0);
+    this->sendTextureData(texture, desc, cmpData->data(), 0, pixelOpsFlags);
 }
 
 /**
  * Move the result of the software mask generation back to the gpu
  */
 void GrSWMaskHelper::toTexture(GrTexture *texture) {
+    // If we aren't reusing scratch textures we don't need to flush before
+    // writing since no one else will be using 'texture'
+    bool reuseScratch = fContext->getGpu()->caps()->reuseScratchTextures();
+
+    this->uploadToTexture(texture, reuseScratch ? 0 : GrContext::kDontFlush_PixelOpsFlag);
+}
+
+void GrSWMaskHelper::uploadToTexture(GrTexture* texture, uint32_t pixelOpsFlags) {
     SkAutoLockPixels alp(fBM);
 
     GrSurfaceDesc desc;
@@ -291,16 +314,16 @@ void GrSWMaskHelper::toTexture(GrTexture *texture) {
     // First see if we should compress this texture before uploading.
     switch (fCompressionMode) {
         case kNone_CompressionMode:
-            this->sendTextureData(texture, desc, fBM.getPixels(), fBM.rowBytes());
+            this->sendTextureData(texture, desc, fBM.getPixels(), fBM.rowBytes(), pixelOpsFlags);
             break;
 
         case kCompress_CompressionMode:
-            this->compressTextureData(texture, desc);
+            this->compressTextureData(texture, desc, pixelOpsFlags);
             break;
 
         case kBlitter_CompressionMode:
             SkASSERT(fCompressedBuffer.get());
-            this->sendTextureData(texture, desc, fCompressedBuffer.get(), 0);
+            this->sendTextureData(texture, desc, fCompressedBuffer.get(), 0, pixelOpsFlags);
             break;
     }
 }
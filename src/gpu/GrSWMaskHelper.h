@@ -52,6 +52,11 @@ public:
     // your own texture to draw into, and not a scratch texture via getTexture().
     bool init(const SkIRect& resultBounds, const SkMatrix* matrix, bool allowCompression = true);
 
+    // set up to draw into the rows [top, bottom) of mask's bitmap, with mask's matrix, so several
+    // helpers can each accumulate the same draws into a band of one mask on a different thread.
+    // mask must have been initialized without compression, and outlive this helper.
+    void initBand(const GrSWMaskHelper& mask, int top, int bottom);
+
     // Draw a single rect into the accumulation bitmap using the specified op
     void draw(const SkRect& rect, SkRegion::Op op,
               bool antiAlias, uint8_t alpha);
@@ -96,9 +101,20 @@ public:
                                          const SkIRect& rect);
 
 private:
+    friend class GrSWMaskBatch;
+
     // Helper function to get a scratch texture suitable for capturing the
-    // result (i.e., right size & format)
-    GrTexture* createTexture();
+    // result (i.e., right size & format). If requireNoPendingIO is set the
+    // texture won't be one that draws already recorded read from or write to,
+    // so it can be uploaded to later without flushing.
+    GrTexture* createTexture(bool requireNoPendingIO = false);
+
+    // Points fDraw at the bitmap and matrix, clipped to bounds.
+    void setupDraw(const SkIRect& bounds);
+
+    // Moves the results to the gpu as toTexture() does, passing pixelOpsFlags
+    // on to the write.
+    void uploadToTexture(GrTexture* texture, uint32_t pixelOpsFlags);
 
     GrContext*      fContext;
     SkMatrix        fMatrix;
@@ -127,11 +143,12 @@ private:
     // Actually sends the texture data to the GPU. This is called from
     // toTexture with the data filled in depending on the texture config.
     void sendTextureData(GrTexture *texture, const GrSurfaceDesc& desc,
-                         const void *data, int rowbytes);
+                         const void *data, int rowbytes, uint32_t pixelOpsFlags);
 
     // Compresses the bitmap stored in fBM and sends the compressed data
     // to the GPU to be stored in 'texture' using sendTextureData.
-    void compressTextureData(GrTexture *texture, const GrSurfaceDesc& desc);
+    void compressTextureData(GrTexture *texture, const GrSurfaceDesc& desc,
+                             uint32_t pixelOpsFlags);
 
     typedef SkNoncopyable INHERITED;
 };
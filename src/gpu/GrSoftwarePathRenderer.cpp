@@ -8,6 +8,7 @@
 
 #include "GrSoftwarePathRenderer.h"
 #include "GrContext.h"
+#include "GrSWMaskBatch.h"
 #include "GrSWMaskHelper.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,10 +133,10 @@ bool GrSoftwarePathRenderer::onDrawPath(GrDrawTarget* target,
         return true;
     }
 
+    // The mask is rasterized while the draws after this one are recorded, and is uploaded when
+    // the draw buffer is flushed.
     SkAutoTUnref<GrTexture> texture(
-            GrSWMaskHelper::DrawPathMaskToTexture(fContext, path, stroke,
-                                                  devPathBounds,
-                                                  antiAlias, &vm));
+            fContext->getSWMaskBatch()->addPathMask(path, stroke, devPathBounds, antiAlias, vm));
     if (NULL == texture) {
         return false;
     }
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrTessellatingPathRenderer.h"
+
+#include "GrContext.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrDrawState.h"
+#include "GrDrawTarget.h"
+#include "GrGpu.h"
+#include "GrPathTessellator.h"
+#include "GrVertexBuffer.h"
+
+#include "SkChecksum.h"
+
+#include <math.h>
+
+// largest distance between a curve and its flattened lines, in device pixels
+static const SkScalar kTolerance = SK_Scalar1 / 4;
+
+// The view matrix' scale is rounded to this many steps per octave, so the antialiasing ramps are
+// within 5% of a pixel wide and a path being animated in size is only tessellated every few frames.
+static const double kScaleBucketsPerOctave = 8;
+
+// Sweeping is O(n log n) in the flattened segments in the common case, but can approach O(n^2)
+// when many of them span the same rows. Bigger paths are left to the stencil or mask renderers.
+static const int kMaxPathPoints = 1024;
+
+static GrResourceKey compute_key(uint32_t genID, int32_t scaleBucket, uint32_t fillType,
+                                 uint32_t antiAlias) {
+    static const GrResourceKey::ResourceType gMeshResourceType =
+        GrResourceKey::GenerateResourceType();
+    static const GrCacheID::Domain gMeshDomain = GrCacheID::GenerateDomain();
+
+    GrCacheID::Key key;
+    key.fData32[0] = genID;
+    key.fData32[1] = scaleBucket;
+    key.fData32[2] = fillType;
+    key.fData32[3] = antiAlias;
+
+    return GrResourceKey(GrCacheID(gMeshDomain, key), gMeshResourceType, 0);
+}
+
+GrTessellatingPathRenderer::GrTessellatingPathRenderer(GrContext* context)
+    : fContext(context) {
+    // Paths never have a generation ID of 0.
+    memset(fFailedKeys, 0, sizeof(fFailedKeys));
+}
+
+bool GrTessellatingPathRenderer::canDrawPath(const GrDrawTarget* target,
+                                             const GrDrawState* drawState,
+                                             const SkPath& path,
+                                             const SkStrokeRec& stroke,
+                                             bool antiAlias) const {
+    // Meshes are only worth making for paths that will be drawn again.
+    // TODO: Support inverse fills, by drawing the mesh's complement in the clip bounds.
+    if (path.isInverseFillType() || path.isVolatile() || !stroke.isFillStyle() ||
+        path.countPoints() > kMaxPathPoints || !path.isFinite()) {
+        return false;
+    }
+
+    const SkMatrix& vm = drawState->getViewMatrix();
+    if (vm.hasPerspective()) {
+        return false;
+    }
+
+    // The ramps are made a pixel wide in the path's space, which only stays a pixel wide on the
+    // device if the matrix scales the same in every direction.
+    if (antiAlias && !vm.isSimilarity()) {
+        return false;
+    }
+
+    MeshKey key;
+    if (!ComputeMeshKey(path, vm, antiAlias, &key)) {
+        return false;
+    }
+    GrResourceKey resourceKey = compute_key(key.fGenID, key.fScaleBucket, key.fFillType,
+                                            key.fAntiAlias);
+    GrGpuResource* cached = fContext->findAndRefCachedResource(resourceKey);
+    if (cached) {
+        cached->unref();
+        return true;
+    }
+
+    // Not being volatile doesn't make a path drawn again, so wait until it is. The draw target
+    // only hands out a new token once it has flushed, which keeps the several lookups made for
+    // one draw from counting as several draws.
+    if (!this->wasSeenBefore(const_cast<GrDrawTarget*>(target), key)) {
+        return false;
+    }
+
+    // Tessellate now, so the draw falls back to the other renderers if it fails.
+    GrVertexBuffer* mesh;
+    if (!this->findOrCreateMesh(path, key, &mesh)) {
+        return false;
+    }
+    SkSafeUnref(mesh);
+    return true;
+}
+
+GrPathRenderer::StencilSupport
+GrTessellatingPathRenderer::onGetStencilSupport(const GrDrawTarget*,
+                                                const GrDrawState*,
+                                                const SkPath&,
+                                                const SkStrokeRec&) const {
+    // The triangles never overlap, so each pixel is drawn at most once.
+    return GrPathRenderer::kNoRestriction_StencilSupport;
+}
+
+bool GrTessellatingPathRenderer::ComputeMeshKey(const SkPath& path,
+                                                const SkMatrix& viewMatrix,
+                                                bool antiAlias,
+                                                MeshKey* key) {
+    SkScalar maxScale = viewMatrix.getMaxScale();
+    if (!(maxScale > 0)) {
+        return false;
+    }
+    key->fGenID = path.getGenerationID();
+    key->fScaleBucket = (int32_t) floor(log(maxScale) / log(2.0) * kScaleBucketsPerOctave + 0.5);
+    key->fFillType = path.getFillType();
+    key->fAntiAlias = antiAlias;
+    return true;
+}
+
+bool GrTessellatingPathRenderer::wasSeenBefore(GrDrawTarget* target, const MeshKey& key) const {
+    SeenKey& seen = fSeenKeys[SkChecksum::Mix(key.fGenID ^ key.fScaleBucket) % kSeenKeyCount];
+    if (seen.fKey == key) {
+        return seen.fToken.isIssued();
+    }
+    seen.fKey = key;
+    seen.fToken = target->getCurrentDrawToken();
+    return false;
+}
+
+bool GrTessellatingPathRenderer::findOrCreateMesh(const SkPath& path,
+                                                  const MeshKey& key,
+                                                  GrVertexBuffer** mesh) const {
+    *mesh = NULL;
+    GrResourceKey resourceKey = compute_key(key.fGenID, key.fScaleBucket, key.fFillType,
+                                            key.fAntiAlias);
+    GrGpuResource* cached = fContext->findAndRefCachedResource(resourceKey);
+    if (cached) {
+        *mesh = static_cast<GrVertexBuffer*>(cached);
+        return true;
+    }
+
+    MeshKey& failed = fFailedKeys[SkChecksum::Mix(key.fGenID) % kFailedKeyCount];
+    if (failed == key) {
+        return false;
+    }
+
+    // Tessellate in the path's space, as finely as the device needs.
+    bool antiAlias = SkToBool(key.fAntiAlias);
+    SkScalar scale = SkDoubleToScalar(pow(2.0, key.fScaleBucket / kScaleBucketsPerOctave));
+    SkTDArray<GrPathTessellator::Vertex> verts;
+    if (!GrPathTessellator::Tessellate(path, kTolerance / scale, antiAlias ? 1 / scale : 0,
+                                       &verts)) {
+        failed = key;
+        return false;
+    }
+    if (verts.isEmpty()) {
+        return true;
+    }
+
+    // The default geometry processors read positions, followed by a float coverage with AA.
+    size_t vertexSize = antiAlias ? sizeof(GrPathTessellator::Vertex) : sizeof(SkPoint);
+    GrVertexBuffer* buffer = fContext->getGpu()->createVertexBuffer(verts.count() * vertexSize,
+                                                                    false);
+    if (NULL == buffer) {
+        return false;
+    }
+    bool updated;
+    if (antiAlias) {
+        updated = buffer->updateData(verts.begin(), verts.count() * vertexSize);
+    } else {
+        SkAutoSTMalloc<256, SkPoint> positions(verts.count());
+        for (int i = 0; i < verts.count(); ++i) {
+            positions[i] = verts[i].fPosition;
+        }
+        updated = buffer->updateData(positions.get(), verts.count() * vertexSize);
+    }
+    if (!updated) {
+        buffer->unref();
+        return false;
+    }
+
+    fContext->addResourceToCache(resourceKey, buffer);
+    *mesh = buffer;
+    return true;
+}
+
+bool GrTessellatingPathRenderer::onDrawPath(GrDrawTarget* target,
+                                            GrDrawState* drawState,
+                                            const SkPath& path,
+                                            const SkStrokeRec& stroke,
+                                            bool antiAlias) {
+    const SkMatrix& vm = drawState->getViewMatrix();
+    MeshKey key;
+    GrVertexBuffer* mesh;
+    if (!ComputeMeshKey(path, vm, antiAlias, &key) || !this->findOrCreateMesh(path, key, &mesh)) {
+        return false;
+    }
+    if (NULL == mesh) {
+        return true;
+    }
+    SkAutoTUnref<GrVertexBuffer> aur(mesh);
+
+    GrDrawState::AutoRestoreEffects are(drawState);
+    uint32_t gpTypeFlags = antiAlias ? GrDefaultGeoProcFactory::kCoverage_GPType :
+                                       GrDefaultGeoProcFactory::kPosition_GPType;
+    drawState->setGeometryProcessor(GrDefaultGeoProcFactory::Create(gpTypeFlags))->unref();
+    size_t vertexStride = drawState->getGeometryProcessor()->getVertexStride();
+    SkASSERT(vertexStride == (antiAlias ? sizeof(GrPathTessellator::Vertex) : sizeof(SkPoint)));
+    int vertexCount = SkToInt(mesh->gpuMemorySize() / vertexStride);
+
+    SkRect devBounds;
+    vm.mapRect(&devBounds, path.getBounds());
+    devBounds.outset(SK_Scalar1, SK_Scalar1);
+
+    target->setVertexSourceToBuffer(mesh, vertexStride);
+    target->drawNonIndexed(drawState, kTriangles_GrPrimitiveType, 0, vertexCount, &devBounds);
+    target->resetVertexSource();
+    return true;
+}
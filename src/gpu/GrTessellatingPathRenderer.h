@@ -0,0 +1,96 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrTessellatingPathRenderer_DEFINED
+#define GrTessellatingPathRenderer_DEFINED
+
+#include "GrPathRenderer.h"
+
+class GrContext;
+class GrVertexBuffer;
+
+/**
+ * Draws filled paths from triangle meshes made by GrPathTessellator, with antialiasing ramps when
+ * asked for. The meshes are kept in the resource cache, keyed by the path's generation ID and the
+ * scale of the view matrix rounded to an eighth of an octave, so a path that doesn't change is
+ * only tessellated once for as long as it keeps being drawn at about the same size. Paths are only
+ * taken once they are drawn again after the flush they were first drawn in, so one-off paths are
+ * left to the other renderers.
+ */
+class GrTessellatingPathRenderer : public GrPathRenderer {
+public:
+    GrTessellatingPathRenderer(GrContext* context);
+
+    virtual bool canDrawPath(const GrDrawTarget*,
+                             const GrDrawState*,
+                             const SkPath&,
+                             const SkStrokeRec&,
+                             bool antiAlias) const SK_OVERRIDE;
+
+protected:
+    virtual StencilSupport onGetStencilSupport(const GrDrawTarget*,
+                                               const GrDrawState*,
+                                               const SkPath&,
+                                               const SkStrokeRec&) const SK_OVERRIDE;
+
+    virtual bool onDrawPath(GrDrawTarget*,
+                            GrDrawState*,
+                            const SkPath&,
+                            const SkStrokeRec&,
+                            bool antiAlias) SK_OVERRIDE;
+
+private:
+    // Everything a path's mesh depends on besides its points.
+    struct MeshKey {
+        uint32_t fGenID;
+        int32_t  fScaleBucket;
+        uint32_t fFillType;
+        uint32_t fAntiAlias;
+
+        bool operator==(const MeshKey& that) const {
+            return fGenID == that.fGenID && fScaleBucket == that.fScaleBucket &&
+                   fFillType == that.fFillType && fAntiAlias == that.fAntiAlias;
+        }
+    };
+    // A path seen by canDrawPath, and the flush of the target it was seen in.
+    struct SeenKey {
+        SeenKey() : fToken(NULL, 0) { memset(&fKey, 0, sizeof(fKey)); }
+
+        MeshKey                 fKey;
+        GrDrawTarget::DrawToken fToken;
+    };
+    enum {
+        kFailedKeyCount = 64,
+        kSeenKeyCount = 256,
+    };
+
+    /** Returns false if the view matrix has no scale to tessellate the path for. */
+    static bool ComputeMeshKey(const SkPath&, const SkMatrix& viewMatrix, bool antiAlias,
+                               MeshKey*);
+
+    /**
+     * Returns true if the path was seen with the same key in an earlier flush of the target.
+     * Otherwise remembers that it was seen in this one, and returns false.
+     */
+    bool wasSeenBefore(GrDrawTarget*, const MeshKey&) const;
+
+    /**
+     * Finds the path's mesh in the cache, or tessellates it and adds it there. Returns false if
+     * the path can't be tessellated. Otherwise *mesh is set to a ref'ed vertex buffer, or to NULL
+     * if the path covers nothing.
+     */
+    bool findOrCreateMesh(const SkPath& path, const MeshKey&, GrVertexBuffer** mesh) const;
+
+    GrContext*        fContext;
+    // Keys of the paths that couldn't be antialiased, so they aren't tried again every frame.
+    mutable MeshKey   fFailedKeys[kFailedKeyCount];
+    mutable SeenKey   fSeenKeys[kSeenKeyCount];
+
+    typedef GrPathRenderer INHERITED;
+};
+
+#endif
@@ -8,7 +8,7 @@
 #include "GrGLBufferImpl.h"
 #include "GrGpuGL.h"
 
-#define GL_CALL(GPU, X) GR_GL_CALL(GPU->glInterface(), X)
+#define GL_CALL(GPU, X) GR_GL_GPU_CALL(GPU, X)
 
 #ifdef SK_DEBUG
 #define VALIDATE() this->validate()
@@ -95,8 +95,8 @@ void* GrGLBufferImpl::map(GrGpuGL* gpu) {
                             BufferData(fBufferType, fGLSizeInBytes, NULL,
                                        fDesc.fDynamic ? DYNAMIC_USAGE_PARAM : GR_GL_STATIC_DRAW));
                 }
-                GR_GL_CALL_RET(gpu->glInterface(), fMapPtr,
-                               MapBuffer(fBufferType, GR_GL_WRITE_ONLY));
+                GR_GL_GPU_CALL_RET(gpu, fMapPtr,
+                                   MapBuffer(fBufferType, GR_GL_WRITE_ONLY));
                 break;
             case GrGLCaps::kMapBufferRange_MapBufferType: {
                 this->bind(gpu);
@@ -109,9 +109,8 @@ void* GrGLBufferImpl::map(GrGpuGL* gpu) {
                 }
                 static const GrGLbitfield kAccess = GR_GL_MAP_INVALIDATE_BUFFER_BIT |
                                                     GR_GL_MAP_WRITE_BIT;
-                GR_GL_CALL_RET(gpu->glInterface(),
-                               fMapPtr,
-                               MapBufferRange(fBufferType, 0, fGLSizeInBytes, kAccess));
+                GR_GL_GPU_CALL_RET(gpu, fMapPtr,
+                                   MapBufferRange(fBufferType, 0, fGLSizeInBytes, kAccess));
                 break;
             }
             case GrGLCaps::kChromium_MapBufferType:
@@ -123,9 +122,9 @@ void* GrGLBufferImpl::map(GrGpuGL* gpu) {
                             BufferData(fBufferType, fGLSizeInBytes, NULL,
                                        fDesc.fDynamic ? DYNAMIC_USAGE_PARAM : GR_GL_STATIC_DRAW));
                 }
-                GR_GL_CALL_RET(gpu->glInterface(),
-                               fMapPtr,
-                               MapBufferSubData(fBufferType, 0, fGLSizeInBytes, GR_GL_WRITE_ONLY));
+                GR_GL_GPU_CALL_RET(gpu, fMapPtr,
+                                   MapBufferSubData(fBufferType, 0, fGLSizeInBytes,
+                                                    GR_GL_WRITE_ONLY));
                 break;
         }
     }
@@ -148,7 +147,7 @@ void GrGLBufferImpl::unmap(GrGpuGL* gpu) {
                 break;
             case GrGLCaps::kChromium_MapBufferType:
                 this->bind(gpu);
-                GR_GL_CALL(gpu->glInterface(), UnmapBufferSubData(fMapPtr));
+                GR_GL_GPU_CALL(gpu, UnmapBufferSubData(fMapPtr));
                 break;
         }
     }
@@ -164,22 +164,22 @@ void GrGLPath::InitPathObject(GrGpuGL* gpu,
         SkASSERT(verbCnt == pathCommands.count());
         SkASSERT(numCoords == pathCoords.count());
 
-        GR_GL_CALL(gpu->glInterface(), PathCommands(pathID, pathCommands.count(), &pathCommands[0],
-                   pathCoords.count(), GR_GL_FLOAT, &pathCoords[0]));
+        GR_GL_GPU_CALL(gpu, PathCommands(pathID, pathCommands.count(), &pathCommands[0],
+                       pathCoords.count(), GR_GL_FLOAT, &pathCoords[0]));
     } else {
-        GR_GL_CALL(gpu->glInterface(), PathCommands(pathID, 0, NULL, 0, GR_GL_FLOAT, NULL));
+        GR_GL_GPU_CALL(gpu, PathCommands(pathID, 0, NULL, 0, GR_GL_FLOAT, NULL));
     }
 
     if (stroke.needToApply()) {
         SkASSERT(!stroke.isHairlineStyle());
-        GR_GL_CALL(gpu->glInterface(),
+        GR_GL_GPU_CALL(gpu,
             PathParameterf(pathID, GR_GL_PATH_STROKE_WIDTH, SkScalarToFloat(stroke.getWidth())));
-        GR_GL_CALL(gpu->glInterface(),
+        GR_GL_GPU_CALL(gpu,
             PathParameterf(pathID, GR_GL_PATH_MITER_LIMIT, SkScalarToFloat(stroke.getMiter())));
         GrGLenum join = join_to_gl_join(stroke.getJoin());
-        GR_GL_CALL(gpu->glInterface(), PathParameteri(pathID, GR_GL_PATH_JOIN_STYLE, join));
+        GR_GL_GPU_CALL(gpu, PathParameteri(pathID, GR_GL_PATH_JOIN_STYLE, join));
         GrGLenum cap = cap_to_gl_cap(stroke.getCap());
-        GR_GL_CALL(gpu->glInterface(), PathParameteri(pathID, GR_GL_PATH_END_CAPS, cap));
+        GR_GL_GPU_CALL(gpu, PathParameteri(pathID, GR_GL_PATH_END_CAPS, cap));
     }
 }
 
@@ -38,7 +38,7 @@ void GrGLPathRange::onInitPath(int index, const SkPath& skPath) const {
     // Make sure the path at this index hasn't been initted already.
     SkDEBUGCODE(
         GrGLboolean isPath;
-        GR_GL_CALL_RET(gpu->glInterface(), isPath, IsPath(fBasePathID + index)));
+        GR_GL_GPU_CALL_RET(gpu, isPath, IsPath(fBasePathID + index)));
     SkASSERT(GR_GL_FALSE == isPath);
 
     GrGLPath::InitPathObject(gpu, fBasePathID + index, skPath, this->getStroke());
@@ -17,8 +17,8 @@
 #include "SkStream.h"
 #include "SkTypeface.h"
 
-#define GL_CALL(X) GR_GL_CALL(fGpu->glInterface(), X)
-#define GL_CALL_RET(RET, X) GR_GL_CALL_RET(fGpu->glInterface(), RET, X)
+#define GL_CALL(X) GR_GL_GPU_CALL(fGpu, X)
+#define GL_CALL_RET(RET, X) GR_GL_GPU_CALL_RET(fGpu, RET, X)
 
 
 static const GrGLenum gIndexType2GLType[] = {
@@ -19,8 +19,8 @@
 #include "GrOptDrawState.h"
 #include "SkXfermode.h"
 
-#define GL_CALL(X) GR_GL_CALL(fGpu->glInterface(), X)
-#define GL_CALL_RET(R, X) GR_GL_CALL_RET(fGpu->glInterface(), R, X)
+#define GL_CALL(X) GR_GL_GPU_CALL(fGpu, X)
+#define GL_CALL_RET(R, X) GR_GL_GPU_CALL_RET(fGpu, R, X)
 
 /**
  * Retrieves the final matrix that a transform needs to apply to its source coords.
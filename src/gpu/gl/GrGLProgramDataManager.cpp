@@ -51,10 +51,10 @@ void GrGLProgramDataManager::setSampler(UniformHandle u, GrGLint texUnit) const
     // once stages insert their own samplers.
     // SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fFSLocation, texUnit));
+        GR_GL_GPU_CALL(fGpu, Uniform1i(uni.fFSLocation, texUnit));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fVSLocation, texUnit));
+        GR_GL_GPU_CALL(fGpu, Uniform1i(uni.fVSLocation, texUnit));
     }
 }
 
@@ -64,10 +64,10 @@ void GrGLProgramDataManager::set1f(UniformHandle u, GrGLfloat v0) const {
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fFSLocation, v0));
+        GR_GL_GPU_CALL(fGpu, Uniform1f(uni.fFSLocation, v0));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fVSLocation, v0));
+        GR_GL_GPU_CALL(fGpu, Uniform1f(uni.fVSLocation, v0));
     }
 }
 
@@ -83,10 +83,10 @@ void GrGLProgramDataManager::set1fv(UniformHandle u,
     // arrays in VS and FS driver bug workaround, this can be enabled.
     //SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1fv(uni.fFSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform1fv(uni.fFSLocation, arrayCount, v));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform1fv(uni.fVSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform1fv(uni.fVSLocation, arrayCount, v));
     }
 }
 
@@ -96,10 +96,10 @@ void GrGLProgramDataManager::set2f(UniformHandle u, GrGLfloat v0, GrGLfloat v1)
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fFSLocation, v0, v1));
+        GR_GL_GPU_CALL(fGpu, Uniform2f(uni.fFSLocation, v0, v1));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fVSLocation, v0, v1));
+        GR_GL_GPU_CALL(fGpu, Uniform2f(uni.fVSLocation, v0, v1));
     }
 }
 
@@ -112,10 +112,10 @@ void GrGLProgramDataManager::set2fv(UniformHandle u,
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform2fv(uni.fFSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform2fv(uni.fFSLocation, arrayCount, v));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform2fv(uni.fVSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform2fv(uni.fVSLocation, arrayCount, v));
     }
 }
 
@@ -125,10 +125,10 @@ void GrGLProgramDataManager::set3f(UniformHandle u, GrGLfloat v0, GrGLfloat v1,
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fFSLocation, v0, v1, v2));
+        GR_GL_GPU_CALL(fGpu, Uniform3f(uni.fFSLocation, v0, v1, v2));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fVSLocation, v0, v1, v2));
+        GR_GL_GPU_CALL(fGpu, Uniform3f(uni.fVSLocation, v0, v1, v2));
     }
 }
 
@@ -141,10 +141,10 @@ void GrGLProgramDataManager::set3fv(UniformHandle u,
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform3fv(uni.fFSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform3fv(uni.fFSLocation, arrayCount, v));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform3fv(uni.fVSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform3fv(uni.fVSLocation, arrayCount, v));
     }
 }
 
@@ -158,10 +158,10 @@ void GrGLProgramDataManager::set4f(UniformHandle u,
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fFSLocation, v0, v1, v2, v3));
+        GR_GL_GPU_CALL(fGpu, Uniform4f(uni.fFSLocation, v0, v1, v2, v3));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fVSLocation, v0, v1, v2, v3));
+        GR_GL_GPU_CALL(fGpu, Uniform4f(uni.fVSLocation, v0, v1, v2, v3));
     }
 }
 
@@ -174,10 +174,10 @@ void GrGLProgramDataManager::set4fv(UniformHandle u,
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform4fv(uni.fFSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform4fv(uni.fFSLocation, arrayCount, v));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), Uniform4fv(uni.fVSLocation, arrayCount, v));
+        GR_GL_GPU_CALL(fGpu, Uniform4fv(uni.fVSLocation, arrayCount, v));
     }
 }
 
@@ -188,10 +188,10 @@ void GrGLProgramDataManager::setMatrix3f(UniformHandle u, const GrGLfloat matrix
     // TODO: Re-enable this assert once texture matrices aren't forced on all effects
     // SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), UniformMatrix3fv(uni.fFSLocation, 1, false, matrix));
+        GR_GL_GPU_CALL(fGpu, UniformMatrix3fv(uni.fFSLocation, 1, false, matrix));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), UniformMatrix3fv(uni.fVSLocation, 1, false, matrix));
+        GR_GL_GPU_CALL(fGpu, UniformMatrix3fv(uni.fVSLocation, 1, false, matrix));
     }
 }
 
@@ -201,10 +201,10 @@ void GrGLProgramDataManager::setMatrix4f(UniformHandle u, const GrGLfloat matrix
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), UniformMatrix4fv(uni.fFSLocation, 1, false, matrix));
+        GR_GL_GPU_CALL(fGpu, UniformMatrix4fv(uni.fFSLocation, 1, false, matrix));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(), UniformMatrix4fv(uni.fVSLocation, 1, false, matrix));
+        GR_GL_GPU_CALL(fGpu, UniformMatrix4fv(uni.fVSLocation, 1, false, matrix));
     }
 }
 
@@ -217,12 +217,12 @@ void GrGLProgramDataManager::setMatrix3fv(UniformHandle u,
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(),
-                   UniformMatrix3fv(uni.fFSLocation, arrayCount, false, matrices));
+        GR_GL_GPU_CALL(fGpu,
+                       UniformMatrix3fv(uni.fFSLocation, arrayCount, false, matrices));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(),
-                   UniformMatrix3fv(uni.fVSLocation, arrayCount, false, matrices));
+        GR_GL_GPU_CALL(fGpu,
+                       UniformMatrix3fv(uni.fVSLocation, arrayCount, false, matrices));
     }
 }
 
@@ -235,12 +235,12 @@ void GrGLProgramDataManager::setMatrix4fv(UniformHandle u,
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkASSERT(kUnusedUniform != uni.fFSLocation || kUnusedUniform != uni.fVSLocation);
     if (kUnusedUniform != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(),
-                   UniformMatrix4fv(uni.fFSLocation, arrayCount, false, matrices));
+        GR_GL_GPU_CALL(fGpu,
+                       UniformMatrix4fv(uni.fFSLocation, arrayCount, false, matrices));
     }
     if (kUnusedUniform != uni.fVSLocation && uni.fVSLocation != uni.fFSLocation) {
-        GR_GL_CALL(fGpu->glInterface(),
-                   UniformMatrix4fv(uni.fVSLocation, arrayCount, false, matrices));
+        GR_GL_GPU_CALL(fGpu,
+                       UniformMatrix4fv(uni.fVSLocation, arrayCount, false, matrices));
     }
 }
 
@@ -9,7 +9,7 @@
 #include "GrGpuGL.h"
 
 #define GPUGL static_cast<GrGpuGL*>(this->getGpu())
-#define GL_CALL(X) GR_GL_CALL(GPUGL->glInterface(), X)
+#define GL_CALL(X) GR_GL_GPU_CALL(GPUGL, X)
 
 // Because this class is virtually derived from GrSurface we must explicitly call its constructor.
 GrGLTexture::GrGLTexture(GrGpuGL* gpu, const GrSurfaceDesc& desc, const IDDesc& idDesc)
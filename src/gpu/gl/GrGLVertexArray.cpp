@@ -9,7 +9,7 @@
 #include "GrGpuGL.h"
 
 #define GPUGL static_cast<GrGpuGL*>(this->getGpu())
-#define GL_CALL(X) GR_GL_CALL(GPUGL->glInterface(), X);
+#define GL_CALL(X) GR_GL_GPU_CALL(GPUGL, X);
 
 void GrGLAttribArrayState::set(const GrGpuGL* gpu,
                                int index,
@@ -22,7 +22,7 @@ void GrGLAttribArrayState::set(const GrGpuGL* gpu,
     SkASSERT(index >= 0 && index < fAttribArrayStates.count());
     AttribArrayState* array = &fAttribArrayStates[index];
     if (!array->fEnableIsValid || !array->fEnabled) {
-        GR_GL_CALL(gpu->glInterface(), EnableVertexAttribArray(index));
+        GR_GL_GPU_CALL(gpu, EnableVertexAttribArray(index));
         array->fEnableIsValid = true;
         array->fEnabled = true;
     }
@@ -34,12 +34,12 @@ void GrGLAttribArrayState::set(const GrGpuGL* gpu,
         array->fOffset != offset) {
 
         buffer->bind();
-        GR_GL_CALL(gpu->glInterface(), VertexAttribPointer(index,
-                                                           size,
-                                                           type,
-                                                           normalized,
-                                                           stride,
-                                                           offset));
+        GR_GL_GPU_CALL(gpu, VertexAttribPointer(index,
+                                                size,
+                                                type,
+                                                normalized,
+                                                stride,
+                                                offset));
         array->fAttribPointerIsValid = true;
         array->fVertexBufferID = buffer->bufferID();
         array->fSize = size;
@@ -54,7 +54,7 @@ void GrGLAttribArrayState::disableUnusedArrays(const GrGpuGL* gpu, uint64_t used
     for (int i = 0; i < count; ++i) {
         if (!(usedMask & 0x1)) {
             if (!fAttribArrayStates[i].fEnableIsValid || fAttribArrayStates[i].fEnabled) {
-                GR_GL_CALL(gpu->glInterface(), DisableVertexAttribArray(i));
+                GR_GL_GPU_CALL(gpu, DisableVertexAttribArray(i));
                 fAttribArrayStates[i].fEnableIsValid = true;
                 fAttribArrayStates[i].fEnabled = false;
             }
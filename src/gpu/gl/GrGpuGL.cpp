@@ -18,18 +18,18 @@
 #include "SkStrokeRec.h"
 #include "SkTemplates.h"
 
-#define GL_CALL(X) GR_GL_CALL(this->glInterface(), X)
-#define GL_CALL_RET(RET, X) GR_GL_CALL_RET(this->glInterface(), RET, X)
+#define GL_CALL(X) GR_GL_GPU_CALL(this, X)
+#define GL_CALL_RET(RET, X) GR_GL_GPU_CALL_RET(this, RET, X)
 
 #define SKIP_CACHE_CHECK    true
 
 #if GR_GL_CHECK_ALLOC_WITH_GET_ERROR
     #define CLEAR_ERROR_BEFORE_ALLOC(iface)   GrGLClearErr(iface)
-    #define GL_ALLOC_CALL(iface, call)        GR_GL_CALL_NOERRCHECK(iface, call)
+    #define GL_ALLOC_CALL(gpu, call)          GR_GL_GPU_CALL_NOERRCHECK(gpu, call)
     #define CHECK_ALLOC_ERROR(iface)          GR_GL_GET_ERROR(iface)
 #else
     #define CLEAR_ERROR_BEFORE_ALLOC(iface)
-    #define GL_ALLOC_CALL(iface, call)        GR_GL_CALL(iface, call)
+    #define GL_ALLOC_CALL(gpu, call)          GR_GL_GPU_CALL(gpu, call)
     #define CHECK_ALLOC_ERROR(iface)          GR_GL_NO_ERROR
 #endif
 
@@ -151,6 +151,11 @@ GrGpuGL::GrGpuGL(const GrGLContext& ctx, GrContext* context)
     fLastSuccessfulStencilFmtIdx = 0;
     fHWProgramID = 0;
 
+#if GR_GPU_STATS
+    fGLCallCount = 0;
+    fGPUStats.setGLCallCount(&fGLCallCount);
+#endif
+
     if (this->glCaps().pathRenderingSupport()) {
         fPathRendering.reset(new GrGLPathRendering(this));
     }
@@ -637,13 +642,13 @@ bool GrGpuGL::uploadTexData(const GrSurfaceDesc& desc,
         CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
         if (useTexStorage) {
             // We never resize  or change formats of textures.
-            GL_ALLOC_CALL(this->glInterface(),
+            GL_ALLOC_CALL(this,
                           TexStorage2D(GR_GL_TEXTURE_2D,
                                        1, // levels
                                        internalFormat,
                                        desc.fWidth, desc.fHeight));
         } else {
-            GL_ALLOC_CALL(this->glInterface(),
+            GL_ALLOC_CALL(this,
                           TexImage2D(GR_GL_TEXTURE_2D,
                                      0, // level
                                      internalFormat,
@@ -732,7 +737,7 @@ bool GrGpuGL::uploadCompressedTexData(const GrSurfaceDesc& desc,
 
     if (isNewTexture) {
         CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
-        GL_ALLOC_CALL(this->glInterface(),
+        GL_ALLOC_CALL(this,
                       CompressedTexImage2D(GR_GL_TEXTURE_2D,
                                            0, // level
                                            internalFormat,
@@ -761,24 +766,24 @@ bool GrGpuGL::uploadCompressedTexData(const GrSurfaceDesc& desc,
     return true;
 }
 
-static bool renderbuffer_storage_msaa(GrGLContext& ctx,
+static bool renderbuffer_storage_msaa(GrGpuGL* gpu,
                                       int sampleCount,
                                       GrGLenum format,
                                       int width, int height) {
-    CLEAR_ERROR_BEFORE_ALLOC(ctx.interface());
-    SkASSERT(GrGLCaps::kNone_MSFBOType != ctx.caps()->msFBOType());
-    switch (ctx.caps()->msFBOType()) {
+    CLEAR_ERROR_BEFORE_ALLOC(gpu->glInterface());
+    SkASSERT(GrGLCaps::kNone_MSFBOType != gpu->glCaps().msFBOType());
+    switch (gpu->glCaps().msFBOType()) {
         case GrGLCaps::kDesktop_ARB_MSFBOType:
         case GrGLCaps::kDesktop_EXT_MSFBOType:
         case GrGLCaps::kES_3_0_MSFBOType:
-            GL_ALLOC_CALL(ctx.interface(),
+            GL_ALLOC_CALL(gpu,
                             RenderbufferStorageMultisample(GR_GL_RENDERBUFFER,
                                                             sampleCount,
                                                             format,
                                                             width, height));
             break;
         case GrGLCaps::kES_Apple_MSFBOType:
-            GL_ALLOC_CALL(ctx.interface(),
+            GL_ALLOC_CALL(gpu,
                             RenderbufferStorageMultisampleES2APPLE(GR_GL_RENDERBUFFER,
                                                                     sampleCount,
                                                                     format,
@@ -786,7 +791,7 @@ static bool renderbuffer_storage_msaa(GrGLContext& ctx,
             break;
         case GrGLCaps::kES_EXT_MsToTexture_MSFBOType:
         case GrGLCaps::kES_IMG_MsToTexture_MSFBOType:
-            GL_ALLOC_CALL(ctx.interface(),
+            GL_ALLOC_CALL(gpu,
                             RenderbufferStorageMultisampleES2EXT(GR_GL_RENDERBUFFER,
                                                                 sampleCount,
                                                                 format,
@@ -796,7 +801,7 @@ static bool renderbuffer_storage_msaa(GrGLContext& ctx,
             SkFAIL("Shouldn't be here if we don't support multisampled renderbuffers.");
             break;
     }
-    return (GR_GL_NO_ERROR == CHECK_ALLOC_ERROR(ctx.interface()));;
+    return (GR_GL_NO_ERROR == CHECK_ALLOC_ERROR(gpu->glInterface()));;
 }
 
 bool GrGpuGL::createRenderTargetObjects(const GrSurfaceDesc& desc, GrGLuint texID,
@@ -846,7 +851,7 @@ bool GrGpuGL::createRenderTargetObjects(const GrSurfaceDesc& desc, GrGLuint texI
     if (idDesc->fRTFBOID != idDesc->fTexFBOID) {
         SkASSERT(desc.fSampleCnt > 0);
         GL_CALL(BindRenderbuffer(GR_GL_RENDERBUFFER, idDesc->fMSColorRenderbufferID));
-        if (!renderbuffer_storage_msaa(fGLContext,
+        if (!renderbuffer_storage_msaa(this,
                                        desc.fSampleCnt,
                                        msColorFormat,
                                        desc.fWidth, desc.fHeight)) {
@@ -1152,14 +1157,14 @@ bool GrGpuGL::createStencilBufferForRenderTarget(GrRenderTarget* rt, int width,
         // version on a GL that doesn't have an MSAA extension.
         bool created;
         if (samples > 0) {
-            created = renderbuffer_storage_msaa(fGLContext,
+            created = renderbuffer_storage_msaa(this,
                                                 samples,
                                                 sFmt.fInternalFormat,
                                                 width, height);
         } else {
-            GL_ALLOC_CALL(this->glInterface(), RenderbufferStorage(GR_GL_RENDERBUFFER,
-                                                                   sFmt.fInternalFormat,
-                                                                   width, height));
+            GL_ALLOC_CALL(this, RenderbufferStorage(GR_GL_RENDERBUFFER,
+                                                    sFmt.fInternalFormat,
+                                                    width, height));
             created = (GR_GL_NO_ERROR == check_alloc_error(rt->desc(), this->glInterface()));
         }
         if (created) {
@@ -1268,7 +1273,7 @@ GrVertexBuffer* GrGpuGL::onCreateVertexBuffer(size_t size, bool dynamic) {
             fHWGeometryState.setVertexBufferID(this, desc.fID);
             CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
             // make sure driver can allocate memory for this buffer
-            GL_ALLOC_CALL(this->glInterface(),
+            GL_ALLOC_CALL(this,
                           BufferData(GR_GL_ARRAY_BUFFER,
                                      (GrGLsizeiptr) desc.fSizeInBytes,
                                      NULL,   // data ptr
@@ -1301,7 +1306,7 @@ GrIndexBuffer* GrGpuGL::onCreateIndexBuffer(size_t size, bool dynamic) {
             fHWGeometryState.setIndexBufferIDOnDefaultVertexArray(this, desc.fID);
             CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
             // make sure driver can allocate memory for this buffer
-            GL_ALLOC_CALL(this->glInterface(),
+            GL_ALLOC_CALL(this,
                           BufferData(GR_GL_ELEMENT_ARRAY_BUFFER,
                                      (GrGLsizeiptr) desc.fSizeInBytes,
                                      NULL,  // data ptr
@@ -1751,6 +1756,7 @@ void GrGpuGL::onDraw(const GrOptDrawState& ds, const GrDrawTarget::DrawInfo& inf
         // accounted for startVertex.
         GL_CALL(DrawArrays(gPrimitiveType2GLMode[info.primitiveType()], 0, info.vertexCount()));
     }
+    fGPUStats.incDraws();
 #if SWAP_PER_DRAW
     glFlush();
     #if defined(SK_BUILD_FOR_MAC)
@@ -2341,14 +2347,14 @@ GrGLuint GrGpuGL::bindSurfaceAsFBO(GrSurface* surface, GrGLenum fboTarget, GrGLI
     if (NULL == rt) {
         SkASSERT(surface->asTexture());
         GrGLuint texID = static_cast<GrGLTexture*>(surface->asTexture())->textureID();
-        GR_GL_CALL(this->glInterface(), GenFramebuffers(1, &tempFBOID));
+        GR_GL_GPU_CALL(this, GenFramebuffers(1, &tempFBOID));
         fGPUStats.incRenderTargetBinds();
-        GR_GL_CALL(this->glInterface(), BindFramebuffer(fboTarget, tempFBOID));
-        GR_GL_CALL(this->glInterface(), FramebufferTexture2D(fboTarget,
-                                                             GR_GL_COLOR_ATTACHMENT0,
-                                                             GR_GL_TEXTURE_2D,
-                                                             texID,
-                                                             0));
+        GR_GL_GPU_CALL(this, BindFramebuffer(fboTarget, tempFBOID));
+        GR_GL_GPU_CALL(this, FramebufferTexture2D(fboTarget,
+                                                  GR_GL_COLOR_ATTACHMENT0,
+                                                  GR_GL_TEXTURE_2D,
+                                                  texID,
+                                                  0));
         viewport->fLeft = 0;
         viewport->fBottom = 0;
         viewport->fWidth = surface->width();
@@ -2356,7 +2362,7 @@ GrGLuint GrGpuGL::bindSurfaceAsFBO(GrSurface* surface, GrGLenum fboTarget, GrGLI
     } else {
         tempFBOID = 0;
         fGPUStats.incRenderTargetBinds();
-        GR_GL_CALL(this->glInterface(), BindFramebuffer(fboTarget, rt->renderFBOID()));
+        GR_GL_GPU_CALL(this, BindFramebuffer(fboTarget, rt->renderFBOID()));
         *viewport = rt->getViewport();
     }
     return tempFBOID;
@@ -2561,7 +2567,7 @@ GrGLAttribArrayState* GrGpuGL::HWGeometryState::bindArrayAndBuffersToDraw(
         if (NULL == fVBOVertexArray || fVBOVertexArray->wasDestroyed()) {
             SkSafeUnref(fVBOVertexArray);
             GrGLuint arrayID;
-            GR_GL_CALL(gpu->glInterface(), GenVertexArrays(1, &arrayID));
+            GR_GL_GPU_CALL(gpu, GenVertexArrays(1, &arrayID));
             int attrCount = gpu->glCaps().maxVertexAttributes();
             fVBOVertexArray = SkNEW_ARGS(GrGLVertexArray, (gpu, arrayID, attrCount));
         }
@@ -27,6 +27,32 @@
 #define PROGRAM_CACHE_STATS
 #endif
 
+// Makes a GL call through a GrGpuGL's interface, counting it for GrContext::GPUStats (if
+// necessary). Calls made straight through a GrGLInterface are not counted.
+#if GR_GPU_STATS
+    #define GR_GL_GPU_COUNT_CALL_IMPL(GPU) (GPU)->countGLCall()
+#else
+    #define GR_GL_GPU_COUNT_CALL_IMPL(GPU)
+#endif
+
+#define GR_GL_GPU_CALL(GPU, X)                                  \
+    do {                                                        \
+        GR_GL_GPU_COUNT_CALL_IMPL(GPU);                         \
+        GR_GL_CALL((GPU)->glInterface(), X);                    \
+    } while (false)
+
+#define GR_GL_GPU_CALL_NOERRCHECK(GPU, X)                       \
+    do {                                                        \
+        GR_GL_GPU_COUNT_CALL_IMPL(GPU);                         \
+        GR_GL_CALL_NOERRCHECK((GPU)->glInterface(), X);         \
+    } while (false)
+
+#define GR_GL_GPU_CALL_RET(GPU, RET, X)                         \
+    do {                                                        \
+        GR_GL_GPU_COUNT_CALL_IMPL(GPU);                         \
+        GR_GL_CALL_RET((GPU)->glInterface(), RET, X);           \
+    } while (false)
+
 class GrGpuGL : public GrGpu {
 public:
     GrGpuGL(const GrGLContext& ctx, GrContext* context);
@@ -43,6 +69,10 @@ public:
     GrGLSLGeneration glslGeneration() const { return fGLContext.glslGeneration(); }
     const GrGLCaps& glCaps() const { return *fGLContext.caps(); }
 
+#if GR_GPU_STATS
+    void countGLCall() const { ++fGLCallCount; }
+#endif
+
     GrGLPathRendering* glPathRendering() {
         SkASSERT(glCaps().pathRenderingSupport());
         return static_cast<GrGLPathRendering*>(pathRendering());
@@ -342,7 +372,7 @@ private:
                 return;
             }
             if (!fBoundVertexArrayIDIsValid || arrayID != fBoundVertexArrayID) {
-                GR_GL_CALL(gpu->glInterface(), BindVertexArray(arrayID));
+                GR_GL_GPU_CALL(gpu, BindVertexArray(arrayID));
                 fBoundVertexArrayIDIsValid = true;
                 fBoundVertexArrayID = arrayID;
             }
@@ -370,7 +400,7 @@ private:
 
         void setVertexBufferID(GrGpuGL* gpu, GrGLuint id) {
             if (!fBoundVertexBufferIDIsValid || id != fBoundVertexBufferID) {
-                GR_GL_CALL(gpu->glInterface(), BindBuffer(GR_GL_ARRAY_BUFFER, id));
+                GR_GL_GPU_CALL(gpu, BindBuffer(GR_GL_ARRAY_BUFFER, id));
                 fBoundVertexBufferIDIsValid = true;
                 fBoundVertexBufferID = id;
             }
@@ -384,7 +414,7 @@ private:
             this->setVertexArrayID(gpu, 0);
             if (!fDefaultVertexArrayBoundIndexBufferIDIsValid ||
                 id != fDefaultVertexArrayBoundIndexBufferID) {
-                GR_GL_CALL(gpu->glInterface(), BindBuffer(GR_GL_ELEMENT_ARRAY_BUFFER, id));
+                GR_GL_GPU_CALL(gpu, BindBuffer(GR_GL_ELEMENT_ARRAY_BUFFER, id));
                 fDefaultVertexArrayBoundIndexBufferIDIsValid = true;
                 fDefaultVertexArrayBoundIndexBufferID = id;
             }
@@ -450,6 +480,11 @@ private:
     // from our loop that tries stencil formats and calls check fb status.
     int fLastSuccessfulStencilFmtIdx;
 
+#if GR_GPU_STATS
+    // Number of GL functions called through GR_GL_GPU_CALL. Read by GrContext::GPUStats.
+    mutable int fGLCallCount;
+#endif
+
     typedef GrGpu INHERITED;
     friend class GrGLPathRendering; // For accessing setTextureUnit.
 };
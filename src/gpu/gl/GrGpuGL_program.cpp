@@ -199,11 +199,12 @@ GrGLProgram* GrGpuGL::ProgramCache::getProgram(const GrOptDrawState& optState) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#define GL_CALL(X) GR_GL_CALL(this->glInterface(), X)
+#define GL_CALL(X) GR_GL_GPU_CALL(this, X)
 
 bool GrGpuGL::flushGraphicsState(const GrOptDrawState& optState) {
     // GrGpu::setupClipAndFlushState should have already checked this and bailed if not true.
     SkASSERT(optState.getRenderTarget());
+    fGPUStats.incStateFlushes();
 
     if (kStencilPath_DrawType == optState.drawType()) {
         const GrRenderTarget* rt = optState.getRenderTarget();
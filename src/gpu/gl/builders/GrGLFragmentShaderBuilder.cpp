@@ -10,8 +10,8 @@
 #include "GrGLProgramBuilder.h"
 #include "../GrGpuGL.h"
 
-#define GL_CALL(X) GR_GL_CALL(fProgramBuilder->gpu()->glInterface(), X)
-#define GL_CALL_RET(R, X) GR_GL_CALL_RET(fProgramBuilder->gpu()->glInterface(), R, X)
+#define GL_CALL(X) GR_GL_GPU_CALL(fProgramBuilder->gpu(), X)
+#define GL_CALL_RET(R, X) GR_GL_GPU_CALL_RET(fProgramBuilder->gpu(), R, X)
 
 const char* GrGLFragmentShaderBuilder::kDstCopyColorName = "_dstColor";
 static const char* declared_color_output_name() { return "fsColorOut"; }
@@ -18,8 +18,8 @@
 #include "SkRTConf.h"
 #include "SkTraceEvent.h"
 
-#define GL_CALL(X) GR_GL_CALL(this->gpu()->glInterface(), X)
-#define GL_CALL_RET(R, X) GR_GL_CALL_RET(this->gpu()->glInterface(), R, X)
+#define GL_CALL(X) GR_GL_GPU_CALL(this->gpu(), X)
+#define GL_CALL_RET(R, X) GR_GL_GPU_CALL_RET(this->gpu(), R, X)
 
 //////////////////////////////////////////////////////////////////////////////
 
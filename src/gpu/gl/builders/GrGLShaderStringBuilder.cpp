@@ -11,8 +11,8 @@
 #include "SkRTConf.h"
 #include "SkTraceEvent.h"
 
-#define GL_CALL(X) GR_GL_CALL(gpu->glInterface(), X)
-#define GL_CALL_RET(R, X) GR_GL_CALL_RET(gpu->glInterface(), R, X)
+#define GL_CALL(X) GR_GL_GPU_CALL(gpu, X)
+#define GL_CALL_RET(R, X) GR_GL_GPU_CALL_RET(gpu, R, X)
 
 SK_CONF_DECLARE(bool, c_PrintShaders, "gpu.printShaders", false,
                 "Print the source code for all shaders generated.");
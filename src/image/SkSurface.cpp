@@ -59,6 +59,7 @@ SkSurface_Base::SkSurface_Base(int width, int height, const SkSurfaceProps* prop
 {
     fCachedCanvas = NULL;
     fCachedImage = NULL;
+    fWantsDirtyBounds = false;
 }
 
 SkSurface_Base::SkSurface_Base(const SkImageInfo& info, const SkSurfaceProps* props)
@@ -66,6 +67,7 @@ SkSurface_Base::SkSurface_Base(const SkImageInfo& info, const SkSurfaceProps* pr
 {
     fCachedCanvas = NULL;
     fCachedImage = NULL;
+    fWantsDirtyBounds = false;
 }
 
 SkSurface_Base::~SkSurface_Base() {
@@ -86,7 +88,7 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y, const SkPa
     }
 }
 
-void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
+void SkSurface_Base::aboutToDraw(ContentChangeMode mode, const SkIRect* dirtyBounds) {
     this->dirtyGenerationID();
 
     SkASSERT(!fCachedCanvas || fCachedCanvas->getSurfaceBase() == this);
@@ -106,6 +108,11 @@ void SkSurface_Base::aboutToDraw(ContentChangeMode mode) {
     } else if (kDiscard_ContentChangeMode == mode) {
         this->onDiscard();
     }
+
+    if (fWantsDirtyBounds) {
+        this->onDirtyBounds(dirtyBounds ? *dirtyBounds : SkIRect::MakeWH(this->width(),
+                                                                          this->height()));
+    }
 }
 
 uint32_t SkSurface_Base::newGenerationID() {
@@ -60,17 +60,31 @@ public:
      */
     virtual void onCopyOnWrite(ContentChangeMode) = 0;
 
+    /**
+     *  Called before every change to the surface (after onCopyOnWrite(), if that was needed)
+     *  with a conservative bound of the pixels that may change. Only called for subclasses
+     *  that have called setWantsDirtyBounds(true).
+     */
+    virtual void onDirtyBounds(const SkIRect&) {}
+
+    bool wantsDirtyBounds() const { return fWantsDirtyBounds; }
+
     inline SkCanvas* getCachedCanvas();
     inline SkImage* getCachedImage();
 
     // called by SkSurface to compute a new genID
     uint32_t newGenerationID();
 
+protected:
+    void setWantsDirtyBounds(bool wants) { fWantsDirtyBounds = wants; }
+
 private:
     SkCanvas*   fCachedCanvas;
     SkImage*    fCachedImage;
+    bool        fWantsDirtyBounds;
 
-    void aboutToDraw(ContentChangeMode mode);
+    // dirtyBounds is in device space, or NULL if the whole surface may change
+    void aboutToDraw(ContentChangeMode mode, const SkIRect* dirtyBounds = NULL);
     friend class SkCanvas;
     friend class SkSurface;
 
@@ -13,6 +13,9 @@
 
 static const size_t kIgnoreRowBytesValue = (size_t)~0;
 
+// Dirty areas are tracked in tiles of (1 << kTileShift) pixels square.
+static const int kTileShift = 6;
+
 class SkSurface_Raster : public SkSurface_Base {
 public:
     static bool Valid(const SkImageInfo&, size_t rb = kIgnoreRowBytesValue);
@@ -28,11 +31,26 @@ public:
     virtual void onDraw(SkCanvas*, SkScalar x, SkScalar y,
                         const SkPaint*) SK_OVERRIDE;
     virtual void onCopyOnWrite(ContentChangeMode) SK_OVERRIDE;
+    virtual void onDirtyBounds(const SkIRect&) SK_OVERRIDE;
 
 private:
+    void markAllTiles(bool dirty);
+    void copyDirtyTiles(const SkBitmap& src, const SkBitmap& dst) const;
+
     SkBitmap    fBitmap;
     bool        fWeOwnThePixels;
 
+    // Once a snapshot has been forked off, we keep a ref on its pixels. When the snapshot goes
+    // away we draw into those pixels again the next time we fork, rather than allocating and
+    // copying a whole new buffer: only the tiles marked in fDirtyTiles (the ones we changed
+    // since the fork) have to be brought up to date. This suits taking a snapshot per frame.
+    // We don't want a second buffer around for the surface's whole life, so fSpare is dropped
+    // at the first draw after the snapshot has gone without a new one being taken.
+    SkAutoTUnref<SkPixelRef> fSpare;
+    SkAutoTMalloc<uint8_t>   fDirtyTiles;
+    int                      fTileCountX;
+    int                      fTileCountY;
+
     typedef SkSurface_Base INHERITED;
 };
 
@@ -85,6 +103,7 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, void* pixels, size_t
 {
     fBitmap.installPixels(info, pixels, rb, NULL, releaseProc, context);
     fWeOwnThePixels = false;    // We are "Direct"
+    fTileCountX = fTileCountY = 0;
 }
 
 SkSurface_Raster::SkSurface_Raster(SkPixelRef* pr, const SkSurfaceProps* props)
@@ -96,6 +115,10 @@ SkSurface_Raster::SkSurface_Raster(SkPixelRef* pr, const SkSurfaceProps* props)
     fBitmap.setPixelRef(pr);
     fWeOwnThePixels = true;
 
+    fTileCountX = (info.width() + (1 << kTileShift) - 1) >> kTileShift;
+    fTileCountY = (info.height() + (1 << kTileShift) - 1) >> kTileShift;
+    fDirtyTiles.reset(fTileCountX * fTileCountY);
+
     if (!info.isOpaque()) {
         fBitmap.eraseColor(SK_ColorTRANSPARENT);
     }
@@ -123,18 +146,107 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     SkASSERT(this->getCachedImage());
     if (SkBitmapImageGetPixelRef(this->getCachedImage()) == fBitmap.pixelRef()) {
         SkASSERT(fWeOwnThePixels);
-        if (kDiscard_ContentChangeMode == mode) {
+        SkASSERT(this->getCachedCanvas());
+        SkBaseDevice* device = this->getCachedCanvas()->getDevice();
+        if (device->fPixelsHandedOut) {
+            // Someone may have written to the pixels directly, so we can't trust fDirtyTiles.
+            this->markAllTiles(true);
+        }
+
+        SkBitmap prev(fBitmap);
+        if (fSpare.get() && fSpare->unique()) {
+            // The last snapshot we forked from is gone, so its pixels are ours again. They only
+            // differ from prev in the tiles we have drawn to since.
+            fBitmap.setPixelRef(fSpare.get());
+            fBitmap.notifyPixelsChanged();
+            if (kDiscard_ContentChangeMode == mode) {
+                this->markAllTiles(true);
+            } else {
+                this->copyDirtyTiles(prev, fBitmap);
+                this->markAllTiles(false);
+            }
+        } else if (kDiscard_ContentChangeMode == mode) {
             fBitmap.setPixelRef(NULL);
             fBitmap.allocPixels();
+            this->markAllTiles(true);
         } else {
-            SkBitmap prev(fBitmap);
             prev.deepCopyTo(&fBitmap);
+            this->markAllTiles(false);
         }
+        fSpare.reset(SkRef(prev.pixelRef()));
+        // from now on we need to know what we draw to
+        this->setWantsDirtyBounds(true);
+
         // Now fBitmap is a deep copy of itself (and therefore different from
         // what is being used by the image. Next we update the canvas to use
         // this as its backend, so we can't modify the image's pixels anymore.
-        SkASSERT(this->getCachedCanvas());
-        this->getCachedCanvas()->getDevice()->replaceBitmapBackendForRasterSurface(fBitmap);
+        device->replaceBitmapBackendForRasterSurface(fBitmap);
+        device->fPixelsHandedOut = false;
+    }
+}
+
+void SkSurface_Raster::onDirtyBounds(const SkIRect& bounds) {
+    SkASSERT(fSpare.get());
+    if (fSpare->unique()) {
+        // The snapshot is gone, and since we are drawing there is no newer one to fork from
+        // (aboutToDraw() has already dropped it), so there's no use for the spare.
+        fSpare.reset(NULL);
+        this->setWantsDirtyBounds(false);
+        return;
+    }
+
+    SkIRect r = bounds;
+    if (!r.intersect(0, 0, fBitmap.width(), fBitmap.height())) {
+        return;
+    }
+    const int left = r.fLeft >> kTileShift;
+    const int right = (r.fRight - 1) >> kTileShift;
+    for (int y = r.fTop >> kTileShift; y <= (r.fBottom - 1) >> kTileShift; ++y) {
+        memset(&fDirtyTiles[y * fTileCountX + left], 1, right - left + 1);
+    }
+}
+
+void SkSurface_Raster::markAllTiles(bool dirty) {
+    memset(fDirtyTiles.get(), dirty, fTileCountX * fTileCountY);
+}
+
+void SkSurface_Raster::copyDirtyTiles(const SkBitmap& src, const SkBitmap& dst) const {
+    SkASSERT(src.info() == dst.info());
+    SkASSERT(src.rowBytes() == dst.rowBytes());
+    SkAutoLockPixels srcLock(src), dstLock(dst);
+    if (NULL == src.getPixels() || NULL == dst.getPixels()) {
+        return;
+    }
+
+    const size_t rowBytes = src.rowBytes();
+    const int shift = src.shiftPerPixel();
+    for (int ty = 0; ty < fTileCountY; ++ty) {
+        const uint8_t* tiles = &fDirtyTiles[ty * fTileCountX];
+        const int top = ty << kTileShift;
+        const int bottom = SkTMin(top + (1 << kTileShift), src.height());
+        int tx = 0;
+        while (tx < fTileCountX) {
+            if (!tiles[tx]) {
+                ++tx;
+                continue;
+            }
+            // copy the whole run of dirty tiles at once
+            int end = tx + 1;
+            while (end < fTileCountX && tiles[end]) {
+                ++end;
+            }
+            const int left = tx << kTileShift;
+            const int right = SkTMin(end << kTileShift, src.width());
+            const size_t offset = top * rowBytes + (left << shift);
+            const char* srcRow = (const char*)src.getPixels() + offset;
+            char* dstRow = (char*)dst.getPixels() + offset;
+            for (int y = top; y < bottom; ++y) {
+                memcpy(dstRow, srcRow, (right - left) << shift);
+                srcRow += rowBytes;
+                dstRow += rowBytes;
+            }
+            tx = end;
+        }
     }
 }
 
@@ -17,6 +17,10 @@ enum SkMorphologyProcType {
     kErodeY_SkMorphologyProcType
 };
 
+// From this radius on, the procs use the van Herk/Gil-Werman algorithm, whose cost per pixel
+// doesn't depend on the radius, instead of scanning the whole window for each pixel.
+static const int kSkMorphologyVanHerkMinRadius = 4;
+
 SkMorphologyImageFilter::Proc SkMorphologyGetPlatformProc(SkMorphologyProcType type);
 
 #endif
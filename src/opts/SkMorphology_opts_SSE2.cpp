@@ -7,7 +7,9 @@
 
 #include <emmintrin.h>
 #include "SkColorPriv.h"
+#include "SkMorphology_opts.h"
 #include "SkMorphology_opts_SSE2.h"
+#include "SkTemplates.h"
 
 /* SSE2 version of dilateX, dilateY, erodeX, erodeY.
  * portable versions are in src/effects/SkMorphologyImageFilter.cpp.
@@ -21,10 +23,74 @@ enum MorphDirection {
     kX, kY
 };
 
+template<MorphType type>
+static inline SkPMColor morph_pick(SkPMColor a, SkPMColor b) {
+    __m128i va = _mm_cvtsi32_si128(a);
+    __m128i vb = _mm_cvtsi32_si128(b);
+    return _mm_cvtsi128_si32(type == kDilate ? _mm_max_epu8(va, vb) : _mm_min_epu8(va, vb));
+}
+
+/*  van Herk/Gil-Werman, for large radii: see the portable version in
+ *  src/effects/SkMorphologyImageFilter.cpp.
+ */
+template<MorphType type, MorphDirection direction>
+static void SkMorphVanHerk_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
+                                int width, int height, int srcStride, int dstStride)
+{
+    const int srcStrideX = direction == kX ? 1 : srcStride;
+    const int dstStrideX = direction == kX ? 1 : dstStride;
+    const int srcStrideY = direction == kX ? srcStride : 1;
+    const int dstStrideY = direction == kX ? dstStride : 1;
+    radius = SkMin32(radius, width - 1);
+    const int blockSize = 2 * radius + 1;
+    const int lastBlockStart = (width - 1) / blockSize * blockSize;
+
+    SkAutoTMalloc<SkPMColor> storage(2 * width);
+    SkPMColor* prefix = storage.get();
+    SkPMColor* suffix = prefix + width;
+    for (int y = 0; y < height; ++y) {
+        const SkPMColor* sptr = src + y * srcStrideY;
+        for (int x = 0, blockX = 0; x < width; ++x, ++blockX) {
+            SkPMColor p = sptr[x * srcStrideX];
+            if (blockX == blockSize) {
+                blockX = 0;
+            }
+            prefix[x] = blockX ? morph_pick<type>(prefix[x - 1], p) : p;
+        }
+        for (int x = width - 1, blockX = width - 1 - lastBlockStart; x >= 0; --x, --blockX) {
+            SkPMColor p = sptr[x * srcStrideX];
+            if (blockX < 0) {
+                blockX = blockSize - 1;
+            }
+            bool blockEnd = (x == width - 1) || (blockX == blockSize - 1);
+            suffix[x] = blockEnd ? p : morph_pick<type>(suffix[x + 1], p);
+        }
+
+        SkPMColor* dptr = dst + y * dstStrideY;
+        for (int x = 0; x < width; ++x) {
+            const int lower = x - radius;
+            const int upper = SkMin32(x + radius, width - 1);
+            if (lower <= 0) {
+                *dptr = prefix[upper];
+            } else if (lower >= lastBlockStart) {
+                *dptr = suffix[lower];
+            } else {
+                *dptr = morph_pick<type>(suffix[lower], prefix[upper]);
+            }
+            dptr += dstStrideX;
+        }
+    }
+}
+
 template<MorphType type, MorphDirection direction>
 static void SkMorph_SSE2(const SkPMColor* src, SkPMColor* dst, int radius,
                          int width, int height, int srcStride, int dstStride)
 {
+    if (radius >= kSkMorphologyVanHerkMinRadius) {
+        SkMorphVanHerk_SSE2<type, direction>(src, dst, radius, width, height,
+                                             srcStride, dstStride);
+        return;
+    }
     const int srcStrideX = direction == kX ? 1 : srcStride;
     const int dstStrideX = direction == kX ? 1 : dstStride;
     const int srcStrideY = direction == kX ? srcStride : 1;
@@ -14,6 +14,8 @@
 #include "SkPixelRef.h"
 #include "SkRRect.h"
 #include "SkRecord.h"
+#include "SkRecordDamage.h"
+#include "SkRegion.h"
 #include "SkShader.h"
 
 class PixelRefSet {
@@ -235,3 +237,47 @@ size_t SkPictureUtils::ApproximateBytesUsed(const SkPicture* pict) {
 
     return byteCount;
 }
+
+void SkPictureUtils::ComputeDamage(const SkPicture* oldPict, const SkPicture* newPict,
+                                   SkTDArray<SkRect>* damage) {
+    if (oldPict == newPict) {
+        return;
+    }
+    SkRecordComputeDamage(oldPict->cullRect(), *oldPict->fRecord,
+                          newPict->cullRect(), *newPict->fRecord, damage);
+}
+
+void SkPictureUtils::PlaybackDamage(const SkPicture* pict, const SkTDArray<SkRect>& damage,
+                                    SkCanvas* canvas) {
+    if (damage.isEmpty()) {
+        return;
+    }
+
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    if (ctm.hasPerspective()) {
+        // The damage can't be mapped to whole device pixels reliably, so redraw everything.
+        canvas->save();
+        canvas->clear(SK_ColorTRANSPARENT);
+        pict->playback(canvas);
+        canvas->restore();
+        return;
+    }
+
+    // Snap the damage out to whole device pixels, with a pixel to spare for antialiasing, so the
+    // clear and the redraw cover exactly the same pixels. Every playback visits each op the BBH
+    // finds in the clip's bounds, or all of them without a BBH, so the rects are replayed
+    // together under their union rather than one at a time.
+    SkRegion devDamage;
+    for (int i = 0; i < damage.count(); ++i) {
+        SkRect devRect;
+        ctm.mapRect(&devRect, damage[i]);
+        devRect.outset(SK_Scalar1, SK_Scalar1);
+        devDamage.op(devRect.roundOut(), SkRegion::kUnion_Op);
+    }
+
+    canvas->save();
+    canvas->clipRegion(devDamage);
+    canvas->clear(SK_ColorTRANSPARENT);
+    pict->playback(canvas);
+    canvas->restore();
+}
@@ -434,6 +434,128 @@ static void test_crbug_422693(skiatest::Reporter* reporter) {
     rc.op(path, rc.getBounds().size(), SkRegion::kIntersect_Op, true);
 }
 
+static bool same_mask(const SkAAClip& a, const SkAAClip& b) {
+    SkMask ma, mb;
+    a.copyToMask(&ma);
+    b.copyToMask(&mb);
+    SkAutoMaskFreeImage aCleanUp(ma.fImage);
+    SkAutoMaskFreeImage bCleanUp(mb.fImage);
+    return ma == mb;
+}
+
+static void make_rand_aaclip(SkAAClip* clip, SkRandom& rand) {
+    SkPath path;
+    for (int i = 0; i < 3; ++i) {
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(0, 60), rand.nextRangeScalar(0, 60),
+                                    rand.nextRangeScalar(1, 40), rand.nextRangeScalar(1, 40));
+        if (rand.nextBool()) {
+            path.addOval(r);
+        } else {
+            path.addRoundRect(r, 4, 4);
+        }
+    }
+    path.setFillType(rand.nextBool() ? SkPath::kEvenOdd_FillType : SkPath::kWinding_FillType);
+    clip->setPath(path);
+}
+
+// Intersecting with a rect crops the runs in place; check that against the
+// general op(), both when the runs are ours and when they are shared.
+static void test_rect_crop(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 1000; ++i) {
+        SkAAClip clip;
+        make_rand_aaclip(&clip, rand);
+        SkIRect r;
+        rand_irect(&r, 50, rand);
+        r.offset(30, 30);
+
+        SkAAClip rectClip, expected;
+        rectClip.setRect(r);
+        expected.op(clip, rectClip, SkRegion::kIntersect_Op);
+
+        SkMask before;
+        clip.copyToMask(&before);
+        SkAutoMaskFreeImage beforeCleanUp(before.fImage);
+
+        SkAAClip cropped(clip);
+        cropped.op(r, SkRegion::kIntersect_Op);
+        REPORTER_ASSERT(reporter, cropped.getBounds() == expected.getBounds());
+        REPORTER_ASSERT(reporter, same_mask(cropped, expected));
+
+        SkMask after;
+        clip.copyToMask(&after);
+        SkAutoMaskFreeImage afterCleanUp(after.fImage);
+        REPORTER_ASSERT(reporter, before == after);
+
+        // now with the runs no longer shared
+        cropped.setEmpty();
+        clip.op(SkRect::Make(r), SkRegion::kIntersect_Op, true);
+        REPORTER_ASSERT(reporter, clip.getBounds() == expected.getBounds());
+        REPORTER_ASSERT(reporter, same_mask(clip, expected));
+    }
+}
+
+#include "SkAAClipCache.h"
+
+static void test_cached_setpath(skiatest::Reporter* reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkRandom rand;
+    for (int i = 0; i < 200; ++i) {
+        SkPath path;
+        path.addRoundRect(SkRect::MakeXYWH(rand.nextRangeScalar(0, 60),
+                                           rand.nextRangeScalar(0, 60),
+                                           rand.nextRangeScalar(1, 40),
+                                           rand.nextRangeScalar(1, 40)), 5, 5);
+        if (rand.nextBool()) {
+            path.toggleInverseFillType();
+        }
+        SkIRect ir;
+        rand_irect(&ir, 50, rand);
+        ir.offset(30, 30);
+        if (rand.nextBool()) {
+            ir.set(0, 0, 100, 100);
+        }
+        SkRegion rgn(ir);
+        bool doAA = rand.nextBool();
+
+        SkAAClip expected;
+        expected.setPath(path, &rgn, doAA);
+        // volatile paths are never cached
+        SkPath volatilePath(path);
+        volatilePath.setIsVolatile(true);
+        const size_t bytesUsed = cache.getTotalBytesUsed();
+        for (int j = 0; j < 2; ++j) {
+            SkAAClip clip;
+            SkAAClipCache::SetPath(&clip, volatilePath, rgn, doAA, &cache);
+            REPORTER_ASSERT(reporter, same_mask(clip, expected));
+        }
+        REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == bytesUsed);
+
+        for (int j = 0; j < 3; ++j) {
+            // the first two calls scan convert, and only the second adds the result to the
+            // cache, which serves the third
+            SkAAClip clip;
+            SkAAClipCache::SetPath(&clip, path, rgn, doAA, &cache);
+            REPORTER_ASSERT(reporter, clip.getBounds() == expected.getBounds());
+            REPORTER_ASSERT(reporter, same_mask(clip, expected));
+            if (0 == j) {
+                REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == bytesUsed);
+            }
+
+            // editing our copy must not disturb the cached one
+            clip.op(SkIRect::MakeXYWH(40, 40, 10, 10), SkRegion::kIntersect_Op);
+        }
+
+        // a different path object with the same contents finds the same entry
+        SkPath copy;
+        copy.addPath(path);
+        copy.setFillType(path.getFillType());
+        SkAAClip clip;
+        SkAAClipCache::SetPath(&clip, copy, rgn, doAA, &cache);
+        REPORTER_ASSERT(reporter, same_mask(clip, expected));
+    }
+}
+
 DEF_TEST(AAClip, reporter) {
     test_empty(reporter);
     test_path_bounds(reporter);
@@ -444,4 +566,6 @@ DEF_TEST(AAClip, reporter) {
     test_nearly_integral(reporter);
     test_really_a_rect(reporter);
     test_crbug_422693(reporter);
+    test_rect_crop(reporter);
+    test_cached_setpath(reporter);
 }
@@ -7,12 +7,15 @@
 
 #include "SkBlurMask.h"
 #include "SkBlurMaskFilter.h"
+#include "SkBlitter.h"
 #include "SkBlurDrawLooper.h"
 #include "SkLayerDrawLooper.h"
+#include "SkMaskCache.h"
 #include "SkEmbossMaskFilter.h"
 #include "SkCanvas.h"
 #include "SkMath.h"
 #include "SkPaint.h"
+#include "SkRasterClip.h"
 #include "Test.h"
 
 #if SK_SUPPORT_GPU
@@ -564,6 +567,156 @@ static void test_asABlur(skiatest::Reporter* reporter) {
     }
 }
 
+static void draw_blurred_path(SkBitmap* bitmap, const SkPath& path, SkScalar dx, SkScalar dy,
+                              const SkRect& clip) {
+    bitmap->allocN32Pixels(100, 100);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bitmap);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 3))->unref();
+    canvas.clipRect(clip);
+    canvas.translate(dx, dy);
+    canvas.drawPath(path, paint);
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    return a.getSize() == b.getSize() && 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+// Blurred masks of persistent paths are cached; draws that hit the cache, including at other
+// integer offsets and under other clips, must match drawing the path uncached.
+DEF_TEST(BlurPathMaskCache, reporter) {
+    SkPath path;
+    path.moveTo(20, 0);
+    path.lineTo(26, 14);
+    path.lineTo(40, 14);
+    path.lineTo(29, 24);
+    path.lineTo(33, 40);
+    path.lineTo(20, 30);
+    path.lineTo(7, 40);
+    path.lineTo(11, 24);
+    path.lineTo(0, 14);
+    path.lineTo(14, 14);
+    path.close();
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+
+    const SkRect fullClip = SkRect::MakeWH(100, 100);
+    const SkRect partialClip = SkRect::MakeXYWH(30, 20, 30, 50);
+    const SkPoint offsets[] = {
+        { 10.25f, 7 }, { 40.25f, 30 }, { 40.25f, 30 }, { 20, 5.5f },
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(offsets); ++i) {
+        for (int c = 0; c < 2; ++c) {
+            const SkRect& clip = c ? partialClip : fullClip;
+            SkMaskCache::PathStats before = SkMaskCache::GetPathStats();
+            SkBitmap cached, uncached;
+            draw_blurred_path(&cached, path, offsets[i].fX, offsets[i].fY, clip);
+            SkMaskCache::PathStats after = SkMaskCache::GetPathStats();
+            draw_blurred_path(&uncached, volatilePath, offsets[i].fX, offsets[i].fY, clip);
+            REPORTER_ASSERT(reporter, same_pixels(cached, uncached));
+
+            // Other tests may purge the cache concurrently, so only check that it was consulted.
+            REPORTER_ASSERT(reporter, after.fHits + after.fMisses > before.fHits + before.fMisses);
+        }
+    }
+}
+
+// Records the coverage it is asked to blit into an A8 bitmap.
+class CoverageBlitter : public SkBlitter {
+public:
+    CoverageBlitter(SkBitmap* coverage) : fCoverage(coverage) {}
+
+    virtual void blitH(int x, int y, int width) SK_OVERRIDE {
+        memset(fCoverage->getAddr8(x, y), 0xFF, width);
+    }
+    virtual void blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) SK_OVERRIDE {
+        for (int n = runs[0]; n > 0; n = runs[0]) {
+            memset(fCoverage->getAddr8(x, y), aa[0], n);
+            x += n;
+            aa += n;
+            runs += n;
+        }
+    }
+    virtual void blitV(int x, int y, int height, SkAlpha alpha) SK_OVERRIDE {
+        for (int i = 0; i < height; ++i) {
+            *fCoverage->getAddr8(x, y + i) = alpha;
+        }
+    }
+    virtual void blitRect(int x, int y, int width, int height) SK_OVERRIDE {
+        for (int i = 0; i < height; ++i) {
+            this->blitH(x, y + i, width);
+        }
+    }
+    virtual void blitMask(const SkMask& mask, const SkIRect& clip) SK_OVERRIDE {
+        SkASSERT(SkMask::kA8_Format == mask.fFormat);
+        for (int y = clip.fTop; y < clip.fBottom; ++y) {
+            memcpy(fCoverage->getAddr8(clip.fLeft, y), mask.getAddr8(clip.fLeft, y),
+                   clip.width());
+        }
+    }
+
+private:
+    SkBitmap* fCoverage;
+};
+
+static void alloc_coverage(SkBitmap* coverage) {
+    coverage->allocPixels(SkImageInfo::MakeA8(160, 160));
+    coverage->eraseColor(SK_ColorTRANSPARENT);
+}
+
+// Largest difference between the coverage and the mask clipped to clip.
+static int max_coverage_diff(const SkBitmap& coverage, const SkMask& mask, const SkIRect& clip) {
+    SkAutoLockPixels alp(coverage);
+    int maxDiff = 0;
+    for (int y = 0; y < coverage.height(); ++y) {
+        for (int x = 0; x < coverage.width(); ++x) {
+            int expected = mask.fBounds.contains(x, y) && clip.contains(x, y) ?
+                           *mask.getAddr8(x, y) : 0;
+            maxDiff = SkTMax(maxDiff, SkAbs32(*coverage.getAddr8(x, y) - expected));
+        }
+    }
+    return maxDiff;
+}
+
+// Blitting an analytic rect blur directly must give exactly the coverage of its mask, under
+// any clip.
+DEF_TEST(BlurRectBlitter, reporter) {
+    const SkRect rects[] = {
+        SkRect::MakeXYWH(40, 40, 80, 60),
+        SkRect::MakeXYWH(50.5f, 45.25f, 20.3f, 70.7f),
+        SkRect::MakeXYWH(70, 70, 4, 3),
+    };
+    const SkScalar sigmas[] = { 0.75f, 3, 9.5f };
+    const SkIRect clips[] = {
+        SkIRect::MakeWH(160, 160),
+        SkIRect::MakeXYWH(30, 55, 50, 20),
+        SkIRect::MakeXYWH(60, 20, 10, 100),
+    };
+    for (size_t r = 0; r < SK_ARRAY_COUNT(rects); ++r) {
+        for (size_t s = 0; s < SK_ARRAY_COUNT(sigmas); ++s) {
+            SkMask mask;
+            REPORTER_ASSERT(reporter, SkBlurMask::BlurRect(sigmas[s], &mask, rects[r],
+                                                           kNormal_SkBlurStyle));
+            SkAutoMaskFreeImage amfi(mask.fImage);
+
+            for (size_t c = 0; c < SK_ARRAY_COUNT(clips); ++c) {
+                SkBitmap coverage;
+                alloc_coverage(&coverage);
+                CoverageBlitter blitter(&coverage);
+                SkRasterClip rc(clips[c]);
+                REPORTER_ASSERT(reporter, SkBlurMask::BlitRect(sigmas[s], rects[r],
+                                                               kNormal_SkBlurStyle, rc,
+                                                               &blitter));
+                REPORTER_ASSERT(reporter, 0 == max_coverage_diff(coverage, mask, clips[c]));
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 DEF_GPUTEST(Blur, reporter, factory) {
@@ -47,6 +47,7 @@
 #include "SkCanvas.h"
 #include "SkDeferredCanvas.h"
 #include "SkDevice.h"
+#include "SkDrawFilter.h"
 #include "SkMatrix.h"
 #include "SkNWayCanvas.h"
 #include "SkPDFDevice.h"
@@ -813,3 +814,103 @@ DEF_TEST(Canvas_SaveState, reporter) {
     canvas.restore();
     REPORTER_ASSERT(reporter, 1 == canvas.getSaveCount());
 }
+
+namespace {
+
+class SaveCountingCanvas : public SkCanvas {
+public:
+    SaveCountingCanvas() : INHERITED(10, 10), fSaves(0), fRestores(0) {}
+
+    int fSaves;
+    int fRestores;
+
+protected:
+    virtual void willSave() SK_OVERRIDE {
+        fSaves += 1;
+        this->INHERITED::willSave();
+    }
+    virtual SaveLayerStrategy willSaveLayer(const SkRect* bounds, const SkPaint* paint,
+                                            SaveFlags flags) SK_OVERRIDE {
+        fSaves += 1;
+        return this->INHERITED::willSaveLayer(bounds, paint, flags);
+    }
+    virtual void willRestore() SK_OVERRIDE {
+        fRestores += 1;
+        this->INHERITED::willRestore();
+    }
+
+private:
+    typedef SkCanvas INHERITED;
+};
+
+class NopDrawFilter : public SkDrawFilter {
+public:
+    virtual bool filter(SkPaint*, Type) SK_OVERRIDE { return true; }
+};
+
+}  // namespace
+
+// save() defers copying the matrix/clip state until it changes, but that must
+// not be visible to subclasses or to the state queries.
+DEF_TEST(Canvas_DeferredSave, reporter) {
+    SaveCountingCanvas canvas;
+    const SkMatrix identity = SkMatrix::I();
+    SkIRect clip;
+
+    // Saves that are never followed by a change are still reported.
+    REPORTER_ASSERT(reporter, 1 == canvas.save());
+    REPORTER_ASSERT(reporter, 2 == canvas.save());
+    REPORTER_ASSERT(reporter, 3 == canvas.getSaveCount());
+    REPORTER_ASSERT(reporter, 2 == canvas.fSaves);
+    canvas.restore();
+    canvas.restore();
+    REPORTER_ASSERT(reporter, 1 == canvas.getSaveCount());
+    REPORTER_ASSERT(reporter, 2 == canvas.fRestores);
+
+    // Changes after nested saves only affect the innermost one.
+    canvas.save();
+    canvas.save();
+    canvas.translate(5, 5);
+    canvas.clipRect(SkRect::MakeWH(7, 7));
+    REPORTER_ASSERT(reporter, canvas.getClipDeviceBounds(&clip) &&
+                              clip == SkIRect::MakeLTRB(5, 5, 10, 10));
+    canvas.restore();
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix() == identity);
+    REPORTER_ASSERT(reporter, canvas.getClipDeviceBounds(&clip) &&
+                              clip == SkIRect::MakeWH(10, 10));
+    canvas.restore();
+    REPORTER_ASSERT(reporter, 1 == canvas.getSaveCount());
+
+    // A deferred save below a layer is still restored in order.
+    canvas.save();
+    REPORTER_ASSERT(reporter, 2 == canvas.saveLayer(NULL, NULL));
+    canvas.scale(2, 2);
+    REPORTER_ASSERT(reporter, 3 == canvas.save());
+    canvas.clipRect(SkRect::MakeWH(1, 1));
+    REPORTER_ASSERT(reporter, 4 == canvas.getSaveCount());
+    canvas.restoreToCount(2);
+    REPORTER_ASSERT(reporter, 2 == canvas.getSaveCount());
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix() == identity);
+    REPORTER_ASSERT(reporter, !canvas.isDrawingToLayer());
+    canvas.restore();
+    REPORTER_ASSERT(reporter, 1 == canvas.getSaveCount());
+
+    // setDrawFilter() and setMatrix() are scoped to their save() as well.
+    SkAutoTUnref<NopDrawFilter> filter(SkNEW(NopDrawFilter));
+    canvas.save();
+    canvas.setDrawFilter(filter);
+    canvas.save();
+    SkMatrix scale;
+    scale.setScale(3, 3);
+    canvas.setMatrix(scale);
+    canvas.restore();
+    REPORTER_ASSERT(reporter, canvas.getTotalMatrix() == identity);
+    REPORTER_ASSERT(reporter, canvas.getDrawFilter() == filter.get());
+    canvas.restore();
+    REPORTER_ASSERT(reporter, NULL == canvas.getDrawFilter());
+
+    // Restoring past the bottom is still ignored.
+    canvas.restore();
+    REPORTER_ASSERT(reporter, 1 == canvas.getSaveCount());
+    REPORTER_ASSERT(reporter, canvas.fSaves == canvas.fRestores);
+}
@@ -214,6 +214,65 @@ static void test_cache(skiatest::Reporter* reporter, GrContext* context) {
 #endif
 }
 
+// check that a few masks are kept, and the least recently used one is dropped for a new one
+static void test_cache_lru(skiatest::Reporter* reporter, GrContext* context) {
+    GrClipMaskCache cache;
+
+    cache.setContext(context);
+
+    GrSurfaceDesc desc;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    desc.fWidth = X_SIZE;
+    desc.fHeight = Y_SIZE;
+    desc.fConfig = kSkia8888_GrPixelConfig;
+
+    static const int kClipCount = 5;
+    SkIRect bound = SkIRect::MakeWH(X_SIZE, Y_SIZE);
+    SkClipStack clips[kClipCount];
+    GrTexture* textures[kClipCount];
+    for (int i = 0; i < kClipCount - 1; ++i) {
+        clips[i].clipDevRect(SkRect::MakeWH(SkIntToScalar(i + 1), SkIntToScalar(i + 1)),
+                             SkRegion::kReplace_Op, true);
+        cache.acquireMask(clips[i].getTopmostGenID(), desc, bound);
+        textures[i] = cache.getLastMask();
+        REPORTER_ASSERT(reporter, textures[i]);
+        if (NULL == textures[i]) {
+            return;
+        }
+    }
+
+    // all of them can be reused, which makes the reused one the last mask
+    for (int i = 0; i < kClipCount - 1; ++i) {
+        REPORTER_ASSERT(reporter, cache.canReuse(clips[i].getTopmostGenID(), bound));
+        check_state(reporter, cache, clips[i], textures[i], bound);
+    }
+    REPORTER_ASSERT(reporter, !cache.canReuse(clips[0].getTopmostGenID(),
+                                              SkIRect::MakeWH(X_SIZE, Y_SIZE - 1)));
+
+    // reusing the second clip leaves the first as the least recently used, so it is dropped
+    REPORTER_ASSERT(reporter, cache.canReuse(clips[1].getTopmostGenID(), bound));
+    clips[kClipCount - 1].clipDevRect(SkRect::MakeWH(1, 2), SkRegion::kReplace_Op, true);
+    cache.acquireMask(clips[kClipCount - 1].getTopmostGenID(), desc, bound);
+    textures[kClipCount - 1] = cache.getLastMask();
+    check_state(reporter, cache, clips[kClipCount - 1], textures[kClipCount - 1], bound);
+    REPORTER_ASSERT(reporter, !cache.canReuse(clips[0].getTopmostGenID(), bound));
+    for (int i = 1; i < kClipCount; ++i) {
+        REPORTER_ASSERT(reporter, cache.canReuse(clips[i].getTopmostGenID(), bound));
+    }
+
+    // at the end of a flush only the last mask is kept
+    cache.purgeExtraMasks();
+    check_state(reporter, cache, clips[kClipCount - 1], textures[kClipCount - 1], bound);
+    for (int i = 0; i < kClipCount - 1; ++i) {
+        REPORTER_ASSERT(reporter, !cache.canReuse(clips[i].getTopmostGenID(), bound));
+    }
+    REPORTER_ASSERT(reporter, cache.canReuse(clips[kClipCount - 1].getTopmostGenID(), bound));
+
+    cache.reset();
+    check_empty_state(reporter, cache);
+    REPORTER_ASSERT(reporter, !cache.canReuse(clips[1].getTopmostGenID(), bound));
+}
+
 DEF_GPUTEST(ClipCache, reporter, factory) {
     for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
         GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
@@ -226,6 +285,7 @@ DEF_GPUTEST(ClipCache, reporter, factory) {
         }
 
         test_cache(reporter, context);
+        test_cache_lru(reporter, context);
         test_clip_bounds(reporter, context);
     }
 }
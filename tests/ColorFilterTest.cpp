@@ -125,3 +125,173 @@ DEF_TEST(LumaColorFilter, reporter) {
         REPORTER_ASSERT(reporter, SkGetPackedB32(out) == 0);
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SkColorMatrixFilter.h"
+#include "SkTableColorFilter.h"
+
+static void test_compose_matches_chain(skiatest::Reporter* reporter, SkColorFilter* outer,
+                                       SkColorFilter* inner, SkColorFilter* composed,
+                                       int tolerance) {
+    SkRandom rand;
+    for (int i = 0; i < 256; ++i) {
+        SkPMColor src = SkPreMultiplyColor(rand.nextU());
+        SkPMColor chained, fused;
+        inner->filterSpan(&src, 1, &chained);
+        outer->filterSpan(&chained, 1, &chained);
+        composed->filterSpan(&src, 1, &fused);
+        REPORTER_ASSERT(reporter,
+            SkTAbs((int)SkGetPackedA32(chained) - (int)SkGetPackedA32(fused)) <= tolerance &&
+            SkTAbs((int)SkGetPackedR32(chained) - (int)SkGetPackedR32(fused)) <= tolerance &&
+            SkTAbs((int)SkGetPackedG32(chained) - (int)SkGetPackedG32(fused)) <= tolerance &&
+            SkTAbs((int)SkGetPackedB32(chained) - (int)SkGetPackedB32(fused)) <= tolerance);
+    }
+}
+
+DEF_TEST(ComposeColorFilter, reporter) {
+    // NULL filters compose to the other filter.
+    SkAutoTUnref<SkColorFilter> luma(SkLumaColorFilter::Create());
+    SkAutoTUnref<SkColorFilter> same(SkColorFilter::CreateComposeFilter(luma, NULL));
+    REPORTER_ASSERT(reporter, same.get() == luma.get());
+
+    // Two non-clamping matrices concatenate into a single matrix filter.
+    SkColorMatrix gray;
+    gray.setSaturation(0);
+    SkAutoTUnref<SkColorFilter> grayCF(SkColorMatrixFilter::Create(gray));
+    SkAutoTUnref<SkColorFilter> dim(SkColorFilter::CreateLightingFilter(0xFF808080, 0));
+    SkAutoTUnref<SkColorFilter> fusedMatrix(SkColorFilter::CreateComposeFilter(grayCF, dim));
+    REPORTER_ASSERT(reporter, fusedMatrix->asColorMatrix(NULL));
+    test_compose_matches_chain(reporter, grayCF, dim, fusedMatrix, 2);
+
+    // Two tables compose into a single table.
+    uint8_t invert[256], posterize[256];
+    for (int i = 0; i < 256; ++i) {
+        invert[i] = 255 - i;
+        posterize[i] = i & 0xC0;
+    }
+    SkAutoTUnref<SkColorFilter> invertCF(SkTableColorFilter::CreateARGB(NULL, invert,
+                                                                         invert, invert));
+    SkAutoTUnref<SkColorFilter> posterizeCF(SkTableColorFilter::CreateARGB(NULL, posterize,
+                                                                            posterize, posterize));
+    SkAutoTUnref<SkColorFilter> fusedTable(
+        SkColorFilter::CreateComposeFilter(invertCF, posterizeCF));
+    REPORTER_ASSERT(reporter, fusedTable->asComponentTable(NULL));
+    test_compose_matches_chain(reporter, invertCF, posterizeCF, fusedTable, 2);
+
+    // An inner table that changes alpha can't be folded: the premultiply in between the two
+    // passes zeroes the color that the outer table would see.
+    uint8_t opaque[256];
+    memset(opaque, 0xFF, sizeof(opaque));
+    SkAutoTUnref<SkColorFilter> opaqueCF(SkTableColorFilter::CreateARGB(opaque, invert,
+                                                                         invert, invert));
+    SkAutoTUnref<SkColorFilter> posterizeAllCF(SkTableColorFilter::Create(posterize));
+    SkAutoTUnref<SkColorFilter> alphaChain(
+        SkColorFilter::CreateComposeFilter(opaqueCF, posterizeAllCF));
+    REPORTER_ASSERT(reporter, !alphaChain->asComponentTable(NULL));
+    test_compose_matches_chain(reporter, opaqueCF, posterizeAllCF, alphaChain, 0);
+
+    // Anything that can't be folded is applied as a chain, and survives serialization.
+    SkAutoTUnref<SkColorFilter> chain(SkColorFilter::CreateComposeFilter(luma, dim));
+    REPORTER_ASSERT(reporter, !chain->asColorMatrix(NULL));
+    test_compose_matches_chain(reporter, luma, dim, chain, 0);
+
+    SkAutoTUnref<SkColorFilter> chain2(reincarnate_colorfilter(chain));
+    REPORTER_ASSERT(reporter, chain2);
+    test_compose_matches_chain(reporter, luma, dim, chain2, 0);
+}
+
+static SkPMColor color_matrix_reference(const SkScalar m[20], SkPMColor c) {
+    float a = SkGetPackedA32(c);
+    float scale = a ? 255 / a : 0;
+    float in[4] = { SkGetPackedR32(c) * scale,
+                    SkGetPackedG32(c) * scale,
+                    SkGetPackedB32(c) * scale,
+                    a };
+    float out[4];
+    for (int j = 0; j < 4; ++j) {
+        const SkScalar* row = &m[j * 5];
+        float v = row[0] * in[0] + row[1] * in[1] + row[2] * in[2] + row[3] * in[3] + row[4];
+        out[j] = SkTMin(SkTMax(v, 0.0f), 255.0f);
+    }
+    float premul = out[3] / 255;
+    return SkPackARGB32((int)(out[3] + 0.5f), (int)(out[0] * premul + 0.5f),
+                        (int)(out[1] * premul + 0.5f), (int)(out[2] * premul + 0.5f));
+}
+
+DEF_TEST(ColorMatrixFilterSpan, reporter) {
+    SkColorMatrix gray, sepia, alpha, readsAlpha;
+    gray.setSaturation(0);
+    sepia.setSaturation(0);
+    sepia.postTranslate(40, 20, -20, 0);
+    alpha.setScale(1, 1, 1, 0.5f);
+    alpha.postTranslate(0, 0, 0, 10);
+    // Leaves alpha alone, but mixes it into r, g and b.
+    readsAlpha.setScale(0.5f, 0.75f, 0.25f, 1);
+    readsAlpha.fMat[3] = 0.25f;
+    readsAlpha.fMat[8] = -0.5f;
+    readsAlpha.fMat[13] = 0.5f;
+    const SkColorMatrix* matrices[] = { &gray, &sepia, &alpha, &readsAlpha };
+
+    SkRandom rand;
+    SkPMColor src[100], dst[100];
+    for (size_t m = 0; m < SK_ARRAY_COUNT(matrices); ++m) {
+        SkAutoTUnref<SkColorFilter> cf(SkColorMatrixFilter::Create(*matrices[m]));
+        for (int opaque = 0; opaque <= 1; ++opaque) {
+            for (int i = 0; i < 100; ++i) {
+                SkColor c = rand.nextU();
+                src[i] = SkPreMultiplyColor(opaque ? SkColorSetA(c, 0xFF) : c);
+            }
+            cf->filterSpan(src, 100, dst);
+            for (int i = 0; i < 100; ++i) {
+                SkPMColor expected = color_matrix_reference(matrices[m]->fMat, src[i]);
+                REPORTER_ASSERT(reporter, dst[i] == expected);
+            }
+        }
+    }
+}
+
+#include "SkColorCubeFilter.h"
+#include "SkUnPreMultiply.h"
+
+DEF_TEST(ColorCubeFilter, reporter) {
+    // A cube that maps each color to its inverse.
+    const int dim = 8;
+    SkAutoDataUnref cubeData(SkData::NewUninitialized(sizeof(SkColor) * dim * dim * dim));
+    SkColor* cube = (SkColor*)cubeData->writable_data();
+    for (int b = 0; b < dim; ++b) {
+        for (int g = 0; g < dim; ++g) {
+            for (int r = 0; r < dim; ++r) {
+                cube[(b * dim + g) * dim + r] = SkColorSetARGB(0xFF,
+                    255 - r * 255 / (dim - 1), 255 - g * 255 / (dim - 1), 255 - b * 255 / (dim - 1));
+            }
+        }
+    }
+    SkAutoTUnref<SkColorFilter> cf(SkColorCubeFilter::Create(cubeData, dim));
+    REPORTER_ASSERT(reporter, cf);
+    // A second filter of the same size shares the index tables with the first.
+    SkAutoTUnref<SkColorFilter> cf2(SkColorCubeFilter::Create(cubeData, dim));
+
+    SkRandom rand;
+    SkPMColor src[64], dst[64], dst2[64];
+    for (int i = 0; i < 64; ++i) {
+        SkColor c = rand.nextU();
+        src[i] = SkPreMultiplyColor(i & 1 ? SkColorSetA(c, 0xFF) : c);
+    }
+    cf->filterSpan(src, 64, dst);
+    cf2->filterSpan(src, 64, dst2);
+    REPORTER_ASSERT(reporter, !memcmp(dst, dst2, sizeof(dst)));
+
+    for (int i = 0; i < 64; ++i) {
+        SkColor in = SkUnPreMultiply::PMColorToColor(src[i]);
+        unsigned a = SkColorGetA(in);
+        REPORTER_ASSERT(reporter, SkGetPackedA32(dst[i]) == a);
+        // The cube is linear, so interpolating it gives back the exact inverse.
+        int r = SkScalarRoundToInt((255 - SkColorGetR(in)) * a / 255.0f);
+        int g = SkScalarRoundToInt((255 - SkColorGetG(in)) * a / 255.0f);
+        int b = SkScalarRoundToInt((255 - SkColorGetB(in)) * a / 255.0f);
+        REPORTER_ASSERT(reporter, SkTAbs(r - (int)SkGetPackedR32(dst[i])) <= 1);
+        REPORTER_ASSERT(reporter, SkTAbs(g - (int)SkGetPackedG32(dst[i])) <= 1);
+        REPORTER_ASSERT(reporter, SkTAbs(b - (int)SkGetPackedB32(dst[i])) <= 1);
+    }
+}
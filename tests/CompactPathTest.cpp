@@ -0,0 +1,137 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCompactPath.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// Walk both iterators in lock step; they must agree on every verb, point and weight.
+static void check_iter(skiatest::Reporter* reporter, const SkPath& path,
+                       const SkCompactPath& compact) {
+    SkPath::RawIter iter(path);
+    SkCompactPath::RawIter citer(compact);
+    SkPoint pts[4], cpts[4];
+    SkPath::Verb verb;
+    do {
+        verb = iter.next(pts);
+        REPORTER_ASSERT(reporter, citer.next(cpts) == verb);
+        int count = 0;
+        switch (verb) {
+            case SkPath::kMove_Verb:  count = 1; break;
+            case SkPath::kLine_Verb:  count = 2; break;
+            case SkPath::kQuad_Verb:  count = 3; break;
+            case SkPath::kConic_Verb:
+                count = 3;
+                REPORTER_ASSERT(reporter, citer.conicWeight() == iter.conicWeight());
+                break;
+            case SkPath::kCubic_Verb: count = 4; break;
+            case SkPath::kClose_Verb: count = 1; break;
+            default: break;
+        }
+        for (int i = 0; i < count; ++i) {
+            REPORTER_ASSERT(reporter, cpts[i] == pts[i]);
+        }
+    } while (verb != SkPath::kDone_Verb);
+}
+
+static void check_round_trip(skiatest::Reporter* reporter, const SkPath& path) {
+    SkAutoTUnref<SkCompactPath> compact(SkCompactPath::Create(path));
+    REPORTER_ASSERT(reporter, compact.get());
+    if (!compact.get()) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, compact->countPoints() == path.countPoints());
+    REPORTER_ASSERT(reporter, compact->countVerbs() == path.countVerbs());
+    REPORTER_ASSERT(reporter, compact->getBounds() == path.getBounds());
+    REPORTER_ASSERT(reporter, compact->getSegmentMasks() == path.getSegmentMasks());
+    check_iter(reporter, path, *compact);
+
+    SkPath decoded;
+    compact->toPath(&decoded);
+    REPORTER_ASSERT(reporter, decoded == path);
+}
+
+// Paths on a tile-local grid, such as 1/8th of a pixel across a 4096 tile.
+static void test_grid_paths(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 100; ++i) {
+        SkPath path;
+        path.setFillType(rand.nextBool() ? SkPath::kEvenOdd_FillType
+                                         : SkPath::kWinding_FillType);
+        for (int contour = 0; contour < 3; ++contour) {
+            SkPoint pts[3];
+            for (int j = 0; j < 3; ++j) {
+                pts[j].set((rand.nextU() % 32768) / 8.0f, (rand.nextU() % 32768) / 8.0f);
+            }
+            path.moveTo(pts[0]);
+            switch (rand.nextU() % 4) {
+                case 0: path.lineTo(pts[1]); break;
+                case 1: path.quadTo(pts[1], pts[2]); break;
+                case 2: path.conicTo(pts[1], pts[2], 0.5f); break;
+                case 3: path.cubicTo(pts[1], pts[2], pts[0]); break;
+            }
+            if (rand.nextBool()) {
+                path.close();
+            }
+        }
+        check_round_trip(reporter, path);
+    }
+
+    // negative and fractional coordinates, with an offset far from the origin
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(-1000.25f, 5000, -900.5f, 5100.75f));
+    path.moveTo(-950, 5040.5f);
+    path.conicTo(-940.125f, 5040.5f, -940.125f, 5050, SK_ScalarRoot2Over2);
+    path.lineTo(-950, 5060);
+    path.close();
+    check_round_trip(reporter, path);
+
+    check_round_trip(reporter, SkPath());
+    SkPath origin;
+    origin.moveTo(0, 0);
+    origin.lineTo(0, 0);
+    check_round_trip(reporter, origin);
+}
+
+static void test_rejects(skiatest::Reporter* reporter) {
+    // too many grid steps: 1/1024th of a pixel across 100 pixels
+    SkPath fine;
+    fine.moveTo(0, 0);
+    fine.lineTo(100, 1.0f / 1024);
+    REPORTER_ASSERT(reporter, NULL == SkCompactPath::Create(fine));
+
+    SkPath huge;
+    huge.moveTo(0, 0);
+    huge.lineTo(1, 1e9f);
+    REPORTER_ASSERT(reporter, NULL == SkCompactPath::Create(huge));
+
+    SkPath inf;
+    inf.moveTo(0, 0);
+    inf.lineTo(SK_ScalarInfinity, 0);
+    REPORTER_ASSERT(reporter, NULL == SkCompactPath::Create(inf));
+}
+
+static void test_size(skiatest::Reporter* reporter) {
+    SkPath path;
+    for (int i = 0; i < 10; ++i) {
+        path.lineTo(SkIntToScalar(i * 7 % 256), SkIntToScalar(i * 13 % 256));
+    }
+    SkAutoTUnref<SkCompactPath> compact(SkCompactPath::Create(path));
+    REPORTER_ASSERT(reporter, compact.get());
+    if (compact.get()) {
+        // half the point storage, plus the verbs and padding
+        size_t pointBytes = path.countPoints() * sizeof(SkPoint);
+        REPORTER_ASSERT(reporter, compact->approximateBytesUsed() <=
+                                  sizeof(SkCompactPath) + pointBytes / 2 + path.countVerbs() + 3);
+    }
+}
+
+DEF_TEST(CompactPath, reporter) {
+    test_grid_paths(reporter);
+    test_rejects(reporter);
+    test_size(reporter);
+}
@@ -13,6 +13,7 @@
 #include "GrFragmentProcessor.h"
 #include "GrInvariantOutput.h"
 #include "SkColorFilter.h"
+#include "SkColorMatrixFilter.h"
 #include "SkGr.h"
 #include "Test.h"
 
@@ -110,6 +111,47 @@ static void test_getConstantColorComponents(skiatest::Reporter* reporter, GrCont
     }
 }
 
+// A filter with no GPU implementation.
+class CPUOnlyColorFilter : public SkColorFilter {
+public:
+    virtual void filterSpan(const SkPMColor src[], int count,
+                            SkPMColor dst[]) const SK_OVERRIDE {
+        memmove(dst, src, count * sizeof(SkPMColor));
+    }
+
+#ifndef SK_IGNORE_TO_STRING
+    virtual void toString(SkString* str) const SK_OVERRIDE {
+        str->append("CPUOnlyColorFilter");
+    }
+#endif
+
+    SK_DECLARE_NOT_FLATTENABLE_PROCS(CPUOnlyColorFilter)
+};
+
+static void test_compose_fragment_processors(skiatest::Reporter* reporter,
+                                             GrContext* grContext) {
+    SkColorMatrix gray;
+    gray.setSaturation(0);
+    SkAutoTUnref<SkColorFilter> grayCF(SkColorMatrixFilter::Create(gray));
+    SkAutoTUnref<SkColorFilter> cpuOnly(SkNEW(CPUOnlyColorFilter));
+
+    SkAutoTUnref<SkColorFilter> both(SkColorFilter::CreateComposeFilter(grayCF, grayCF));
+    SkAutoTUnref<SkColorFilter> innerOnCPU(SkColorFilter::CreateComposeFilter(grayCF, cpuOnly));
+    SkAutoTUnref<SkColorFilter> outerOnCPU(SkColorFilter::CreateComposeFilter(cpuOnly, grayCF));
+
+    // A chain that is only partly expressible on the GPU appends nothing, rather than dropping
+    // the stage it can't express.
+    SkTDArray<GrFragmentProcessor*> array;
+    REPORTER_ASSERT(reporter, both->asFragmentProcessors(grContext, &array));
+    REPORTER_ASSERT(reporter, array.count() > 0);
+    int count = array.count();
+    REPORTER_ASSERT(reporter, !innerOnCPU->asFragmentProcessors(grContext, &array));
+    REPORTER_ASSERT(reporter, count == array.count());
+    REPORTER_ASSERT(reporter, !outerOnCPU->asFragmentProcessors(grContext, &array));
+    REPORTER_ASSERT(reporter, count == array.count());
+    array.unrefAll();
+}
+
 DEF_GPUTEST(GpuColorFilter, reporter, factory) {
     for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
         GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
@@ -120,6 +162,7 @@ DEF_GPUTEST(GpuColorFilter, reporter, factory) {
         }
 
         test_getConstantColorComponents(reporter, grContext);
+        test_compose_fragment_processors(reporter, grContext);
     }
 }
 
@@ -30,25 +30,39 @@ static void test_rectanizer_basic(skiatest::Reporter* reporter, GrRectanizer* re
     REPORTER_ASSERT(reporter, rectanizer->percentFull() == 0.0f);
 }
 
-static void test_rectanizer_inserts(skiatest::Reporter*,
+// Inserts rects until one fails, checking that every placed rect is inside the rectanizer and
+// doesn't overlap any placed before it.
+static void test_rectanizer_inserts(skiatest::Reporter* reporter,
                                     GrRectanizer* rectanizer,
                                     const SkTDArray<SkISize>& rects) {
+    SkTDArray<SkIRect> placed;
     int i;
     for (i = 0; i < rects.count(); ++i) {
         SkIPoint16 loc;
         if (!rectanizer->addRect(rects[i].fWidth, rects[i].fHeight, &loc)) {
             break;
         }
+        SkIRect r = SkIRect::MakeXYWH(loc.fX, loc.fY, rects[i].fWidth, rects[i].fHeight);
+        REPORTER_ASSERT(reporter, SkIRect::MakeWH(kWidth, kHeight).contains(r));
+        for (int j = 0; j < placed.count(); ++j) {
+            REPORTER_ASSERT(reporter, !SkIRect::Intersects(r, placed[j]));
+        }
+        *placed.append() = r;
     }
 
     //SkDebugf("\n***%d %f\n", i, rectanizer->percentFull());
 }
 
 static void test_skyline(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
-    GrRectanizerSkyline skylineRectanizer(kWidth, kHeight);
+    GrRectanizerSkyline skylineRectanizer(kWidth, kHeight, false);
 
     test_rectanizer_basic(reporter, &skylineRectanizer);
     test_rectanizer_inserts(reporter, &skylineRectanizer, rects);
+
+    GrRectanizerSkyline wasteMapRectanizer(kWidth, kHeight, true);
+
+    test_rectanizer_basic(reporter, &wasteMapRectanizer);
+    test_rectanizer_inserts(reporter, &wasteMapRectanizer, rects);
 }
 
 static void test_pow2(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
@@ -58,6 +72,15 @@ static void test_pow2(skiatest::Reporter* reporter, const SkTDArray<SkISize>& re
     test_rectanizer_inserts(reporter, &pow2Rectanizer, rects);
 }
 
+// Packs glyph sized rects, skipping the ones that don't fit, and returns how full it got.
+static float pack_glyphs(GrRectanizer* rectanizer, const SkTDArray<SkISize>& glyphs) {
+    for (int i = 0; i < glyphs.count(); ++i) {
+        SkIPoint16 loc;
+        rectanizer->addRect(glyphs[i].fWidth, glyphs[i].fHeight, &loc);
+    }
+    return rectanizer->percentFull();
+}
+
 DEF_GPUTEST(GpuRectanizer, reporter, factory) {
     SkTDArray<SkISize> rects;
     SkRandom rand;
@@ -69,6 +92,17 @@ DEF_GPUTEST(GpuRectanizer, reporter, factory) {
 
     test_skyline(reporter, rects);
     test_pow2(reporter, rects);
+
+    // The waste map fills the holes the skyline leaves behind.
+    SkTDArray<SkISize> glyphs;
+    for (int i = 0; i < 4000; i++) {
+        glyphs.push(SkISize::Make(rand.nextRangeU(4, 32), rand.nextRangeU(8, 36)));
+    }
+    GrRectanizerSkyline skylineRectanizer(kWidth / 4, kHeight / 4, false);
+    GrRectanizerSkyline wasteMapRectanizer(kWidth / 4, kHeight / 4, true);
+    float skylineFull = pack_glyphs(&skylineRectanizer, glyphs);
+    float wasteMapFull = pack_glyphs(&wasteMapRectanizer, glyphs);
+    REPORTER_ASSERT(reporter, wasteMapFull > skylineFull);
 }
 
 #endif
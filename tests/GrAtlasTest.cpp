@@ -0,0 +1,78 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrAtlas.h"
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrGpu.h"
+#include "Test.h"
+
+static const int kPlotSize = 32;
+
+DEF_GPUTEST(GrAtlas, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+
+    // Two pages of 2x2 plots, each just big enough for one image.
+    GrAtlas atlas(context->getGpu(), kAlpha_8_GrPixelConfig, kNone_GrSurfaceFlags,
+                  SkISize::Make(2 * kPlotSize, 2 * kPlotSize), 2, 2, 2, false);
+    GrAtlas::ClientPlotUsage usage;
+    uint8_t image[kPlotSize * kPlotSize];
+    memset(image, 0xFF, sizeof(image));
+    REPORTER_ASSERT(reporter, 0 == atlas.numPages());
+
+#if GR_GPU_STATS
+    int uploads = context->gpuStats()->textureUploads();
+#endif
+
+    GrPlot* plots[8];
+    SkIPoint16 loc;
+    for (int i = 0; i < 8; ++i) {
+        plots[i] = atlas.addToAtlas(&usage, kPlotSize, kPlotSize, image, &loc);
+        REPORTER_ASSERT(reporter, plots[i]);
+        if (NULL == plots[i]) {
+            return;
+        }
+        // The second page is only allocated once the first is full.
+        REPORTER_ASSERT(reporter, (i < 4 ? 1 : 2) == atlas.numPages());
+        REPORTER_ASSERT(reporter, atlas.getTexture(i / 4) == plots[i]->texture());
+        REPORTER_ASSERT(reporter, i / 4 == plots[i]->id() / 4);
+        for (int j = 0; j < i; ++j) {
+            REPORTER_ASSERT(reporter, plots[j] != plots[i]);
+        }
+    }
+    REPORTER_ASSERT(reporter, atlas.getTexture(0) != atlas.getTexture(1));
+
+    // Both pages are full.
+    REPORTER_ASSERT(reporter, NULL == atlas.addToAtlas(&usage, kPlotSize, kPlotSize, image, &loc));
+    REPORTER_ASSERT(reporter, 2 == atlas.numPages());
+
+#if GR_GPU_STATS
+    REPORTER_ASSERT(reporter, 8 == context->gpuStats()->textureUploads() - uploads);
+#endif
+
+    // Plots are ordered by when they were last added to or drawn from.
+    GrAtlas::PlotIter iter;
+    REPORTER_ASSERT(reporter, plots[7] == atlas.iterInit(&iter, GrAtlas::kMRUFirst_IterOrder));
+    REPORTER_ASSERT(reporter, plots[0] == atlas.iterInit(&iter, GrAtlas::kLRUFirst_IterOrder));
+    plots[0]->setDrawToken(GrDrawTarget::DrawToken(NULL, 0));
+    REPORTER_ASSERT(reporter, plots[0] == atlas.iterInit(&iter, GrAtlas::kMRUFirst_IterOrder));
+    REPORTER_ASSERT(reporter, plots[1] == atlas.iterInit(&iter, GrAtlas::kLRUFirst_IterOrder));
+
+    // A freed plot is reused without growing the atlas.
+    GrAtlas::RemovePlot(&usage, plots[1]);
+    plots[1]->resetRects();
+    REPORTER_ASSERT(reporter, plots[1] == atlas.addToAtlas(&usage, kPlotSize, kPlotSize, image,
+                                                           &loc));
+    REPORTER_ASSERT(reporter, 2 == atlas.numPages());
+}
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static const int kSize = 128;
+
+// Draws rows of rects, text, ovals and images, interleaved so that no two consecutive draws share
+// state. With overlap every row is drawn over the same spot. With flushEach every draw is flushed
+// on its own, so nothing can be batched or reordered.
+static void draw_interleaved(GrContext* context, SkCanvas* canvas, const SkBitmap& image,
+                             bool overlap, bool flushEach) {
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint, aaPaint;
+    aaPaint.setAntiAlias(true);
+    for (int i = 0; i < 8; ++i) {
+        SkScalar y = overlap ? 0 : SkIntToScalar(16 * i);
+        paint.setColor(0xFF000000 | (0x1F << (i % 3 * 8)));
+        aaPaint.setColor(0x80FF00FF);
+
+        for (int op = 0; op < 5; ++op) {
+            switch (op) {
+                case 0:
+                    canvas->drawRect(SkRect::MakeXYWH(2, y + 2, 30, 12), paint);
+                    break;
+                case 1:
+                    canvas->drawText("batch", 5, 36, y + 12, aaPaint);
+                    break;
+                case 2:
+                    canvas->drawOval(SkRect::MakeXYWH(70.5f, y + 1.5f, 20, 13), aaPaint);
+                    break;
+                case 3:
+                    canvas->drawBitmap(image, 96, y);
+                    break;
+                case 4:
+                    // Overlaps the text and the oval of this row.
+                    canvas->drawRect(SkRect::MakeXYWH(50.25f, y + 4.5f, 30, 6), aaPaint);
+                    break;
+            }
+            if (flushEach) {
+                context->flush();
+            }
+        }
+    }
+    context->flush();
+}
+
+static bool read_pixels(SkSurface* surface, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(kSize, kSize);
+    return surface->getCanvas()->readPixels(bitmap, 0, 0);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    for (int y = 0; y < kSize; ++y) {
+        if (0 != memcmp(a.getAddr32(0, y), b.getAddr32(0, y), kSize * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_GPUTEST(GrDrawBatching, reporter, factory) {
+    SkBitmap image;
+    image.allocN32Pixels(12, 12);
+    image.eraseColor(SK_ColorGREEN);
+    image.eraseArea(SkIRect::MakeWH(6, 6), SK_ColorBLUE);
+
+    for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+
+        GrContext* context = factory->get(glType);
+        if (NULL == context) {
+            continue;
+        }
+        SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(
+            context, SkImageInfo::MakeN32Premul(kSize, kSize)));
+        if (NULL == surface.get()) {
+            continue;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+
+        for (int overlap = 0; overlap < 2; ++overlap) {
+            // Batching must not change the result.
+            draw_interleaved(context, canvas, image, SkToBool(overlap), true);
+            SkBitmap expected;
+            bool readExpected = read_pixels(surface, &expected);
+
+            draw_interleaved(context, canvas, image, SkToBool(overlap), false);
+            SkBitmap actual;
+            bool readActual = read_pixels(surface, &actual);
+
+            if (GrContextFactory::IsRenderingGLContext(glType) && readExpected && readActual) {
+                REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+            }
+        }
+
+#if GR_GPU_STATS
+        // Rows that don't overlap share state across the draws in between.
+        const GrContext::GPUStats* stats = context->gpuStats();
+        int draws = stats->draws();
+        int stateFlushes = stats->stateFlushes();
+        draw_interleaved(context, canvas, image, false, false);
+        const int batchedDraws = stats->draws() - draws;
+        const int batchedFlushes = stats->stateFlushes() - stateFlushes;
+
+        draws = stats->draws();
+        stateFlushes = stats->stateFlushes();
+        draw_interleaved(context, canvas, image, true, false);
+        const int overlapDraws = stats->draws() - draws;
+        const int overlapFlushes = stats->stateFlushes() - stateFlushes;
+
+        REPORTER_ASSERT(reporter, batchedDraws == overlapDraws);
+        REPORTER_ASSERT(reporter, batchedFlushes < batchedDraws);
+        REPORTER_ASSERT(reporter, batchedFlushes < overlapFlushes);
+#endif
+    }
+}
+
+#endif
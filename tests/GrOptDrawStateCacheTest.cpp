@@ -0,0 +1,82 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "GrDrawState.h"
+#include "GrGpu.h"
+#include "GrOptDrawStateCache.h"
+#include "GrTexture.h"
+#include "Test.h"
+
+static void init_state(GrDrawState* drawState, GrRenderTarget* rt, GrColor color) {
+    drawState->setRenderTarget(rt);
+    drawState->setGeometryProcessor(GrDefaultGeoProcFactory::Create())->unref();
+    drawState->setColor(color);
+}
+
+DEF_GPUTEST(GrOptDrawStateCache, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+
+    GrSurfaceDesc desc;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    desc.fWidth = 16;
+    desc.fHeight = 16;
+    desc.fConfig = kSkia8888_GrPixelConfig;
+    SkAutoTUnref<GrTexture> texture(context->createUncachedTexture(desc, NULL, 0));
+    if (NULL == texture.get() || NULL == texture->asRenderTarget()) {
+        return;
+    }
+    GrRenderTarget* rt = texture->asRenderTarget();
+    const GrDrawTargetCaps& caps = *context->getGpu()->caps();
+    const GrGpu::DrawType drawType = GrGpu::kDrawTriangles_DrawType;
+    GrOptDrawStateCache::ScissorState scissor;
+
+    GrDrawState red, blue, scissoredRed, skipped;
+    init_state(&red, rt, GrColorPackRGBA(0xFF, 0, 0, 0xFF));
+    init_state(&blue, rt, GrColorPackRGBA(0, 0, 0xFF, 0xFF));
+    init_state(&scissoredRed, rt, GrColorPackRGBA(0xFF, 0, 0, 0xFF));
+    init_state(&skipped, rt, GrColorPackRGBA(0xFF, 0, 0, 0xFF));
+    skipped.setBlendFunc(kZero_GrBlendCoeff, kOne_GrBlendCoeff);
+
+    GrOptDrawStateCache cache;
+    GrOptDrawState* a = cache.intern(red, caps, scissor, NULL, drawType);
+    GrOptDrawState* b = cache.intern(blue, caps, scissor, NULL, drawType);
+    GrOptDrawStateCache::ScissorState rect;
+    rect.set(SkIRect::MakeWH(8, 8));
+    GrOptDrawState* c = cache.intern(scissoredRed, caps, rect, NULL, drawType);
+    REPORTER_ASSERT(reporter, a && b && c);
+    REPORTER_ASSERT(reporter, a != b && a != c && b != c);
+    REPORTER_ASSERT(reporter, 3 == cache.count());
+
+    // Equal states, even from different draw states, are the same object.
+    GrDrawState red2;
+    init_state(&red2, rt, GrColorPackRGBA(0xFF, 0, 0, 0xFF));
+    REPORTER_ASSERT(reporter, a == cache.intern(red2, caps, scissor, NULL, drawType));
+    REPORTER_ASSERT(reporter, b == cache.intern(blue, caps, scissor, NULL, drawType));
+    REPORTER_ASSERT(reporter, c == cache.intern(scissoredRed, caps, rect, NULL, drawType));
+    REPORTER_ASSERT(reporter, 3 == cache.count());
+
+    // Draws that can be skipped have no state.
+    REPORTER_ASSERT(reporter, NULL == cache.intern(skipped, caps, scissor, NULL, drawType));
+    REPORTER_ASSERT(reporter, 3 == cache.count());
+
+    // After a reset the states are created anew.
+    cache.reset();
+    REPORTER_ASSERT(reporter, 0 == cache.count());
+    a = cache.intern(red, caps, scissor, NULL, drawType);
+    REPORTER_ASSERT(reporter, a && a == cache.intern(red2, caps, scissor, NULL, drawType));
+    REPORTER_ASSERT(reporter, 1 == cache.count());
+}
+
+#endif
@@ -0,0 +1,287 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrPathTessellator.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+typedef GrPathTessellator::Vertex Vertex;
+
+// Returns how many triangles contain pt, and the coverage interpolated at pt by the last of them.
+static int count_hits(const SkTDArray<Vertex>& verts, double x, double y, double* coverage) {
+    int hits = 0;
+    for (int i = 0; i + 2 < verts.count(); i += 3) {
+        const Vertex& a = verts[i];
+        const Vertex& b = verts[i + 1];
+        const Vertex& c = verts[i + 2];
+        double abx = b.fPosition.fX - a.fPosition.fX, aby = b.fPosition.fY - a.fPosition.fY;
+        double acx = c.fPosition.fX - a.fPosition.fX, acy = c.fPosition.fY - a.fPosition.fY;
+        double apx = x - a.fPosition.fX, apy = y - a.fPosition.fY;
+        double det = abx * acy - aby * acx;
+        if (0 == det) {
+            continue;
+        }
+        double u = (apx * acy - apy * acx) / det;
+        double v = (abx * apy - aby * apx) / det;
+        if (u >= 0 && v >= 0 && u + v <= 1) {
+            ++hits;
+            *coverage = (1 - u - v) * a.fCoverage + u * b.fCoverage + v * c.fCoverage;
+        }
+    }
+    return hits;
+}
+
+// Samples a grid over the path's bounds, off any of the test paths' vertices and edges.
+static void test_fill(skiatest::Reporter* reporter, const SkPath& path) {
+    SkTDArray<Vertex> verts;
+    REPORTER_ASSERT(reporter, GrPathTessellator::Tessellate(path, 0.05f, 0, &verts));
+    REPORTER_ASSERT(reporter, 0 == verts.count() % 3);
+
+    SkRect bounds = path.getBounds();
+    bounds.outset(2, 2);
+    for (double y = bounds.fTop + 0.29; y < bounds.fBottom; y += 0.5) {
+        for (double x = bounds.fLeft + 0.13; x < bounds.fRight; x += 0.5) {
+            double coverage = 0;
+            int hits = count_hits(verts, x, y, &coverage);
+            bool inside = path.contains(SkDoubleToScalar(x), SkDoubleToScalar(y));
+            REPORTER_ASSERT(reporter, (inside ? 1 : 0) == hits);
+            REPORTER_ASSERT(reporter, 0 == hits || coverage > 0.999);
+        }
+    }
+}
+
+// Checks that points further than half the ramp from the edge of an axis aligned polygon have full
+// or no coverage, and that the edge itself is half covered.
+static void test_aa_fill(skiatest::Reporter* reporter, const SkPath& path, SkScalar aaWidth) {
+    SkTDArray<Vertex> verts;
+    REPORTER_ASSERT(reporter, GrPathTessellator::Tessellate(path, 0.05f, aaWidth, &verts));
+
+    SkRect bounds = path.getBounds();
+    bounds.outset(2, 2);
+    SkScalar r = aaWidth / 2;
+    for (double y = bounds.fTop + 0.29; y < bounds.fBottom; y += 0.25) {
+        for (double x = bounds.fLeft + 0.13; x < bounds.fRight; x += 0.25) {
+            double coverage = 0;
+            int hits = count_hits(verts, x, y, &coverage);
+            REPORTER_ASSERT(reporter, hits <= 1);
+            SkScalar sx = SkDoubleToScalar(x), sy = SkDoubleToScalar(y);
+            bool deepInside = path.contains(sx - r, sy - r) && path.contains(sx + r, sy - r) &&
+                              path.contains(sx - r, sy + r) && path.contains(sx + r, sy + r);
+            bool farOutside = !path.contains(sx - r, sy - r) && !path.contains(sx + r, sy - r) &&
+                              !path.contains(sx - r, sy + r) && !path.contains(sx + r, sy + r);
+            if (deepInside) {
+                REPORTER_ASSERT(reporter, 1 == hits && coverage > 0.999);
+            } else if (farOutside) {
+                REPORTER_ASSERT(reporter, 0 == hits || coverage < 0.001);
+            }
+        }
+    }
+
+    // Halfway up the left edge of the bounds
+    double coverage = 0;
+    const SkRect& pathBounds = path.getBounds();
+    REPORTER_ASSERT(reporter, 1 == count_hits(verts, pathBounds.fLeft, pathBounds.centerY(),
+                                              &coverage));
+    REPORTER_ASSERT(reporter, SkScalarNearlyEqual(SkDoubleToScalar(coverage), 0.5f));
+}
+
+static void test_aa_fails(skiatest::Reporter* reporter, const SkPath& path, SkScalar aaWidth) {
+    SkTDArray<Vertex> verts;
+    verts.append();
+    REPORTER_ASSERT(reporter, !GrPathTessellator::Tessellate(path, 0.05f, aaWidth, &verts));
+    REPORTER_ASSERT(reporter, 1 == verts.count());
+}
+
+static void make_star(SkPath* path, SkPath::FillType fillType) {
+    path->moveTo(20, 0);
+    path->lineTo(32, 38);
+    path->lineTo(0, 14);
+    path->lineTo(40, 14);
+    path->lineTo(8, 38);
+    path->close();
+    path->setFillType(fillType);
+}
+
+DEF_TEST(GrPathTessellator, reporter) {
+    SkPath empty;
+    SkTDArray<Vertex> verts;
+    REPORTER_ASSERT(reporter, GrPathTessellator::Tessellate(empty, 0.25f, 1, &verts));
+    REPORTER_ASSERT(reporter, verts.isEmpty());
+
+    SkPath rect;
+    rect.addRect(SkRect::MakeLTRB(1, 2, 21, 12));
+    test_fill(reporter, rect);
+    test_aa_fill(reporter, rect, 1);
+
+    // Both fill rules, with the edges crossing
+    SkPath star;
+    make_star(&star, SkPath::kWinding_FillType);
+    test_fill(reporter, star);
+    star.reset();
+    make_star(&star, SkPath::kEvenOdd_FillType);
+    test_fill(reporter, star);
+    test_aa_fails(reporter, star, 1);
+
+    // A hole, and rects overlapping each other and sharing an edge
+    SkPath frame;
+    frame.addRect(SkRect::MakeLTRB(0, 0, 30, 30));
+    frame.addRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPath::kCCW_Direction);
+    test_fill(reporter, frame);
+    test_aa_fill(reporter, frame, 1);
+    frame.setFillType(SkPath::kEvenOdd_FillType);
+    frame.addRect(SkRect::MakeLTRB(30, 0, 40, 10));
+    frame.addRect(SkRect::MakeLTRB(35, 5, 45, 15));
+    test_fill(reporter, frame);
+    test_aa_fails(reporter, frame, 1);
+
+    // An L shape, which has a reflex corner
+    SkPath ell;
+    ell.moveTo(0, 0);
+    ell.lineTo(10, 0);
+    ell.lineTo(10, 20);
+    ell.lineTo(30, 20);
+    ell.lineTo(30, 30);
+    ell.lineTo(0, 30);
+    ell.close();
+    test_fill(reporter, ell);
+    test_aa_fill(reporter, ell, 1);
+    test_aa_fill(reporter, ell, 0.25f);
+
+    // Curves are flattened to within the tolerance.
+    SkPath circle;
+    circle.addCircle(20, 20, 15);
+    REPORTER_ASSERT(reporter, GrPathTessellator::Tessellate(circle, 0.05f, 0, &verts));
+    double area = 0;
+    for (int i = 0; i < verts.count(); i += 3) {
+        SkVector ab = verts[i + 1].fPosition - verts[i].fPosition;
+        SkVector ac = verts[i + 2].fPosition - verts[i].fPosition;
+        area += 0.5 * fabs(SkPoint::CrossProduct(ab, ac));
+    }
+    REPORTER_ASSERT(reporter, area < SK_ScalarPI * 15.05 * 15.05);
+    REPORTER_ASSERT(reporter, area > SK_ScalarPI * 14.95 * 14.95);
+    verts.rewind();
+    REPORTER_ASSERT(reporter, GrPathTessellator::Tessellate(circle, 0.05f, 1, &verts));
+    double coverage = 0;
+    REPORTER_ASSERT(reporter, 1 == count_hits(verts, 20.1, 20.2, &coverage) && coverage > 0.999);
+    REPORTER_ASSERT(reporter, 0 == count_hits(verts, 20, 3.9, &coverage));
+
+    // Thinner than the ramp, so the inset turns inside out.
+    SkPath thin;
+    thin.addRect(SkRect::MakeLTRB(0, 0, 20, 0.5f));
+    test_fill(reporter, thin);
+    test_aa_fails(reporter, thin, 1);
+
+    // Two contours too close for their ramps not to overlap
+    SkPath close;
+    close.addRect(SkRect::MakeLTRB(0, 0, 10, 10));
+    close.addRect(SkRect::MakeLTRB(10.5f, 0, 20, 10));
+    test_aa_fails(reporter, close, 1);
+    test_aa_fill(reporter, close, 0.25f);
+}
+
+DEF_GPUTEST(GrTessellatingPathRenderer, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(
+        context, SkImageInfo::MakeN32Premul(256, 256)));
+    if (NULL == surface.get()) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    // Too big for the distance field renderer and not convex
+    SkMatrix scale;
+    scale.setScale(4, 4);
+    SkPath star, otherStar;
+    make_star(&star, SkPath::kWinding_FillType);
+    star.transform(scale);
+    make_star(&otherStar, SkPath::kWinding_FillType);
+    otherStar.transform(scale);
+    SkPath ell;
+    ell.moveTo(0, 0);
+    ell.lineTo(80, 0);
+    ell.lineTo(80, 160);
+    ell.lineTo(240, 160);
+    ell.lineTo(240, 240);
+    ell.lineTo(0, 240);
+    ell.close();
+    SkPath otherEll;
+    ell.offset(8, 8, &otherEll);
+    SkPath volatileEll(ell);
+    volatileEll.setIsVolatile(true);
+
+    // Paths are drawn with masks, whose textures are reused, until they're drawn again after a
+    // flush.
+    int resources;
+    size_t bytes;
+    canvas->drawPath(star, paint);
+    canvas->drawPath(ell, paint);
+    canvas->drawPath(volatileEll, paint);
+    context->flush();
+    context->getResourceCacheUsage(&resources, &bytes);
+
+    // Then they get meshes, except for volatile ones and the star, which can't be antialiased.
+    canvas->drawPath(ell, paint);
+    canvas->drawPath(star, paint);
+    canvas->drawPath(volatileEll, paint);
+    context->flush();
+    int newResources;
+    context->getResourceCacheUsage(&newResources, &bytes);
+    REPORTER_ASSERT(reporter, resources + 1 == newResources);
+
+    // The same paths reuse their meshes.
+    canvas->drawPath(ell, paint);
+    canvas->drawPath(star, paint);
+    canvas->drawPath(star, paint);
+    context->flush();
+    context->getResourceCacheUsage(&resources, &bytes);
+    REPORTER_ASSERT(reporter, resources == newResources);
+
+    // A new path gets its own, and so does one drawn at another size.
+    for (int i = 0; i < 2; ++i) {
+        context->getResourceCacheUsage(&resources, &bytes);
+        canvas->drawPath(otherEll, paint);
+        canvas->scale(0.5f, 0.5f);
+        canvas->drawPath(ell, paint);
+        canvas->scale(2, 2);
+        context->flush();
+    }
+    context->getResourceCacheUsage(&newResources, &bytes);
+    REPORTER_ASSERT(reporter, resources + 2 == newResources);
+
+    // Self-intersecting paths can't be antialiased, and volatile ones aren't kept.
+    for (int i = 0; i < 2; ++i) {
+        canvas->drawPath(otherStar, paint);
+        canvas->drawPath(volatileEll, paint);
+        context->flush();
+    }
+    context->getResourceCacheUsage(&resources, &bytes);
+    REPORTER_ASSERT(reporter, newResources == resources);
+
+    // A path that couldn't be antialiased is still tessellated when it's drawn without AA.
+    paint.setAntiAlias(false);
+    for (int i = 0; i < 2; ++i) {
+        context->getResourceCacheUsage(&resources, &bytes);
+        canvas->drawPath(otherStar, paint);
+        context->flush();
+    }
+    context->getResourceCacheUsage(&newResources, &bytes);
+    REPORTER_ASSERT(reporter, resources + 1 == newResources);
+}
+
+#endif
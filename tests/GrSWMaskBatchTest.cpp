@@ -0,0 +1,92 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrSWMaskBatch.h"
+#include "GrSurfacePriv.h"
+#include "GrTexture.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkStrokeRec.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static void make_star(SkPath* path, SkScalar scale) {
+    path->moveTo(20 * scale, 0);
+    path->lineTo(32 * scale, 38 * scale);
+    path->lineTo(0, 14 * scale);
+    path->lineTo(40 * scale, 14 * scale);
+    path->lineTo(8 * scale, 38 * scale);
+    path->close();
+    path->setIsVolatile(true);
+}
+
+DEF_GPUTEST(GrSWMaskBatch, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(
+        context, SkImageInfo::MakeN32Premul(256, 256)));
+    if (NULL == surface.get()) {
+        return;
+    }
+    GrSWMaskBatch* batch = context->getSWMaskBatch();
+    context->flush();
+
+    // Masks waiting for the same flush each get a texture no earlier draw uses.
+    SkPath star;
+    make_star(&star, 2);
+    SkStrokeRec stroke(SkStrokeRec::kFill_InitStyle);
+    SkIRect bounds = SkIRect::MakeWH(80, 76);
+    SkAutoTUnref<GrTexture> first(batch->addPathMask(star, stroke, bounds, true, SkMatrix::I()));
+    SkAutoTUnref<GrTexture> second(batch->addPathMask(star, stroke, bounds, true, SkMatrix::I()));
+    REPORTER_ASSERT(reporter, first && second && first != second);
+    if (NULL == first || NULL == second) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, !first->surfacePriv().hasPendingIO());
+    REPORTER_ASSERT(reporter, !second->surfacePriv().hasPendingIO());
+    batch->uploadMasks();
+    first.reset(NULL);
+    second.reset(NULL);
+
+    // Volatile, self-intersecting paths are drawn with software masks. Once the masks have been
+    // uploaded and drawn with, their textures are reused by the next flush's masks.
+    SkCanvas* canvas = surface->getCanvas();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 4; ++i) {
+        canvas->drawPath(star, paint);
+        canvas->translate(40, 40);
+    }
+    context->flush();
+    int resources;
+    size_t bytes;
+    context->getResourceCacheUsage(&resources, &bytes);
+
+    canvas->translate(-160, -160);
+    for (int i = 0; i < 4; ++i) {
+        canvas->drawPath(star, paint);
+        canvas->translate(40, 40);
+    }
+    context->flush();
+    int newResources;
+    context->getResourceCacheUsage(&newResources, &bytes);
+    REPORTER_ASSERT(reporter, resources == newResources);
+
+    // Masks whose draws are discarded are dropped without being uploaded.
+    canvas->drawPath(star, paint);
+    context->flush(GrContext::kDiscard_FlushBit);
+    context->flush();
+}
+
+#endif
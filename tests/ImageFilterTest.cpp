@@ -27,6 +27,7 @@
 #include "SkPicture.h"
 #include "SkPictureImageFilter.h"
 #include "SkPictureRecorder.h"
+#include "SkRandom.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkRectShaderImageFilter.h"
@@ -822,6 +823,325 @@ DEF_TEST(ImageFilterClippedPictureImageFilter, reporter) {
     REPORTER_ASSERT(reporter, !imageFilter->filterImage(&proxy, bitmap, ctx, &result, &offset));
 }
 
+DEF_TEST(ColorFilterImageFilterMatchesPaint, reporter) {
+    // SkColorFilterImageFilter filters raster pixels directly, in bands of rows. Check that it
+    // matches drawing the source with the color filter, including with a crop rect that
+    // extends past the source.
+    const int width = 100, height = 70;
+    SkBitmap gradient = make_gradient_circle(width, height);
+
+    SkBitmap expected;
+    expected.allocN32Pixels(width, height);
+    {
+        SkCanvas canvas(expected);
+        canvas.clear(0x0);
+        SkPaint paint;
+        paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+        SkAutoTUnref<SkColorFilter> cf(SkColorFilter::CreateLightingFilter(0xFF808040, 0x00102030));
+        paint.setColorFilter(cf);
+        canvas.drawBitmap(gradient, 0, 0, &paint);
+    }
+
+    SkBitmap temp;
+    temp.allocN32Pixels(width, height);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+
+    SkAutoTUnref<SkColorFilter> cf(SkColorFilter::CreateLightingFilter(0xFF808040, 0x00102030));
+    const SkImageFilter::CropRect cropRects[] = {
+        SkImageFilter::CropRect(SkRect::MakeWH(SkIntToScalar(width), SkIntToScalar(height))),
+        SkImageFilter::CropRect(SkRect::MakeXYWH(10, 5, 80, 90)),
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(cropRects); ++i) {
+        SkAutoTUnref<SkImageFilter> filter(
+            SkColorFilterImageFilter::Create(cf, NULL, &cropRects[i]));
+        SkBitmap result;
+        SkIPoint offset;
+        REPORTER_ASSERT(reporter, filter->filterImage(&proxy, gradient, ctx, &result, &offset));
+
+        SkAutoLockPixels alpResult(result), alpExpected(expected);
+        for (int y = 0; y < result.height(); ++y) {
+            for (int x = 0; x < result.width(); ++x) {
+                int srcX = x + offset.fX, srcY = y + offset.fY;
+                SkPMColor want = srcX < width && srcY < height ?
+                                 *expected.getAddr32(srcX, srcY) : 0;
+                REPORTER_ASSERT(reporter, *result.getAddr32(x, y) == want);
+            }
+        }
+    }
+}
+
+static void test_morphology(skiatest::Reporter* reporter, bool dilate, int radiusX, int radiusY) {
+    const int width = 60, height = 45;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    SkRandom rand;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+
+    SkAutoTUnref<SkImageFilter> filter(dilate ?
+        static_cast<SkImageFilter*>(SkDilateImageFilter::Create(radiusX, radiusY)) :
+        static_cast<SkImageFilter*>(SkErodeImageFilter::Create(radiusX, radiusY)));
+    SkBitmap temp;
+    temp.allocN32Pixels(width, height);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+    SkBitmap result;
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, filter->filterImage(&proxy, bitmap, ctx, &result, &offset));
+    REPORTER_ASSERT(reporter, result.width() == width && result.height() == height);
+
+    // Compare against the min/max over each (clipped) window.
+    SkAutoLockPixels alp(result);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            unsigned want[4];
+            for (int c = 0; c < 4; ++c) {
+                want[c] = dilate ? 0 : 255;
+            }
+            for (int wy = SkMax32(0, y - radiusY); wy <= SkMin32(height - 1, y + radiusY); ++wy) {
+                for (int wx = SkMax32(0, x - radiusX); wx <= SkMin32(width - 1, x + radiusX); ++wx) {
+                    SkPMColor p = *bitmap.getAddr32(wx, wy);
+                    unsigned channels[4] = { SkGetPackedA32(p), SkGetPackedR32(p),
+                                             SkGetPackedG32(p), SkGetPackedB32(p) };
+                    for (int c = 0; c < 4; ++c) {
+                        want[c] = dilate ? SkTMax(want[c], channels[c]) :
+                                           SkTMin(want[c], channels[c]);
+                    }
+                }
+            }
+            SkPMColor expected = SkPackARGB32(want[0], want[1], want[2], want[3]);
+            if (*result.getAddr32(x, y) != expected) {
+                ERRORF(reporter, "%s %dx%d mismatch at (%d, %d)", dilate ? "dilate" : "erode",
+                       radiusX, radiusY, x, y);
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(MorphologyImageFilter, reporter) {
+    // Small radii scan the window; large ones use van Herk/Gil-Werman. Both must agree with
+    // a brute force min/max, including windows clipped at both ends and larger than the image.
+    static const int kRadii[][2] = {
+        { 1, 2 }, { 5, 0 }, { 8, 8 }, { 10, 3 }, { 13, 21 }, { 0, 22 }, { 29, 44 }, { 70, 9 },
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kRadii); ++i) {
+        test_morphology(reporter, true, kRadii[i][0], kRadii[i][1]);
+        test_morphology(reporter, false, kRadii[i][0], kRadii[i][1]);
+    }
+}
+
+static void test_matrix_convolution(skiatest::Reporter* reporter, const SkISize& kernelSize,
+                                    const SkScalar* kernel,
+                                    SkMatrixConvolutionImageFilter::TileMode tileMode) {
+    const int width = 40, height = 70;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    SkRandom rand;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+
+    const SkScalar gain = 0.5f, bias = 10;
+    const SkIPoint kernelOffset = SkIPoint::Make(kernelSize.width() / 2, kernelSize.height() / 2);
+    SkAutoTUnref<SkImageFilter> filter(SkMatrixConvolutionImageFilter::Create(
+        kernelSize, kernel, gain, bias, kernelOffset, tileMode, true));
+    SkBitmap temp;
+    temp.allocN32Pixels(width, height);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+    SkBitmap result;
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, filter->filterImage(&proxy, bitmap, ctx, &result, &offset));
+
+    SkAutoLockPixels alp(result);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double sum[4] = { 0, 0, 0, 0 };
+            for (int cy = 0; cy < kernelSize.height(); ++cy) {
+                for (int cx = 0; cx < kernelSize.width(); ++cx) {
+                    int sx = x + cx - kernelOffset.fX, sy = y + cy - kernelOffset.fY;
+                    SkPMColor p = 0;
+                    if (SkMatrixConvolutionImageFilter::kClamp_TileMode == tileMode) {
+                        p = *bitmap.getAddr32(SkPin32(sx, 0, width - 1),
+                                              SkPin32(sy, 0, height - 1));
+                    } else if (sx >= 0 && sx < width && sy >= 0 && sy < height) {
+                        p = *bitmap.getAddr32(sx, sy);
+                    }
+                    double k = kernel[cy * kernelSize.width() + cx];
+                    sum[0] += SkGetPackedA32(p) * k;
+                    sum[1] += SkGetPackedR32(p) * k;
+                    sum[2] += SkGetPackedG32(p) * k;
+                    sum[3] += SkGetPackedB32(p) * k;
+                }
+            }
+            int want[4];
+            want[0] = SkClampMax((int)floor(sum[0] * gain + bias), 255);
+            for (int c = 1; c < 4; ++c) {
+                want[c] = SkClampMax((int)floor(sum[c] * gain + bias), want[0]);
+            }
+            SkPMColor got = *result.getAddr32(x, y);
+            int gotChannels[4] = { (int)SkGetPackedA32(got), (int)SkGetPackedR32(got),
+                                   (int)SkGetPackedG32(got), (int)SkGetPackedB32(got) };
+            for (int c = 0; c < 4; ++c) {
+                // Allow for float rounding right at integer boundaries.
+                if (SkTAbs(gotChannels[c] - want[c]) > 1) {
+                    ERRORF(reporter, "%dx%d kernel mismatch at (%d, %d): %d vs %d",
+                           kernelSize.width(), kernelSize.height(), x, y,
+                           gotChannels[c], want[c]);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(ImageFilterMatrixConvolutionSeparable, reporter) {
+    // A separable kernel (run as two 1D passes) and a general one, at sizes that fit in the
+    // image and that don't, must match a direct 2D convolution.
+    static const SkScalar kRow[] = { 1, 2, 3, 4, 5, 4, 3, 2, 1 };
+    for (int n = 3; n <= 9; n += 2) {
+        SkAutoTMalloc<SkScalar> separable(n * n), general(n * n);
+        SkRandom rand;
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                separable[y * n + x] = kRow[x] * kRow[y] / 100;
+                general[y * n + x] = rand.nextSScalar1();
+            }
+        }
+        const SkISize size = SkISize::Make(n, n);
+        test_matrix_convolution(reporter, size, separable,
+                                SkMatrixConvolutionImageFilter::kClamp_TileMode);
+        test_matrix_convolution(reporter, size, separable,
+                                SkMatrixConvolutionImageFilter::kClampToBlack_TileMode);
+        test_matrix_convolution(reporter, size, general,
+                                SkMatrixConvolutionImageFilter::kClamp_TileMode);
+        test_matrix_convolution(reporter, size, general,
+                                SkMatrixConvolutionImageFilter::kClampToBlack_TileMode);
+    }
+    // Taller than the image, and a column vector.
+    SkScalar tall[80 * 2];
+    for (int i = 0; i < 80 * 2; ++i) {
+        tall[i] = SkIntToScalar(i % 2 + 1) / 80;
+    }
+    test_matrix_convolution(reporter, SkISize::Make(2, 80), tall,
+                            SkMatrixConvolutionImageFilter::kClamp_TileMode);
+    test_matrix_convolution(reporter, SkISize::Make(1, 80), tall,
+                            SkMatrixConvolutionImageFilter::kClampToBlack_TileMode);
+}
+
+static void test_diffuse_lighting(skiatest::Reporter* reporter, const SkBitmap& bitmap,
+                                  SkImageFilter* filter, const SkPoint3* location,
+                                  const SkPoint3* direction, SkScalar surfaceScale, SkScalar kd) {
+    const int width = bitmap.width(), height = bitmap.height();
+    SkBitmap temp;
+    temp.allocN32Pixels(width, height);
+    SkBitmapDevice device(temp);
+    SkDeviceImageFilterProxy proxy(&device, SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), NULL);
+    SkBitmap result;
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, filter->filterImage(&proxy, bitmap, ctx, &result, &offset));
+    REPORTER_ASSERT(reporter, result.width() == width && result.height() == height);
+
+    // Compare the interior against the Sobel normal and diffuse formula from the SVG spec,
+    // which scales alpha to [0, 1] before applying surfaceScale.
+    const double scale = surfaceScale / 255;
+    SkAutoLockPixels alp(result);
+    for (int y = 1; y < height - 1; ++y) {
+        for (int x = 1; x < width - 1; ++x) {
+            int a[3][3];
+            for (int j = 0; j < 3; ++j) {
+                for (int i = 0; i < 3; ++i) {
+                    a[j][i] = SkGetPackedA32(*bitmap.getAddr32(x + i - 1, y + j - 1));
+                }
+            }
+            double nx = -scale / 4 * (a[0][2] - a[0][0] + 2 * (a[1][2] - a[1][0]) +
+                                             a[2][2] - a[2][0]);
+            double ny = -scale / 4 * (a[2][0] - a[0][0] + 2 * (a[2][1] - a[0][1]) +
+                                             a[2][2] - a[0][2]);
+            double nz = 1;
+            double lx, ly, lz;
+            if (location) {
+                lx = location->fX - x;
+                ly = location->fY - y;
+                lz = location->fZ - scale * a[1][1];
+            } else {
+                lx = direction->fX;
+                ly = direction->fY;
+                lz = direction->fZ;
+            }
+            double dot = (nx * lx + ny * ly + nz * lz) /
+                         (sqrt(nx * nx + ny * ny + nz * nz) * sqrt(lx * lx + ly * ly + lz * lz));
+            int want = (int)floor(SkTMin(SkTMax(kd * dot, 0.0), 1.0) * 255 + 0.5);
+            SkPMColor got = *result.getAddr32(x, y);
+            if (SkGetPackedA32(got) != 255 || SkTAbs((int)SkGetPackedR32(got) - want) > 1 ||
+                SkGetPackedR32(got) != SkGetPackedG32(got) ||
+                SkGetPackedR32(got) != SkGetPackedB32(got)) {
+                ERRORF(reporter, "diffuse lighting mismatch at (%d, %d): %08x vs %d",
+                       x, y, got, want);
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(LightingImageFilterDiffuse, reporter) {
+    // An odd width exercises both the four-wide and the per-pixel lighting paths.
+    const int width = 37, height = 35;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    SkRandom rand;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+
+    const SkScalar surfaceScale = 30, kd = 1.5f;
+    const SkPoint3 direction(0.6f, -0.48f, 0.64f);
+    SkAutoTUnref<SkImageFilter> distant(SkLightingImageFilter::CreateDistantLitDiffuse(
+        direction, SK_ColorWHITE, surfaceScale, kd));
+    test_diffuse_lighting(reporter, bitmap, distant, NULL, &direction, surfaceScale, kd);
+
+    // Normals of a mutable bitmap are computed band by band, and never cached. For an
+    // immutable one, moving the light reuses the cached normals; changing the surface scale
+    // must not.
+    SkBitmap immutable;
+    REPORTER_ASSERT(reporter, bitmap.copyTo(&immutable));
+    immutable.setImmutable();
+    for (int i = 0; i < 3; ++i) {
+        const SkPoint3 location(SkIntToScalar(10 * i), SkIntToScalar(30 - 7 * i), 20);
+        SkAutoTUnref<SkImageFilter> point(SkLightingImageFilter::CreatePointLitDiffuse(
+            location, SK_ColorWHITE, surfaceScale, kd));
+        test_diffuse_lighting(reporter, bitmap, point, &location, NULL, surfaceScale, kd);
+        test_diffuse_lighting(reporter, immutable, point, &location, NULL, surfaceScale, kd);
+    }
+    const SkPoint3 location(20, 15, 10);
+    SkAutoTUnref<SkImageFilter> rescaled(SkLightingImageFilter::CreatePointLitDiffuse(
+        location, SK_ColorWHITE, 2 * surfaceScale, kd));
+    test_diffuse_lighting(reporter, immutable, rescaled, &location, NULL, 2 * surfaceScale, kd);
+    test_diffuse_lighting(reporter, bitmap, rescaled, &location, NULL, 2 * surfaceScale, kd);
+
+    bitmap.eraseARGB(0x80, 0, 0, 0);
+    *bitmap.getAddr32(width / 2, height / 2) = 0;
+    bitmap.notifyPixelsChanged();
+    test_diffuse_lighting(reporter, bitmap, rescaled, &location, NULL, 2 * surfaceScale, kd);
+
+    // Pixels written directly keep the generation ID.
+    *bitmap.getAddr32(width / 2, height / 2) = SK_ColorWHITE;
+    test_diffuse_lighting(reporter, bitmap, rescaled, &location, NULL, 2 * surfaceScale, kd);
+}
+
 DEF_TEST(ImageFilterEmptySaveLayer, reporter) {
     // Even when there's an empty saveLayer()/restore(), ensure that an image
     // filter or color filter which affects transparent black still draws.
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2014 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkLayerPool.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static bool is_clear(const SkImageInfo& info, const void* pixels, size_t rowBytes) {
+    for (int y = 0; y < info.height(); ++y) {
+        const SkPMColor* row = (const SkPMColor*)((const char*)pixels + y * rowBytes);
+        for (int x = 0; x < info.width(); ++x) {
+            if (row[x]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool bitmap_is_clear(const SkBitmap& bm) {
+    SkAutoLockPixels alp(bm);
+    return bm.getPixels() && is_clear(bm.info(), bm.getPixels(), bm.rowBytes());
+}
+
+static bool layer_is_clear(SkCanvas* canvas) {
+    SkImageInfo info;
+    size_t rowBytes;
+    const void* pixels = canvas->accessTopLayerPixels(&info, &rowBytes);
+    return pixels && is_clear(info, pixels, rowBytes);
+}
+
+DEF_TEST(LayerPool, reporter) {
+    SkAutoTUnref<SkLayerPool> pool(SkNEW_ARGS(SkLayerPool, (2, 1024 * 1024)));
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+
+    SkBitmap bm;
+    bm.setInfo(info);
+    REPORTER_ASSERT(reporter, bm.tryAllocPixels(pool, NULL));
+    REPORTER_ASSERT(reporter, bitmap_is_clear(bm));
+    bm.eraseColor(SK_ColorRED);
+    const void* pixels = bm.getPixels();
+
+    // Pixels go back to the pool only once the last ref to them is gone.
+    SkBitmap copy(bm);
+    bm.reset();
+    REPORTER_ASSERT(reporter, 0 == pool->countBuffers());
+    copy.reset();
+    REPORTER_ASSERT(reporter, 1 == pool->countBuffers());
+    REPORTER_ASSERT(reporter, pool->getTotalBytes() >= info.getSafeSize(info.minRowBytes()));
+
+    // A slightly smaller bitmap shares the size class, and gets the buffer back cleared.
+    bm.setInfo(SkImageInfo::MakeN32Premul(99, 98));
+    REPORTER_ASSERT(reporter, bm.tryAllocPixels(pool, NULL));
+    REPORTER_ASSERT(reporter, pixels == bm.getPixels());
+    REPORTER_ASSERT(reporter, bitmap_is_clear(bm));
+    REPORTER_ASSERT(reporter, 0 == pool->countBuffers());
+
+    // The pool keeps at most two buffers.
+    SkBitmap bms[3];
+    for (int i = 0; i < 3; ++i) {
+        bms[i].setInfo(info);
+        REPORTER_ASSERT(reporter, bms[i].tryAllocPixels(pool, NULL));
+    }
+    bm.reset();
+    for (int i = 0; i < 3; ++i) {
+        bms[i].reset();
+    }
+    REPORTER_ASSERT(reporter, 2 == pool->countBuffers());
+
+    pool->purge();
+    REPORTER_ASSERT(reporter, 0 == pool->countBuffers());
+    REPORTER_ASSERT(reporter, 0 == pool->getTotalBytes());
+}
+
+// Raster layers come from the global pool, and must always start out clear.
+DEF_TEST(LayerPool_SaveLayer, reporter) {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterPMColor(100, 100));
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+
+    for (int i = 0; i < 3; ++i) {
+        canvas->saveLayer(NULL, NULL);
+        REPORTER_ASSERT(reporter, layer_is_clear(canvas));
+        canvas->clear(SK_ColorRED);
+        canvas->saveLayerAlpha(NULL, 0x80);
+        REPORTER_ASSERT(reporter, layer_is_clear(canvas));
+        canvas->clear(SK_ColorBLUE);
+        canvas->restore();
+        canvas->restore();
+    }
+}
+
+static int count_pixels(SkCanvas* canvas, SkPMColor color) {
+    SkImageInfo info;
+    size_t rowBytes;
+    const char* pixels = (const char*)canvas->accessTopLayerPixels(&info, &rowBytes);
+    int count = 0;
+    for (int y = 0; pixels && y < info.height(); ++y) {
+        const SkPMColor* row = (const SkPMColor*)(pixels + y * rowBytes);
+        for (int x = 0; x < info.width(); ++x) {
+            count += color == row[x];
+        }
+    }
+    return count;
+}
+
+// Recycled layers are only cleared when they are not overwritten right away. Make sure the
+// pixels a layer doesn't overwrite are still clear.
+DEF_TEST(LayerPool_SaveLayerOverwrite, reporter) {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterPMColor(100, 100));
+    SkCanvas* canvas = surface->getCanvas();
+    const SkPMColor blue = SkPreMultiplyColor(SK_ColorBLUE);
+
+    // Leave a dirty buffer in the pool.
+    canvas->saveLayer(NULL, NULL);
+    canvas->clear(SK_ColorRED);
+    canvas->restore();
+
+    // Only part of the layer is filled.
+    canvas->saveLayer(NULL, NULL);
+    canvas->save();
+    canvas->clipRect(SkRect::MakeWH(50, 100));
+    canvas->clear(SK_ColorBLUE);
+    canvas->restore();
+    REPORTER_ASSERT(reporter, 50 * 100 == count_pixels(canvas, blue));
+    REPORTER_ASSERT(reporter, 50 * 100 == count_pixels(canvas, 0));
+    canvas->restore();
+
+    // The layer is filled with a translucent color that doesn't blend.
+    canvas->saveLayer(NULL, NULL);
+    canvas->clear(0x80000000);
+    REPORTER_ASSERT(reporter, 100 * 100 == count_pixels(canvas, SkPreMultiplyColor(0x80000000)));
+    canvas->restore();
+
+    // A translucent fill that blends needs the layer to start out clear.
+    canvas->saveLayer(NULL, NULL);
+    SkPaint paint;
+    paint.setColor(0x80000000);
+    canvas->drawPaint(paint);
+    REPORTER_ASSERT(reporter, 100 * 100 == count_pixels(canvas, SkPreMultiplyColor(0x80000000)));
+    canvas->restore();
+
+    // Every pixel is overwritten.
+    canvas->saveLayer(NULL, NULL);
+    canvas->clear(SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, 100 * 100 == count_pixels(canvas, blue));
+    canvas->restore();
+}
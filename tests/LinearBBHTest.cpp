@@ -0,0 +1,59 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkLinearBBH.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static const size_t NUM_ITERATIONS = 50;
+static const size_t NUM_QUERIES = 50;
+
+// Sometimes empty, sometimes not.
+static SkRect random_rect(SkRandom& rand) {
+    SkRect rect;
+    rect.fLeft   = rand.nextRangeF(0, 1000);
+    rect.fRight  = rand.nextRangeF(0, 1000);
+    rect.fTop    = rand.nextRangeF(0, 1000);
+    rect.fBottom = rand.nextRangeF(0, 1000);
+    if (rand.nextU() % 8) {
+        rect.sort();
+    }
+    return rect;
+}
+
+static void run_queries(skiatest::Reporter* reporter, SkRandom& rand,
+                        const SkRect rects[], int count, const SkLinearBBH& bbh) {
+    for (size_t i = 0; i < NUM_QUERIES; ++i) {
+        SkRect query = random_rect(rand);
+        query.sort();
+
+        SkTDArray<unsigned> expected, hits;
+        for (int j = 0; j < count; ++j) {
+            if (SkRect::Intersects(query, rects[j])) {
+                expected.push(j);
+            }
+        }
+        bbh.search(query, &hits);
+        REPORTER_ASSERT(reporter, hits == expected);
+    }
+}
+
+DEF_TEST(LinearBBH, reporter) {
+    SkRandom rand;
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        // Not always a multiple of four, to exercise the padding.
+        const int count = rand.nextRangeU(0, 300);
+        SkAutoTMalloc<SkRect> rects(count);
+        for (int j = 0; j < count; j++) {
+            rects[j] = random_rect(rand);
+        }
+
+        SkLinearBBH bbh;
+        bbh.insert(&rects, count);
+        run_queries(reporter, rand, rects, count, bbh);
+    }
+}
@@ -104,3 +104,69 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkScalar sigma = 0.8f;
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkBlurQuality quality = kLow_SkBlurQuality;
+    SkPath path;
+    path.addCircle(50, 50, 40);
+    const uint32_t genID = path.getGenerationID();
+    SkMatrix ctm = SkMatrix::I();
+    SkMatrix srcToDevice;
+    srcToDevice.setTranslate(10.5f, 20);
+    SkMask mask;
+
+    SkMaskCache::PathStats stats = SkMaskCache::GetPathStats();
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, quality, genID,
+                                                 path.getFillType(), SkPaint::kFill_Style,
+                                                 srcToDevice, ctm, &mask, &cache);
+    REPORTER_ASSERT(reporter, NULL == data);
+    REPORTER_ASSERT(reporter, SkMaskCache::GetPathStats().fMisses > stats.fMisses);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(15, 25, 100, 100);
+    mask.fRowBytes = 100;
+    mask.fFormat = SkMask::kA8_Format;
+    SkMaskCache::Add(sigma, style, quality, genID, path.getFillType(), SkPaint::kFill_Style,
+                     srcToDevice, ctm, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // A different subpixel offset or scale is a different mask.
+    srcToDevice.setTranslate(10.25f, 20);
+    REPORTER_ASSERT(reporter, NULL == SkMaskCache::FindAndRef(sigma, style, quality, genID,
+                                                              path.getFillType(),
+                                                              SkPaint::kFill_Style,
+                                                              srcToDevice, ctm, &mask, &cache));
+    ctm.setScale(2, 2);
+    srcToDevice.setTranslate(10.5f, 20);
+    REPORTER_ASSERT(reporter, NULL == SkMaskCache::FindAndRef(sigma, style, quality, genID,
+                                                              path.getFillType(),
+                                                              SkPaint::kFill_Style,
+                                                              srcToDevice, ctm, &mask, &cache));
+    ctm.reset();
+
+    // The same subpixel offset at another pixel position hits, with the bounds moved along.
+    stats = SkMaskCache::GetPathStats();
+    srcToDevice.setTranslate(13.5f, 18);
+    sk_bzero(&mask, sizeof(mask));
+    data = SkMaskCache::FindAndRef(sigma, style, quality, genID, path.getFillType(),
+                                   SkPaint::kFill_Style, srcToDevice, ctm, &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, SkMaskCache::GetPathStats().fHits > stats.fHits);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    REPORTER_ASSERT(reporter, mask.fBounds == SkIRect::MakeXYWH(18, 23, 100, 100));
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    cache.purgeAll();
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
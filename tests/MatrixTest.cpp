@@ -863,3 +863,97 @@ DEF_TEST(Matrix_Concat, r) {
 
     REPORTER_ASSERT(r, expected == SkMatrix::Concat(a, b));
 }
+
+static bool nearly_equal_relative(SkScalar a, SkScalar b) {
+    return SkScalarAbs(a - b) <= SkTMax(SK_Scalar1, SkScalarAbs(a)) * 1e-5f;
+}
+
+static void make_batch_matrices(SkMatrix mats[7]) {
+    mats[0].reset();
+    mats[1].setTranslate(10.5f, -3.25f);
+    mats[2].setScale(2.5f, -0.75f);
+    mats[3].setScale(1.5f, 3, 7, 9);
+    mats[3].postTranslate(-4, 12);
+    mats[4].setRotate(30);
+    mats[5].setRotate(-70, 20, 40);
+    mats[6].setRotate(15);
+    mats[6].setPerspX(0.001f);
+    mats[6].setPerspY(-0.0025f);
+}
+
+// mapPoints() maps points in pairs, with a scalar tail; check it against mapXY().
+DEF_TEST(Matrix_MapPointsBatched, r) {
+    SkMatrix mats[7];
+    make_batch_matrices(mats);
+
+    SkRandom rand;
+    SkPoint src[17], dst[17];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(mats); ++i) {
+        for (int count = 1; count <= (int)SK_ARRAY_COUNT(src); ++count) {
+            for (int j = 0; j < count; ++j) {
+                src[j].set(rand.nextRangeScalar(-500, 500), rand.nextRangeScalar(-500, 500));
+            }
+            mats[i].mapPoints(dst, src, count);
+            for (int j = 0; j < count; ++j) {
+                SkPoint expected;
+                mats[i].mapXY(src[j].fX, src[j].fY, &expected);
+                REPORTER_ASSERT(r, nearly_equal_relative(expected.fX, dst[j].fX));
+                REPORTER_ASSERT(r, nearly_equal_relative(expected.fY, dst[j].fY));
+            }
+            // In place.
+            mats[i].mapPoints(src, count);
+            REPORTER_ASSERT(r, 0 == memcmp(src, dst, count * sizeof(SkPoint)));
+        }
+    }
+
+    // A point mapped to z == 0 comes out as (0, 0), whether or not it is in a pair.
+    SkMatrix persp;
+    persp.reset();
+    persp.setPerspX(SK_Scalar1 / 4);
+    SkPoint pts[3] = { { -4, 7 }, { 1, 1 }, { -4, 3 } };
+    persp.mapPoints(pts, 3);
+    REPORTER_ASSERT(r, 0 == pts[0].fX && 0 == pts[0].fY);
+    REPORTER_ASSERT(r, nearly_equal_relative(pts[1].fX, 0.8f));
+    REPORTER_ASSERT(r, 0 == pts[2].fX && 0 == pts[2].fY);
+}
+
+// mapRects() should produce the same bounds as mapping each rect's corners.
+DEF_TEST(Matrix_MapRects, r) {
+    SkMatrix mats[7];
+    make_batch_matrices(mats);
+
+    SkRandom rand;
+    SkRect src[9], dst[9];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(mats); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(src); ++j) {
+            SkScalar x = rand.nextRangeScalar(-500, 500);
+            SkScalar y = rand.nextRangeScalar(-500, 500);
+            src[j].setXYWH(x, y, rand.nextRangeScalar(0, 300), rand.nextRangeScalar(0, 300));
+        }
+        mats[i].mapRects(dst, src, SK_ARRAY_COUNT(src));
+        for (size_t j = 0; j < SK_ARRAY_COUNT(src); ++j) {
+            SkPoint quad[4];
+            mats[i].mapRectToQuad(quad, src[j]);
+            SkRect expected;
+            expected.set(quad, 4);
+            REPORTER_ASSERT(r, nearly_equal_relative(expected.fLeft,   dst[j].fLeft));
+            REPORTER_ASSERT(r, nearly_equal_relative(expected.fTop,    dst[j].fTop));
+            REPORTER_ASSERT(r, nearly_equal_relative(expected.fRight,  dst[j].fRight));
+            REPORTER_ASSERT(r, nearly_equal_relative(expected.fBottom, dst[j].fBottom));
+
+            SkRect single;
+            REPORTER_ASSERT(r, mats[i].mapRect(&single, src[j]) == mats[i].rectStaysRect());
+            REPORTER_ASSERT(r, single == dst[j]);
+        }
+        // In place.
+        mats[i].mapRects(src, src, SK_ARRAY_COUNT(src));
+        REPORTER_ASSERT(r, 0 == memcmp(src, dst, sizeof(src)));
+    }
+
+    // Like SkRect::set(), a rotated rect with a non-finite corner maps to empty.
+    SkRect bad[2] = { SkRect::MakeLTRB(0, 0, SK_ScalarInfinity, 10),
+                      SkRect::MakeLTRB(0, SK_ScalarNaN, 10, 10) };
+    mats[5].mapRects(bad, bad, 2);
+    REPORTER_ASSERT(r, bad[0].isEmpty() && bad[0].isFinite());
+    REPORTER_ASSERT(r, bad[1].isEmpty() && bad[1].isFinite());
+}
@@ -17,6 +17,8 @@
 #include "SkSize.h"
 #include "SkStream.h"
 #include "SkSurface.h"
+#include "SkRunnable.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 #include "SkWriter32.h"
 #include "Test.h"
@@ -3648,3 +3650,40 @@ DEF_TEST(Paths, reporter) {
     test_dump(reporter);
     test_path_crbugskia2820(reporter);
 }
+
+namespace {
+
+struct GenIDRacer : public SkRunnable {
+    GenIDRacer() : fPath(NULL), fSeen(0) {}
+
+    virtual void run() SK_OVERRIDE { fSeen = fPath->getGenerationID(); }
+
+    const SkPath* fPath;
+    uint32_t      fSeen;
+};
+
+} // namespace
+
+// A path shared between threads (e.g. by a picture played back in tiles) must have one ID,
+// whichever thread asks for it first.
+DEF_TEST(Path_GenID_Threaded, r) {
+    static const int kRacers = 64;
+    for (int i = 0; i < 20; ++i) {
+        SkPath path;
+        path.moveTo(0, 0);
+        path.lineTo(SkIntToScalar(i), 1);
+
+        GenIDRacer racers[kRacers];
+        SkTaskGroup tg;
+        for (int j = 0; j < kRacers; ++j) {
+            racers[j].fPath = &path;
+            tg.add(racers + j);
+        }
+        tg.wait();
+
+        for (int j = 1; j < kRacers; ++j) {
+            REPORTER_ASSERT(r, racers[j].fSeen == racers[0].fSeen);
+        }
+        REPORTER_ASSERT(r, path.getGenerationID() == racers[0].fSeen);
+    }
+}
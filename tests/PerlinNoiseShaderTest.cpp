@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPerlinNoiseShader.h"
+#include "Test.h"
+
+static const int kSize = 64;
+
+static void draw_noise(SkBitmap* bitmap, SkPerlinNoiseShader::Type type, SkScalar seed,
+                       const SkISize* tileSize, SkScalar dx, SkScalar dy, int size = kSize) {
+    bitmap->allocN32Pixels(kSize, kSize);
+    bitmap->eraseColor(SK_ColorTRANSPARENT);
+    SkShader* shader = (SkPerlinNoiseShader::kFractalNoise_Type == type) ?
+        SkPerlinNoiseShader::CreateFractalNoise(0.07f, 0.05f, 3, seed, tileSize) :
+        SkPerlinNoiseShader::CreateTurbulence(0.07f, 0.05f, 3, seed, tileSize);
+    SkPaint paint;
+    paint.setShader(shader)->unref();
+    SkCanvas canvas(*bitmap);
+    canvas.translate(dx, dy);
+    canvas.drawRect(SkRect::MakeXYWH(-dx, -dy, SkIntToScalar(size), SkIntToScalar(size)),
+                    paint);
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b, int dx, int dy,
+                        int size = kSize) {
+    SkAutoLockPixels alpa(a);
+    SkAutoLockPixels alpb(b);
+    for (int y = SkTMax(0, dy); y < SkTMin(size, size + dy); ++y) {
+        for (int x = SkTMax(0, dx); x < SkTMin(size, size + dx); ++x) {
+            if (*a.getAddr32(x - dx, y - dy) != *b.getAddr32(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Stitched noise is rendered through a per-tile cache once a draw covers enough of the tile.
+// Check that a draw too small to fill the cache, a cache hit, and a draw that only partially
+// overlaps the cached tile, produce the same pixels as the first draw.
+DEF_TEST(PerlinNoiseShader_StitchedTileCache, reporter) {
+    const SkISize tileSize = SkISize::Make(40, 30);
+    for (int type = 0; type < 2; ++type) {
+        SkPerlinNoiseShader::Type noiseType = (SkPerlinNoiseShader::Type)type;
+        SkGraphics::PurgeResourceCache();
+
+        SkBitmap small, miss, hit, shifted, unstitched, reseeded;
+        draw_noise(&small, noiseType, 2, &tileSize, 0, 0, 8);
+        draw_noise(&miss, noiseType, 2, &tileSize, 0, 0);
+        REPORTER_ASSERT(reporter, same_pixels(miss, small, 0, 0, 8));
+        draw_noise(&hit, noiseType, 2, &tileSize, 0, 0);
+        REPORTER_ASSERT(reporter, same_pixels(miss, hit, 0, 0));
+
+        draw_noise(&shifted, noiseType, 2, &tileSize, 7, 5);
+        REPORTER_ASSERT(reporter, same_pixels(miss, shifted, 7, 5));
+        draw_noise(&shifted, noiseType, 2, &tileSize, -9, -3);
+        REPORTER_ASSERT(reporter, same_pixels(miss, shifted, -9, -3));
+
+        // Neither the tile nor the seed may be shared with a different shader.
+        draw_noise(&unstitched, noiseType, 2, NULL, 0, 0);
+        REPORTER_ASSERT(reporter, !same_pixels(miss, unstitched, 0, 0));
+        draw_noise(&reseeded, noiseType, 3, &tileSize, 0, 0);
+        REPORTER_ASSERT(reporter, !same_pixels(miss, reseeded, 0, 0));
+    }
+}
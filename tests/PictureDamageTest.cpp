@@ -0,0 +1,212 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkPictureUtils.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+static const int kSize = 256;
+
+// What to do differently from the base picture.
+enum Change {
+    kNone_Change,
+    kRecolor_Change,
+    kMove_Change,
+    kInsert_Change,
+    kRemove_Change,
+};
+
+// Draws a diagonal row of overlapping rects, with op 'which' changed as asked.  With shapes, these
+// are antialiased and some are rotated ovals.
+static SkPicture* record(SkBBHFactory* factory, bool shapes, Change change, int which) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kSize), SkIntToScalar(kSize),
+                                               factory);
+    SkRandom rand;
+    for (int i = 0; i < 20; ++i) {
+        SkPaint paint;
+        paint.setAntiAlias(shapes);
+        paint.setColor(rand.nextU() | 0xFF000000);
+        SkRect r = SkRect::MakeXYWH(SkIntToScalar(12 * i) + 0.5f, SkIntToScalar(10 * i) + 0.25f,
+                                    30, 20);
+        if (i == which) {
+            if (kRecolor_Change == change) {
+                paint.setColor(SK_ColorBLUE);
+            } else if (kMove_Change == change) {
+                r.offset(7.5f, 3);
+            } else if (kInsert_Change == change) {
+                canvas->drawRect(SkRect::MakeXYWH(100, 200, 15, 15), paint);
+            } else if (kRemove_Change == change) {
+                continue;
+            }
+        }
+        canvas->save();
+        if (shapes) {
+            canvas->rotate(SkIntToScalar(i));
+        } else {
+            canvas->translate(0, SkIntToScalar(i & 3));
+        }
+        if (shapes && (i & 1)) {
+            canvas->drawOval(r, paint);
+        } else {
+            canvas->drawRect(r, paint);
+        }
+        canvas->restore();
+    }
+    return recorder.endRecording();
+}
+
+static void draw_full(const SkPicture* pict, const SkMatrix& matrix, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(kSize, kSize);
+    bitmap->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bitmap);
+    canvas.concat(matrix);
+    canvas.drawPicture(pict);
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    for (int y = 0; y < kSize; ++y) {
+        if (0 != memcmp(a.getAddr32(0, y), b.getAddr32(0, y), kSize * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static float damage_area(const SkTDArray<SkRect>& damage) {
+    float area = 0;
+    for (int i = 0; i < damage.count(); ++i) {
+        area += damage[i].width() * damage[i].height();
+    }
+    return area;
+}
+
+// Returns true if every pixel that differs between a and b lies inside the damage, which is mapped
+// to device space by matrix.
+static bool damage_covers_changes(const SkBitmap& a, const SkBitmap& b,
+                                  const SkTDArray<SkRect>& damage, const SkMatrix& matrix) {
+    SkAutoLockPixels lockA(a), lockB(b);
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            if (*a.getAddr32(x, y) == *b.getAddr32(x, y)) {
+                continue;
+            }
+            bool covered = false;
+            for (int i = 0; i < damage.count() && !covered; ++i) {
+                SkRect devRect;
+                matrix.mapRect(&devRect, damage[i]);
+                devRect.outset(SK_Scalar1, SK_Scalar1);
+                covered = devRect.roundOut().contains(x, y);
+            }
+            if (!covered) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void test_change(skiatest::Reporter* reporter, SkBBHFactory* factory, bool shapes,
+                        const SkMatrix& matrix, Change change, int which) {
+    SkAutoTUnref<SkPicture> oldPict(record(factory, shapes, kNone_Change, -1));
+    SkAutoTUnref<SkPicture> newPict(record(factory, shapes, change, which));
+
+    SkTDArray<SkRect> damage;
+    SkPictureUtils::ComputeDamage(oldPict, newPict, &damage);
+    if (kNone_Change == change) {
+        REPORTER_ASSERT(reporter, damage.isEmpty());
+    } else {
+        REPORTER_ASSERT(reporter, !damage.isEmpty());
+        // A single op changed, so the damage should be nowhere near the whole picture.
+        REPORTER_ASSERT(reporter, damage_area(damage) < kSize * kSize / 4);
+    }
+
+    SkBitmap expected, actual;
+    draw_full(newPict, matrix, &expected);
+    draw_full(oldPict, matrix, &actual);
+    REPORTER_ASSERT(reporter, damage_covers_changes(expected, actual, damage, matrix));
+
+    // Edges that aren't axis-aligned may come out a little differently when clipped, so only
+    // rects are expected to redraw exactly.
+    if (!shapes) {
+        SkCanvas canvas(actual);
+        canvas.concat(matrix);
+        SkPictureUtils::PlaybackDamage(newPict, damage, &canvas);
+        REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+    }
+}
+
+DEF_TEST(PictureDamage, reporter) {
+    SkMatrix identity, scaled, perspective;
+    identity.reset();
+    scaled.setScale(0.75f, 1.25f);
+    scaled.postTranslate(3.5f, -2);
+    perspective.reset();
+    perspective.setPerspX(0.001f);
+
+    const Change changes[] = {
+        kNone_Change, kRecolor_Change, kMove_Change, kInsert_Change, kRemove_Change,
+    };
+
+    SkRTreeFactory rtree;
+    SkBBHFactory* factories[] = { NULL, &rtree };
+    for (size_t f = 0; f < SK_ARRAY_COUNT(factories); ++f) {
+        for (size_t c = 0; c < SK_ARRAY_COUNT(changes); ++c) {
+            for (int shapes = 0; shapes < 2; ++shapes) {
+                test_change(reporter, factories[f], SkToBool(shapes), identity, changes[c], 3);
+                test_change(reporter, factories[f], SkToBool(shapes), identity, changes[c], 19);
+                test_change(reporter, factories[f], SkToBool(shapes), scaled, changes[c], 8);
+                test_change(reporter, factories[f], SkToBool(shapes), perspective, changes[c], 8);
+            }
+        }
+    }
+
+    // A picture never damages itself.
+    SkAutoTUnref<SkPicture> pict(record(NULL, true, kNone_Change, -1));
+    SkTDArray<SkRect> damage;
+    SkPictureUtils::ComputeDamage(pict, pict, &damage);
+    REPORTER_ASSERT(reporter, damage.isEmpty());
+}
+
+// Many scattered changes are merged down to a few rects that still cover them all.
+DEF_TEST(PictureDamage_Merge, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkIntToScalar(kSize), SkIntToScalar(kSize));
+    for (int i = 0; i < 64; ++i) {
+        canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(i % 8 * 32), SkIntToScalar(i / 8 * 32),
+                                          8, 8), SkPaint());
+    }
+    SkAutoTUnref<SkPicture> oldPict(recorder.endRecording());
+
+    canvas = recorder.beginRecording(SkIntToScalar(kSize), SkIntToScalar(kSize));
+    SkPaint red;
+    red.setColor(SK_ColorRED);
+    for (int i = 0; i < 64; ++i) {
+        canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(i % 8 * 32), SkIntToScalar(i / 8 * 32),
+                                          8, 8), red);
+    }
+    SkAutoTUnref<SkPicture> newPict(recorder.endRecording());
+
+    SkTDArray<SkRect> damage;
+    SkPictureUtils::ComputeDamage(oldPict, newPict, &damage);
+    REPORTER_ASSERT(reporter, damage.count() > 0 && damage.count() <= 8);
+
+    SkBitmap expected, actual;
+    draw_full(newPict, SkMatrix::I(), &expected);
+    draw_full(oldPict, SkMatrix::I(), &actual);
+    {
+        SkCanvas playbackCanvas(actual);
+        SkPictureUtils::PlaybackDamage(newPict, damage, &playbackCanvas);
+    }
+    REPORTER_ASSERT(reporter, equal_pixels(expected, actual));
+}
@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkShader.h"
@@ -24,3 +27,46 @@ DEF_TEST(PictureShader_empty, reporter) {
             SkShader::kClamp_TileMode, SkShader::kClamp_TileMode, NULL, NULL);
     REPORTER_ASSERT(reporter, NULL == shader);
 }
+
+// Tiles are rendered at quantized scales; check that the pattern still lands where it should,
+// both at scales that have their own bucket and at scales that reuse a larger tile.
+DEF_TEST(PictureShader_scaleBuckets, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* recordingCanvas = recorder.beginRecording(20, 20, NULL, 0);
+    SkPaint red;
+    red.setColor(SK_ColorRED);
+    recordingCanvas->drawRect(SkRect::MakeWH(10, 10), red);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkPaint paint;
+    paint.setShader(SkShader::CreatePictureShader(picture, SkShader::kRepeat_TileMode,
+                                                  SkShader::kRepeat_TileMode, NULL, NULL))->unref();
+
+    static const SkScalar kScales[] = { 1, 2, 0.5f, 1.2f, 1.3f, 2.9f, 0.7f };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kScales); ++i) {
+        const SkScalar scale = kScales[i];
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(100, 100);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        canvas.scale(scale, scale);
+        canvas.drawPaint(paint);
+
+        // Sample the middle of each quadrant of the repeated tiles, away from any edge.
+        for (int ty = 0; ty < 2; ++ty) {
+            for (int tx = 0; tx < 2; ++tx) {
+                for (int q = 0; q < 4; ++q) {
+                    SkScalar cx = (tx * 20 + (q & 1) * 10 + 5) * scale;
+                    SkScalar cy = (ty * 20 + (q >> 1) * 10 + 5) * scale;
+                    if (cx >= 100 || cy >= 100) {
+                        continue;
+                    }
+                    SkPMColor expected = (0 == q) ? SkPreMultiplyColor(SK_ColorRED) : 0;
+                    REPORTER_ASSERT(reporter, expected ==
+                                    *bitmap.getAddr32(SkScalarFloorToInt(cx),
+                                                      SkScalarFloorToInt(cy)));
+                }
+            }
+        }
+    }
+}
@@ -12,6 +12,7 @@
 #include "SkDrawPictureCallback.h"
 #include "SkDropShadowImageFilter.h"
 #include "SkImagePriv.h"
+#include "SkLayerInfo.h"
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
@@ -259,6 +260,64 @@ DEF_TEST(RecordDraw_SaveLayerBoundsAffectsClipBounds, r) {
     REPORTER_ASSERT(r, sloppy_rect_eq(bbh.fEntries[2].bounds, SkRect::MakeLTRB(10, 10, 40, 40)));
 }
 
+// SkRecordTightenLayerBounds() should shrink saveLayers to what is drawn inside them,
+// in the saveLayer's local space, but leave image filter layers (and layers inside them) alone.
+DEF_TEST(RecordDraw_TightenLayerBounds, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 50, 50);
+
+    SkPaint alpha;
+    alpha.setAlpha(0x80);
+    SkPaint filter;
+    filter.setImageFilter(SkDropShadowImageFilter::Create(20, 0, 0, 0, SK_ColorBLACK,
+                          SkDropShadowImageFilter::kDrawShadowAndForeground_ShadowMode))->unref();
+
+    const SkRect explicitBounds = SkRect::MakeLTRB(0, 0, 12, 50);
+    recorder.translate(5, 5);
+    recorder.saveLayer(NULL, &alpha);                   // 1
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPaint());
+    recorder.restore();
+    recorder.saveLayer(&explicitBounds, NULL);          // 4
+        recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPaint());
+    recorder.restore();
+    recorder.saveLayer(NULL, &filter);                  // 7
+        recorder.saveLayer(NULL, &alpha);               // 8
+            recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPaint());
+        recorder.restore();
+    recorder.restore();
+    recorder.saveLayer(NULL, &alpha);                   // 12
+        recorder.saveLayer(NULL, &alpha);               // 13
+            recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPaint());
+        recorder.restore();
+    recorder.restore();
+
+    SkLayerInfo info(SkLayerInfo::ComputeKey());
+    SkRecordComputeLayers(SkRect::MakeWH(50, 50), record, NULL, NULL, &info);
+    SkRecordTightenLayerBounds(&record, info);
+
+    const SkRecords::SaveLayer* layer = assert_type<SkRecords::SaveLayer>(r, record, 1);
+    REPORTER_ASSERT(r, layer->bounds && sloppy_rect_eq(*layer->bounds,
+                                                       SkRect::MakeLTRB(10, 10, 20, 20)));
+    REPORTER_ASSERT(r, layer->paint && 0x80 == layer->paint->getAlpha());
+
+    layer = assert_type<SkRecords::SaveLayer>(r, record, 4);
+    REPORTER_ASSERT(r, layer->bounds && sloppy_rect_eq(*layer->bounds,
+                                                       SkRect::MakeLTRB(10, 10, 12, 20)));
+
+    layer = assert_type<SkRecords::SaveLayer>(r, record, 7);
+    REPORTER_ASSERT(r, NULL == layer->bounds);
+    // The shadow is offset from what the nested layer holds, so its bounds must not be used.
+    layer = assert_type<SkRecords::SaveLayer>(r, record, 8);
+    REPORTER_ASSERT(r, NULL == layer->bounds);
+
+    layer = assert_type<SkRecords::SaveLayer>(r, record, 12);
+    REPORTER_ASSERT(r, layer->bounds && sloppy_rect_eq(*layer->bounds,
+                                                       SkRect::MakeLTRB(10, 10, 20, 20)));
+    layer = assert_type<SkRecords::SaveLayer>(r, record, 13);
+    REPORTER_ASSERT(r, layer->bounds && sloppy_rect_eq(*layer->bounds,
+                                                       SkRect::MakeLTRB(10, 10, 20, 20)));
+}
+
 DEF_TEST(RecordDraw_drawImage, r){
     class SkCanvasMock : public SkCanvas {
     public:
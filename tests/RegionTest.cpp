@@ -254,3 +254,96 @@ DEF_TEST(Region, reporter) {
     test_empties(reporter);
     test_fromchrome(reporter);
 }
+
+static void rand_region(SkRandom& rand, SkRegion* rgn, int n) {
+    rgn->setEmpty();
+    for (int i = 0; i < n; ++i) {
+        rgn->op(randRect(rand), SkRegion::kXOR_Op);
+    }
+}
+
+// Union and intersect use dedicated span mergers; check them against identities that only
+// go through the generic difference/xor merger.
+DEF_TEST(Region_UnionIntersect, reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 1000; ++i) {
+        SkRegion a, b;
+        rand_region(rand, &a, 1 + (i % 7));
+        rand_region(rand, &b, 1 + (i % 5));
+
+        SkRegion aMinusB, expected, actual;
+        aMinusB.op(a, b, SkRegion::kDifference_Op);
+
+        expected.op(aMinusB, b, SkRegion::kXOR_Op);
+        actual.op(a, b, SkRegion::kUnion_Op);
+        REPORTER_ASSERT(reporter, expected == actual);
+
+        expected.op(a, aMinusB, SkRegion::kDifference_Op);
+        actual.op(a, b, SkRegion::kIntersect_Op);
+        REPORTER_ASSERT(reporter, expected == actual);
+    }
+}
+
+DEF_TEST(Region_OpBatch, reporter) {
+    static const SkRegion::Op gOps[] = {
+        SkRegion::kDifference_Op,
+        SkRegion::kIntersect_Op,
+        SkRegion::kUnion_Op,
+        SkRegion::kXOR_Op,
+        SkRegion::kReverseDifference_Op,
+        SkRegion::kReplace_Op,
+    };
+
+    SkRandom rand;
+    for (int i = 0; i < 200; ++i) {
+        SkRegion base;
+        rand_region(rand, &base, i % 4);
+
+        const int N = 1 + (i % 9);
+        SkIRect rects[9];
+        SkRegion rgns[9];
+        const SkRegion* rgnPtrs[9];
+        for (int j = 0; j < N; ++j) {
+            rects[j] = randRect(rand);
+            if (0 == j % 3) {
+                // Large rects so that intersections survive.
+                rects[j].outset(W / 2, H / 2);
+            }
+            rand_region(rand, &rgns[j], 1 + (j % 3));
+            if (0 == j % 2) {
+                rgns[j].op(rects[j], SkRegion::kUnion_Op);
+            }
+            rgnPtrs[j] = &rgns[j];
+        }
+
+        for (size_t k = 0; k < SK_ARRAY_COUNT(gOps); ++k) {
+            SkRegion expected(base), actual(base);
+            for (int j = 0; j < N; ++j) {
+                expected.op(rects[j], gOps[k]);
+            }
+            bool nonEmpty = actual.opRects(rects, N, gOps[k]);
+            REPORTER_ASSERT(reporter, expected == actual);
+            REPORTER_ASSERT(reporter, nonEmpty == !actual.isEmpty());
+
+            expected = base;
+            actual = base;
+            for (int j = 0; j < N; ++j) {
+                expected.op(rgns[j], gOps[k]);
+            }
+            nonEmpty = actual.opRegions(rgnPtrs, N, gOps[k]);
+            REPORTER_ASSERT(reporter, expected == actual);
+            REPORTER_ASSERT(reporter, nonEmpty == !actual.isEmpty());
+        }
+    }
+
+    // setRects() skips empty rects.
+    const SkIRect withEmpties[] = {
+        { 0, 0, 10, 10 }, { 5, 5, 5, 20 }, { 20, 0, 30, 10 }, { 8, 8, 4, 4 },
+    };
+    SkRegion rgn;
+    REPORTER_ASSERT(reporter, rgn.setRects(withEmpties, SK_ARRAY_COUNT(withEmpties)));
+    SkRegion expected(withEmpties[0]);
+    expected.op(withEmpties[2], SkRegion::kUnion_Op);
+    REPORTER_ASSERT(reporter, expected == rgn);
+    REPORTER_ASSERT(reporter, !rgn.setRects(&withEmpties[1], 1));
+}
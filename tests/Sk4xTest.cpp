@@ -77,6 +77,7 @@ DEF_TEST(Sk4x_Arith, r) {
 
     float third = 1.0f/3.0f;
     ASSERT_EQ(Sk4f(1*third, 0.5f, 0.6f, 2*third), Sk4f(1,2,3,4).divide(Sk4f(3,4,5,6)));
+    ASSERT_EQ(Sk4f(0,1,1.5f,4),  Sk4f(0,1,2.25f,16).sqrt());
 
     ASSERT_EQ(Sk4i(4,6,8,10),    Sk4i(1,2,3,4).add(Sk4i(3,4,5,6)));
     ASSERT_EQ(Sk4i(-2,-2,-2,-2), Sk4i(1,2,3,4).subtract(Sk4i(3,4,5,6)));
@@ -114,9 +115,13 @@ DEF_TEST(Sk4x_MinMax, r) {
 
 DEF_TEST(Sk4x_Swizzle, r) {
     ASSERT_EQ(Sk4f(3,4,1,2), Sk4f(1,2,3,4).zwxy());
+    ASSERT_EQ(Sk4f(1,1,3,3), Sk4f(1,2,3,4).xxzz());
+    ASSERT_EQ(Sk4f(2,2,4,4), Sk4f(1,2,3,4).yyww());
     ASSERT_EQ(Sk4f(1,2,5,6), Sk4f::XYAB(Sk4f(1,2,3,4), Sk4f(5,6,7,8)));
     ASSERT_EQ(Sk4f(3,4,7,8), Sk4f::ZWCD(Sk4f(1,2,3,4), Sk4f(5,6,7,8)));
     ASSERT_EQ(Sk4i(3,4,1,2), Sk4i(1,2,3,4).zwxy());
+    ASSERT_EQ(Sk4i(1,1,3,3), Sk4i(1,2,3,4).xxzz());
+    ASSERT_EQ(Sk4i(2,2,4,4), Sk4i(1,2,3,4).yyww());
     ASSERT_EQ(Sk4i(1,2,5,6), Sk4i::XYAB(Sk4i(1,2,3,4), Sk4i(5,6,7,8)));
     ASSERT_EQ(Sk4i(3,4,7,8), Sk4i::ZWCD(Sk4i(1,2,3,4), Sk4i(5,6,7,8)));
 }
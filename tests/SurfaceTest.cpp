@@ -9,6 +9,8 @@
 #include "SkData.h"
 #include "SkDecodingImageGenerator.h"
 #include "SkImageEncoder.h"
+#include "SkImagePriv.h"
+#include "SkPixelRef.h"
 #include "SkRRect.h"
 #include "SkSurface.h"
 #include "SkUtils.h"
@@ -320,6 +322,169 @@ static void TestSurfaceWritableAfterSnapshotRelease(skiatest::Reporter* reporter
     canvas->clear(2);  // Must not assert internally
 }
 
+// Makes the i'th of a sequence of small changes, using the various ways a canvas can change its
+// pixels.
+static void draw_change(SkCanvas* canvas, int i) {
+    SkPaint paint;
+    paint.setAntiAlias(SkToBool(i & 1));
+    paint.setColor(SkColorSetARGB(0x80 + (i * 37) % 0x80, (i * 53) & 0xFF, (i * 97) & 0xFF,
+                                  (i * 13) & 0xFF));
+    const SkScalar x = SkIntToScalar((i * 71) % 280);
+    const SkScalar y = SkIntToScalar((i * 43) % 180);
+    switch (i % 4) {
+        case 0:
+            canvas->drawRect(SkRect::MakeXYWH(x, y, 30, 20), paint);
+            break;
+        case 1:
+            canvas->save();
+            canvas->translate(x, y);
+            canvas->rotate(SkIntToScalar(i * 10));
+            canvas->translate(-x, -y);
+            canvas->drawOval(SkRect::MakeXYWH(x, y, 40, 10), paint);
+            canvas->restore();
+            break;
+        case 2:
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(SkIntToScalar(i % 5));
+            canvas->drawLine(x, y, x + 90, y + 15, paint);
+            break;
+        default: {
+            SkBitmap bm;
+            bm.allocN32Pixels(9, 7);
+            bm.eraseColor(paint.getColor());
+            canvas->writePixels(bm, (i * 71) % 300, (i * 43) % 200);
+            break;
+        }
+    }
+}
+
+static bool image_equals(SkImage* image, const SkBitmap& bm) {
+    SkImageInfo info;
+    size_t rowBytes;
+    const char* pixels = (const char*)image->peekPixels(&info, &rowBytes);
+    if (NULL == pixels || info != bm.info()) {
+        return false;
+    }
+    SkAutoLockPixels alp(bm);
+    for (int y = 0; y < bm.height(); ++y) {
+        if (memcmp(pixels + y * rowBytes, bm.getAddr(0, y), bm.width() * bm.bytesPerPixel())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sets a flag when the pixels change, or go away.
+class FlagListener : public SkPixelRef::GenIDChangeListener {
+public:
+    explicit FlagListener(bool* flag) : fFlag(flag) {}
+    virtual void onChange() SK_OVERRIDE { *fFlag = true; }
+
+private:
+    bool* fFlag;
+};
+
+// Raster surfaces draw into the pixels of a released snapshot again, bringing over only the tiles
+// that changed since. Check that snapshots and the surface keep the right contents throughout.
+static void TestSurfaceTiledCopyOnWrite(skiatest::Reporter* reporter) {
+    // not a multiple of the tile size
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 200);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info));
+    SkCanvas* canvas = surface->getCanvas();
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    expected.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas expectedCanvas(expected);
+
+    SkAutoTUnref<SkImage> snapshots[3];
+    SkBitmap snapshotContents[3];
+    int expiry[3] = { 0, 0, 0 };
+
+    for (int i = 0; i < 40; ++i) {
+        // Snapshots are released one or two changes later, so the surface sometimes can and
+        // sometimes can't reuse their pixels.
+        for (int j = 0; j < 3; ++j) {
+            if (snapshots[j].get()) {
+                REPORTER_ASSERT(reporter, image_equals(snapshots[j], snapshotContents[j]));
+                if (expiry[j] == i) {
+                    snapshots[j].reset(NULL);
+                }
+            }
+        }
+        if (7 == i % 8) {
+            surface->notifyContentWillChange(SkSurface::kDiscard_ContentChangeMode);
+            canvas->clear(SK_ColorBLUE);
+            expectedCanvas.clear(SK_ColorBLUE);
+        }
+        draw_change(canvas, i);
+        draw_change(&expectedCanvas, i);
+
+        const int k = i % 3;
+        snapshots[k].reset(surface->newImageSnapshot());
+        REPORTER_ASSERT(reporter, image_equals(snapshots[k], expected));
+        expected.copyTo(&snapshotContents[k]);
+        expiry[k] = i + 1 + (i & 1);
+    }
+
+    // Once the snapshot is gone, the surface goes back to drawing into its pixels.
+    for (int j = 0; j < 3; ++j) {
+        snapshots[j].reset(NULL);
+    }
+    SkAutoTUnref<SkImage> first(surface->newImageSnapshot());
+    const void* firstPixels = first->peekPixels(NULL, NULL);
+    canvas->drawColor(SK_ColorRED, SkXfermode::kSrcOver_Mode);
+    SkAutoTUnref<SkImage> second(surface->newImageSnapshot());
+    first.reset(NULL);
+    canvas->drawColor(SK_ColorGREEN, SkXfermode::kSrcOver_Mode);
+    REPORTER_ASSERT(reporter, surface->peekPixels(NULL, NULL) == firstPixels);
+
+    // Without a snapshot to fork from, the surface lets go of the old snapshot's pixels.
+    bool secondPixelsFreed = false;
+    SkPixelRef* secondPixels = const_cast<SkPixelRef*>(SkBitmapImageGetPixelRef(second));
+    secondPixels->getGenerationID();    // listeners are only kept once there is an ID
+    secondPixels->addGenIDChangeListener(SkNEW_ARGS(FlagListener, (&secondPixelsFreed)));
+    second.reset(NULL);
+    REPORTER_ASSERT(reporter, !secondPixelsFreed);
+    canvas->drawColor(SK_ColorBLUE, SkXfermode::kSrcOver_Mode);
+    REPORTER_ASSERT(reporter, secondPixelsFreed);
+}
+
+// Pixels written directly, rather than drawn through the canvas, must survive a fork too.
+static void TestSurfaceCopyOnWriteDirectWrite(skiatest::Reporter* reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 200);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info));
+    SkCanvas* canvas = surface->getCanvas();
+
+    // The surface only starts tracking what changes after its first fork.
+    SkAutoTUnref<SkImage> zero(surface->newImageSnapshot());
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    zero.reset(NULL);
+
+    SkAutoTUnref<SkImage> first(surface->newImageSnapshot());
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+
+    SkImageInfo pixelsInfo;
+    size_t rowBytes;
+    SkPMColor* pixels = (SkPMColor*)canvas->accessTopLayerPixels(&pixelsInfo, &rowBytes);
+    REPORTER_ASSERT(reporter, pixels);
+    if (NULL == pixels) {
+        return;
+    }
+    SkPMColor* pixel = (SkPMColor*)((char*)pixels + 150 * rowBytes) + 250;
+    *pixel = SkPreMultiplyColor(SK_ColorRED);
+
+    // Forks by reusing first's pixels.
+    first.reset(NULL);
+    SkAutoTUnref<SkImage> second(surface->newImageSnapshot());
+    canvas->drawRect(SkRect::MakeWH(10, 10), SkPaint());
+
+    SkBitmap bm;
+    bm.allocPixels(info);
+    REPORTER_ASSERT(reporter, canvas->readPixels(&bm, 0, 0));
+    REPORTER_ASSERT(reporter, SK_ColorRED == bm.getColor(250, 150));
+}
+
 #if SK_SUPPORT_GPU
 static void Test_crbug263329(skiatest::Reporter* reporter,
                              SurfaceType surfaceType,
@@ -410,6 +575,8 @@ DEF_GPUTEST(Surface, reporter, factory) {
 
     TestSurfaceCopyOnWrite(reporter, kRaster_SurfaceType, NULL);
     TestSurfaceWritableAfterSnapshotRelease(reporter, kRaster_SurfaceType, NULL);
+    TestSurfaceTiledCopyOnWrite(reporter);
+    TestSurfaceCopyOnWriteDirectWrite(reporter);
     TestSurfaceNoCanvas(reporter, kRaster_SurfaceType, NULL, SkSurface::kDiscard_ContentChangeMode);
     TestSurfaceNoCanvas(reporter, kRaster_SurfaceType, NULL, SkSurface::kRetain_ContentChangeMode);
 
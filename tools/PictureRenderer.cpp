@@ -820,6 +820,8 @@ SkBBHFactory* PictureRenderer::getFactory() {
             return SkNEW(SkRTreeFactory);
         case kTileGrid_BBoxHierarchyType:
             return SkNEW_ARGS(SkTileGridFactory, (fGridInfo));
+        case kLinear_BBoxHierarchyType:
+            return SkNEW(SkLinearBBHFactory);
     }
     SkASSERT(0); // invalid bbhType
     return NULL;
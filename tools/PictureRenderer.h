@@ -58,8 +58,9 @@ public:
         kNone_BBoxHierarchyType = 0,
         kRTree_BBoxHierarchyType,
         kTileGrid_BBoxHierarchyType,
+        kLinear_BBoxHierarchyType,
 
-        kLast_BBoxHierarchyType = kTileGrid_BBoxHierarchyType,
+        kLast_BBoxHierarchyType = kLinear_BBoxHierarchyType,
     };
 
     // this uses SkPaint::Flags as a base and adds additional flags
@@ -272,6 +273,8 @@ public:
             config.appendS32(fGridInfo.fTileInterval.width());
             config.append("x");
             config.appendS32(fGridInfo.fTileInterval.height());
+        } else if (kLinear_BBoxHierarchyType == fBBoxHierarchyType) {
+            config.append("_linear");
         }
 #if SK_SUPPORT_GPU
         switch (fDeviceType) {
@@ -322,6 +325,8 @@ public:
             tmp.append("x");
             tmp.appendS32(fGridInfo.fTileInterval.height());
             result["bbh"] = tmp.c_str();
+        } else if (kLinear_BBoxHierarchyType == fBBoxHierarchyType) {
+            result["bbh"] = "linear";
         }
 #if SK_SUPPORT_GPU
         SkString tmp;
@@ -18,7 +18,7 @@
 
 // Alphabetized list of flags used by this file or bench_ and render_pictures.
 DEFINE_string(bbh, "none", "bbhType [width height]: Set the bounding box hierarchy type to "
-              "be used. Accepted values are: none, rtree, grid. "
+              "be used. Accepted values are: none, rtree, grid, linear. "
               "Not compatible with --pipe. With value "
               "'grid', width and height must be specified. 'grid' can "
               "only be used with modes tile, record, and "
@@ -368,6 +368,8 @@ sk_tools::PictureRenderer* parseRenderer(SkString& error, PictureTool tool) {
             int gridHeight = atoi(FLAGS_bbh[2]);
             renderer->setGridSize(gridWidth, gridHeight);
 
+        } else if (0 == strcmp(type, "linear")) {
+            bbhType = sk_tools::PictureRenderer::kLinear_BBoxHierarchyType;
         } else {
             error.printf("%s is not a valid value for --bbhType\n", type);
             return NULL;
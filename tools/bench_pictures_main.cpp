@@ -476,6 +476,9 @@ int tool_main(int argc, char** argv) {
         GrContext* ctx = benchmark.renderer()->getGrContext();
         SkDebugf("RenderTarget Binds: %d\n", ctx->gpuStats()->renderTargetBinds());
         SkDebugf("Shader Compilations: %d\n", ctx->gpuStats()->shaderCompilations());
+        SkDebugf("Draws: %d\n", ctx->gpuStats()->draws());
+        SkDebugf("State Flushes: %d\n", ctx->gpuStats()->stateFlushes());
+        SkDebugf("GL Calls: %d\n", ctx->gpuStats()->glCalls());
     }
 #endif
 